@@ -22,10 +22,12 @@
 #include "model/ufwmodel.h"
 #include "node.h"
 #include "parser/ufwparser.h"
+#include "utility/ufwdelta.h"
 #include "utility/ufwupdate.h"
 
 #include <QDebug>
 #include <QFile>
+#include <QScopedPointer>
 #include <QtEndian>
 
 enum
@@ -61,15 +63,17 @@ Bootloader::Bootloader(Node *node)
     : _node(node)
 {
     _node = node;
-    _ufwModel = nullptr;
     _ufwUpdate = new UfwUpdate(_node);
     connect(_ufwUpdate, &UfwUpdate::finished, this, &Bootloader::processEndUpload);
+    connect(_ufwUpdate, &UfwUpdate::progress, this, &Bootloader::updateProgress);
 
     _programDataObjectId = IndexDb::getObjectId(IndexDb::OD_PROGRAM_DATA_1);
     _programControlObjectId = IndexDb::getObjectId(IndexDb::OD_PROGRAM_CONTROL_1);
     _bootloaderKeyObjectId = IndexDb::getObjectId(IndexDb::OD_BOOTLOADER_KEY);
     _bootloaderChecksumObjectId = IndexDb::getObjectId(IndexDb::OD_BOOTLOADER_CHECKSUM);
     _bootloaderStatusObjectId = IndexDb::getObjectId(IndexDb::OD_BOOTLOADER_STATUS);
+    _pageSizeObjectId = IndexDb::getObjectId(IndexDb::OD_BOOTLOADER_PAGE_SIZE);
+    _pageChecksumsObjectId = IndexDb::getObjectId(IndexDb::OD_BOOTLOADER_PAGE_CHECKSUMS);
 
     setNodeInterrest(_node);
     registerObjId({0x1000, 0});
@@ -84,12 +88,17 @@ Bootloader::Bootloader(Node *node)
     _state = STATE_FREE;
     _statusProgram = NONE;
     _mode = MODE_NONE;
+
+    _deltaMode = false;
+    _deltaSource = DELTA_NONE;
+    _deltaBatchId = 0;
+    _imageWritten = false;
+    connect(_node->nodeOd(), &NodeOd::objectsRead, this, &Bootloader::analyzeDelta);
 }
 
 Bootloader::~Bootloader()
 {
     delete _ufwUpdate;
-    delete _ufwModel;
     unRegisterFullOd();
 }
 
@@ -141,6 +150,8 @@ QString Bootloader::statusStr(Status status) const
             return QString(tr("Device update in progress"));
         case Bootloader::STATUS_CHECKING_UPDATE:
             return QString(tr("Checking the update"));
+        case Bootloader::STATUS_DELTA_ANALYSIS_IN_PROGRESS:
+            return QString(tr("Comparing firmware pages"));
         case Bootloader::STATUS_UPDATE_SUCCESSFUL:
             return QString(tr("Update successful"));
     }
@@ -161,20 +172,34 @@ bool Bootloader::openUfw(const QString &fileName)
         return false;
     }
 
-    _ufwModel = UfwParser::parse(fileName);
+    QSharedPointer<UfwModel> ufwModel(UfwParser::parse(fileName));
     file.close();
 
-    if (_ufwModel == nullptr)
+    if (ufwModel.isNull())
     {
         setStatus(STATUS_ERROR_ERROR_PARSER);
         return false;
     }
 
-    _ufwUpdate->setUfw(_ufwModel);
+    setUfw(ufwModel);
+    return true;
+}
+
+/**
+ * @brief Sets an already parsed firmware, the model is not modified and can be shared by several nodes
+ */
+void Bootloader::setUfw(const QSharedPointer<UfwModel> &ufwModel)
+{
+    if (ufwModel.isNull())
+    {
+        setStatus(STATUS_ERROR_NO_FILE);
+        return;
+    }
+
+    _ufwModel = ufwModel;
+    _ufwUpdate->setUfw(_ufwModel.data());
     setStatus(STATUS_FILE_ANALYZED_OK);
     _state = STATE_FREE;
-
-    return true;
 }
 
 void Bootloader::setOtpInformation(uint32_t address, const QString &date, uint16_t device, uint32_t serialNumber, const QString &version)
@@ -215,7 +240,7 @@ void Bootloader::startOtpUpload()
 
 void Bootloader::startUpdate()
 {
-    if (_ufwModel == nullptr)
+    if (_ufwModel.isNull())
     {
         setStatus(STATUS_ERROR_NO_FILE);
         return;
@@ -227,16 +252,94 @@ void Bootloader::startUpdate()
         return;
     }
 
-    setStatus(STATUS_CHECK_FILE_AND_DEVICE);
-    _state = STATE_CHECK_MODE;
+    _ufwUpdate->clearSegments();
+    _deltaSource = DELTA_NONE;
+    _imageWritten = false;
     _node->sendPreop();
     _node->nodeOd()->createBootloaderObjects();
+
+    if (_deltaMode)
+    {
+        // serial number keys the image cache, device checksums are optional
+        setStatus(STATUS_DELTA_ANALYSIS_IN_PROGRESS);
+        _state = STATE_DELTA_ANALYSIS;
+        _deltaBatchId = 0;
+        quint32 batchId = _node->readObjects({NodeObjectId(0x1018, 4, QMetaType::UInt), _pageSizeObjectId, _pageChecksumsObjectId});
+        if (_state == STATE_DELTA_ANALYSIS)
+        {
+            _deltaBatchId = batchId;
+        }
+        return;
+    }
+
+    setStatus(STATUS_CHECK_FILE_AND_DEVICE);
+    _state = STATE_CHECK_MODE;
     readStatusProgram();
 }
 
+/**
+ * @brief Gives up the update in progress, the device is left as is
+ *
+ * The update ends with STATUS_ERROR_UPDATE_FAILED, a new update can be started.
+ */
+void Bootloader::abortUpdate()
+{
+    if (_state == STATE_FREE)
+    {
+        return;
+    }
+
+    _ufwUpdate->abort();
+    _state = STATE_FREE;
+    _mode = MODE_NONE;
+    setStatus(STATUS_ERROR_UPDATE_FAILED);
+}
+
+/**
+ * @brief Enables delta updates, only the pages that differ from the firmware in the device are written
+ *
+ * Delta updates need a device bootloader reporting its page size (0x2050.4),
+ * it erases each page before writing it and the program is not cleared. Pages
+ * are compared to the checksum table of the device (0x2050.5) when it reports
+ * one, or to the image previously flashed in the device found in
+ * imageCacheDir() with its serial number. Without page support, without
+ * reference or if a changed page has to be erased, the update is a full
+ * update.
+ */
+void Bootloader::setDeltaMode(bool deltaMode)
+{
+    _deltaMode = deltaMode;
+}
+
+bool Bootloader::isDeltaMode() const
+{
+    return _deltaMode;
+}
+
+/**
+ * @brief Sets the directory where images flashed successfully are kept by node serial number, empty to disable
+ */
+void Bootloader::setImageCacheDir(const QString &imageCacheDir)
+{
+    _imageCacheDir = imageCacheDir;
+}
+
+const QString &Bootloader::imageCacheDir() const
+{
+    return _imageCacheDir;
+}
+
+/**
+ * @brief Reference used by the last update, DELTA_NONE for a full update
+ */
+Bootloader::DeltaSource Bootloader::deltaSource() const
+{
+    return _deltaSource;
+}
+
 uint32_t Bootloader::deviceType()
 {
-    if (_ufwModel == nullptr)
+    if (_ufwModel.isNull())
     {
         return 0;
     }
@@ -245,7 +348,7 @@ uint32_t Bootloader::deviceType()
 
 QString Bootloader::versionSoftware()
 {
-    if (_ufwModel == nullptr)
+    if (_ufwModel.isNull())
     {
         return QString();
     }
@@ -254,7 +357,7 @@ QString Bootloader::versionSoftware()
 
 QString Bootloader::buildDate()
 {
-    if (_ufwModel == nullptr)
+    if (_ufwModel.isNull())
     {
         return QString();
     }
@@ -316,7 +419,7 @@ void Bootloader::updateFinishedProgram()
 
 void Bootloader::sendKey()
 {
-    if (_ufwModel != nullptr)
+    if (!_ufwModel.isNull())
     {
         _node->writeObject(_bootloaderKeyObjectId, _ufwModel->deviceType());
     }
@@ -359,6 +462,7 @@ void Bootloader::processEndUpload(bool ok)
 {
     if (ok)
     {
+        _imageWritten = true;
         _state = STATE_UPLOADED_PROGRAM_FINISHED;
     }
     else
@@ -368,6 +472,107 @@ void Bootloader::processEndUpload(bool ok)
     process();
 }
 
+void Bootloader::analyzeDelta(quint32 batchId, const QList<NodeOd::ReadResult> &results)
+{
+    if (_state != STATE_DELTA_ANALYSIS)
+    {
+        return;
+    }
+    // batch completed from readObjects() when no object can be read, its id is not yet known
+    if (_deltaBatchId != 0 && batchId != _deltaBatchId)
+    {
+        return;
+    }
+
+    NodeObjectId serialNumberObjectId(_node->busId(), _node->nodeId(), 0x1018, 4);
+    NodeObjectId pageSizeObjectId(_node->busId(), _node->nodeId(), _pageSizeObjectId.index(), _pageSizeObjectId.subIndex());
+    NodeObjectId pageChecksumsObjectId(_node->busId(), _node->nodeId(), _pageChecksumsObjectId.index(), _pageChecksumsObjectId.subIndex());
+
+    quint32 serialNumber = 0;
+    int pageSize = UfwDelta::DefaultPageSize;
+    bool pageSupport = false;  // device bootloader reports its pages and erases each page before writing it
+    QByteArray checksumTable;
+    for (const NodeOd::ReadResult &result : results)
+    {
+        if (result.error != 0)
+        {
+            continue;
+        }
+        if (result.objectId == serialNumberObjectId)
+        {
+            serialNumber = result.value.toUInt();
+        }
+        else if (result.objectId == pageSizeObjectId && result.value.toInt() > 0)
+        {
+            pageSize = result.value.toInt();
+            pageSupport = true;
+        }
+        else if (result.objectId == pageChecksumsObjectId)
+        {
+            checksumTable = result.value.toByteArray();
+        }
+    }
+
+    // without page support the program is cleared and fully written
+    if (pageSupport)
+    {
+        UfwDelta delta(_ufwModel.data(), pageSize);
+        if (!checksumTable.isEmpty())
+        {
+            delta.compare(UfwDelta::parseChecksumTable(checksumTable));
+            _deltaSource = DELTA_DEVICE_TABLE;
+        }
+        else if (!_imageCacheDir.isEmpty() && serialNumber != 0)
+        {
+            QScopedPointer<UfwModel> cachedImage(UfwParser::parse(UfwDelta::cacheFileName(_imageCacheDir, serialNumber)));
+            if (!cachedImage.isNull() && cachedImage->deviceType() == _ufwModel->deviceType())
+            {
+                delta.compare(cachedImage.data());
+                _deltaSource = DELTA_CACHED_IMAGE;
+            }
+        }
+
+        if (_deltaSource != DELTA_NONE && delta.erasedPageCount() > 0)
+        {
+            // pages to erase are only erased by a full clear
+            _deltaSource = DELTA_NONE;
+        }
+        else if (_deltaSource != DELTA_NONE)
+        {
+            if (delta.changedPageCount() == 0)
+            {
+                // firmware already in the device, nothing to write
+                _state = STATE_FREE;
+                setStatus(STATUS_UPDATE_SUCCESSFUL);
+                return;
+            }
+            _ufwUpdate->setSegments(delta.changedSegments());
+        }
+    }
+
+    setStatus(STATUS_CHECK_FILE_AND_DEVICE);
+    _state = STATE_CHECK_MODE;
+    readStatusProgram();
+}
+
+/**
+ * @brief Keeps the image flashed in the device for next delta updates
+ */
+void Bootloader::saveFlashedImage()
+{
+    if (_imageCacheDir.isEmpty() || _ufwModel.isNull())
+    {
+        return;
+    }
+
+    quint32 serialNumber = _node->nodeOd()->value(0x1018, 4).toUInt();
+    if (serialNumber == 0)
+    {
+        return;
+    }
+    UfwDelta::saveImage(_ufwModel.data(), UfwDelta::cacheFileName(_imageCacheDir, serialNumber));
+}
+
 void Bootloader::process()
 {
     switch (_state)
@@ -376,6 +581,9 @@ void Bootloader::process()
             _statusProgram = StatusProgram::NONE;
             break;
 
+        case STATE_DELTA_ANALYSIS:
+            break;
+
         case STATE_CHECK_MODE:
         {
             switch (_statusProgram)
@@ -392,9 +600,8 @@ void Bootloader::process()
                     }
                     else
                     {
-                        setStatus(STATUS_DEVICE_CLEAR_IN_PROGRESS);
-                        sendKey();
-                        clearProgram();
+                        _state = STATE_CLEAR_PROGRAM;
+                        process();
                     }
                     break;
 
@@ -424,6 +631,14 @@ void Bootloader::process()
             break;
 
         case STATE_CLEAR_PROGRAM:
+            if (_deltaSource != DELTA_NONE)
+            {
+                // delta update, pages are erased by the device when written
+                sendKey();
+                _state = STATE_UPDATE_PROGRAM;
+                process();
+                break;
+            }
             setStatus(STATUS_DEVICE_CLEAR_IN_PROGRESS);
             sendKey();
             clearProgram();
@@ -477,6 +692,10 @@ void Bootloader::process()
             break;
 
         case STATE_OK:
+            if (_imageWritten)
+            {
+                saveFlashedImage();
+            }
             resetProgram();
             _state = STATE_FREE;
             _mode = MODE_NONE;
@@ -24,6 +24,7 @@
 #include "nodeodsubscriber.h"
 
 #include <QObject>
+#include <QSharedPointer>
 
 class Node;
 class NodeObjectId;
@@ -58,14 +59,30 @@ public:
         STATUS_DEVICE_WRITING_OTP_IN_PROGRESS = 6,
         STATUS_DEVICE_UPDATE_IN_PROGRESS = 7,
         STATUS_CHECKING_UPDATE = 8,
+        STATUS_DELTA_ANALYSIS_IN_PROGRESS = 9,
     };
     Status status() const;
     QString statusStr(Status status) const;
     quint32 error() const;
 
     bool openUfw(const QString &fileName);
+    void setUfw(const QSharedPointer<UfwModel> &ufwModel);
 
     void startUpdate();
+    void abortUpdate();
+
+    // delta update
+    void setDeltaMode(bool deltaMode);
+    bool isDeltaMode() const;
+    void setImageCacheDir(const QString &imageCacheDir);
+    const QString &imageCacheDir() const;
+    enum DeltaSource
+    {
+        DELTA_NONE,           // full update
+        DELTA_DEVICE_TABLE,   // pages compared to the checksum table reported by the device
+        DELTA_CACHED_IMAGE    // pages compared to the image previously flashed in the device
+    };
+    DeltaSource deltaSource() const;
 
     void setOtpInformation(uint32_t address, const QString &date, uint16_t device, uint32_t serialNumber, const QString &version);
     void startOtpUpload();
@@ -84,11 +101,13 @@ public slots:
 
 signals:
     void statusEvent();
+    void updateProgress(qint64 bytesWritten, qint64 bytesTotal);
 
 private slots:
     void readStatusProgram();
     void readStatusBootloader();
     void processEndUpload(bool ok);
+    void analyzeDelta(quint32 batchId, const QList<NodeOd::ReadResult> &results);
 
 private:
     Node *_node;
@@ -113,12 +132,22 @@ private:
     NodeObjectId _programControlObjectId;
     NodeObjectId _programDataObjectId;
 
-    UfwModel *_ufwModel;
+    QSharedPointer<UfwModel> _ufwModel;  // may be shared by nodes updated with the same file
     UfwUpdate *_ufwUpdate;
 
+    bool _deltaMode;
+    QString _imageCacheDir;
+    DeltaSource _deltaSource;
+    quint32 _deltaBatchId;
+    bool _imageWritten;  // firmware written by the current update, kept in the cache once checked
+    NodeObjectId _pageSizeObjectId;
+    NodeObjectId _pageChecksumsObjectId;
+    void saveFlashedImage();
+
     enum BootloaderState
     {
         STATE_FREE,
+        STATE_DELTA_ANALYSIS,
         STATE_CHECK_MODE,
         STATE_STOP_PROGRAM,
         STATE_CLEAR_PROGRAM,
@@ -20,140 +20,305 @@
 
 #include <QDebug>
 #include <QFile>
-#include <QTextStream>
+
+#include <array>
+#include <cstring>
+
+// flat image limit of prog()
+#define HEX_PROG_MAX 0x1E8480
+
+enum RecordType : quint8
+{
+    RECORD_DATA = 0x00,
+    RECORD_END_OF_FILE = 0x01,
+    RECORD_EXTENDED_SEGMENT_ADDRESS = 0x02,
+    RECORD_START_SEGMENT_ADDRESS = 0x03,
+    RECORD_EXTENDED_LINEAR_ADDRESS = 0x04,
+    RECORD_START_LINEAR_ADDRESS = 0x05
+};
+
+/**
+ * @brief Nibble value of each character, 0xFF for non hexadecimal characters
+ */
+static const quint8 *hexNibbleTable()
+{
+    static const std::array<quint8, 256> table = []()
+    {
+        std::array<quint8, 256> nibbles;
+        nibbles.fill(0xFF);
+        for (int i = 0; i < 10; i++)
+        {
+            nibbles['0' + i] = static_cast<quint8>(i);
+        }
+        for (int i = 0; i < 6; i++)
+        {
+            nibbles['A' + i] = static_cast<quint8>(10 + i);
+            nibbles['a' + i] = static_cast<quint8>(10 + i);
+        }
+        return nibbles;
+    }();
+    return table.data();
+}
 
 HexParser::HexParser(const QString &fileName)
 {
     _fileName = fileName;
+    _checksum = 0;
+    _hasStartAddress = false;
+    _startAddress = 0;
+    _errorLine = 0;
 }
 
 bool HexParser::read()
 {
-    int lineCount = 1;
-    int offsetAddr = 0;
-    int dataCount;
-    int addr;
-    int type;
-    int checkSum;
-    bool ok;
-
     if (_fileName.isEmpty())
     {
         return false;
     }
 
     QFile file(_fileName);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    if (!file.open(QIODevice::ReadOnly))
     {
         qDebug() << "HexParser::read : cannot open" << _fileName;
         return false;
     }
 
-    QTextStream stream(&file);
+    qint64 size = file.size();
+    uchar *map = (size > 0) ? file.map(0, size) : nullptr;
+    if (map != nullptr)
+    {
+        bool ok = parse(reinterpret_cast<const char *>(map), size);
+        file.unmap(map);
+        return ok;
+    }
+
+    // file system without mapping support
+    QByteArray content = file.readAll();
+    return parse(content.constData(), content.size());
+}
+
+/**
+ * @brief Decodes an Intel HEX content already in memory
+ */
+bool HexParser::parse(const QByteArray &hex)
+{
+    return parse(hex.constData(), hex.size());
+}
+
+const QByteArray &HexParser::prog() const
+{
+    return _prog;
+}
+
+const unsigned short &HexParser::checksum() const
+{
+    return _checksum;
+}
+
+/**
+ * @brief Contiguous data of the file, in file order
+ */
+const QVector<HexParser::Range> &HexParser::ranges() const
+{
+    return _ranges;
+}
+
+bool HexParser::hasStartAddress() const
+{
+    return _hasStartAddress;
+}
+
+/**
+ * @brief Start address of a type 5 record, or linear equivalent of a type 3 record
+ */
+quint32 HexParser::startAddress() const
+{
+    return _startAddress;
+}
+
+/**
+ * @brief Line of the first invalid record, 0 if the last read succeeded
+ */
+int HexParser::errorLine() const
+{
+    return _errorLine;
+}
+
+bool HexParser::parse(const char *data, qint64 size)
+{
+    const quint8 *nibble = hexNibbleTable();
+    quint8 record[255 + 5];  // count, address, type, data, checksum
+    quint32 baseAddress = 0;
+    int lineCount = 0;
+
+    _ranges.clear();
     _prog.clear();
-    _prog.fill(static_cast<char>(0xFF), 0x100);
+    _checksum = 0;
+    _hasStartAddress = false;
+    _startAddress = 0;
+    _errorLine = 0;
 
-    while (!stream.atEnd())
+    const char *pos = data;
+    const char *end = data + size;
+    bool endOfFile = false;
+    while (pos < end && !endOfFile)
     {
-        int index = 0;
-        QString line = stream.readLine();
+        const char *lineEnd = static_cast<const char *>(memchr(pos, '\n', static_cast<size_t>(end - pos)));
+        if (lineEnd == nullptr)
+        {
+            lineEnd = end;
+        }
+        const char *next = (lineEnd < end) ? lineEnd + 1 : end;
+        lineCount++;
 
-        if (line.size() < 11)
+        const char *stop = lineEnd;
+        while (stop > pos && (stop[-1] == '\r' || stop[-1] == ' ' || stop[-1] == '\t'))
         {
-            return false;
+            stop--;
         }
-        if (line.at(index) != ':')
+        if (stop == pos)
         {
-            return false;
+            pos = next;
+            continue;
         }
-        index++;
 
-        dataCount = line.mid(index, 2).toInt(&ok, 16);
-        if (!ok)
+        qint64 digits = stop - pos - 1;
+        if (*pos != ':' || digits < 10 || (digits & 1) != 0 || digits > 2 * static_cast<qint64>(sizeof(record)))
         {
+            _errorLine = lineCount;
             return false;
         }
-        index += 2;
 
-        addr = line.mid(index, 4).toInt(&ok, 16);
-        if (!ok)
+        int byteCount = static_cast<int>(digits / 2);
+        const quint8 *hex = reinterpret_cast<const quint8 *>(pos + 1);
+        quint8 sum = 0;
+        for (int i = 0; i < byteCount; i++)
         {
-            return false;
+            quint8 high = nibble[hex[2 * i]];
+            quint8 low = nibble[hex[2 * i + 1]];
+            if (((high | low) & 0xF0) != 0)
+            {
+                _errorLine = lineCount;
+                return false;
+            }
+            record[i] = static_cast<quint8>((high << 4) | low);
+            sum += record[i];
         }
-        index += 4;
 
-        type = line.mid(index, 2).toInt(&ok, 16);
-        if (!ok)
+        quint8 count = record[0];
+        if (count + 5 != byteCount)
+        {
+            _errorLine = lineCount;
+            return false;
+        }
+        if (sum != 0)
         {
+            qDebug() << "HexParser::read : checksum error at line" << lineCount;
+            _errorLine = lineCount;
             return false;
         }
-        index += 2;
 
-        if (type == 0)
+        quint16 address = static_cast<quint16>((record[1] << 8) | record[2]);
+        const quint8 *payload = record + 4;
+        switch (record[3])
         {
-            if (offsetAddr + addr < 0x1E8480)
-            {
-                if (offsetAddr + addr + dataCount > _prog.size())
+            case RECORD_DATA:
+                appendData(baseAddress + address, payload, count);
+                break;
+
+            case RECORD_END_OF_FILE:
+                endOfFile = true;
+                break;
+
+            case RECORD_EXTENDED_SEGMENT_ADDRESS:
+            case RECORD_EXTENDED_LINEAR_ADDRESS:
+                if (count != 2)
                 {
-                    _prog.append(QByteArray((offsetAddr + addr + dataCount) - _prog.size(), static_cast<char>(0xFF)));
-                    // qDebug() << "outData" << QString::number(offsetAddr + addr, 16) << line.midRef(index, 2 * dataCount);
+                    _errorLine = lineCount;
+                    return false;
                 }
-                for (int i = 0; i < dataCount; i++)
+                baseAddress = static_cast<quint32>((payload[0] << 8) | payload[1]);
+                baseAddress <<= (record[3] == RECORD_EXTENDED_SEGMENT_ADDRESS) ? 4 : 16;
+                break;
+
+            case RECORD_START_SEGMENT_ADDRESS:
+            case RECORD_START_LINEAR_ADDRESS:
+            {
+                if (count != 4)
                 {
-                    int data = line.mid(index, 2).toInt(&ok, 16);
-                    if (!ok)
-                    {
-                        return false;
-                    }
-                    index += 2;
-                    _prog[addr + i + offsetAddr] = static_cast<char>(data);
+                    _errorLine = lineCount;
+                    return false;
                 }
+                quint32 high = static_cast<quint32>((payload[0] << 8) | payload[1]);
+                quint32 low = static_cast<quint32>((payload[2] << 8) | payload[3]);
+                _startAddress = (record[3] == RECORD_START_SEGMENT_ADDRESS) ? (high << 4) + low : (high << 16) | low;
+                _hasStartAddress = true;
+                break;
             }
+
+            default:
+                break;
         }
-        else if (type == 4)
-        {
-            offsetAddr = line.mid(index, 4).toInt(&ok, 16) * 0x10000;
-            if (!ok)
-            {
-                return false;
-            }
-            index += 4;
-            // qDebug() << "offset" << QString::number(offsetAddr, 16);
-        }
-        else if (type == 1)
+
+        pos = next;
+    }
+
+    buildProg();
+    return true;
+}
+
+void HexParser::appendData(quint32 address, const quint8 *data, int count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    if (!_ranges.isEmpty())
+    {
+        Range &last = _ranges.last();
+        if (last.start + static_cast<quint32>(last.data.size()) == address)
         {
-            break;
+            last.data.append(reinterpret_cast<const char *>(data), count);
+            return;
         }
-        else
+    }
+
+    Range range;
+    range.start = address;
+    range.data = QByteArray(reinterpret_cast<const char *>(data), count);
+    _ranges.append(range);
+}
+
+/**
+ * @brief Flattens ranges below HEX_PROG_MAX in a single preallocated image
+ */
+void HexParser::buildProg()
+{
+    quint32 size = 0x100;
+    for (const Range &range : qAsConst(_ranges))
+    {
+        if (range.start < HEX_PROG_MAX)
         {
-            // qDebug() << "unknow type" << type << "at line" << lineCount;
+            size = qMax(size, qMin(range.start + static_cast<quint32>(range.data.size()), static_cast<quint32>(HEX_PROG_MAX)));
         }
+    }
 
-        checkSum = line.mid(index, 2).toInt(&ok, 16);
-        if (!ok)
+    _prog = QByteArray(static_cast<int>(size), static_cast<char>(0xFF));
+    char *prog = _prog.data();
+    for (const Range &range : qAsConst(_ranges))
+    {
+        if (range.start < HEX_PROG_MAX)
         {
-            return false;
+            quint32 count = qMin(static_cast<quint32>(range.data.size()), size - range.start);
+            memcpy(prog + range.start, range.data.constData(), count);
         }
-        index += 2;
-
-        lineCount++;
     }
 
     _checksum = 0;
-    for (auto &&i : _prog)
+    const uchar *bytes = reinterpret_cast<const uchar *>(prog);
+    for (quint32 i = 0; i < size; i++)
     {
-        _checksum += static_cast<unsigned char>(i);
+        _checksum += bytes[i];
     }
-
-    return true;
-}
-
-const QByteArray &HexParser::prog() const
-{
-    return _prog;
-}
-
-const unsigned short &HexParser::checksum() const
-{
-    return _checksum;
 }
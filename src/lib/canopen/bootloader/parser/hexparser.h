@@ -23,21 +23,52 @@
 
 #include <QByteArray>
 #include <QString>
+#include <QVector>
 
+/**
+ * @brief Intel HEX file decoder
+ *
+ * The file is memory mapped and decoded with a lookup table, record checksums
+ * are verified. Data records are gathered in contiguous address ranges, prog()
+ * is the flat image of the ranges below 2 MB, unwritten bytes set to 0xFF.
+ * Record types 0 to 5 are supported.
+ */
 class CANOPEN_EXPORT HexParser
 {
 public:
     HexParser(const QString &fileName = QString());
 
     bool read();
+    bool parse(const QByteArray &hex);
     const QByteArray &prog() const;
 
     const unsigned short &checksum() const;
 
+    struct Range
+    {
+        quint32 start;
+        QByteArray data;
+    };
+    const QVector<Range> &ranges() const;
+
+    bool hasStartAddress() const;
+    quint32 startAddress() const;
+
+    int errorLine() const;
+
 private:
     QByteArray _prog;
     QString _fileName;
     unsigned short _checksum;
+
+    QVector<Range> _ranges;
+    bool _hasStartAddress;
+    quint32 _startAddress;
+    int _errorLine;
+
+    bool parse(const char *data, qint64 size);
+    void appendData(quint32 address, const quint8 *data, int count);
+    void buildProg();
 };
 
 #endif  // HEXPARSER_H
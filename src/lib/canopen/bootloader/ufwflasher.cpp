@@ -0,0 +1,412 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "ufwflasher.h"
+
+#include "canopenbus.h"
+#include "model/ufwmodel.h"
+#include "node.h"
+#include "parser/ufwparser.h"
+
+#define UFW_FLASHER_WATCHDOG_MS 1000
+
+UfwFlasher::UfwFlasher()
+{
+    _maxConcurrent = 8;
+    _busLoadLimit = 0.6;
+    _deltaMode = false;
+    _nodeTimeoutMs = 60000;
+    _running = false;
+
+    connect(&_watchdogTimer, &QTimer::timeout, this, &UfwFlasher::checkNodeTimeouts);
+}
+
+UfwFlasher::~UfwFlasher()
+{
+    abort();
+}
+
+bool UfwFlasher::openUfw(const QString &fileName)
+{
+    QSharedPointer<UfwModel> ufwModel(UfwParser::parse(fileName));
+    if (ufwModel.isNull())
+    {
+        return false;
+    }
+    setUfw(ufwModel);
+    return true;
+}
+
+void UfwFlasher::setUfw(const QSharedPointer<UfwModel> &ufwModel)
+{
+    _ufwModel = ufwModel;
+}
+
+const QSharedPointer<UfwModel> &UfwFlasher::ufwModel() const
+{
+    return _ufwModel;
+}
+
+void UfwFlasher::addNode(Node *node)
+{
+    if (node == nullptr || _nodes.contains(node))
+    {
+        return;
+    }
+
+    _nodes.append(node);
+
+    NodeProgress progress;
+    progress.status = Bootloader::STATUS_FILE_ANALYZED_OK;
+    progress.bytesWritten = 0;
+    progress.bytesTotal = 0;
+    progress.elapsedMs = 0;
+    progress.throughput = 0.0;
+    progress.finished = false;
+    progress.ok = false;
+    _progress.insert(node, progress);
+}
+
+/**
+ * @brief Adds all nodes of a bus with a product code (0x1018.2) matching the firmware device type
+ * @return number of nodes added
+ */
+int UfwFlasher::addMatchingNodes(CanOpenBus *bus)
+{
+    if (bus == nullptr || _ufwModel.isNull())
+    {
+        return 0;
+    }
+
+    int count = 0;
+    for (Node *node : bus->nodes())
+    {
+        if (node->productCode() == _ufwModel->deviceType() && !_nodes.contains(node))
+        {
+            addNode(node);
+            count++;
+        }
+    }
+    return count;
+}
+
+const QList<Node *> &UfwFlasher::nodes() const
+{
+    return _nodes;
+}
+
+int UfwFlasher::maxConcurrent() const
+{
+    return _maxConcurrent;
+}
+
+void UfwFlasher::setMaxConcurrent(int maxConcurrent)
+{
+    _maxConcurrent = qMax(1, maxConcurrent);
+}
+
+double UfwFlasher::busLoadLimit() const
+{
+    return _busLoadLimit;
+}
+
+/**
+ * @brief Sets the max bus load used by SDO transfers of the update, in ]0, 1]
+ */
+void UfwFlasher::setBusLoadLimit(double busLoadLimit)
+{
+    _busLoadLimit = qBound(0.05, busLoadLimit, 1.0);
+}
+
+bool UfwFlasher::isDeltaMode() const
+{
+    return _deltaMode;
+}
+
+/**
+ * @brief Writes only the pages that differ from the firmware of each node, see Bootloader::setDeltaMode()
+ */
+void UfwFlasher::setDeltaMode(bool deltaMode)
+{
+    _deltaMode = deltaMode;
+}
+
+const QString &UfwFlasher::imageCacheDir() const
+{
+    return _imageCacheDir;
+}
+
+/**
+ * @brief Sets the directory of images flashed by node serial number, used as delta reference
+ */
+void UfwFlasher::setImageCacheDir(const QString &imageCacheDir)
+{
+    _imageCacheDir = imageCacheDir;
+}
+
+int UfwFlasher::nodeTimeoutMs() const
+{
+    return _nodeTimeoutMs;
+}
+
+/**
+ * @brief Sets the max duration without status or progress of a node before its update fails
+ */
+void UfwFlasher::setNodeTimeoutMs(int nodeTimeoutMs)
+{
+    _nodeTimeoutMs = qMax(UFW_FLASHER_WATCHDOG_MS, nodeTimeoutMs);
+}
+
+/**
+ * @brief Starts the update of all added nodes
+ * @return false if no firmware or no node, or if already running
+ */
+bool UfwFlasher::start()
+{
+    if (_running || _ufwModel.isNull() || _nodes.isEmpty())
+    {
+        return false;
+    }
+
+    _pending.clear();
+    for (Node *node : qAsConst(_nodes))
+    {
+        NodeProgress &progress = _progress[node];
+        progress.finished = false;
+        progress.ok = false;
+        progress.bytesWritten = 0;
+        progress.elapsedMs = 0;
+        progress.throughput = 0.0;
+        _pending.enqueue(node);
+
+        // SDO block transfers hold back their segments above the bus SDO load limit
+        CanOpenBus *bus = node->bus();
+        if (bus != nullptr && !_savedBusLoadLimits.contains(bus))
+        {
+            _savedBusLoadLimits.insert(bus, bus->sdoBusLoadLimit());
+            bus->setSdoBusLoadLimit(_busLoadLimit);
+        }
+    }
+
+    _running = true;
+    _elapsed.start();
+    _watchdogTimer.start(UFW_FLASHER_WATCHDOG_MS);
+    schedule();
+    return true;
+}
+
+/**
+ * @brief Stops scheduling updates, nodes not started are left untouched
+ *
+ * Updates already started are not interrupted on the devices, their results
+ * are no longer followed.
+ */
+void UfwFlasher::abort()
+{
+    if (!_running)
+    {
+        return;
+    }
+
+    _pending.clear();
+    for (Node *node : qAsConst(_active))
+    {
+        disconnect(node->bootloader(), nullptr, this, nullptr);
+        NodeProgress &progress = _progress[node];
+        progress.finished = true;
+        progress.ok = false;
+    }
+    _active.clear();
+    _watchdogTimer.stop();
+    restoreSettings();
+    _running = false;
+    emit finished(false);
+}
+
+bool UfwFlasher::isRunning() const
+{
+    return _running;
+}
+
+UfwFlasher::NodeProgress UfwFlasher::progress(Node *node) const
+{
+    return _progress.value(node);
+}
+
+int UfwFlasher::successCount() const
+{
+    int count = 0;
+    for (const NodeProgress &progress : _progress)
+    {
+        if (progress.finished && progress.ok)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+int UfwFlasher::failureCount() const
+{
+    int count = 0;
+    for (const NodeProgress &progress : _progress)
+    {
+        if (progress.finished && !progress.ok)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Time since start() in ms
+ */
+qint64 UfwFlasher::elapsedMs() const
+{
+    return _elapsed.isValid() ? _elapsed.elapsed() : 0;
+}
+
+/**
+ * @brief Starts pending nodes while slots are free, ends the update when all nodes are done
+ */
+void UfwFlasher::schedule()
+{
+    if (!_running)
+    {
+        return;
+    }
+
+    while (_active.count() < _maxConcurrent && !_pending.isEmpty())
+    {
+        startNode(_pending.dequeue());
+    }
+
+    if (_active.isEmpty() && _pending.isEmpty())
+    {
+        _watchdogTimer.stop();
+        restoreSettings();
+        _running = false;
+        emit finished(failureCount() == 0);
+    }
+}
+
+void UfwFlasher::startNode(Node *node)
+{
+    Bootloader *bootloader = node->bootloader();
+    _active.append(node);
+    _nodeElapsed[node].start();
+    _nodeActivity[node].start();
+
+    bootloader->setUfw(_ufwModel);
+    bootloader->setDeltaMode(_deltaMode);
+    bootloader->setImageCacheDir(_imageCacheDir);
+    connect(bootloader,
+            &Bootloader::statusEvent,
+            this,
+            [=]()
+            {
+                updateNodeStatus(node);
+            });
+    connect(bootloader,
+            &Bootloader::updateProgress,
+            this,
+            [=](qint64 bytesWritten, qint64 bytesTotal)
+            {
+                updateNodeProgress(node, bytesWritten, bytesTotal);
+            });
+    bootloader->startUpdate();
+}
+
+void UfwFlasher::updateNodeStatus(Node *node)
+{
+    Bootloader::Status status = node->bootloader()->status();
+    NodeProgress &progress = _progress[node];
+    progress.status = status;
+    progress.elapsedMs = _nodeElapsed[node].elapsed();
+    _nodeActivity[node].restart();
+    emit nodeProgress(node);
+
+    if (status == Bootloader::STATUS_UPDATE_SUCCESSFUL)
+    {
+        finishNode(node, true);
+    }
+    else if (status < 0)
+    {
+        finishNode(node, false);
+    }
+}
+
+void UfwFlasher::updateNodeProgress(Node *node, qint64 bytesWritten, qint64 bytesTotal)
+{
+    NodeProgress &progress = _progress[node];
+    progress.bytesWritten = bytesWritten;
+    progress.bytesTotal = bytesTotal;
+    progress.elapsedMs = _nodeElapsed[node].elapsed();
+    _nodeActivity[node].restart();
+    if (progress.elapsedMs > 0)
+    {
+        progress.throughput = static_cast<double>(bytesWritten) * 1000.0 / static_cast<double>(progress.elapsedMs);
+    }
+    emit nodeProgress(node);
+}
+
+void UfwFlasher::finishNode(Node *node, bool ok)
+{
+    if (!_active.removeOne(node))
+    {
+        return;
+    }
+
+    disconnect(node->bootloader(), nullptr, this, nullptr);
+
+    NodeProgress &progress = _progress[node];
+    progress.finished = true;
+    progress.ok = ok;
+    progress.elapsedMs = _nodeElapsed[node].elapsed();
+    emit nodeFinished(node, ok);
+
+    // status signals of the bootloader may come from startNode(), next nodes are started from the event loop
+    QMetaObject::invokeMethod(this, &UfwFlasher::schedule, Qt::QueuedConnection);
+}
+
+/**
+ * @brief Fails the nodes stalled for nodeTimeoutMs(), their bootloader is released
+ */
+void UfwFlasher::checkNodeTimeouts()
+{
+    const QList<Node *> active = _active;
+    for (Node *node : active)
+    {
+        if (_nodeActivity[node].elapsed() < _nodeTimeoutMs)
+        {
+            continue;
+        }
+        node->bootloader()->abortUpdate();
+        finishNode(node, false);
+    }
+}
+
+void UfwFlasher::restoreSettings()
+{
+    for (auto it = _savedBusLoadLimits.cbegin(); it != _savedBusLoadLimits.cend(); ++it)
+    {
+        it.key()->setSdoBusLoadLimit(it.value());
+    }
+    _savedBusLoadLimits.clear();
+}
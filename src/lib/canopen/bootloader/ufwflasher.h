@@ -0,0 +1,131 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef UFWFLASHER_H
+#define UFWFLASHER_H
+
+#include "canopen_global.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QQueue>
+#include <QSharedPointer>
+#include <QTimer>
+
+#include "bootloader.h"
+
+class CanOpenBus;
+class Node;
+class UfwModel;
+
+/**
+ * @brief Updates several nodes with the same firmware concurrently
+ *
+ * The firmware is parsed once and shared by the bootloaders of all nodes. Up
+ * to maxConcurrent() nodes are updated at the same time, the others wait in a
+ * queue. SDO block downloads of the nodes of a bus run interleaved, the SDO
+ * load limit of the bus is set to busLoadLimit() so that their sum stays
+ * under it. Progress and throughput are reported per node. A node without
+ * status or progress for nodeTimeoutMs() fails and frees its slot.
+ */
+class CANOPEN_EXPORT UfwFlasher : public QObject
+{
+    Q_OBJECT
+public:
+    UfwFlasher();
+    ~UfwFlasher() override;
+
+    bool openUfw(const QString &fileName);
+    void setUfw(const QSharedPointer<UfwModel> &ufwModel);
+    const QSharedPointer<UfwModel> &ufwModel() const;
+
+    void addNode(Node *node);
+    int addMatchingNodes(CanOpenBus *bus);
+    const QList<Node *> &nodes() const;
+
+    int maxConcurrent() const;
+    void setMaxConcurrent(int maxConcurrent);
+    double busLoadLimit() const;
+    void setBusLoadLimit(double busLoadLimit);
+    bool isDeltaMode() const;
+    void setDeltaMode(bool deltaMode);
+    const QString &imageCacheDir() const;
+    void setImageCacheDir(const QString &imageCacheDir);
+    int nodeTimeoutMs() const;
+    void setNodeTimeoutMs(int nodeTimeoutMs);
+
+    bool start();
+    void abort();
+    bool isRunning() const;
+
+    struct NodeProgress
+    {
+        Bootloader::Status status;
+        qint64 bytesWritten;
+        qint64 bytesTotal;
+        qint64 elapsedMs;   // since the update of the node started
+        double throughput;  // firmware bytes per second
+        bool finished;
+        bool ok;
+    };
+    NodeProgress progress(Node *node) const;
+    int successCount() const;
+    int failureCount() const;
+    qint64 elapsedMs() const;
+
+signals:
+    void nodeProgress(Node *node);
+    void nodeFinished(Node *node, bool ok);
+    void finished(bool ok);
+
+protected slots:
+    void schedule();
+    void checkNodeTimeouts();
+
+private:
+    QSharedPointer<UfwModel> _ufwModel;
+    QList<Node *> _nodes;
+    QHash<Node *, NodeProgress> _progress;
+    QHash<Node *, QElapsedTimer> _nodeElapsed;
+    QHash<Node *, QElapsedTimer> _nodeActivity;  // since the last status or progress of the node
+
+    int _maxConcurrent;
+    double _busLoadLimit;
+    bool _deltaMode;
+    QString _imageCacheDir;
+    int _nodeTimeoutMs;
+
+    bool _running;
+    QQueue<Node *> _pending;
+    QList<Node *> _active;
+    QElapsedTimer _elapsed;
+    QTimer _watchdogTimer;
+
+    // settings changed while flashing, restored at the end
+    QHash<CanOpenBus *, double> _savedBusLoadLimits;
+
+    void startNode(Node *node);
+    void updateNodeStatus(Node *node);
+    void updateNodeProgress(Node *node, qint64 bytesWritten, qint64 bytesTotal);
+    void finishNode(Node *node, bool ok);
+    void restoreSettings();
+};
+
+#endif  // UFWFLASHER_H
@@ -21,6 +21,7 @@
 #include <QDebug>
 #include <QFile>
 #include <QtEndian>
+#include <cstring>
 #include <utility>
 
 #include "bootloader/parser/hexparser.h"
@@ -31,12 +32,14 @@ HexMerger::HexMerger()
 
 int HexMerger::merge(QString &fileA, QStringList &segmentA, QString &fileB, QStringList &segmentB)
 {
-    HexParser *hexAFile = new HexParser(fileA);
-    hexAFile->read();
-    HexParser *hexBFile = new HexParser(fileB);
-    hexBFile->read();
+    HexParser hexAFile(fileA);
+    HexParser hexBFile(fileB);
+    if (!hexAFile.read() || !hexBFile.read())
+    {
+        return -1;
+    }
 
-    int ret = merge(hexAFile->prog(), segmentA, hexBFile->prog(), segmentB);
+    int ret = merge(hexAFile.prog(), segmentA, hexBFile.prog(), segmentB);
     if (ret < 0)
     {
         return -1;
@@ -79,22 +82,27 @@ int HexMerger::append(const QByteArray &a, const QStringList &addresses)
         return error;
     }
 
-    QByteArray app = a;
-
     for (i = 0; i < addresses.size(); i++)
     {
         int adrStart = addresses.at(i).split(QLatin1Char(':')).at(0).toInt(&ok, 16);
         int adrEnd = addresses.at(i).split(QLatin1Char(':')).at(1).toInt(&ok, 16);
+        if (adrStart < 0 || adrEnd < adrStart)
+        {
+            return -1;
+        }
         if (adrEnd > _prog.size())
         {
             _prog.append(QByteArray(adrEnd - _prog.size(), static_cast<char>(0xFF)));
         }
-        if (adrEnd > app.size())
+
+        // copied in place from the source image, bytes beyond its end are 0xFF
+        char *dest = _prog.data() + adrStart;
+        int count = qBound(0, a.size() - adrStart, adrEnd - adrStart);
+        if (count > 0)
         {
-            app.append(QByteArray(adrEnd - app.size(), static_cast<char>(0xFF)));
+            memcpy(dest, a.constData() + adrStart, static_cast<size_t>(count));
         }
-
-        _prog.replace(adrStart, adrEnd - adrStart, app.mid(adrStart, adrEnd - adrStart));
+        memset(dest + count, 0xFF, static_cast<size_t>(adrEnd - adrStart - count));
     }
     return 0;
 }
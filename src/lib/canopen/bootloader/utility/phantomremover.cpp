@@ -18,19 +18,15 @@
 
 #include "phantomremover.h"
 
+#include "ufwpacker.h"
+
 PhantomRemover::PhantomRemover()
 {
 }
 
 const QByteArray &PhantomRemover::remove(const QByteArray &prog)
 {
-    int index = 0;
-    while (index < prog.size())
-    {
-        _prog.append(prog.mid(index, 3));
-        index += 4;
-    }
-
+    _prog.append(UfwPacker::removePhantoms(prog));
     return _prog;
 }
 
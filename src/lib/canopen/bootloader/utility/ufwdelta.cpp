@@ -0,0 +1,295 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "ufwdelta.h"
+
+#include "ufwupdate.h"
+
+#include "../writer/ufwwriter.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QtEndian>
+
+#include <array>
+#include <cstring>
+
+/**
+ * @brief CRC-32 (IEEE 802.3, reflected polynomial 0xEDB88320) of a buffer
+ */
+static quint32 pageCrc(const char *data, int size)
+{
+    static const std::array<quint32, 256> table = []()
+    {
+        std::array<quint32, 256> crcTable;
+        for (quint32 i = 0; i < 256; i++)
+        {
+            quint32 value = i;
+            for (int bit = 0; bit < 8; bit++)
+            {
+                value = (value & 1) ? ((value >> 1) ^ 0xEDB88320U) : (value >> 1);
+            }
+            crcTable[i] = value;
+        }
+        return crcTable;
+    }();
+
+    quint32 crc = 0xFFFFFFFFU;
+    for (int i = 0; i < size; i++)
+    {
+        crc = (crc >> 8) ^ table[(crc ^ static_cast<quint8>(data[i])) & 0xFF];
+    }
+    return ~crc;
+}
+
+UfwDelta::UfwDelta(const UfwModel *ufwModel, int pageSize)
+    : _ufwModel(ufwModel)
+{
+    // pages are kept aligned on the 4 bytes words of the phantom remover
+    _pageSize = (pageSize >= 4) ? (pageSize & ~3) : DefaultPageSize;
+    _changedPageCount = 0;
+    _erasedPageCount = 0;
+    _pageChecksums = pageChecksums(_ufwModel, _pageSize);
+}
+
+int UfwDelta::pageSize() const
+{
+    return _pageSize;
+}
+
+const QVector<quint32> &UfwDelta::pageChecksums() const
+{
+    return _pageChecksums;
+}
+
+int UfwDelta::pageCount() const
+{
+    return _pageChecksums.size();
+}
+
+/**
+ * @brief Compares the image to the page checksum table of a device
+ * @param referenceChecksums CRC-32 of each page, pages missing from the table are considered changed
+ * @return true if at least one page changed
+ *
+ * Pages of the table past the end of the image are compared to erased pages.
+ */
+bool UfwDelta::compare(const QVector<quint32> &referenceChecksums)
+{
+    _changedSegments.clear();
+    _changedPageCount = 0;
+    _erasedPageCount = 0;
+
+    QByteArray erasedPage(_pageSize, static_cast<char>(0xFF));
+    quint32 erasedChecksum = pageCrc(erasedPage.constData(), erasedPage.size());
+
+    int count = qMax(_pageChecksums.size(), referenceChecksums.size());
+    for (int page = 0; page < count; page++)
+    {
+        quint32 checksum = (page < _pageChecksums.size()) ? _pageChecksums.at(page) : erasedChecksum;
+        if (page >= referenceChecksums.size() || referenceChecksums.at(page) != checksum)
+        {
+            appendChangedPage(page);
+        }
+    }
+    return _changedPageCount > 0;
+}
+
+/**
+ * @brief Compares the image to the image previously flashed in the device
+ * @return true if at least one page changed
+ */
+bool UfwDelta::compare(const UfwModel *reference)
+{
+    if (reference == nullptr)
+    {
+        return compare(QVector<quint32>());
+    }
+    return compare(pageChecksums(reference, _pageSize));
+}
+
+/**
+ * @brief Parts of the segments located in changed pages, in the format of UfwModel::segmentList()
+ */
+const QList<UfwModel::Segment> &UfwDelta::changedSegments() const
+{
+    return _changedSegments;
+}
+
+int UfwDelta::changedPageCount() const
+{
+    return _changedPageCount;
+}
+
+/**
+ * @brief Number of changed pages without segment in the image, a full update is needed when not 0
+ */
+int UfwDelta::erasedPageCount() const
+{
+    return _erasedPageCount;
+}
+
+/**
+ * @brief Bytes sent to the device to write the changed segments
+ */
+qint64 UfwDelta::transferSize() const
+{
+    return UfwUpdate::transferSize(_ufwModel, _changedSegments);
+}
+
+/**
+ * @brief Bytes sent to the device by a full update
+ */
+qint64 UfwDelta::fullTransferSize() const
+{
+    if (_ufwModel == nullptr)
+    {
+        return 0;
+    }
+    return UfwUpdate::transferSize(_ufwModel, _ufwModel->segmentList());
+}
+
+/**
+ * @brief CRC-32 of each page of an image as written by a full update
+ */
+QVector<quint32> UfwDelta::pageChecksums(const UfwModel *ufwModel, int pageSize)
+{
+    QVector<quint32> checksums;
+    if (ufwModel == nullptr || pageSize <= 0)
+    {
+        return checksums;
+    }
+
+    const QByteArray &prog = ufwModel->prog();
+    quint32 end = 0;
+    for (const UfwModel::Segment &segment : ufwModel->segmentList())
+    {
+        end = qMax(end, segment.end);
+    }
+    int count = static_cast<int>((static_cast<quint64>(end) + static_cast<quint64>(pageSize) - 1) / static_cast<quint64>(pageSize));
+    checksums.reserve(count);
+
+    QByteArray page(pageSize, static_cast<char>(0xFF));
+    for (int i = 0; i < count; i++)
+    {
+        quint32 pageStart = static_cast<quint32>(i) * static_cast<quint32>(pageSize);
+        quint32 pageEnd = pageStart + static_cast<quint32>(pageSize);
+        page.fill(static_cast<char>(0xFF));
+
+        for (const UfwModel::Segment &segment : ufwModel->segmentList())
+        {
+            quint32 start = qMax(segment.start, pageStart);
+            quint32 stop = qMin(qMin(segment.end, pageEnd), static_cast<quint32>(prog.size()));
+            if (start < stop)
+            {
+                memcpy(page.data() + (start - pageStart), prog.constData() + start, stop - start);
+            }
+        }
+        checksums.append(pageCrc(page.constData(), page.size()));
+    }
+    return checksums;
+}
+
+/**
+ * @brief Decodes the page checksum table read from a device, little endian 32 bits CRC per page
+ */
+QVector<quint32> UfwDelta::parseChecksumTable(const QByteArray &table)
+{
+    QVector<quint32> checksums;
+    checksums.reserve(table.size() / 4);
+    for (int i = 0; i + 4 <= table.size(); i += 4)
+    {
+        checksums.append(qFromLittleEndian<quint32>(table.constData() + i));
+    }
+    return checksums;
+}
+
+QString UfwDelta::cacheFileName(const QString &cacheDir, quint32 serialNumber)
+{
+    return QDir(cacheDir).filePath(QStringLiteral("%1.ufw").arg(serialNumber, 8, 16, QLatin1Char('0')));
+}
+
+/**
+ * @brief Writes an image in ufw format, used to keep the image flashed in a device
+ * @return false if the file cannot be written
+ */
+bool UfwDelta::saveImage(const UfwModel *ufwModel, const QString &fileName)
+{
+    if (ufwModel == nullptr)
+    {
+        return false;
+    }
+
+    QStringList segments;
+    for (const UfwModel::Segment &segment : ufwModel->segmentList())
+    {
+        segments.append(QStringLiteral("%1:%2").arg(segment.start, 0, 16).arg(segment.end, 0, 16));
+    }
+
+    UfwWriter writer;
+    writer.create(ufwModel->deviceType(), ufwModel->softwareVersion(), ufwModel->buildDate(), segments, ufwModel->prog());
+
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+    QFile file(fileName);
+    if (!file.open(QFile::WriteOnly))
+    {
+        return false;
+    }
+    bool ok = (file.write(writer.binary()) == writer.binary().size());
+    file.close();
+    return ok;
+}
+
+void UfwDelta::appendChangedPage(int page)
+{
+    quint32 pageStart = static_cast<quint32>(page) * static_cast<quint32>(_pageSize);
+    quint32 pageEnd = pageStart + static_cast<quint32>(_pageSize);
+
+    bool inSegment = false;
+    for (const UfwModel::Segment &segment : _ufwModel->segmentList())
+    {
+        quint32 start = qMax(segment.start, pageStart);
+        quint32 end = qMin(segment.end, pageEnd);
+        if (start >= end)
+        {
+            continue;
+        }
+        inSegment = true;
+
+        // contiguous changed pages are sent as a single segment
+        if (!_changedSegments.isEmpty() && _changedSegments.last().end == start)
+        {
+            _changedSegments.last().end = end;
+        }
+        else
+        {
+            UfwModel::Segment changed;
+            changed.start = start;
+            changed.end = end;
+            _changedSegments.append(changed);
+        }
+    }
+
+    if (!inSegment)
+    {
+        // data of the reference to erase, nothing to write
+        _erasedPageCount++;
+    }
+    _changedPageCount++;
+}
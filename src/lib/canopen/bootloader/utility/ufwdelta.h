@@ -0,0 +1,83 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef UFWDELTA_H
+#define UFWDELTA_H
+
+#include "canopen_global.h"
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QVector>
+
+#include "../model/ufwmodel.h"
+
+/**
+ * @brief Pages of a firmware that differ from the firmware already in a device
+ *
+ * The image is split in pages of pageSize() bytes of the ufw address space,
+ * each page is summarized by the CRC-32 of its content as flashed by a full
+ * update: bytes of the segments, 0xFF elsewhere. Pages are compared to a
+ * checksum table reported by the device or to a previously flashed image, the
+ * parts of the segments in changed pages are the only ones to transmit. A
+ * changed page without segment cannot be erased by a delta update, a full
+ * update is needed in this case.
+ */
+class CANOPEN_EXPORT UfwDelta
+{
+public:
+    UfwDelta(const UfwModel *ufwModel, int pageSize = DefaultPageSize);
+
+    enum
+    {
+        DefaultPageSize = 2048
+    };
+    int pageSize() const;
+
+    const QVector<quint32> &pageChecksums() const;
+    int pageCount() const;
+
+    bool compare(const QVector<quint32> &referenceChecksums);
+    bool compare(const UfwModel *reference);
+
+    const QList<UfwModel::Segment> &changedSegments() const;
+    int changedPageCount() const;
+    int erasedPageCount() const;
+    qint64 transferSize() const;
+    qint64 fullTransferSize() const;
+
+    static QVector<quint32> pageChecksums(const UfwModel *ufwModel, int pageSize);
+    static QVector<quint32> parseChecksumTable(const QByteArray &table);
+
+    // images cache, keyed by node serial number
+    static QString cacheFileName(const QString &cacheDir, quint32 serialNumber);
+    static bool saveImage(const UfwModel *ufwModel, const QString &fileName);
+
+private:
+    const UfwModel *_ufwModel;
+    int _pageSize;
+    QVector<quint32> _pageChecksums;
+    QList<UfwModel::Segment> _changedSegments;
+    int _changedPageCount;
+    int _erasedPageCount;  // changed pages without segment, erased in the new image
+
+    void appendChangedPage(int page);
+};
+
+#endif  // UFWDELTA_H
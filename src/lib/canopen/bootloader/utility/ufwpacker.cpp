@@ -0,0 +1,237 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "ufwpacker.h"
+
+#include <QtEndian>
+
+#include <cstring>
+
+#if defined(__AVX2__)
+#    define UFW_PACKER_AVX2
+#    include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define UFW_PACKER_SSE2
+#    include <emmintrin.h>
+#endif
+
+// erased bytes are sent by runs shorter than 8 bytes
+#define UFW_PACKER_ERASED_RUN 8
+
+namespace
+{
+struct PackState
+{
+    char *out;
+    int erased;  // erased bytes pending, modulo UFW_PACKER_ERASED_RUN
+    uint32_t sum;
+};
+
+inline void flushErased(PackState &state)
+{
+    if (state.erased > 0)
+    {
+        memset(state.out, 0xFF, static_cast<size_t>(state.erased));
+        state.out += state.erased;
+        state.erased = 0;
+    }
+}
+
+inline void packByte(PackState &state, uint8_t byte)
+{
+    if (byte == 0xFF)
+    {
+        state.erased = (state.erased + 1) % UFW_PACKER_ERASED_RUN;
+        return;
+    }
+    flushErased(state);
+    *state.out++ = static_cast<char>(byte);
+}
+
+/**
+ * @brief Packs whole words without erased bytes, sum already accumulated
+ */
+inline void packWords(PackState &state, const char *in, int wordCount)
+{
+    flushErased(state);
+    for (int word = 0; word < wordCount; word++)
+    {
+        memcpy(state.out, in + word * 4, 3);
+        state.out += 3;
+    }
+}
+
+/**
+ * @brief Packs words one byte at a time
+ * @param withSum true to accumulate the sum, false if already accumulated by the vector path
+ */
+inline void packBytes(PackState &state, const char *in, int size, bool withSum)
+{
+    for (int i = 0; i < size; i++)
+    {
+        if ((i & 3) != 3)
+        {
+            uint8_t byte = static_cast<uint8_t>(in[i]);
+            if (withSum)
+            {
+                state.sum += byte;
+            }
+            packByte(state, byte);
+        }
+    }
+}
+
+/**
+ * @brief Packs the blocks of words of a segment, returns the number of bytes consumed
+ */
+int packBlocks(PackState &state, const char *in, int size)
+{
+    int pos = 0;
+#if defined(UFW_PACKER_AVX2)
+    const __m256i keep = _mm256_set1_epi32(0x00FFFFFF);
+    const __m256i erased = _mm256_set1_epi8(static_cast<char>(0xFF));
+    __m256i sum = _mm256_setzero_si256();
+    for (; pos + 32 <= size; pos += 32)
+    {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + pos));
+        sum = _mm256_add_epi64(sum, _mm256_sad_epu8(_mm256_and_si256(block, keep), _mm256_setzero_si256()));
+        uint32_t erasedMask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, erased))) & 0x77777777U;
+        if (erasedMask == 0x77777777U)
+        {
+            state.erased = (state.erased + 24) % UFW_PACKER_ERASED_RUN;
+        }
+        else if (erasedMask == 0)
+        {
+            packWords(state, in + pos, 8);
+        }
+        else
+        {
+            packBytes(state, in + pos, 32, false);
+        }
+    }
+    __m128i sum128 = _mm_add_epi64(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    state.sum += static_cast<uint32_t>(_mm_cvtsi128_si32(sum128)) + static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(sum128, 8)));
+#elif defined(UFW_PACKER_SSE2)
+    const __m128i keep = _mm_set1_epi32(0x00FFFFFF);
+    const __m128i erased = _mm_set1_epi8(static_cast<char>(0xFF));
+    __m128i sum = _mm_setzero_si128();
+    for (; pos + 16 <= size; pos += 16)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + pos));
+        sum = _mm_add_epi64(sum, _mm_sad_epu8(_mm_and_si128(block, keep), _mm_setzero_si128()));
+        int erasedMask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, erased)) & 0x7777;
+        if (erasedMask == 0x7777)
+        {
+            state.erased = (state.erased + 12) % UFW_PACKER_ERASED_RUN;
+        }
+        else if (erasedMask == 0)
+        {
+            packWords(state, in + pos, 4);
+        }
+        else
+        {
+            packBytes(state, in + pos, 16, false);
+        }
+    }
+    state.sum += static_cast<uint32_t>(_mm_cvtsi128_si32(sum)) + static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(sum, 8)));
+#else
+    Q_UNUSED(state)
+    Q_UNUSED(in)
+    Q_UNUSED(size)
+#endif
+    return pos;
+}
+}  // namespace
+
+/**
+ * @brief Data of a segment as written to the program object: address followed by the program without phantom bytes
+ * @param sum checksum accumulator, incremented by the sum of the program bytes without phantom bytes
+ */
+QByteArray UfwPacker::packSegment(const QByteArray &prog, const UfwModel::Segment &segment, uint32_t &sum)
+{
+    uint32_t progSize = static_cast<uint32_t>(prog.size());
+    uint32_t start = qMin(segment.start, progSize);
+    uint32_t end = qBound(start, segment.end, progSize);
+    int size = static_cast<int>(end - start);
+    const char *in = prog.constData() + start;
+
+    // 4 bytes of address, then 3 bytes at most for each started word
+    QByteArray data(4 + (size / 4) * 3 + 3, Qt::Uninitialized);
+    qToLittleEndian(segment.start, data.data());
+
+    PackState state;
+    state.out = data.data() + 4;
+    state.erased = 0;
+    state.sum = 0;
+
+    int pos = packBlocks(state, in, size);
+    packBytes(state, in + pos, size - pos, true);
+    flushErased(state);
+
+    data.resize(static_cast<int>(state.out - data.constData()));
+    sum += state.sum;
+    return data;
+}
+
+/**
+ * @brief Packs all the segments, in the order of the list
+ */
+QList<QByteArray> UfwPacker::packSegments(const QByteArray &prog, const QList<UfwModel::Segment> &segments, uint32_t &sum)
+{
+    QList<QByteArray> dataList;
+    dataList.reserve(segments.size());
+    for (const UfwModel::Segment &segment : segments)
+    {
+        dataList.append(packSegment(prog, segment, sum));
+    }
+    return dataList;
+}
+
+/**
+ * @brief Program without the phantom byte of each 4 bytes word
+ */
+QByteArray UfwPacker::removePhantoms(const QByteArray &prog)
+{
+    int size = prog.size();
+    QByteArray data((size / 4) * 3 + qMin(size % 4, 3), Qt::Uninitialized);
+    const char *in = prog.constData();
+    char *out = data.data();
+
+    int pos = 0;
+    for (; pos + 4 <= size; pos += 4)
+    {
+        memcpy(out, in + pos, 3);
+        out += 3;
+    }
+    memcpy(out, in + pos, static_cast<size_t>(qMin(size - pos, 3)));
+    return data;
+}
+
+/**
+ * @brief Vector instruction set used by the packer, "avx2", "sse2" or "scalar"
+ */
+const char *UfwPacker::instructionSet()
+{
+#if defined(UFW_PACKER_AVX2)
+    return "avx2";
+#elif defined(UFW_PACKER_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,49 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef UFWPACKER_H
+#define UFWPACKER_H
+
+#include "canopen_global.h"
+
+#include <QByteArray>
+#include <QList>
+
+#include "../model/ufwmodel.h"
+
+/**
+ * @brief Prepares the segments of a firmware as written to the program data object
+ *
+ * Each segment is read once: the phantom byte of each 4 bytes word is dropped,
+ * the checksum of the remaining bytes is accumulated and each run of erased
+ * bytes (0xFF) is shortened by a multiple of 8 bytes. Blocks of words are
+ * processed with SSE2 or AVX2 when the compiler targets them, other targets use
+ * the scalar path.
+ */
+class CANOPEN_EXPORT UfwPacker
+{
+public:
+    static QByteArray packSegment(const QByteArray &prog, const UfwModel::Segment &segment, uint32_t &sum);
+    static QList<QByteArray> packSegments(const QByteArray &prog, const QList<UfwModel::Segment> &segments, uint32_t &sum);
+
+    static QByteArray removePhantoms(const QByteArray &prog);
+
+    static const char *instructionSet();
+};
+
+#endif  // UFWPACKER_H
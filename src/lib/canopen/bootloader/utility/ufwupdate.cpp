@@ -18,7 +18,7 @@
 
 #include "ufwupdate.h"
 
-#include "../utility/phantomremover.h"
+#include "ufwpacker.h"
 
 #include "indexdb.h"
 #include "node.h"
@@ -34,6 +34,11 @@ UfwUpdate::UfwUpdate(Node *node, UfwModel *ufwModel)
     , _ufwModel(ufwModel)
 {
     _programDataObjectId = IndexDb::getObjectId(IndexDb::OD_PROGRAM_DATA_1);
+    _segmentsSet = false;
+    _checksum = 0;
+    _indexList = 0;
+    _bytesTotal = 0;
+    _bytesWritten = 0;
     setNodeInterrest(_node);
     registerObjId({0x1F50, 1});
 }
@@ -41,6 +46,26 @@ UfwUpdate::UfwUpdate(Node *node, UfwModel *ufwModel)
 void UfwUpdate::setUfw(UfwModel *ufwModel)
 {
     _ufwModel = ufwModel;
+    clearSegments();
+}
+
+/**
+ * @brief Restricts the next update to a part of the firmware, for delta updates
+ * @param segments segments in the format of UfwModel::segmentList()
+ */
+void UfwUpdate::setSegments(const QList<UfwModel::Segment> &segments)
+{
+    _segments = segments;
+    _segmentsSet = true;
+}
+
+/**
+ * @brief Next update writes all the segments of the firmware
+ */
+void UfwUpdate::clearSegments()
+{
+    _segments.clear();
+    _segmentsSet = false;
 }
 
 void UfwUpdate::update()
@@ -57,26 +82,16 @@ void UfwUpdate::update()
         return;
     }
 
-    char buffer[4];
     uint32_t sum = 0;
     _checksum = 0;
-    for (auto i : _ufwModel->segmentList())
+    _byteArrayList.clear();
+    _bytesTotal = 0;
+    _bytesWritten = 0;
+    const QList<UfwModel::Segment> &segments = _segmentsSet ? _segments : _ufwModel->segmentList();
+    _byteArrayList = UfwPacker::packSegments(_ufwModel->prog(), segments, sum);
+    for (const QByteArray &data : qAsConst(_byteArrayList))
     {
-        uint32_t start = i.start;
-        uint32_t end = i.end;
-
-        QByteArray prog = _ufwModel->prog().mid(static_cast<int>(start), static_cast<int>(end) - static_cast<int>(start));
-
-        PhantomRemover phantomRemover;
-        QByteArray progRemove = phantomRemover.remove(prog);
-
-        sum += sumByte(progRemove);
-        removeByte(progRemove);
-
-        qToLittleEndian(start, buffer);
-        progRemove.prepend(buffer, sizeof(start));
-
-        _byteArrayList.append(progRemove);
+        _bytesTotal += data.size();
     }
 
     _checksum = (~(sum % 256) + 1) & 0xFF;
@@ -85,11 +100,52 @@ void UfwUpdate::update()
     process();
 }
 
+/**
+ * @brief Stops writing the segments, answers of the writes in progress are ignored
+ */
+void UfwUpdate::abort()
+{
+    _indexList = 0;
+    _byteArrayList.clear();
+}
+
 uint8_t UfwUpdate::checksum() const
 {
     return _checksum;
 }
 
+qint64 UfwUpdate::bytesTotal() const
+{
+    return _bytesTotal;
+}
+
+/**
+ * @brief Bytes of the segments acknowledged by the device
+ */
+qint64 UfwUpdate::bytesWritten() const
+{
+    return _bytesWritten;
+}
+
+/**
+ * @brief Bytes sent to the device to write the given segments of a firmware
+ */
+qint64 UfwUpdate::transferSize(const UfwModel *ufwModel, const QList<UfwModel::Segment> &segments)
+{
+    if (ufwModel == nullptr)
+    {
+        return 0;
+    }
+
+    uint32_t sum = 0;
+    qint64 size = 0;
+    for (const UfwModel::Segment &segment : segments)
+    {
+        size += UfwPacker::packSegment(ufwModel->prog(), segment, sum).size();
+    }
+    return size;
+}
+
 void UfwUpdate::process()
 {
     _indexList--;
@@ -105,35 +161,6 @@ void UfwUpdate::process()
     _node->writeObject(_programDataObjectId, _byteArrayList.at(_indexList));
 }
 
-uint32_t UfwUpdate::sumByte(const QByteArray &prog)
-{
-    uint32_t checksum = 0;
-    int i = 0;
-    for (i = 0; i < prog.size(); i++)
-    {
-        checksum += static_cast<uint8_t>(prog[i]);
-    }
-    return checksum;
-}
-
-void UfwUpdate::removeByte(QByteArray &prog)
-{
-    char str[8] = {static_cast<char>(0xFF),
-                   static_cast<char>(0xFF),
-                   static_cast<char>(0xFF),
-                   static_cast<char>(0xFF),
-                   static_cast<char>(0xFF),
-                   static_cast<char>(0xFF),
-                   static_cast<char>(0xFF),
-                   static_cast<char>(0xFF)};
-
-    int j = 0;
-    while ((j = prog.indexOf(str, j)) != -1)
-    {
-        prog.remove(j, 8);
-    }
-}
-
 void UfwUpdate::odNotify(const NodeObjectId &objId, NodeOd::FlagsRequest flags)
 {
     if (_byteArrayList.isEmpty())
@@ -151,6 +178,9 @@ void UfwUpdate::odNotify(const NodeObjectId &objId, NodeOd::FlagsRequest flags)
         }
         else if (flags == NodeOd::FlagsRequest::Write)
         {
+            _bytesWritten += _byteArrayList.at(_indexList).size();
+            emit progress(_bytesWritten, _bytesTotal);
+
             if (_indexList == 0)
             {
                 _indexList = 0;
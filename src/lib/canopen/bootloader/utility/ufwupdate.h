@@ -21,6 +21,7 @@
 
 #include "canopen_global.h"
 
+#include "../model/ufwmodel.h"
 #include "../parser/ufwparser.h"
 #include "nodeodsubscriber.h"
 
@@ -36,27 +37,37 @@ public:
     UfwUpdate(Node *node, UfwModel *ufwModel = nullptr);
 
     void setUfw(UfwModel *ufwModel);
+    void setSegments(const QList<UfwModel::Segment> &segments);
+    void clearSegments();
 
     void update();
+    void abort();
 
     int status();
 
     uint8_t checksum() const;
+    qint64 bytesTotal() const;
+    qint64 bytesWritten() const;
+
+    static qint64 transferSize(const UfwModel *ufwModel, const QList<UfwModel::Segment> &segments);
 
 signals:
     void finished(bool ok);
+    void progress(qint64 bytesWritten, qint64 bytesTotal);
 
 private:
     Node *_node;
     UfwModel *_ufwModel;
+    QList<UfwModel::Segment> _segments;
+    bool _segmentsSet;
     uint8_t _checksum;
     NodeObjectId _programDataObjectId;
 
     int _indexList;
     QList<QByteArray> _byteArrayList;
+    qint64 _bytesTotal;
+    qint64 _bytesWritten;
     void process();
-    uint32_t sumByte(const QByteArray &prog);
-    void removeByte(QByteArray &prog);
 
     // NodeOdSubscriber interface
 protected:
@@ -18,9 +18,11 @@
 
 #include "hexwriter.h"
 
-#include <QDebug>
 #include <QFile>
-#include <QTextStream>
+
+#include <cstring>
+
+#define HEX_RECORD_SIZE 0x10
 
 HexWriter::HexWriter()
 {
@@ -34,79 +36,79 @@ int HexWriter::write(const QByteArray &prog, const QString &filePath, Optimizati
         return -1;
     }
 
-    int offset = 1;
-    int dataCount = 0x10;
-    QTextStream stream(&data);
+    QByteArray hex = encode(prog, optimization);
+    if (data.write(hex) != hex.size())
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Encodes a flat image starting at address 0 in Intel HEX format
+ */
+QByteArray HexWriter::encode(const QByteArray &prog, Optimization optimization)
+{
+    static const char ffRecord[HEX_RECORD_SIZE] = {'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF',
+                                                   '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF'};
+
+    QByteArray out;
+    // ':' + count + address + type + 16 data + checksum + '\n'
+    out.reserve((prog.size() / HEX_RECORD_SIZE + 1) * (1 + 2 * (4 + HEX_RECORD_SIZE + 1) + 1) + 64);
 
-    for (int index = 0; index < prog.size(); index += dataCount)
+    quint32 upperAddress = 0;
+    for (int index = 0; index < prog.size(); index += HEX_RECORD_SIZE)
     {
-        int mod = prog.size() % dataCount;
-        if (mod != 0 && index >= (prog.size() - mod))
+        int count = qMin(HEX_RECORD_SIZE, prog.size() - index);
+        const char *data = prog.constData() + index;
+        if (optimization == ON && memcmp(data, ffRecord, static_cast<size_t>(count)) == 0)
         {
-            QString line(QString(":%1").arg(QString::number(mod, 16).rightJustified(2, '0').toUpper()));
-            // address
-            line.append(QString::number(index & 0xFFFF, 16).rightJustified(4, '0').toUpper());
-            // type
-            line.append("00");
-            // Data
-            line.append(prog.mid(prog.size() - mod, mod).toHex().rightJustified(2 * mod, '0').toUpper());
-            // Checksum
-            line.append(QString::number(checksum(line), 16).rightJustified(2, '0').toUpper());
-            stream << line << "\n";
+            continue;
         }
-        else
+
+        quint32 upper = static_cast<quint32>(index) >> 16;
+        if (upper != upperAddress)
         {
-            // Number octet
-            QString line(QString(":%1").arg(QString::number(dataCount, 16).rightJustified(2, '0').toUpper().toUpper()));
-            // address
-            line.append(QString::number(index & 0xFFFF, 16).rightJustified(4, '0').toUpper().toUpper());
-            // type
-            line.append("00");
-            // Data
-            line.append(prog.mid(index, dataCount).toHex().rightJustified(16, '0').toUpper());
-            // Checksum
-            line.append(QString::number(checksum(line), 16).rightJustified(2, '0').toUpper());
-            if (optimization == ON)
-            {
-                if (!line.contains("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF"))
-                {
-                    stream << line << "\n";
-                }
-            }
-            else
-            {
-                stream << line << "\n";
-            }
-
-            if ((index & 0xFFFF) == 0xFFF0)
-            {
-                QString extended(":02000004");
-                extended.append(QString::number(offset, 16).rightJustified(4, '0').toUpper());
-                // Checksum
-                extended.append(QString::number(checksum(extended), 16).rightJustified(2, '0').toUpper());
-                stream << extended << "\n";
-                offset++;
-            }
+            const char extended[2] = {static_cast<char>(upper >> 8), static_cast<char>(upper)};
+            appendRecord(out, 0x04, 0, extended, 2);
+            upperAddress = upper;
         }
+        appendRecord(out, 0x00, static_cast<quint16>(index & 0xFFFF), data, count);
     }
 
     // End of Hex
-    stream << ":00000001FF"
-           << "\n";
-
-    return 0;
+    out.append(":00000001FF\n");
+    return out;
 }
 
-int HexWriter::checksum(const QString &data)
+void HexWriter::appendRecord(QByteArray &out, quint8 type, quint16 address, const char *data, int count)
 {
-    int i = 0;
-    int checksum = 0;
-    bool ok;
+    static const char digits[] = "0123456789ABCDEF";
+
+    char line[1 + 2 * (4 + 255 + 1) + 1];
+    char *pos = line;
+    quint8 checksum = 0;
+
+    auto appendByte = [&pos, &checksum](quint8 value)
+    {
+        *pos++ = digits[value >> 4];
+        *pos++ = digits[value & 0x0F];
+        checksum += value;
+    };
 
-    for (i = 1; i < data.size(); i = i + 2)
+    *pos++ = ':';
+    appendByte(static_cast<quint8>(count));
+    appendByte(static_cast<quint8>(address >> 8));
+    appendByte(static_cast<quint8>(address));
+    appendByte(type);
+    for (int i = 0; i < count; i++)
     {
-        checksum += data.mid(i, 2).toInt(&ok, 16);
+        appendByte(static_cast<quint8>(data[i]));
     }
+    quint8 sum = static_cast<quint8>(-checksum);
+    appendByte(sum);
+    *pos++ = '\n';
 
-    return (~(checksum % 256) + 1) & 0xFF;
+    out.append(line, static_cast<int>(pos - line));
 }
@@ -22,7 +22,15 @@
 #include "canopen_global.h"
 
 #include <QByteArray>
+#include <QString>
 
+/**
+ * @brief Intel HEX file encoder
+ *
+ * Records of 16 bytes are encoded with a lookup table in a single buffer
+ * written at once, extended linear address records are emitted when the
+ * upper 16 bits of the address change.
+ */
 class CANOPEN_EXPORT HexWriter
 {
 public:
@@ -31,13 +39,14 @@ public:
     enum Optimization
     {
         OFF,
-        ON
+        ON  // records of 0xFF only are skipped
     };
 
     int write(const QByteArray &prog, const QString &filePath, Optimization optimization = OFF);
+    static QByteArray encode(const QByteArray &prog, Optimization optimization = OFF);
 
 private:
-    int checksum(const QString &data);
+    static void appendRecord(QByteArray &out, quint8 type, quint16 address, const char *data, int count);
 };
 
 #endif  // HEXWRITER_H
@@ -24,6 +24,7 @@ CanBusDriver::CanBusDriver(QString adress)
     : _adress(std::move(adress))
 {
     _state = DISCONNECTED;
+    _bitRate = 0;
 }
 
 CanBusDriver::State CanBusDriver::state() const
@@ -31,6 +32,14 @@ CanBusDriver::State CanBusDriver::state() const
     return _state;
 }
 
+/**
+ * @brief Nominal bit rate of the bus in bit/s, reported by the device once connected, 0 if unknown
+ */
+int CanBusDriver::bitRate() const
+{
+    return _bitRate;
+}
+
 bool CanBusDriver::connectDevice()
 {
     return false;
@@ -40,17 +49,33 @@ void CanBusDriver::disconnectDevice()
 {
 }
 
-QCanBusFrame CanBusDriver::readFrame()
+CanFrame CanBusDriver::readFrame()
 {
-    return QCanBusFrame();
+    return CanFrame(CanFrame::InvalidFrame);
 }
 
-bool CanBusDriver::writeFrame(const QCanBusFrame &qtframe)
+bool CanBusDriver::writeFrame(const CanFrame &frame)
 {
-    Q_UNUSED(qtframe);
+    Q_UNUSED(frame);
     return false;
 }
 
+/**
+ * @brief Writes a batch of frames in order, drivers able to submit a batch at once override it
+ * @return number of frames written from the start of the batch
+ */
+int CanBusDriver::writeFrames(const CanFrame *frames, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (!writeFrame(frames[i]))
+        {
+            return i;
+        }
+    }
+    return count;
+}
+
 void CanBusDriver::setState(const State &state)
 {
     bool stateChange = (_state != state);
@@ -61,6 +86,11 @@ void CanBusDriver::setState(const State &state)
     }
 }
 
+void CanBusDriver::setBitRate(int bitRate)
+{
+    _bitRate = bitRate;
+}
+
 const QString &CanBusDriver::adress() const
 {
     return _adress;
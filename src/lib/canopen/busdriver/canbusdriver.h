@@ -23,7 +23,7 @@
 
 #include <QObject>
 
-#include "busdriver/qcanbusframe.h"
+#include "busdriver/canframe.h"
 
 class CANOPEN_EXPORT CanBusDriver : public QObject
 {
@@ -39,12 +39,14 @@ public:
         ERROR
     };
     State state() const;
+    int bitRate() const;
 
     virtual bool connectDevice();
     virtual void disconnectDevice();
 
-    virtual QCanBusFrame readFrame();
-    virtual bool writeFrame(const QCanBusFrame &qtframe);
+    virtual CanFrame readFrame();
+    virtual bool writeFrame(const CanFrame &frame);
+    virtual int writeFrames(const CanFrame *frames, int count);
 
 signals:
     void framesReceived();
@@ -53,9 +55,11 @@ signals:
 protected:
     QString _adress;
     void setState(const State &state);
+    void setBitRate(int bitRate);
 
 private:
     State _state;
+    int _bitRate;
 };
 
 #endif  // CANBUSDRIVER_H
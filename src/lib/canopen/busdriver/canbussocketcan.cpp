@@ -18,20 +18,38 @@
 
 #include "canbussocketcan.h"
 
+#include <QDateTime>
+
+#include <cerrno>
 #include <cstdio>
 #include <fcntl.h>
+#include <poll.h>
 #include <unistd.h>
 
 #include <linux/can.h>
+#include <linux/can/netlink.h>
+#include <linux/if_link.h>
+#include <linux/rtnetlink.h>
 #include <net/if.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
+#include <sys/time.h>
 #include <sys/types.h>
 
 #include <cstring>
 #include <iostream>
 using namespace std;
 
+// max number of frames read by a single recvmmsg call
+#define CAN_RX_BATCH 64
+// max number of frames written by a single sendmmsg call
+#define CAN_TX_BATCH 64
+// wait for room in the interface queue during a batch write, 5 ms at most
+#define CAN_TX_RETRY_US 200
+#define CAN_TX_RETRIES 25
+// notifier thread poll period, used to check for interruption request
+#define CAN_RX_POLL_MS 100
+
 int createSocketCan(const QString &adress)
 {
     struct ifreq ifr;
@@ -58,6 +76,10 @@ int createSocketCan(const QString &adress)
 
     fcntl(can_socket, F_SETFL, O_NONBLOCK);
 
+    // kernel reception timestamp delivered as ancillary data with each frame
+    int timestampOn = 1;
+    setsockopt(can_socket, SOL_SOCKET, SO_TIMESTAMP, &timestampOn, sizeof(timestampOn));
+
 #ifndef Q_OS_ANDROID
     // TODO find a way to do that...
     if (bind(can_socket, (struct sockaddr *)&addr, sizeof(addr)) < 0)
@@ -70,12 +92,89 @@ int createSocketCan(const QString &adress)
     return can_socket;
 }
 
+/**
+ * @brief Bit rate of a CAN interface, read from its link information with rtnetlink
+ * @return bit rate in bit/s, 0 if unknown (virtual interfaces have no bit timing)
+ */
+static int readSocketCanBitRate(const QString &adress)
+{
+    unsigned int ifIndex = if_nametoindex(adress.toLocal8Bit().constData());
+    if (ifIndex == 0)
+    {
+        return 0;
+    }
+
+    int nlSocket = socket(AF_NETLINK, SOCK_RAW, NETLINK_ROUTE);
+    if (nlSocket < 0)
+    {
+        return 0;
+    }
+
+    struct
+    {
+        struct nlmsghdr header;
+        struct ifinfomsg info;
+    } request;
+    memset(&request, 0, sizeof(request));
+    request.header.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+    request.header.nlmsg_type = RTM_GETLINK;
+    request.header.nlmsg_flags = NLM_F_REQUEST;
+    request.info.ifi_family = AF_UNSPEC;
+    request.info.ifi_index = static_cast<int>(ifIndex);
+
+    char buffer[8192];
+    int len = -1;
+    if (send(nlSocket, &request, request.header.nlmsg_len, 0) >= 0)
+    {
+        len = static_cast<int>(recv(nlSocket, buffer, sizeof(buffer), 0));
+    }
+    close(nlSocket);
+
+    // RTM_NEWLINK > IFLA_LINKINFO > IFLA_INFO_DATA > IFLA_CAN_BITTIMING
+    for (struct nlmsghdr *header = reinterpret_cast<struct nlmsghdr *>(buffer); NLMSG_OK(header, len); header = NLMSG_NEXT(header, len))
+    {
+        if (header->nlmsg_type != RTM_NEWLINK)
+        {
+            continue;
+        }
+        struct ifinfomsg *info = static_cast<struct ifinfomsg *>(NLMSG_DATA(header));
+        int attrLen = static_cast<int>(IFLA_PAYLOAD(header));
+        for (struct rtattr *attr = IFLA_RTA(info); RTA_OK(attr, attrLen); attr = RTA_NEXT(attr, attrLen))
+        {
+            if (attr->rta_type != IFLA_LINKINFO)
+            {
+                continue;
+            }
+            int linkLen = static_cast<int>(RTA_PAYLOAD(attr));
+            for (struct rtattr *link = static_cast<struct rtattr *>(RTA_DATA(attr)); RTA_OK(link, linkLen); link = RTA_NEXT(link, linkLen))
+            {
+                if (link->rta_type != IFLA_INFO_DATA)
+                {
+                    continue;
+                }
+                int dataLen = static_cast<int>(RTA_PAYLOAD(link));
+                for (struct rtattr *data = static_cast<struct rtattr *>(RTA_DATA(link)); RTA_OK(data, dataLen); data = RTA_NEXT(data, dataLen))
+                {
+                    if (data->rta_type == IFLA_CAN_BITTIMING && RTA_PAYLOAD(data) >= sizeof(struct can_bittiming))
+                    {
+                        struct can_bittiming bitTiming;
+                        memcpy(&bitTiming, RTA_DATA(data), sizeof(bitTiming));
+                        return static_cast<int>(bitTiming.bitrate);
+                    }
+                }
+            }
+        }
+    }
+    return 0;
+}
+
 CanBusSocketCAN::CanBusSocketCAN(const QString &adress)
     : CanBusDriver(adress)
 {
     _can_socket = -1;
     _readNotifier = nullptr;
     _errorNotifier = nullptr;
+    _notifyPending.storeRelease(0);
 }
 
 CanBusSocketCAN::~CanBusSocketCAN()
@@ -93,12 +192,15 @@ bool CanBusSocketCAN::connectDevice()
         return false;
     }
 
+    _rxRing.clear();
+    _notifyPending.storeRelease(0);
     _readNotifier = new CanBusSocketCANNotifierThead(this);
     _readNotifier->start();
 
     _errorNotifier = new QSocketNotifier(_can_socket, QSocketNotifier::Exception, this);
     connect(_errorNotifier, &QSocketNotifier::activated, this, &CanBusSocketCAN::handleError);
 
+    setBitRate(readSocketCanBitRate(_adress));
     setState(CONNECTED);
     return true;
 }
@@ -111,7 +213,8 @@ void CanBusSocketCAN::disconnectDevice()
         return;
     }
 
-    _readNotifier->terminate();
+    _readNotifier->requestInterruption();
+    _readNotifier->wait();
     _errorNotifier->setEnabled(false);
     close(_can_socket);
     _can_socket = -1;
@@ -120,68 +223,127 @@ void CanBusSocketCAN::disconnectDevice()
     _errorNotifier->deleteLater();
 }
 
-QCanBusFrame CanBusSocketCAN::readFrame()
+/**
+ * @brief Pops the next frame received by the notifier thread, lock-free
+ * @return received frame or an InvalidFrame if no more frames are pending
+ */
+CanFrame CanBusSocketCAN::readFrame()
 {
-    QMutexLocker socketLocker(&_socketMutex);
-    QCanBusFrame qtFrame;
+    if (_rxRing.isEmpty())
+    {
+        // re-arm the wakeup before the last check, a batch committed in between
+        // is either seen here or notified again by the notifier thread
+        _notifyPending.storeRelease(0);
+        if (_rxRing.isEmpty())
+        {
+            return CanFrame(CanFrame::InvalidFrame);
+        }
+    }
 
-    struct can_frame frame;
+    const RxFrame &rxFrame = _rxRing.front();
+    const struct can_frame &rawFrame = rxFrame.frame;
 
-    int recvbytes = read(_can_socket, &frame, sizeof(struct can_frame));
-    if (recvbytes < 0)
+    CanFrame frame(rawFrame.can_id & CAN_EFF_MASK, rawFrame.data, qMin<int>(rawFrame.can_dlc, CAN_MAX_DLEN));
+    frame.setExtendedFrameFormat((rawFrame.can_id & CAN_EFF_FLAG) != 0);
+    frame.setTimeStamp(rxFrame.timeStampUs);
+    if ((rawFrame.can_id & CAN_RTR_FLAG) != 0)
     {
-        qtFrame.setFrameType(QCanBusFrame::InvalidFrame);
-        return qtFrame;
+        frame.setFrameType(CanFrame::RemoteRequestFrame);
     }
 
-    struct timeval tv;
-    ioctl(_can_socket, SIOCGSTAMP_OLD, &tv);
-    qtFrame.setTimeStamp(QCanBusFrame::TimeStamp(tv.tv_sec, tv.tv_usec));
-
-    qtFrame.setFrameId(frame.can_id & 0x1FFFFFFF);
+    _rxRing.pop();
+    return frame;
+}
 
-    QByteArray payLoad;
-    for (int i = 0; i < frame.can_dlc; i++)
+static void toRawFrame(const CanFrame &frame, struct can_frame *rawFrame)
+{
+    rawFrame->can_id = frame.frameId();
+    if (frame.hasExtendedFrameFormat())
     {
-        payLoad.append(frame.data[i]);
+        rawFrame->can_id |= CAN_EFF_FLAG;
     }
-    qtFrame.setPayload(payLoad);
-
-    qtFrame.setFrameType(QCanBusFrame::DataFrame);
-    if ((frame.can_id & CAN_RTR_FLAG) != 0)
+    if (frame.frameType() == CanFrame::RemoteRequestFrame)
     {
-        qtFrame.setFrameType(QCanBusFrame::RemoteRequestFrame);
+        rawFrame->can_id |= CAN_RTR_FLAG;
     }
 
-    return qtFrame;
+    rawFrame->can_dlc = static_cast<__u8>(qMin(frame.size(), CAN_MAX_DLEN));
+    memcpy(rawFrame->data, frame.data(), rawFrame->can_dlc);
 }
 
-bool CanBusSocketCAN::writeFrame(const QCanBusFrame &qtframe)
+bool CanBusSocketCAN::writeFrame(const CanFrame &frame)
 {
     QMutexLocker socketLocker(&_socketMutex);
     int retval;
-    struct can_frame frame;
+    struct can_frame rawFrame;
 
-    frame.can_id = qtframe.frameId();
+    toRawFrame(frame, &rawFrame);
 
-    if (qtframe.frameType() == QCanBusFrame::RemoteRequestFrame)
-    {
-        frame.can_id += CAN_RTR_FLAG;
-    }
+    retval = write(_can_socket, &rawFrame, sizeof(struct can_frame));
+    return (retval == sizeof(struct can_frame));
+}
+
+/**
+ * @brief Writes a batch of frames with sendmmsg, one syscall per CAN_TX_BATCH frames
+ *
+ * When the interface queue is full, waits a few ms for room instead of
+ * dropping the end of the batch. ENOBUFS does not wake up poll(), the wait
+ * is done by short sleeps.
+ */
+int CanBusSocketCAN::writeFrames(const CanFrame *frames, int count)
+{
+    QMutexLocker socketLocker(&_socketMutex);
 
-    frame.can_dlc = qtframe.payload().size();
-    for (int i = 0; i < qtframe.payload().size(); i++)
+    struct can_frame rawFrames[CAN_TX_BATCH];
+    struct iovec iovs[CAN_TX_BATCH];
+    struct mmsghdr msgs[CAN_TX_BATCH];
+    memset(msgs, 0, sizeof(msgs));
+
+    int written = 0;
+    int retries = 0;
+    while (written < count)
     {
-        frame.data[i] = qtframe.payload()[i];
+        int batch = qMin(count - written, CAN_TX_BATCH);
+        for (int i = 0; i < batch; i++)
+        {
+            toRawFrame(frames[written + i], &rawFrames[i]);
+            iovs[i].iov_base = &rawFrames[i];
+            iovs[i].iov_len = sizeof(struct can_frame);
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int sent = sendmmsg(_can_socket, msgs, static_cast<unsigned int>(batch), 0);
+        if (sent > 0)
+        {
+            written += sent;
+            continue;
+        }
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) && retries < CAN_TX_RETRIES)
+        {
+            retries++;
+            usleep(CAN_TX_RETRY_US);
+            continue;
+        }
+        break;
     }
+    return written;
+}
 
-    retval = write(_can_socket, &frame, sizeof(struct can_frame));
-    return (retval == sizeof(struct can_frame));
+quint32 CanBusSocketCAN::droppedFrames() const
+{
+    return _rxRing.dropped();
 }
 
+/**
+ * @brief Wakes up the consumer, coalesced : only one signal is emitted until readFrame() drained the ring
+ */
 void CanBusSocketCAN::notifyRead()
 {
-    emit framesReceived();
+    if (_notifyPending.testAndSetOrdered(0, 1))
+    {
+        emit framesReceived();
+    }
 }
 
 void CanBusSocketCAN::handleError()
@@ -195,28 +357,103 @@ CanBusSocketCANNotifierThead::CanBusSocketCANNotifierThead(CanBusSocketCAN *driv
     _driver = driver;
 }
 
+/**
+ * @brief Reception loop, drains the socket by batches with recvmmsg directly into the frame ring
+ */
 void CanBusSocketCANNotifierThead::run()
 {
-    fd_set rdfs;
-    bool running = true;
+    int canSocket = _driver->_can_socket;
+
+    struct mmsghdr msgs[CAN_RX_BATCH];
+    struct iovec iovs[CAN_RX_BATCH];
+    alignas(struct cmsghdr) char controls[CAN_RX_BATCH][CMSG_SPACE(sizeof(struct timeval))];
+    CanBusSocketCAN::RxFrame overflow[CAN_RX_BATCH];
 
-    _can_socket = createSocketCan(_driver->_adress);
+    memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < CAN_RX_BATCH; i++)
+    {
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_control = controls[i];
+    }
 
-    while (running)
+    while (!isInterruptionRequested())
     {
-        FD_ZERO(&rdfs);
-        FD_SET(_can_socket, &rdfs);
+        struct pollfd pollSocket;
+        pollSocket.fd = canSocket;
+        pollSocket.events = POLLIN;
+        pollSocket.revents = 0;
 
-        if (select(_can_socket + 1, &rdfs, nullptr, nullptr, nullptr) <= 0)
+        int ret = poll(&pollSocket, 1, CAN_RX_POLL_MS);
+        if (ret < 0)
         {
-            terminate();
-            running = false;
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
         }
-        else
+        if (ret == 0)
         {
-            struct can_frame frame;
-            read(_can_socket, &frame, sizeof(struct can_frame));
-            _driver->notifyRead();
+            continue;
+        }
+        if ((pollSocket.revents & (POLLERR | POLLHUP | POLLNVAL)) != 0)
+        {
+            break;
         }
+
+        // drain all pending frames
+        int count;
+        do
+        {
+            // ring full, frames are still read from the socket to not stall it, but dropped
+            quint32 available = _driver->_rxRing.contiguousWriteAvailable();
+            bool drop = (available == 0);
+            int batch = drop ? CAN_RX_BATCH : static_cast<int>(qMin<quint32>(available, CAN_RX_BATCH));
+
+            for (int i = 0; i < batch; i++)
+            {
+                CanBusSocketCAN::RxFrame *slot = drop ? &overflow[i] : _driver->_rxRing.writeSlot(static_cast<quint32>(i));
+                iovs[i].iov_base = &slot->frame;
+                iovs[i].iov_len = sizeof(struct can_frame);
+                msgs[i].msg_hdr.msg_controllen = sizeof(controls[i]);
+                msgs[i].msg_hdr.msg_flags = 0;
+            }
+
+            count = recvmmsg(canSocket, msgs, static_cast<unsigned int>(batch), MSG_DONTWAIT, nullptr);
+            if (count <= 0)
+            {
+                break;
+            }
+
+            if (drop)
+            {
+                _driver->_rxRing.addDropped(static_cast<quint32>(count));
+                continue;
+            }
+
+            for (int i = 0; i < count; i++)
+            {
+                CanBusSocketCAN::RxFrame *slot = _driver->_rxRing.writeSlot(static_cast<quint32>(i));
+                slot->timeStampUs = -1;
+                for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msgs[i].msg_hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msgs[i].msg_hdr, cmsg))
+                {
+                    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMP)
+                    {
+                        struct timeval tv;
+                        memcpy(&tv, CMSG_DATA(cmsg), sizeof(tv));
+                        slot->timeStampUs = static_cast<qint64>(tv.tv_sec) * 1000000 + tv.tv_usec;
+                    }
+                }
+                if (slot->timeStampUs < 0)
+                {
+                    slot->timeStampUs = QDateTime::currentMSecsSinceEpoch() * 1000;
+                }
+            }
+            _driver->_rxRing.commit(static_cast<quint32>(count));
+
+            // one wakeup for the whole batch
+            _driver->notifyRead();
+        } while (count == CAN_RX_BATCH);
     }
 }
@@ -22,11 +22,14 @@
 #include "canopen_global.h"
 
 #include "canbusdriver.h"
+#include "canframering.h"
 
 #include <QMutex>
 #include <QSocketNotifier>
 #include <QThread>
 
+#include <linux/can.h>
+
 class CanBusSocketCANNotifierThead;
 
 class CANOPEN_EXPORT CanBusSocketCAN : public CanBusDriver
@@ -41,8 +44,11 @@ public:
     bool connectDevice() override;
     void disconnectDevice() override;
 
-    QCanBusFrame readFrame() override;
-    bool writeFrame(const QCanBusFrame &qtframe) override;
+    CanFrame readFrame() override;
+    bool writeFrame(const CanFrame &frame) override;
+    int writeFrames(const CanFrame *frames, int count) override;
+
+    quint32 droppedFrames() const;
 
 private:
     int _can_socket;
@@ -51,6 +57,15 @@ private:
     CanBusSocketCANNotifierThead *_readNotifier;
     QSocketNotifier *_errorNotifier;
 
+    // received frames, filled by notifier thread, drained by readFrame()
+    struct RxFrame
+    {
+        struct can_frame frame;
+        qint64 timeStampUs;
+    };
+    CanFrameRing<RxFrame, 4096> _rxRing;
+    QAtomicInt _notifyPending;
+
     void notifyRead();
 
 protected slots:
@@ -65,7 +80,6 @@ public:
 
     // QThread interface
 protected:
-    int _can_socket;
     void run() override;
     CanBusSocketCAN *_driver;
 };
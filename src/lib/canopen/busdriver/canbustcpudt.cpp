@@ -19,12 +19,13 @@
 #include "canbustcpudt.h"
 
 #include <QDataStream>
+#include <QDateTime>
 #include <QDebug>
 
 CanBusTcpUDT::CanBusTcpUDT(const QString &adress)
     : CanBusDriver(adress)
 {
-    _sock = new QTcpSocket;
+    _sock = new QTcpSocket(this);  // moved along with the driver to the bus I/O thread
     QObject::connect(_sock, &QIODevice::readyRead, this, &CanBusTcpUDT::readTCP);
     QObject::connect(_sock, &QAbstractSocket::stateChanged, this, &CanBusTcpUDT::stateChanged);
 }
@@ -40,28 +41,28 @@ void CanBusTcpUDT::disconnectDevice()
     _sock->disconnectFromHost();
 }
 
-QCanBusFrame CanBusTcpUDT::readFrame()
+CanFrame CanBusTcpUDT::readFrame()
 {
     if (_queue.isEmpty())
     {
-        return QCanBusFrame(QCanBusFrame::InvalidFrame);
+        return CanFrame(CanFrame::InvalidFrame);
     }
 
     return _queue.dequeue();
 }
 
-bool CanBusTcpUDT::writeFrame(const QCanBusFrame &qtframe)
+bool CanBusTcpUDT::writeFrame(const CanFrame &frame)
 {
     quint8 flags;
     quint8 dlc;
-    switch (qtframe.frameType())
+    switch (frame.frameType())
     {
-        case QCanBusFrame::UnknownFrame:
-        case QCanBusFrame::InvalidFrame:
+        case CanFrame::UnknownFrame:
+        case CanFrame::InvalidFrame:
             return false;
 
-        case QCanBusFrame::DataFrame:
-            if (qtframe.hasExtendedFrameFormat())
+        case CanFrame::DataFrame:
+            if (frame.hasExtendedFrameFormat())
             {
                 flags = 2;
             }
@@ -71,11 +72,11 @@ bool CanBusTcpUDT::writeFrame(const QCanBusFrame &qtframe)
             }
             break;
 
-        case QCanBusFrame::ErrorFrame:
+        case CanFrame::ErrorFrame:
             flags = 3;
             break;
 
-        case QCanBusFrame::RemoteRequestFrame:
+        case CanFrame::RemoteRequestFrame:
             flags = 4;
             break;
     }
@@ -83,15 +84,15 @@ bool CanBusTcpUDT::writeFrame(const QCanBusFrame &qtframe)
     QByteArray data;
     QDataStream stream(&data, QIODevice::WriteOnly);
     stream.setByteOrder(QDataStream::LittleEndian);
-    dlc = qtframe.payload().size();
+    dlc = static_cast<quint8>(frame.size());
 
     stream << static_cast<quint8>('U');  // Magic id
     stream << static_cast<quint8>(0);    // bus id
     stream << flags;                     // flags
     stream << dlc;                       // dlc
 
-    stream << static_cast<quint32>(qtframe.frameId());  // frame id
-    data.append(qtframe.payload());
+    stream << static_cast<quint32>(frame.frameId());  // frame id
+    data.append(reinterpret_cast<const char *>(frame.data()), frame.size());
 
     return (_sock->write(data) != -1);
 }
@@ -130,23 +131,14 @@ int CanBusTcpUDT::readPacket(QByteArray data)
         return -1;
     }
 
-    QCanBusFrame qtFrame;
-    qtFrame.setFrameId(frameId);
-
-    QByteArray payLoad;
-    for (int i = 0; i < dlc; i++)
-    {
-        payLoad.append(data[i + 8]);
-    }
-    qtFrame.setPayload(payLoad);
-
-    qtFrame.setFrameType(QCanBusFrame::DataFrame);
+    CanFrame frame(frameId, reinterpret_cast<const quint8 *>(data.constData()) + 8, qMin<int>(dlc, data.size() - 8));
+    frame.setTimeStamp(QDateTime::currentMSecsSinceEpoch() * 1000);
     if (flags == 4)
     {
-        qtFrame.setFrameType(QCanBusFrame::RemoteRequestFrame);
+        frame.setFrameType(CanFrame::RemoteRequestFrame);
     }
 
-    _queue.append(qtFrame);
+    _queue.append(frame);
     emit framesReceived();
 
     return dlc + 8;
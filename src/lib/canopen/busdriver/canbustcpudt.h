@@ -37,13 +37,13 @@ public:
 public:
     bool connectDevice() override;
     void disconnectDevice() override;
-    QCanBusFrame readFrame() override;
-    bool writeFrame(const QCanBusFrame &qtframe) override;
+    CanFrame readFrame() override;
+    bool writeFrame(const CanFrame &frame) override;
 
 private:
     QMutex _socketMutex;
     QTcpSocket *_sock;
-    QQueue<QCanBusFrame> _queue;
+    QQueue<CanFrame> _queue;
 
 protected slots:
     void readTCP();
@@ -0,0 +1,64 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "canframe.h"
+
+/**
+ * @brief Payload copy as a QByteArray
+ * @return payload, allocated
+ */
+QByteArray CanFrame::payload() const
+{
+    return QByteArray(reinterpret_cast<const char *>(_data), _size);
+}
+
+/**
+ * @brief Conversion to QCanBusFrame, for GUI code only
+ * @return converted frame
+ */
+QCanBusFrame CanFrame::toQCanBusFrame() const
+{
+    QCanBusFrame qtFrame(static_cast<QCanBusFrame::FrameType>(_type));
+    qtFrame.setFrameId(_frameId);
+    qtFrame.setExtendedFrameFormat(hasExtendedFrameFormat());
+    qtFrame.setPayload(payload());
+    qtFrame.setFlexibleDataRateFormat(hasFlexibleDataRateFormat());
+    qtFrame.setBitrateSwitch((_flags & BitrateSwitch) != 0);
+    qtFrame.setErrorStateIndicator((_flags & ErrorStateIndicator) != 0);
+    qtFrame.setLocalEcho(hasLocalEcho());
+    qtFrame.setTimeStamp(QCanBusFrame::TimeStamp::fromMicroSeconds(_timeStamp));
+    return qtFrame;
+}
+
+/**
+ * @brief Conversion from a QCanBusFrame
+ * @param qtFrame frame to convert
+ * @return converted frame
+ */
+CanFrame CanFrame::fromQCanBusFrame(const QCanBusFrame &qtFrame)
+{
+    CanFrame frame(static_cast<FrameType>(qtFrame.frameType()));
+    frame.setFrameId(qtFrame.frameId());
+    frame.setExtendedFrameFormat(qtFrame.hasExtendedFrameFormat());
+    frame.setPayload(qtFrame.payload());
+    frame.setFlag(BitrateSwitch, qtFrame.hasBitrateSwitch());
+    frame.setFlag(ErrorStateIndicator, qtFrame.hasErrorStateIndicator());
+    frame.setLocalEcho(qtFrame.hasLocalEcho());
+    frame.setTimeStamp(qtFrame.timeStamp().seconds() * 1000000 + qtFrame.timeStamp().microSeconds());
+    return frame;
+}
@@ -0,0 +1,255 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef CANFRAME_H
+#define CANFRAME_H
+
+#include "canopen_global.h"
+
+#include <QByteArray>
+#include <QtEndian>
+
+#include <cstring>
+#include <type_traits>
+
+#include "busdriver/qcanbusframe.h"
+
+/**
+ * @brief Fixed size, trivially copyable CAN / CAN FD frame with inline payload
+ *
+ * Used on the whole reception and emission path instead of QCanBusFrame to avoid
+ * any heap allocation per frame. toQCanBusFrame() is provided for GUI code.
+ */
+class CANOPEN_EXPORT CanFrame
+{
+public:
+    enum FrameType : quint8
+    {
+        UnknownFrame = 0x0,
+        DataFrame = 0x1,
+        ErrorFrame = 0x2,
+        RemoteRequestFrame = 0x3,
+        InvalidFrame = 0x4
+    };
+
+    enum Flags : quint8
+    {
+        ExtendedFrameFormat = 0x01,
+        FlexibleDataRate = 0x02,
+        BitrateSwitch = 0x04,
+        ErrorStateIndicator = 0x08,
+        LocalEcho = 0x10
+    };
+
+    enum
+    {
+        MaxPayloadSize = 64,
+        MaxClassicPayloadSize = 8
+    };
+
+    CanFrame()
+    {
+        std::memset(this, 0, sizeof(CanFrame));
+        _type = DataFrame;
+    }
+
+    explicit CanFrame(FrameType type)
+    {
+        std::memset(this, 0, sizeof(CanFrame));
+        _type = type;
+    }
+
+    CanFrame(quint32 frameId, const quint8 *data, int size)
+    {
+        std::memset(this, 0, sizeof(CanFrame));
+        _type = DataFrame;
+        setFrameId(frameId);
+        setPayload(data, size);
+    }
+
+    CanFrame(quint32 frameId, const QByteArray &data)
+    {
+        std::memset(this, 0, sizeof(CanFrame));
+        _type = DataFrame;
+        setFrameId(frameId);
+        setPayload(data);
+    }
+
+    bool isValid() const
+    {
+        return _type != InvalidFrame;
+    }
+
+    FrameType frameType() const
+    {
+        return static_cast<FrameType>(_type);
+    }
+
+    void setFrameType(FrameType type)
+    {
+        _type = type;
+    }
+
+    quint32 frameId() const
+    {
+        return _frameId;
+    }
+
+    void setFrameId(quint32 frameId)
+    {
+        // a reused frame follows the format of its new identifier
+        _frameId = frameId & 0x1FFFFFFFU;
+        setFlag(ExtendedFrameFormat, (_frameId & 0x1FFFF800U) != 0U);
+    }
+
+    bool hasExtendedFrameFormat() const
+    {
+        return (_flags & ExtendedFrameFormat) != 0;
+    }
+
+    void setExtendedFrameFormat(bool extended)
+    {
+        setFlag(ExtendedFrameFormat, extended);
+    }
+
+    bool hasFlexibleDataRateFormat() const
+    {
+        return (_flags & FlexibleDataRate) != 0;
+    }
+
+    bool hasLocalEcho() const
+    {
+        return (_flags & LocalEcho) != 0;
+    }
+
+    void setLocalEcho(bool localEcho)
+    {
+        setFlag(LocalEcho, localEcho);
+    }
+
+    quint8 flags() const
+    {
+        return _flags;
+    }
+
+    void setFlag(Flags flag, bool enabled)
+    {
+        if (enabled)
+        {
+            _flags |= flag;
+        }
+        else
+        {
+            _flags &= ~flag;
+        }
+    }
+
+    // payload
+    int size() const
+    {
+        return _size;
+    }
+
+    bool isEmpty() const
+    {
+        return _size == 0;
+    }
+
+    void setSize(int size)
+    {
+        _size = static_cast<quint8>(qBound(0, size, static_cast<int>(MaxPayloadSize)));
+        setFlag(FlexibleDataRate, _size > MaxClassicPayloadSize);
+    }
+
+    const quint8 *data() const
+    {
+        return _data;
+    }
+
+    quint8 *data()
+    {
+        return _data;
+    }
+
+    quint8 at(int pos) const
+    {
+        return _data[pos];
+    }
+
+    void setPayload(const quint8 *data, int size)
+    {
+        setSize(size);
+        std::memcpy(_data, data, _size);
+    }
+
+    void setPayload(const QByteArray &data)
+    {
+        setPayload(reinterpret_cast<const quint8 *>(data.constData()), data.size());
+    }
+
+    // little endian accessors, CANopen byte order
+    quint16 u16At(int pos) const
+    {
+        return qFromLittleEndian<quint16>(_data + pos);
+    }
+
+    quint32 u32At(int pos) const
+    {
+        return qFromLittleEndian<quint32>(_data + pos);
+    }
+
+    void setU16At(int pos, quint16 value)
+    {
+        qToLittleEndian<quint16>(value, _data + pos);
+    }
+
+    void setU32At(int pos, quint32 value)
+    {
+        qToLittleEndian<quint32>(value, _data + pos);
+    }
+
+    // timestamp in micro seconds since epoch
+    qint64 timeStamp() const
+    {
+        return _timeStamp;
+    }
+
+    void setTimeStamp(qint64 timeStampUs)
+    {
+        _timeStamp = timeStampUs;
+    }
+
+    // conversions, GUI only, allocates
+    QByteArray payload() const;
+    QCanBusFrame toQCanBusFrame() const;
+    static CanFrame fromQCanBusFrame(const QCanBusFrame &qtFrame);
+
+private:
+    quint32 _frameId;
+    quint8 _type;
+    quint8 _flags;
+    quint8 _size;
+    quint8 _reserved;
+    qint64 _timeStamp;
+    quint8 _data[MaxPayloadSize];
+};
+
+Q_DECLARE_TYPEINFO(CanFrame, Q_PRIMITIVE_TYPE);
+static_assert(std::is_trivially_copyable<CanFrame>::value, "CanFrame must stay trivially copyable");
+
+#endif  // CANFRAME_H
@@ -0,0 +1,304 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "canframejournal.h"
+
+#include <QDebug>
+
+#include <cstring>
+
+CanFrameJournal::CanFrameJournal(int ringCapacity)
+{
+    // round up to a power of two to index the ring with a mask
+    quint64 size = 1;
+    while (size < static_cast<quint64>(qMax(ringCapacity, 1)))
+    {
+        size <<= 1;
+    }
+    _ring.resize(static_cast<int>(size));
+    _ringMask = size - 1;
+
+    _firstId = 0;
+    _endId = 0;
+
+    _retentionCount = 0;
+    _retentionBytes = 0;
+    _retentionAgeUs = 0;
+
+    _spillMap = nullptr;
+    _spillHeader = nullptr;
+    _spillRecords = nullptr;
+    _spillCapacity = 0;
+
+    updateCapacity();
+}
+
+CanFrameJournal::~CanFrameJournal()
+{
+    closeSpillFile();
+}
+
+/**
+ * @brief Appends a frame, oldest frames are dropped according to retention
+ * @param frame frame to append
+ */
+void CanFrameJournal::append(const CanFrame &frame)
+{
+    _ring[static_cast<int>(_endId & _ringMask)] = frame;
+    if (_spillRecords != nullptr)
+    {
+        _spillRecords[_endId % _spillCapacity] = frame;
+    }
+    _endId++;
+
+    if (_endId - _firstId > _capacity)
+    {
+        _firstId = _endId - _capacity;
+    }
+    if (_retentionAgeUs > 0)
+    {
+        applyRetention(frame);
+    }
+
+    if (_spillHeader != nullptr)
+    {
+        _spillHeader->firstId = _firstId;
+        _spillHeader->endId = _endId;
+    }
+}
+
+/**
+ * @brief Forgets all frames, ids continue from the current endId()
+ */
+void CanFrameJournal::clear()
+{
+    _firstId = _endId;
+    if (_spillHeader != nullptr)
+    {
+        _spillHeader->firstId = _firstId;
+    }
+}
+
+quint64 CanFrameJournal::firstId() const
+{
+    return _firstId;
+}
+
+quint64 CanFrameJournal::endId() const
+{
+    return _endId;
+}
+
+int CanFrameJournal::count() const
+{
+    return static_cast<int>(_endId - _firstId);
+}
+
+bool CanFrameJournal::contains(quint64 id) const
+{
+    return (id >= _firstId) && (id < _endId);
+}
+
+/**
+ * @brief Frame access by id, without copy
+ * @param id frame id
+ * @return pointer to the frame, valid until the next append(), nullptr if out of retention
+ */
+const CanFrame *CanFrameJournal::frame(quint64 id) const
+{
+    if (!contains(id))
+    {
+        return nullptr;
+    }
+    if (_endId - id <= static_cast<quint64>(_ring.size()))
+    {
+        return &_ring.at(static_cast<int>(id & _ringMask));
+    }
+    if (_spillRecords != nullptr)
+    {
+        return &_spillRecords[id % _spillCapacity];
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Sets retention limits, 0 means unlimited for each criterion
+ *
+ * Without spill file, history is always bounded by the ring capacity.
+ * @param maxCount maximum number of frames
+ * @param maxBytes maximum storage in bytes
+ * @param maxAgeUs maximum age in micro seconds relative to the newest frame
+ */
+void CanFrameJournal::setRetention(quint64 maxCount, quint64 maxBytes, qint64 maxAgeUs)
+{
+    _retentionCount = maxCount;
+    _retentionBytes = maxBytes;
+    _retentionAgeUs = maxAgeUs;
+    updateCapacity();
+
+    const CanFrame *newest = frame(_endId - 1);
+    if ((_retentionAgeUs > 0) && (newest != nullptr))
+    {
+        applyRetention(*newest);
+    }
+}
+
+quint64 CanFrameJournal::retentionCount() const
+{
+    return _retentionCount;
+}
+
+quint64 CanFrameJournal::retentionBytes() const
+{
+    return _retentionBytes;
+}
+
+qint64 CanFrameJournal::retentionAgeUs() const
+{
+    return _retentionAgeUs;
+}
+
+int CanFrameJournal::ringCapacity() const
+{
+    return _ring.size();
+}
+
+/**
+ * @brief Opens a spill file to keep more history than the in memory ring
+ *
+ * The file holds a small header followed by capacity fixed size records. Frames
+ * currently in the ring are copied to the file.
+ * @param fileName file path, truncated if it exists
+ * @param capacity number of records
+ * @return true on success
+ */
+bool CanFrameJournal::openSpillFile(const QString &fileName, quint64 capacity)
+{
+    closeSpillFile();
+    if (capacity < static_cast<quint64>(_ring.size()))
+    {
+        capacity = static_cast<quint64>(_ring.size());
+    }
+
+    _spillFile.setFileName(fileName);
+    if (!_spillFile.open(QIODevice::ReadWrite | QIODevice::Truncate))
+    {
+        qDebug() << "CanFrameJournal: cannot open spill file" << fileName;
+        return false;
+    }
+
+    qint64 fileSize = static_cast<qint64>(sizeof(SpillHeader) + capacity * sizeof(CanFrame));
+    if (!_spillFile.resize(fileSize))
+    {
+        _spillFile.close();
+        return false;
+    }
+    _spillMap = _spillFile.map(0, fileSize);
+    if (_spillMap == nullptr)
+    {
+        qDebug() << "CanFrameJournal: cannot map spill file" << fileName;
+        _spillFile.close();
+        return false;
+    }
+
+    _spillHeader = reinterpret_cast<SpillHeader *>(_spillMap);
+    _spillRecords = reinterpret_cast<CanFrame *>(_spillMap + sizeof(SpillHeader));
+    _spillCapacity = capacity;
+
+    std::memcpy(_spillHeader->magic, "UCFJ", 4);
+    _spillHeader->recordSize = sizeof(CanFrame);
+    _spillHeader->capacity = capacity;
+    for (quint64 id = _firstId; id < _endId; id++)
+    {
+        _spillRecords[id % _spillCapacity] = _ring.at(static_cast<int>(id & _ringMask));
+    }
+    _spillHeader->firstId = _firstId;
+    _spillHeader->endId = _endId;
+
+    updateCapacity();
+    return true;
+}
+
+/**
+ * @brief Closes the spill file, history is reduced to the ring capacity
+ */
+void CanFrameJournal::closeSpillFile()
+{
+    if (_spillMap != nullptr)
+    {
+        _spillFile.unmap(_spillMap);
+    }
+    if (_spillFile.isOpen())
+    {
+        _spillFile.close();
+    }
+    _spillMap = nullptr;
+    _spillHeader = nullptr;
+    _spillRecords = nullptr;
+    _spillCapacity = 0;
+
+    updateCapacity();
+}
+
+bool CanFrameJournal::hasSpillFile() const
+{
+    return _spillMap != nullptr;
+}
+
+QString CanFrameJournal::spillFileName() const
+{
+    return _spillFile.fileName();
+}
+
+quint64 CanFrameJournal::spillCapacity() const
+{
+    return _spillCapacity;
+}
+
+void CanFrameJournal::updateCapacity()
+{
+    _capacity = (_spillCapacity > 0) ? _spillCapacity : static_cast<quint64>(_ring.size());
+    if ((_retentionCount > 0) && (_retentionCount < _capacity))
+    {
+        _capacity = _retentionCount;
+    }
+    if (_retentionBytes > 0)
+    {
+        quint64 byteCount = qMax<quint64>(_retentionBytes / sizeof(CanFrame), 1);
+        _capacity = qMin(_capacity, byteCount);
+    }
+
+    if (_endId - _firstId > _capacity)
+    {
+        _firstId = _endId - _capacity;
+    }
+}
+
+void CanFrameJournal::applyRetention(const CanFrame &newestFrame)
+{
+    const qint64 oldestAllowed = newestFrame.timeStamp() - _retentionAgeUs;
+    while (_endId - _firstId > 1)
+    {
+        const CanFrame *oldest = frame(_firstId);
+        if ((oldest == nullptr) || (oldest->timeStamp() >= oldestAllowed))
+        {
+            break;
+        }
+        _firstId++;
+    }
+}
@@ -0,0 +1,107 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef CANFRAMEJOURNAL_H
+#define CANFRAMEJOURNAL_H
+
+#include "canopen_global.h"
+
+#include <QFile>
+#include <QVector>
+
+#include "canframe.h"
+
+/**
+ * @brief Bounded journal of CAN frames
+ *
+ * Frames are identified by a monotonic id. The most recent frames are kept in
+ * a fixed size in memory ring. An optional spill file extends the history with
+ * fixed size records in a memory mapped file, written sequentially and wrapped
+ * once full. Retention can be limited by frame count, bytes or age; frames out
+ * of retention are forgotten and firstId() moves forward.
+ */
+class CANOPEN_EXPORT CanFrameJournal
+{
+public:
+    CanFrameJournal(int ringCapacity = DefaultRingCapacity);
+    ~CanFrameJournal();
+
+    enum
+    {
+        DefaultRingCapacity = 65536,
+        DefaultSpillCapacity = 4 * 1024 * 1024
+    };
+
+    void append(const CanFrame &frame);
+    void clear();
+
+    // ids window, [firstId, endId[
+    quint64 firstId() const;
+    quint64 endId() const;
+    int count() const;
+    bool contains(quint64 id) const;
+
+    const CanFrame *frame(quint64 id) const;
+
+    // retention, 0 means no limit
+    void setRetention(quint64 maxCount, quint64 maxBytes = 0, qint64 maxAgeUs = 0);
+    quint64 retentionCount() const;
+    quint64 retentionBytes() const;
+    qint64 retentionAgeUs() const;
+
+    int ringCapacity() const;
+
+    // spill file
+    bool openSpillFile(const QString &fileName, quint64 capacity = DefaultSpillCapacity);
+    void closeSpillFile();
+    bool hasSpillFile() const;
+    QString spillFileName() const;
+    quint64 spillCapacity() const;
+
+private:
+    QVector<CanFrame> _ring;
+    quint64 _ringMask;
+
+    quint64 _firstId;
+    quint64 _endId;
+
+    quint64 _retentionCount;
+    quint64 _retentionBytes;
+    qint64 _retentionAgeUs;
+    quint64 _capacity;
+
+    struct SpillHeader
+    {
+        char magic[4];
+        quint32 recordSize;
+        quint64 capacity;
+        quint64 firstId;
+        quint64 endId;
+    };
+
+    QFile _spillFile;
+    uchar *_spillMap;
+    SpillHeader *_spillHeader;
+    CanFrame *_spillRecords;
+    quint64 _spillCapacity;
+
+    void updateCapacity();
+    void applyRetention(const CanFrame &newestFrame);
+};
+
+#endif  // CANFRAMEJOURNAL_H
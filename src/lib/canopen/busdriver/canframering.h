@@ -0,0 +1,122 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef CANFRAMERING_H
+#define CANFRAMERING_H
+
+#include <QAtomicInteger>
+
+/**
+ * @brief Lock-free single-producer / single-consumer ring of fixed size items
+ *
+ * The producer thread reserves free slots with writeSlot(), fills them in place
+ * and publishes them with commit(). The consumer thread reads with front() and
+ * releases with pop(). Size must be a power of two.
+ */
+template <typename T, quint32 Size>
+class CanFrameRing
+{
+    static_assert((Size & (Size - 1)) == 0, "CanFrameRing size must be a power of two");
+
+public:
+    CanFrameRing()
+        : _head(0)
+        , _tail(0)
+        , _dropped(0)
+    {
+    }
+
+    // producer side
+    quint32 writeAvailable() const
+    {
+        return Size - (_head.loadAcquire() - _tail.loadAcquire());
+    }
+
+    quint32 contiguousWriteAvailable() const
+    {
+        quint32 available = writeAvailable();
+        quint32 toEnd = Size - (_head.loadAcquire() & (Size - 1));
+        return (available < toEnd) ? available : toEnd;
+    }
+
+    T *writeSlot(quint32 offset = 0)
+    {
+        return &_items[(_head.loadAcquire() + offset) & (Size - 1)];
+    }
+
+    void commit(quint32 count)
+    {
+        _head.storeRelease(_head.loadAcquire() + count);
+    }
+
+    bool push(const T &item)
+    {
+        if (writeAvailable() == 0)
+        {
+            _dropped.fetchAndAddRelaxed(1);
+            return false;
+        }
+        *writeSlot() = item;
+        commit(1);
+        return true;
+    }
+
+    void addDropped(quint32 count)
+    {
+        _dropped.fetchAndAddRelaxed(count);
+    }
+
+    // consumer side
+    bool isEmpty() const
+    {
+        return _head.loadAcquire() == _tail.loadAcquire();
+    }
+
+    quint32 count() const
+    {
+        return _head.loadAcquire() - _tail.loadAcquire();
+    }
+
+    const T &front() const
+    {
+        return _items[_tail.loadAcquire() & (Size - 1)];
+    }
+
+    void pop()
+    {
+        _tail.storeRelease(_tail.loadAcquire() + 1);
+    }
+
+    void clear()
+    {
+        _tail.storeRelease(_head.loadAcquire());
+    }
+
+    quint32 dropped() const
+    {
+        return _dropped.loadAcquire();
+    }
+
+private:
+    T _items[Size];
+    QAtomicInteger<quint32> _head;
+    QAtomicInteger<quint32> _tail;
+    QAtomicInteger<quint32> _dropped;
+};
+
+#endif  // CANFRAMERING_H
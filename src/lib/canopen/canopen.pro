@@ -14,26 +14,36 @@ CONFIG(release, debug|release) {
 SOURCES += \
     $$PWD/canopen.cpp \
     $$PWD/canopenbus.cpp \
+    $$PWD/canopenbusworker.cpp \
     $$PWD/node.cpp \
     $$PWD/nodeod.cpp \
     $$PWD/nodeindex.cpp \
     $$PWD/nodesubindex.cpp \
+    $$PWD/nodevalue.cpp \
     $$PWD/nodeobjectid.cpp \
     $$PWD/nodeodsubscriber.cpp \
+    $$PWD/nodeodtemplate.cpp \
     $$PWD/services/service.cpp \
     $$PWD/services/emergency.cpp \
     $$PWD/services/nmt.cpp \
     $$PWD/services/pdo.cpp \
     $$PWD/services/tpdo.cpp \
     $$PWD/services/rpdo.cpp \
+    $$PWD/services/rpdoprocessimage.cpp \
     $$PWD/services/sdo.cpp \
+    $$PWD/services/sdoscheduler.cpp \
+    $$PWD/services/liveobjects.cpp \
     $$PWD/services/sync.cpp \
+    $$PWD/services/syncproducer.cpp \
     $$PWD/services/timestamp.cpp \
     $$PWD/services/errorcontrol.cpp \
     $$PWD/services/servicedispatcher.cpp \
     $$PWD/services/nodediscover.cpp \
     $$PWD/datalogger/datalogger.cpp \
+    $$PWD/datalogger/dlcapturefile.cpp \
     $$PWD/datalogger/dldata.cpp \
+    $$PWD/datalogger/dlexport.cpp \
+    $$PWD/datalogger/dltimeseries.cpp \
     $$PWD/datalogger/fastdatalogger.cpp \
     $$PWD/datalogger/fastdataloggerconfig.cpp \
     $$PWD/profile/nodeprofile.cpp \
@@ -49,14 +59,19 @@ SOURCES += \
     $$PWD/indexdb401.cpp \
     $$PWD/indexdb402.cpp \
     $$PWD/busdriver/qcanbusframe.cpp \
+    $$PWD/busdriver/canframe.cpp \
+    $$PWD/busdriver/canframejournal.cpp \
     $$PWD/busdriver/canbusdriver.cpp \
     $$PWD/busdriver/canbustcpudt.cpp \
     $$PWD/bootloader/bootloader.cpp \
+    $$PWD/bootloader/ufwflasher.cpp \
     $$PWD/bootloader/model/ufwmodel.cpp \
     $$PWD/bootloader/parser/hexparser.cpp \
     $$PWD/bootloader/parser/ufwparser.cpp \
     $$PWD/bootloader/utility/hexmerger.cpp \
     $$PWD/bootloader/utility/phantomremover.cpp \
+    $$PWD/bootloader/utility/ufwdelta.cpp \
+    $$PWD/bootloader/utility/ufwpacker.cpp \
     $$PWD/bootloader/utility/ufwupdate.cpp \
     $$PWD/bootloader/writer/hexwriter.cpp \
     $$PWD/bootloader/writer/ufwwriter.cpp \
@@ -70,12 +85,15 @@ HEADERS += \
     $$PWD/canopen.h \
     $$PWD/canopen_global.h \
     $$PWD/canopenbus.h \
+    $$PWD/canopenbusworker.h \
     $$PWD/node.h \
     $$PWD/nodeod.h \
     $$PWD/nodeindex.h \
     $$PWD/nodesubindex.h \
+    $$PWD/nodevalue.h \
     $$PWD/nodeobjectid.h \
     $$PWD/nodeodsubscriber.h \
+    $$PWD/nodeodtemplate.h \
     $$PWD/services/service.h \
     $$PWD/services/services.h \
     $$PWD/services/emergency.h \
@@ -83,14 +101,21 @@ HEADERS += \
     $$PWD/services/pdo.h \
     $$PWD/services/tpdo.h \
     $$PWD/services/rpdo.h \
+    $$PWD/services/rpdoprocessimage.h \
     $$PWD/services/sdo.h \
+    $$PWD/services/sdoscheduler.h \
+    $$PWD/services/liveobjects.h \
     $$PWD/services/sync.h \
+    $$PWD/services/syncproducer.h \
     $$PWD/services/timestamp.h \
     $$PWD/services/errorcontrol.h \
     $$PWD/services/servicedispatcher.h \
     $$PWD/services/nodediscover.h \
     $$PWD/datalogger/datalogger.h \
+    $$PWD/datalogger/dlcapturefile.h \
     $$PWD/datalogger/dldata.h \
+    $$PWD/datalogger/dlexport.h \
+    $$PWD/datalogger/dltimeseries.h \
     $$PWD/datalogger/fastdatalogger.h \
     $$PWD/datalogger/fastdataloggerconfig.h \
     $$PWD/profile/nodeprofilefactory.h \
@@ -106,14 +131,20 @@ HEADERS += \
     $$PWD/indexdb401.h \
     $$PWD/indexdb402.h \
     $$PWD/busdriver/qcanbusframe.h \
+    $$PWD/busdriver/canframe.h \
+    $$PWD/busdriver/canframejournal.h \
     $$PWD/busdriver/canbusdriver.h \
+    $$PWD/busdriver/canframering.h \
     $$PWD/busdriver/canbustcpudt.h \
     $$PWD/bootloader/bootloader.h \
+    $$PWD/bootloader/ufwflasher.h \
     $$PWD/bootloader/model/ufwmodel.h \
     $$PWD/bootloader/parser/hexparser.h \
     $$PWD/bootloader/parser/ufwparser.h \
     $$PWD/bootloader/utility/hexmerger.h \
     $$PWD/bootloader/utility/phantomremover.h \
+    $$PWD/bootloader/utility/ufwdelta.h \
+    $$PWD/bootloader/utility/ufwpacker.h \
     $$PWD/bootloader/utility/ufwupdate.h \
     $$PWD/bootloader/writer/hexwriter.h \
     $$PWD/bootloader/writer/ufwwriter.h \
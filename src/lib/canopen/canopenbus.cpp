@@ -24,15 +24,21 @@ CanOpenBus::CanOpenBus(CanBusDriver *canBusDriver)
 {
     _busId = 255;
     _canOpen = nullptr;
-    _canBusDriver = nullptr;
-    setCanBusDriver(canBusDriver);
     _spyMode = false;
 
+    // driver I/O runs in its own thread, received frames are processed here
+    _hasDriver = false;
+    _worker = new CanOpenBusWorker();
+    connect(_worker, &CanOpenBusWorker::framesAvailable, this, &CanOpenBus::canFrameRec);
+    connect(_worker, &CanOpenBusWorker::stateChanged, this, &CanOpenBus::updateState);
+    setCanBusDriver(canBusDriver);
+
     // services
     _serviceDispatcher = new ServiceDispatcher(this);
 
     _sync = new Sync(this);
     _serviceDispatcher->addService(_sync);
+    _rpdoProcessImage = new RpdoProcessImage(this);
 
     _timestamp = new TimeStamp(this);
     _serviceDispatcher->addService(_timestamp);
@@ -45,6 +51,13 @@ CanOpenBus::CanOpenBus(CanBusDriver *canBusDriver)
     _canFramesLogTimer = new QTimer();
     connect(_canFramesLogTimer, &QTimer::timeout, this, &CanOpenBus::notifyForNewFrames);
     _canFramesLogTimer->start(100);
+
+    // bus load
+    _bitRate = 1000000;
+    _busBitCount = 0;
+    _busLoad = 0.0;
+    _sdoBusLoadLimit = 0.8;
+    _busLoadElapsed.start();
 }
 
 CanOpenBus::~CanOpenBus()
@@ -54,11 +67,10 @@ CanOpenBus::~CanOpenBus()
     delete _nodeDiscover;
     delete _serviceDispatcher;
     qDeleteAll(_nodes);
+    delete _rpdoProcessImage;
 
-    if (_canBusDriver != nullptr)
-    {
-        _canBusDriver->deleteLater();
-    }
+    // driver deleted by the worker
+    delete _worker;
 }
 
 QString CanOpenBus::busName() const
@@ -144,7 +156,7 @@ void CanOpenBus::stopAll()
     QByteArray nmtStopPayload;
     nmtStopPayload.append(static_cast<char>(0x02));
     nmtStopPayload.append(static_cast<char>(0));
-    QCanBusFrame frameNmt;
+    CanFrame frameNmt;
     frameNmt.setFrameId(0);
     frameNmt.setPayload(nmtStopPayload);
     writeFrame(frameNmt);
@@ -155,63 +167,127 @@ void CanOpenBus::stopAll()
     }
 }
 
-const QList<QCanBusFrame> &CanOpenBus::canFramesLog() const
+CanFrameJournal *CanOpenBus::frameJournal()
 {
-    return _canFramesLog;
+    return &_frameJournal;
 }
 
-CanBusDriver *CanOpenBus::canBusDriver() const
+const CanFrameJournal *CanOpenBus::frameJournal() const
 {
-    return _canBusDriver;
+    return &_frameJournal;
 }
 
+bool CanOpenBus::hasDriver() const
+{
+    return _hasDriver;
+}
+
+/**
+ * @brief Adress of the driver given at its creation, the driver itself is only reachable through the bus
+ */
+const QString &CanOpenBus::driverAdress() const
+{
+    return _driverAdress;
+}
+
+/**
+ * @brief Sets the bus driver, moved to the bus I/O thread and owned by the bus, the previous one is deleted
+ *
+ * The driver must not be used directly once set, connection is requested with
+ * connectDevice() / disconnectDevice() and frames are written with writeFrame().
+ */
 void CanOpenBus::setCanBusDriver(CanBusDriver *canBusDriver)
 {
-    if (_canBusDriver != nullptr)
-    {
-        _canBusDriver->deleteLater();
-    }
+    _hasDriver = (canBusDriver != nullptr);
+    _driverAdress = _hasDriver ? canBusDriver->adress() : QString();
+    _worker->setDriver(canBusDriver);
+}
 
-    _canBusDriver = canBusDriver;
-    if (_canBusDriver != nullptr)
-    {
-        if (_canBusDriver->state() == CanBusDriver::DISCONNECTED)
-        {
-            _canBusDriver->connectDevice();
-        }
-        connect(_canBusDriver, &CanBusDriver::framesReceived, this, &CanOpenBus::canFrameRec, Qt::UniqueConnection);
-        connect(_canBusDriver, &CanBusDriver::stateChanged, this, &CanOpenBus::updateState);
-    }
+void CanOpenBus::connectDevice()
+{
+    _worker->connectDevice();
+}
+
+void CanOpenBus::disconnectDevice()
+{
+    _worker->disconnectDevice();
 }
 
 bool CanOpenBus::isConnected() const
 {
-    if (_canBusDriver == nullptr)
+    if (!_hasDriver)
     {
         return false;
     }
-    return (_canBusDriver->state() == CanBusDriver::CONNECTED);
+    return (_worker->state() == CanBusDriver::CONNECTED);
 }
 
 bool CanOpenBus::canWrite() const
 {
-    return !((_canBusDriver == nullptr) || _spyMode);
+    return _hasDriver && !_spyMode;
 }
 
-bool CanOpenBus::writeFrame(const QCanBusFrame &frame)
+bool CanOpenBus::writeFrame(const CanFrame &frame)
 {
     if (!canWrite())
     {
         return false;
     }
-    _canBusDriver->writeFrame(frame);
-    QCanBusFrame emitFrame = frame;
-    emitFrame.setTimeStamp(QCanBusFrame::TimeStamp::fromMicroSeconds(QDateTime::currentMSecsSinceEpoch() * 1000));
-    emitFrame.setLocalEcho(true);
-    _canFramesLog.append(emitFrame);
+    if (!_worker->postFrame(frame))
+    {
+        return false;
+    }
+    journalSentFrame(frame);
     return true;
 }
 
+/**
+ * @brief Writes a batch of frames, queued at once and given together to the driver
+ * @return false if the batch was not queued
+ */
+bool CanOpenBus::writeFrames(const CanFrame *frames, int count)
+{
+    if (!canWrite())
+    {
+        return false;
+    }
+    if (!_worker->postFrames(frames, count))
+    {
+        return false;
+    }
+
+    qint64 timeStamp = QDateTime::currentMSecsSinceEpoch() * 1000;
+    for (int i = 0; i < count; i++)
+    {
+        CanFrame emitFrame = frames[i];
+        emitFrame.setTimeStamp(timeStamp);
+        emitFrame.setLocalEcho(true);
+        _frameJournal.append(emitFrame);
+        accountFrame(emitFrame);
+    }
+    return true;
+}
+
+/**
+ * @brief Records a frame emitted without writeFrame(), directly posted to the worker by another thread
+ */
+void CanOpenBus::journalSentFrame(const CanFrame &frame)
+{
+    CanFrame emitFrame = frame;
+    emitFrame.setTimeStamp(QDateTime::currentMSecsSinceEpoch() * 1000);
+    emitFrame.setLocalEcho(true);
+    _frameJournal.append(emitFrame);
+    accountFrame(emitFrame);
+}
+
+/**
+ * @brief I/O worker of the bus, frames can be posted to it from any thread
+ */
+CanOpenBusWorker *CanOpenBus::worker() const
+{
+    return _worker;
+}
+
 ServiceDispatcher *CanOpenBus::dispatcher() const
 {
     return _serviceDispatcher;
@@ -222,33 +298,137 @@ Sync *CanOpenBus::sync() const
     return _sync;
 }
 
-void CanOpenBus::canFrameRec()
+NodeDiscover *CanOpenBus::nodeDiscover() const
 {
-    if (_canBusDriver == nullptr)
-    {
-        return;
-    }
+    return _nodeDiscover;
+}
 
-    QCanBusFrame frame = _canBusDriver->readFrame();
+RpdoProcessImage *CanOpenBus::rpdoProcessImage() const
+{
+    return _rpdoProcessImage;
+}
+
+void CanOpenBus::canFrameRec()
+{
+    CanFrame frame = _worker->takeFrame();
     while (frame.isValid())
     {
         _serviceDispatcher->parseFrame(frame);
-        _canFramesLog.append(frame);
+        _frameJournal.append(frame);
+        accountFrame(frame);
 
-        frame = _canBusDriver->readFrame();
+        frame = _worker->takeFrame();
     }
 }
 
+/**
+ * @brief Processes frames already received by the I/O thread but not yet by this thread
+ *
+ * To be called by protocol timeouts before they expire, a timer delayed by a
+ * busy thread may fire while the expected answer is waiting in the queue.
+ * @return true if frames were processed
+ */
+bool CanOpenBus::processPendingFrames()
+{
+    if (!_worker->hasPendingFrames())
+    {
+        return false;
+    }
+    canFrameRec();
+    return true;
+}
+
+/**
+ * @brief Number of received frames dropped because this thread did not process them fast enough
+ */
+quint32 CanOpenBus::droppedFrames() const
+{
+    return _worker->droppedRxFrames();
+}
+
 void CanOpenBus::notifyForNewFrames()
 {
-    if (_canFrameLogId < _canFramesLog.count())
+    updateBusLoad();
+
+    if (_canFrameLogId < _frameJournal.endId())
     {
-        _canFrameLogId = _canFramesLog.count();
+        _canFrameLogId = _frameJournal.endId();
         emit frameAvailable(_canFrameLogId);
     }
 }
 
+/**
+ * @brief Nominal bit rate used for the bus load estimation, in bit/s
+ */
+int CanOpenBus::bitRate() const
+{
+    return _bitRate;
+}
+
+/**
+ * @brief Sets the bit rate of the bus, for drivers unable to report it
+ *
+ * The bit rate reported by the driver on connection takes precedence, 1 Mbit/s
+ * is assumed until either is known.
+ */
+void CanOpenBus::setBitRate(int bitRate)
+{
+    if (bitRate > 0)
+    {
+        _bitRate = bitRate;
+    }
+}
+
+/**
+ * @brief Estimated bus load over the last 100 ms
+ * @return ratio between 0.0 and 1.0
+ */
+double CanOpenBus::busLoad() const
+{
+    return _busLoad;
+}
+
+double CanOpenBus::sdoBusLoadLimit() const
+{
+    return _sdoBusLoadLimit;
+}
+
+/**
+ * @brief Sets bus load above which SDO clients delay new transfers, 1.0 to disable
+ */
+void CanOpenBus::setSdoBusLoadLimit(double sdoBusLoadLimit)
+{
+    _sdoBusLoadLimit = sdoBusLoadLimit;
+}
+
+bool CanOpenBus::isSdoRateLimited() const
+{
+    return _busLoad > _sdoBusLoadLimit;
+}
+
+void CanOpenBus::accountFrame(const CanFrame &frame)
+{
+    // frame length in bits without bit stuffing
+    _busBitCount += static_cast<quint64>((frame.hasExtendedFrameFormat() ? 67 : 47) + 8 * frame.size());
+}
+
+void CanOpenBus::updateBusLoad()
+{
+    qint64 elapsedUs = _busLoadElapsed.nsecsElapsed() / 1000;
+    if (elapsedUs <= 0 || _bitRate <= 0)
+    {
+        return;
+    }
+    _busLoad = qMin(1.0, static_cast<double>(_busBitCount) * 1000000.0 / (static_cast<double>(_bitRate) * elapsedUs));
+    _busBitCount = 0;
+    _busLoadElapsed.restart();
+}
+
 void CanOpenBus::updateState()
 {
+    if (_worker->state() == CanBusDriver::CONNECTED)
+    {
+        setBitRate(_worker->bitRate());
+    }
     emit connectedChanged(isConnected());
 }
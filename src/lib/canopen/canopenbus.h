@@ -24,9 +24,12 @@
 #include <QObject>
 
 #include "busdriver/canbusdriver.h"
+#include "busdriver/canframejournal.h"
+#include "canopenbusworker.h"
 #include "node.h"
 #include "services/services.h"
 
+#include <QElapsedTimer>
 #include <QMap>
 
 class CanOpen;
@@ -49,24 +52,43 @@ public:
     void removeNode(Node *node);
     bool existNode(quint8 nodeId);
 
-    CanBusDriver *canBusDriver() const;
+    bool hasDriver() const;
+    const QString &driverAdress() const;
     void setCanBusDriver(CanBusDriver *canBusDriver);
     bool isConnected() const;
     bool canWrite() const;
-    bool writeFrame(const QCanBusFrame &frame);
-
-    const QList<QCanBusFrame> &canFramesLog() const;
-
+    bool writeFrame(const CanFrame &frame);
+    bool writeFrames(const CanFrame *frames, int count);
+    void journalSentFrame(const CanFrame &frame);
+    bool processPendingFrames();
+    quint32 droppedFrames() const;
+
+    // bus load estimation, used to rate limit SDO transfers
+    int bitRate() const;
+    void setBitRate(int bitRate);
+    double busLoad() const;
+    double sdoBusLoadLimit() const;
+    void setSdoBusLoadLimit(double sdoBusLoadLimit);
+    bool isSdoRateLimited() const;
+
+    CanFrameJournal *frameJournal();
+    const CanFrameJournal *frameJournal() const;
+
+    CanOpenBusWorker *worker() const;
     ServiceDispatcher *dispatcher() const;
     Sync *sync() const;
+    NodeDiscover *nodeDiscover() const;
+    RpdoProcessImage *rpdoProcessImage() const;
 
 public slots:
+    void connectDevice();
+    void disconnectDevice();
     void exploreBus();
     void stopAll();
     void setBusName(const QString &busName);
 
 signals:
-    void frameAvailable(int id);
+    void frameAvailable(quint64 endId);
 
     void nodeAboutToBeAdded(int nodeId);
     void nodeAdded(int nodeId);
@@ -89,17 +111,29 @@ protected:
     QString _busName;
     QMap<quint8, Node *> _nodesMap;
     QList<Node *> _nodes;
-    CanBusDriver *_canBusDriver;
+    bool _hasDriver;
+    QString _driverAdress;      // copied, the driver lives in the I/O thread
+    CanOpenBusWorker *_worker;  // driver I/O thread
 
     // CAN frames logger
-    QList<QCanBusFrame> _canFramesLog;
-    int _canFrameLogId;
+    CanFrameJournal _frameJournal;
+    quint64 _canFrameLogId;
     QTimer *_canFramesLogTimer;
 
+    // bus load
+    int _bitRate;
+    quint64 _busBitCount;
+    double _busLoad;
+    double _sdoBusLoadLimit;
+    QElapsedTimer _busLoadElapsed;
+    void accountFrame(const CanFrame &frame);
+    void updateBusLoad();
+
     // services
     ServiceDispatcher *_serviceDispatcher;
     NodeDiscover *_nodeDiscover;
     Sync *_sync;
+    RpdoProcessImage *_rpdoProcessImage;
     TimeStamp *_timestamp;
 
     // spy mode
@@ -0,0 +1,363 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "canopenbusworker.h"
+
+#include <QDateTime>
+
+CanOpenBusWorker::CanOpenBusWorker()
+{
+    qRegisterMetaType<CanBusDriver::State>("CanBusDriver::State");
+
+    _driver = nullptr;
+    _state.storeRelease(CanBusDriver::DISCONNECTED);
+    _bitRate.storeRelease(0);
+    _rxNotifyPending.storeRelease(0);
+    _txNotifyPending.storeRelease(0);
+    _txPosted.storeRelease(0);
+    _txWritten.storeRelease(0);
+    _txFailed.storeRelease(0);
+
+    _thread.setObjectName("CanOpenBusWorker");
+    moveToThread(&_thread);
+    _thread.start(QThread::TimeCriticalPriority);
+}
+
+/**
+ * @brief Disconnects and deletes the driver in the worker thread, then stops it
+ */
+CanOpenBusWorker::~CanOpenBusWorker()
+{
+    runInWorker(
+        [this]()
+        {
+            if (_driver != nullptr)
+            {
+                _driver->disconnectDevice();
+                delete _driver;
+                _driver = nullptr;
+            }
+        },
+        true);
+    _thread.quit();
+    _thread.wait();
+}
+
+/**
+ * @brief Takes ownership of a driver and moves it to the worker thread, the previous driver is deleted
+ *
+ * Must be called from the thread owning the driver. The driver is connected if it is not,
+ * connection management calls return once done by the worker.
+ */
+void CanOpenBusWorker::setDriver(CanBusDriver *driver)
+{
+    if (driver != nullptr)
+    {
+        driver->setParent(nullptr);
+        driver->moveToThread(&_thread);
+    }
+
+    runInWorker(
+        [this, driver]()
+        {
+            if (_driver != nullptr)
+            {
+                _driver->disconnectDevice();
+                delete _driver;
+            }
+            _driver = driver;
+            if (_driver == nullptr)
+            {
+                updateState(CanBusDriver::DISCONNECTED);
+                return;
+            }
+
+            connect(_driver, &CanBusDriver::framesReceived, this, &CanOpenBusWorker::readFrames);
+            connect(_driver, &CanBusDriver::stateChanged, this, &CanOpenBusWorker::updateState);
+            if (_driver->state() == CanBusDriver::DISCONNECTED)
+            {
+                _driver->connectDevice();
+            }
+            updateState(_driver->state());
+        },
+        true);
+}
+
+void CanOpenBusWorker::connectDevice()
+{
+    runInWorker(
+        [this]()
+        {
+            if (_driver != nullptr)
+            {
+                _driver->connectDevice();
+            }
+        },
+        true);
+}
+
+void CanOpenBusWorker::disconnectDevice()
+{
+    runInWorker(
+        [this]()
+        {
+            if (_driver != nullptr)
+            {
+                _driver->disconnectDevice();
+            }
+        },
+        true);
+}
+
+CanBusDriver::State CanOpenBusWorker::state() const
+{
+    return static_cast<CanBusDriver::State>(_state.loadAcquire());
+}
+
+/**
+ * @brief Bit rate reported by the driver at the last connection, 0 if unknown
+ */
+int CanOpenBusWorker::bitRate() const
+{
+    return _bitRate.loadAcquire();
+}
+
+/**
+ * @brief Queues a frame to be written by the worker thread, thread safe
+ * @return false if the emission queue is full
+ */
+bool CanOpenBusWorker::postFrame(const CanFrame &frame)
+{
+    {
+        QMutexLocker locker(&_txMutex);
+        if (!_txRing.push(frame))
+        {
+            return false;
+        }
+        _txPosted.fetchAndAddOrdered(1);
+    }
+
+    notifyWrite();
+    return true;
+}
+
+/**
+ * @brief Queues a batch of frames at once, thread safe
+ *
+ * The batch is either queued entirely or dropped, it is written by the worker
+ * with a single driver call when it fits in TxBatchSize.
+ * @return false if the emission queue has not enough room
+ */
+bool CanOpenBusWorker::postFrames(const CanFrame *frames, int count)
+{
+    if (count <= 0)
+    {
+        return true;
+    }
+
+    {
+        QMutexLocker locker(&_txMutex);
+        if (_txRing.writeAvailable() < static_cast<quint32>(count))
+        {
+            _txRing.addDropped(static_cast<quint32>(count));
+            return false;
+        }
+        for (int i = 0; i < count; i++)
+        {
+            *_txRing.writeSlot(static_cast<quint32>(i)) = frames[i];
+        }
+        _txRing.commit(static_cast<quint32>(count));
+        _txPosted.fetchAndAddOrdered(static_cast<quint32>(count));
+    }
+
+    notifyWrite();
+    return true;
+}
+
+/**
+ * @brief Wakes up the worker, one wakeup until it drained the emission queue
+ */
+void CanOpenBusWorker::notifyWrite()
+{
+    if (_txNotifyPending.testAndSetOrdered(0, 1))
+    {
+        QMetaObject::invokeMethod(this, &CanOpenBusWorker::writeFrames, Qt::QueuedConnection);
+    }
+}
+
+quint32 CanOpenBusWorker::droppedTxFrames() const
+{
+    return _txRing.dropped();
+}
+
+/**
+ * @brief Number of frames queued since the worker started, wraps around
+ */
+quint32 CanOpenBusWorker::txPostedCount() const
+{
+    return _txPosted.loadAcquire();
+}
+
+/**
+ * @brief Number of queued frames accepted by the driver, wraps around
+ *
+ * A frame queued when txPostedCount() was N has been processed once
+ * txWrittenCount() + txFailedCount() reached N + 1, it left the host if
+ * txFailedCount() did not change meanwhile.
+ */
+quint32 CanOpenBusWorker::txWrittenCount() const
+{
+    return _txWritten.loadAcquire();
+}
+
+/**
+ * @brief Number of queued frames the driver failed to write, wraps around
+ */
+quint32 CanOpenBusWorker::txFailedCount() const
+{
+    return _txFailed.loadAcquire();
+}
+
+/**
+ * @brief Number of frames queued and not yet handed to the driver
+ *
+ * Grows when the driver cannot write as fast as frames are posted, used by
+ * bulk transfers as back-pressure.
+ */
+quint32 CanOpenBusWorker::txPendingCount() const
+{
+    // processed counts first, posted count can only be greater or equal
+    const quint32 processed = txWrittenCount() + txFailedCount();
+    return txPostedCount() - processed;
+}
+
+bool CanOpenBusWorker::hasPendingFrames() const
+{
+    return !_rxRing.isEmpty();
+}
+
+/**
+ * @brief Pops the next received frame, lock-free, to be called from a single thread
+ * @return received frame or an InvalidFrame if no more frames are pending
+ */
+CanFrame CanOpenBusWorker::takeFrame()
+{
+    if (_rxRing.isEmpty())
+    {
+        // re-arm the wakeup before the last check, a frame published in between
+        // is either seen here or notified again
+        _rxNotifyPending.storeRelease(0);
+        if (_rxRing.isEmpty())
+        {
+            return CanFrame(CanFrame::InvalidFrame);
+        }
+    }
+
+    CanFrame frame = _rxRing.front();
+    _rxRing.pop();
+    return frame;
+}
+
+quint32 CanOpenBusWorker::droppedRxFrames() const
+{
+    return _rxRing.dropped();
+}
+
+void CanOpenBusWorker::readFrames()
+{
+    if (_driver == nullptr)
+    {
+        return;
+    }
+
+    bool received = false;
+    qint64 nowUs = 0;
+    CanFrame frame = _driver->readFrame();
+    while (frame.isValid())
+    {
+        if (frame.timeStamp() == 0)
+        {
+            if (nowUs == 0)
+            {
+                nowUs = QDateTime::currentMSecsSinceEpoch() * 1000;
+            }
+            frame.setTimeStamp(nowUs);
+        }
+        received |= _rxRing.push(frame);
+        frame = _driver->readFrame();
+    }
+
+    if (received && _rxNotifyPending.testAndSetOrdered(0, 1))
+    {
+        emit framesAvailable();
+    }
+}
+
+void CanOpenBusWorker::writeFrames()
+{
+    _txNotifyPending.storeRelease(0);
+
+    CanFrame batch[TxBatchSize];
+    while (!_txRing.isEmpty())
+    {
+        int count = 0;
+        while (count < TxBatchSize && !_txRing.isEmpty())
+        {
+            batch[count++] = _txRing.front();
+            _txRing.pop();
+        }
+
+        int written = 0;
+        if (_driver != nullptr)
+        {
+            written = _driver->writeFrames(batch, count);
+        }
+        if (written < count)
+        {
+            _txRing.addDropped(static_cast<quint32>(count - written));
+            _txFailed.fetchAndAddOrdered(static_cast<quint32>(count - written));
+        }
+        _txWritten.fetchAndAddOrdered(static_cast<quint32>(written));
+    }
+}
+
+void CanOpenBusWorker::updateState(CanBusDriver::State state)
+{
+    if (state == CanBusDriver::CONNECTED && _driver != nullptr)
+    {
+        _bitRate.storeRelease(_driver->bitRate());
+    }
+    if (_state.fetchAndStoreOrdered(state) != state)
+    {
+        emit stateChanged(state);
+    }
+}
+
+void CanOpenBusWorker::runInWorker(const std::function<void()> &function, bool blocking)
+{
+    if (QThread::currentThread() == &_thread)
+    {
+        function();
+        return;
+    }
+    if (!_thread.isRunning())
+    {
+        return;
+    }
+    QMetaObject::invokeMethod(this, function, blocking ? Qt::BlockingQueuedConnection : Qt::QueuedConnection);
+}
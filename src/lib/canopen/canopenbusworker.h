@@ -0,0 +1,108 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef CANOPENBUSWORKER_H
+#define CANOPENBUSWORKER_H
+
+#include "canopen_global.h"
+
+#include <QAtomicInteger>
+#include <QMutex>
+#include <QObject>
+#include <QThread>
+
+#include <functional>
+
+#include "busdriver/canbusdriver.h"
+#include "busdriver/canframering.h"
+
+/**
+ * @brief Bus I/O thread of a CanOpenBus
+ *
+ * The driver is moved to a dedicated thread, it is connected, read and written
+ * only from there. Received frames are drained from the driver as soon as it
+ * signals them, time stamped if the driver did not, and published to the bus
+ * thread through a lock-free ring with a single coalesced wakeup. Frames to
+ * emit are queued from any thread and written by the worker. Reception and
+ * emission do not depend on the load of the thread owning the bus.
+ */
+class CANOPEN_EXPORT CanOpenBusWorker : public QObject
+{
+    Q_OBJECT
+public:
+    CanOpenBusWorker();
+    ~CanOpenBusWorker() override;
+
+    enum
+    {
+        RxRingSize = 8192,
+        TxRingSize = 1024,
+        TxBatchSize = 64  // max frames given at once to the driver
+    };
+
+    void setDriver(CanBusDriver *driver);
+    void connectDevice();
+    void disconnectDevice();
+    CanBusDriver::State state() const;
+    int bitRate() const;
+
+    // any thread
+    bool postFrame(const CanFrame &frame);
+    bool postFrames(const CanFrame *frames, int count);
+    quint32 droppedTxFrames() const;
+    quint32 txPostedCount() const;
+    quint32 txWrittenCount() const;
+    quint32 txFailedCount() const;
+    quint32 txPendingCount() const;
+
+    // bus thread
+    bool hasPendingFrames() const;
+    CanFrame takeFrame();
+    quint32 droppedRxFrames() const;
+
+signals:
+    void framesAvailable();
+    void stateChanged(CanBusDriver::State state);
+
+protected slots:
+    void readFrames();
+    void writeFrames();
+    void updateState(CanBusDriver::State state);
+
+private:
+    QThread _thread;
+    CanBusDriver *_driver;  // only used from worker thread
+    QAtomicInt _state;
+    QAtomicInt _bitRate;  // reported by the driver on connection
+
+    CanFrameRing<CanFrame, RxRingSize> _rxRing;
+    QAtomicInt _rxNotifyPending;
+
+    CanFrameRing<CanFrame, TxRingSize> _txRing;
+    QMutex _txMutex;  // serializes producers, the ring is single producer
+    QAtomicInt _txNotifyPending;
+    QAtomicInteger<quint32> _txPosted;   // frames queued since start, wraps
+    QAtomicInteger<quint32> _txWritten;  // frames accepted by the driver since start, wraps
+    QAtomicInteger<quint32> _txFailed;   // frames refused by the driver since start, wraps
+
+    void notifyWrite();
+
+    void runInWorker(const std::function<void()> &function, bool blocking = false);
+};
+
+#endif  // CANOPENBUSWORKER_H
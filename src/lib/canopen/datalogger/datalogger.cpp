@@ -19,16 +19,14 @@
 #include "datalogger.h"
 
 #include <QDebug>
-#include <QFile>
-#include <QTextStream>
 
 #include "db/odindexdb.h"
 
 DataLogger::DataLogger(QObject *parent)
     : QObject(parent)
 {
-    _timer.setTimerType(Qt::PreciseTimer);
-    connect(&_timer, &QTimer::timeout, this, &DataLogger::readData);
+    _logPeriodMs = 0;
+    _captureFile = nullptr;
 
     _timerNotify.setInterval(100);
     connect(&_timerNotify, &QTimer::timeout, this, &DataLogger::notify);
@@ -36,12 +34,13 @@ DataLogger::DataLogger(QObject *parent)
 
 DataLogger::~DataLogger()
 {
+    stopCapture();
     removeAllData();
 }
 
 bool DataLogger::isStarted() const
 {
-    return _timer.isActive();
+    return _logPeriodMs > 0;
 }
 
 void DataLogger::addData(const NodeObjectId &objId)
@@ -97,20 +96,13 @@ void DataLogger::removeData(const NodeObjectId &objId)
     {
         return;
     }
-
-    emit dataAboutToBeRemoved(_dataList.indexOf(dlData));
-
-    _dataMap.remove(dlData->key());
-    _dataList.removeOne(dlData);
-    unRegisterObjId(dlData->objectId());
-    delete dlData;
-
-    emit dataRemoved();
+    removeDlData(dlData);
 }
 
 void DataLogger::removeAllData()
 {
-    for (DLData *dlData : qAsConst(_dataList))
+    const QList<DLData *> dataList = _dataList;  // removeData modifies _dataList
+    for (DLData *dlData : dataList)
     {
         removeData(dlData->objectId());
     }
@@ -131,6 +123,15 @@ DLData *DataLogger::data(const NodeObjectId &objId) const
     return _dataMap.value(objId.key());
 }
 
+/**
+ * @brief Enables or disables logging of a data, an inactive data is not polled anymore
+ */
+void DataLogger::setDataActive(DLData *dlData, bool active)
+{
+    dlData->setActive(active);
+    updateRefreshPeriod(dlData);
+}
+
 qreal DataLogger::min() const
 {
     qreal min = std::numeric_limits<int>::max();
@@ -162,6 +163,24 @@ void DataLogger::range(qreal &min, qreal &max) const
     }
 }
 
+/**
+ * @brief Range of values with a time stamp in [fromUs, toUs[, time stamps in micro seconds since epoch
+ */
+void DataLogger::range(qint64 fromUs, qint64 toUs, qreal &min, qreal &max) const
+{
+    min = std::numeric_limits<int>::max();
+    max = std::numeric_limits<int>::min();
+    for (DLData *dlData : _dataList)
+    {
+        const DLTimeSeries::Summary summary = dlData->series().summary(fromUs, toUs);
+        if (summary.count > 0)
+        {
+            min = qMin(summary.min, min);
+            max = qMax(summary.max, max);
+        }
+    }
+}
+
 QDateTime DataLogger::firstDateTime() const
 {
     QDateTime first;
@@ -202,78 +221,175 @@ QDateTime DataLogger::lastDateTime() const
 
 void DataLogger::addDataValue(DLData *dlData, const QVariant &value, const QDateTime &dateTime)
 {
-    double valueDouble = value.toDouble();
+    addDataValue(dlData, value.toDouble(), dateTime.toMSecsSinceEpoch() * 1000);
+}
 
+/**
+ * @brief Appends a raw value to dlData, Q15.16 conversion and scale are applied
+ * @param timeUs time stamp in micro seconds since epoch
+ */
+void DataLogger::addDataValue(DLData *dlData, double value, qint64 timeUs)
+{
     if (dlData->isQ1516())
     {
-        valueDouble /= 65536.0;
+        value /= 65536.0;
     }
-    valueDouble *= dlData->scale();
+    value *= dlData->scale();
 
-    dlData->appendData(valueDouble, dateTime);
+    dlData->appendData(value, timeUs);
+    if (_captureFile != nullptr)
+    {
+        _captureFile->append(_captureChannels.value(dlData, -1), dlData->series().lastTime(), dlData->lastValue());
+    }
 
     dlData->setHasChanged(true);
 }
 
+/**
+ * @brief Exports all data to a CSV file, one row per ms, see DLExport::exportCSV
+ */
 void DataLogger::exportCSVData(const QString &fileName)
 {
-    QList<quint64> timeStamps;
-    QVector<QMap<quint64, double>> maps(_dataList.count());
-    uint dlDataId = 0;
+    const QList<DLExport::Column> columns = exportColumns();
+    DLExport::exportCSV(columns, fileName);
+    for (const DLExport::Column &column : columns)
+    {
+        delete column.cursor;
+    }
+}
+
+/**
+ * @brief Exports all data as numpy columns in directory, see DLExport::exportColumns
+ */
+bool DataLogger::exportColumnData(const QString &directory)
+{
+    const QList<DLExport::Column> columns = exportColumns();
+    bool ok = DLExport::exportColumns(columns, directory);
+    for (const DLExport::Column &column : columns)
+    {
+        delete column.cursor;
+    }
+    return ok;
+}
+
+QList<DLExport::Column> DataLogger::exportColumns() const
+{
+    QList<DLExport::Column> columns;
     for (DLData *dlData : _dataList)
     {
-        int minCount = qMin(dlData->values().count(), dlData->times().count());
-        for (int i = 0; i < minCount; i++)
+        columns.append({dlData->name() + " (" + dlData->unit() + ")", new DLSeriesCursor(dlData->series())});
+    }
+    return columns;
+}
+
+/**
+ * @brief Streams all values logged from now to a capture file, values already logged are not written
+ * @return false if the file cannot be created
+ */
+bool DataLogger::startCapture(const QString &fileName)
+{
+    stopCapture();
+
+    _captureFile = new DLCaptureFile();
+    if (!_captureFile->create(fileName))
+    {
+        delete _captureFile;
+        _captureFile = nullptr;
+        return false;
+    }
+    for (DLData *dlData : qAsConst(_dataList))
+    {
+        if (!_offlineData.contains(dlData))
         {
-            quint64 time = dlData->times()[i].toMSecsSinceEpoch();
-            maps[dlDataId].insert(time, dlData->values()[i]);
-            timeStamps.append(time);
+            addCaptureChannel(dlData);
         }
-        dlDataId++;
     }
+    emit captureChanged(true);
+    return true;
+}
 
-    // sort timestamps and make it unique
-    std::sort(timeStamps.begin(), timeStamps.end());
-    auto last = std::unique(timeStamps.begin(), timeStamps.end());
-    timeStamps.erase(last, timeStamps.end());
-
-    QFile file(fileName);
-    if (!file.open(QIODevice::WriteOnly))
+void DataLogger::stopCapture()
+{
+    if (_captureFile == nullptr)
     {
         return;
     }
+    _captureFile->close();
+    delete _captureFile;
+    _captureFile = nullptr;
+    _captureChannels.clear();
+    emit captureChanged(false);
+}
 
-    QTextStream stream(&file);
-    stream << "Time (s)"
-           << ";";
-    for (DLData *dlData : _dataList)
+bool DataLogger::isCapturing() const
+{
+    return _captureFile != nullptr;
+}
+
+QString DataLogger::captureFileName() const
+{
+    if (_captureFile == nullptr)
     {
-        stream << dlData->name() << " (" << dlData->unit() << ")"
-               << ";";
+        return QString();
     }
-    stream << '\n';
+    return _captureFile->fileName();
+}
 
-    quint64 firstDateTime = timeStamps.first();
-    for (quint64 time : timeStamps)
+/**
+ * @brief Replaces all data with the content of a capture file, for offline viewing
+ * @return false if the file cannot be read
+ */
+bool DataLogger::loadCapture(const QString &fileName)
+{
+    DLCaptureFile captureFile;
+    if (!captureFile.open(fileName))
     {
-        stream << static_cast<double>(time - firstDateTime) / 1000.0 << ';';
-        for (const auto &mapValues : maps)
+        return false;
+    }
+
+    stop();
+    stopCapture();
+    removeAllData();
+
+    for (int channel = 0; channel < captureFile.channels().count(); channel++)
+    {
+        const DLCaptureFile::Channel &captureChannel = captureFile.channels().at(channel);
+        if (_dataMap.contains(captureChannel.objectId.key()))
         {
-            auto it = mapValues.constFind(time);
-            if (it != mapValues.constEnd())
-            {
-                stream << QString::number(*it, 'f');
-            }
-            stream << ";";
+            continue;
         }
-        stream << '\n';
+        DLData *dlData = addDlData(captureChannel.objectId, false);
+        dlData->setName(captureChannel.name);
+        dlData->setUnit(captureChannel.unit);
+        dlData->setScale(captureChannel.scale);
+        dlData->setQ1516(captureChannel.q1516);
+
+        // values are stored converted
+        DLSampleCursor *cursor = captureFile.cursor(channel);
+        for (; !cursor->atEnd(); cursor->next())
+        {
+            dlData->appendData(cursor->value(), cursor->time());
+        }
+        delete cursor;
+        emit dataChanged(_dataList.indexOf(dlData));
     }
-    file.close();
+    return true;
+}
+
+void DataLogger::addCaptureChannel(DLData *dlData)
+{
+    DLCaptureFile::Channel channel;
+    channel.objectId = dlData->objectId();
+    channel.name = dlData->name();
+    channel.unit = dlData->unit();
+    channel.scale = dlData->scale();
+    channel.q1516 = dlData->isQ1516();
+    _captureChannels.insert(dlData, _captureFile->addChannel(channel));
 }
 
 void DataLogger::odNotify(const NodeObjectId &objId, NodeOd::FlagsRequest flags)
 {
-    if (!_timer.isActive())
+    if (!isStarted())
     {
         return;
     }
@@ -284,22 +400,35 @@ void DataLogger::odNotify(const NodeObjectId &objId, NodeOd::FlagsRequest flags)
         return;
     }
 
-    const QVariant &value = dlData->nodeSubIndex()->value();
-    const QDateTime &dateTime = dlData->nodeSubIndex()->lastModification();
-    addDataValue(dlData, value, dateTime);
+    const NodeSubIndex *nodeSubIndex = dlData->nodeSubIndex();
+    const NodeValue &nodeValue = nodeSubIndex->nodeValue();
+    double value = nodeValue.isValid() ? nodeValue.toDouble() : nodeSubIndex->value().toDouble();
+    addDataValue(dlData, value, nodeSubIndex->timeStamp());
 }
 
+/**
+ * @brief Starts logging, data are refreshed by their node at the given period
+ * @param ms period in ms
+ */
 void DataLogger::start(int ms)
 {
     _timerNotify.start();
-    _timer.start(ms);
+    _logPeriodMs = qMax(ms, 1);
+    for (DLData *dlData : qAsConst(_dataList))
+    {
+        updateRefreshPeriod(dlData);
+    }
     emit startChanged(true);
 }
 
 void DataLogger::stop()
 {
     _timerNotify.stop();
-    _timer.stop();
+    _logPeriodMs = 0;
+    for (DLData *dlData : qAsConst(_dataList))
+    {
+        updateRefreshPeriod(dlData);
+    }
     emit startChanged(false);
 }
 
@@ -314,19 +443,13 @@ void DataLogger::clear()
     }
 }
 
-void DataLogger::readData()
+void DataLogger::notify()
 {
-    for (DLData *dlData : qAsConst(_dataList))
+    if (_captureFile != nullptr)
     {
-        if ((dlData->node() != nullptr) && dlData->isActive())
-        {
-            dlData->node()->readObject(dlData->objectId());
-        }
+        _captureFile->flush(1000);
     }
-}
 
-void DataLogger::notify()
-{
     for (DLData *dlData : qAsConst(_dataList))
     {
         if (dlData->hasChanged())
@@ -337,7 +460,11 @@ void DataLogger::notify()
     }
 }
 
-void DataLogger::addDlData(const NodeObjectId &mobjId)
+/**
+ * @brief Adds a data to the logger
+ * @param live false for data loaded from a capture, neither subscribed to its node nor polled
+ */
+DLData *DataLogger::addDlData(const NodeObjectId &mobjId, bool live)
 {
     // TODO optimize emit signal
     emit dataAboutToBeAdded(_dataList.count());
@@ -346,16 +473,62 @@ void DataLogger::addDlData(const NodeObjectId &mobjId)
     dlData->setActive(true);
     _dataMap.insert(dlData->key(), dlData);
     _dataList.append(dlData);
+    if (!live)
+    {
+        _offlineData.insert(dlData);
+        emit dataAdded();
+        return dlData;
+    }
+
     registerObjId(dlData->objectId());
+    updateRefreshPeriod(dlData);
+    if (_captureFile != nullptr)
+    {
+        addCaptureChannel(dlData);
+    }
     emit dataAdded();
 
+    if (dlData->node() == nullptr)
+    {
+        return dlData;  // offline data
+    }
     connect(dlData->node(),
             &QObject::destroyed,
             this,
             [=]()
             {
-                removeData(mobjId);
+                DLData *removedData = data(mobjId);
+                if (removedData != nullptr)
+                {
+                    removeDlData(removedData);
+                }
             });
+    return dlData;
+}
+
+void DataLogger::removeDlData(DLData *dlData)
+{
+    emit dataAboutToBeRemoved(_dataList.indexOf(dlData));
+
+    _dataMap.remove(dlData->key());
+    _dataList.removeOne(dlData);
+    _captureChannels.remove(dlData);
+    if (!_offlineData.remove(dlData))
+    {
+        unRegisterObjId(dlData->objectId());
+    }
+    delete dlData;
+
+    emit dataRemoved();
+}
+
+void DataLogger::updateRefreshPeriod(DLData *dlData)
+{
+    if (_offlineData.contains(dlData))
+    {
+        return;
+    }
+    setRefreshPeriod(dlData->objectId(), (isStarted() && dlData->isActive()) ? _logPeriodMs : 0);
 }
 
 QColor DataLogger::findFreeColor() const
@@ -23,8 +23,12 @@
 
 #include "nodeodsubscriber.h"
 
+#include "dlcapturefile.h"
 #include "dldata.h"
+#include "dlexport.h"
+#include <QHash>
 #include <QMap>
+#include <QSet>
 
 class CANOPEN_EXPORT DataLogger : public QObject, public NodeOdSubscriber
 {
@@ -42,17 +46,28 @@ public:
     QList<DLData *> &dataList();
     DLData *data(int index) const;
     DLData *data(const NodeObjectId &objId) const;
+    void setDataActive(DLData *dlData, bool active);
 
     qreal min() const;
     qreal max() const;
     void range(qreal &min, qreal &max) const;
+    void range(qint64 fromUs, qint64 toUs, qreal &min, qreal &max) const;
 
     QDateTime firstDateTime() const;
     QDateTime lastDateTime() const;
 
     void addDataValue(DLData *dlData, const QVariant &value, const QDateTime &dateTime);
+    void addDataValue(DLData *dlData, double value, qint64 timeUs);
 
     void exportCSVData(const QString &fileName);
+    bool exportColumnData(const QString &directory);
+
+    // capture to file
+    bool startCapture(const QString &fileName);
+    void stopCapture();
+    bool isCapturing() const;
+    QString captureFileName() const;
+    bool loadCapture(const QString &fileName);
 
 signals:
     void valueChanged(int id);
@@ -63,6 +78,7 @@ signals:
     void dataRemoved();
 
     void startChanged(bool);
+    void captureChanged(bool);
 
 public slots:
     void start(int ms);
@@ -70,16 +86,23 @@ public slots:
     void clear();
 
 protected slots:
-    void readData();
     void notify();
 
 protected:
-    void addDlData(const NodeObjectId &mobjId);
+    DLData *addDlData(const NodeObjectId &mobjId, bool live = true);
+    void removeDlData(DLData *dlData);
+    void updateRefreshPeriod(DLData *dlData);
     QMap<quint64, DLData *> _dataMap;
     QList<DLData *> _dataList;
-    QTimer _timer;
+    int _logPeriodMs;  // 0 when stopped
     QTimer _timerNotify;
 
+    DLCaptureFile *_captureFile;  // nullptr if not capturing
+    QHash<DLData *, int> _captureChannels;
+    QSet<DLData *> _offlineData;  // loaded from a capture, not fed by nodes
+    void addCaptureChannel(DLData *dlData);
+    QList<DLExport::Column> exportColumns() const;
+
     QColor findFreeColor() const;
     bool isColorFree(const QColor &color) const;
 
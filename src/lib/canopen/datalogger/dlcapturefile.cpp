@@ -0,0 +1,418 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "dlcapturefile.h"
+
+#include "dlexport.h"
+
+#include <QDataStream>
+#include <QtEndian>
+
+#include <cstring>
+
+#define DLCAPTURE_MAGIC 0x434C4455U  // 'UDLC'
+#define DLCAPTURE_VERSION 1U
+#define DLCAPTURE_HEADER_SIZE 8
+#define DLCAPTURE_BLOCK_HEADER_SIZE 8
+
+static double doubleFromLittleEndian(const uchar *src)
+{
+    const quint64 bits = qFromLittleEndian<quint64>(src);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Cursor over the sample blocks of a channel in a mapped file
+ */
+class DLCaptureFile::Cursor : public DLSampleCursor
+{
+public:
+    Cursor(const uchar *data, const QVector<SampleBlock> &blocks)
+        : _data(data)
+        , _blocks(blocks)
+    {
+        _block = 0;
+        _index = 0;
+    }
+
+    bool atEnd() const override
+    {
+        return _block >= _blocks.count();
+    }
+
+    qint64 time() const override
+    {
+        const SampleBlock &block = _blocks.at(_block);
+        return qFromLittleEndian<qint64>(_data + block.offset + _index * 8);
+    }
+
+    double value() const override
+    {
+        const SampleBlock &block = _blocks.at(_block);
+        return doubleFromLittleEndian(_data + block.offset + (block.count + _index) * 8);
+    }
+
+    void next() override
+    {
+        _index++;
+        if (_index >= _blocks.at(_block).count)
+        {
+            _index = 0;
+            _block++;
+        }
+    }
+
+private:
+    const uchar *_data;
+    const QVector<SampleBlock> &_blocks;
+    int _block;
+    int _index;
+};
+
+DLCaptureFile::DLCaptureFile()
+{
+    _mode = MODE_CLOSED;
+    _data = nullptr;
+    _size = 0;
+}
+
+DLCaptureFile::~DLCaptureFile()
+{
+    close();
+}
+
+const QString &DLCaptureFile::fileName() const
+{
+    return _fileName;
+}
+
+bool DLCaptureFile::isOpen() const
+{
+    return _mode != MODE_CLOSED;
+}
+
+/**
+ * @brief Closes the file, pending samples are written first
+ */
+void DLCaptureFile::close()
+{
+    if (_mode == MODE_WRITING)
+    {
+        flush();
+    }
+    if (_mode == MODE_READING && _readData.isEmpty() && _data != nullptr)
+    {
+        _file.unmap(const_cast<uchar *>(_data));
+    }
+    _file.close();
+    _mode = MODE_CLOSED;
+    _channels.clear();
+    _pending.clear();
+    _blocks.clear();
+    _readData.clear();
+    _data = nullptr;
+    _size = 0;
+}
+
+/**
+ * @brief Creates a capture file, overwritten if it exists
+ * @return false if the file cannot be created
+ */
+bool DLCaptureFile::create(const QString &fileName)
+{
+    close();
+    _file.setFileName(fileName);
+    if (!_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return false;
+    }
+    _fileName = fileName;
+    _mode = MODE_WRITING;
+
+    uchar header[DLCAPTURE_HEADER_SIZE];
+    qToLittleEndian<quint32>(DLCAPTURE_MAGIC, header);
+    qToLittleEndian<quint32>(DLCAPTURE_VERSION, header + 4);
+    _file.write(reinterpret_cast<const char *>(header), DLCAPTURE_HEADER_SIZE);
+    _flushTimer.start();
+    return true;
+}
+
+/**
+ * @brief Declares a new channel
+ * @return channel id to append samples to, -1 if not writing
+ */
+int DLCaptureFile::addChannel(const Channel &channel)
+{
+    if (_mode != MODE_WRITING)
+    {
+        return -1;
+    }
+
+    const int id = _channels.count();
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream << static_cast<quint32>(id) << channel.objectId.busId() << channel.objectId.nodeId() << channel.objectId.index() << channel.objectId.subIndex();
+    stream << channel.name << channel.unit << channel.scale << channel.q1516;
+    writeBlock(BLOCK_CHANNEL, payload);
+
+    _channels.append(channel);
+    _pending.append(PendingSamples());
+    _pending.last().times.reserve(SamplesPerBlock);
+    _pending.last().values.reserve(SamplesPerBlock);
+    return id;
+}
+
+/**
+ * @brief Appends a sample to a channel, written once a block is full or on flush
+ * @param timeUs time stamp in us since epoch, not lower than the previous one of the channel
+ */
+void DLCaptureFile::append(int channel, qint64 timeUs, double value)
+{
+    if (_mode != MODE_WRITING || channel < 0 || channel >= _pending.count())
+    {
+        return;
+    }
+
+    PendingSamples &pending = _pending[channel];
+    pending.times.append(timeUs);
+    pending.values.append(value);
+    if (pending.times.count() >= SamplesPerBlock)
+    {
+        writeSamples(channel);
+    }
+}
+
+/**
+ * @brief Writes pending samples of all channels if the last flush is older than maxAgeMs
+ */
+void DLCaptureFile::flush(int maxAgeMs)
+{
+    if (_mode != MODE_WRITING || (maxAgeMs > 0 && !_flushTimer.hasExpired(maxAgeMs)))
+    {
+        return;
+    }
+
+    for (int channel = 0; channel < _pending.count(); channel++)
+    {
+        writeSamples(channel);
+    }
+    _file.flush();
+    _flushTimer.restart();
+}
+
+void DLCaptureFile::writeBlock(BlockType type, const QByteArray &payload)
+{
+    uchar header[DLCAPTURE_BLOCK_HEADER_SIZE];
+    qToLittleEndian<quint32>(type, header);
+    qToLittleEndian<quint32>(static_cast<quint32>(payload.size()), header + 4);
+    _file.write(reinterpret_cast<const char *>(header), DLCAPTURE_BLOCK_HEADER_SIZE);
+    _file.write(payload);
+}
+
+void DLCaptureFile::writeSamples(int channel)
+{
+    PendingSamples &pending = _pending[channel];
+    const int count = pending.times.count();
+    if (count == 0)
+    {
+        return;
+    }
+
+    QByteArray payload(8 + count * 16, Qt::Uninitialized);
+    uchar *dest = reinterpret_cast<uchar *>(payload.data());
+    qToLittleEndian<quint32>(static_cast<quint32>(channel), dest);
+    qToLittleEndian<quint32>(static_cast<quint32>(count), dest + 4);
+    dest += 8;
+    for (int i = 0; i < count; i++)
+    {
+        qToLittleEndian<qint64>(pending.times.at(i), dest + i * 8);
+    }
+    dest += count * 8;
+    for (int i = 0; i < count; i++)
+    {
+        quint64 bits;
+        memcpy(&bits, &pending.values.at(i), sizeof(bits));
+        qToLittleEndian<quint64>(bits, dest + i * 8);
+    }
+    writeBlock(BLOCK_SAMPLES, payload);
+
+    pending.times.clear();
+    pending.values.clear();
+}
+
+/**
+ * @brief Opens a capture file for reading, the file may still be written by a logger
+ * @return false if the file cannot be read or is not a capture file
+ */
+bool DLCaptureFile::open(const QString &fileName)
+{
+    close();
+    _file.setFileName(fileName);
+    if (!_file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    _fileName = fileName;
+    _mode = MODE_READING;
+
+    _size = _file.size();
+    _data = _file.map(0, _size);
+    if (_data == nullptr)
+    {
+        _readData = _file.readAll();
+        _data = reinterpret_cast<const uchar *>(_readData.constData());
+        _size = _readData.size();
+    }
+
+    if (!readBlocks())
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool DLCaptureFile::readBlocks()
+{
+    if (_size < DLCAPTURE_HEADER_SIZE || qFromLittleEndian<quint32>(_data) != DLCAPTURE_MAGIC
+        || qFromLittleEndian<quint32>(_data + 4) != DLCAPTURE_VERSION)
+    {
+        return false;
+    }
+
+    qint64 pos = DLCAPTURE_HEADER_SIZE;
+    while (pos + DLCAPTURE_BLOCK_HEADER_SIZE <= _size)
+    {
+        const quint32 type = qFromLittleEndian<quint32>(_data + pos);
+        const quint32 payloadSize = qFromLittleEndian<quint32>(_data + pos + 4);
+        const qint64 payloadPos = pos + DLCAPTURE_BLOCK_HEADER_SIZE;
+        if (payloadPos + payloadSize > _size)
+        {
+            break;  // truncated block
+        }
+
+        if (type == BLOCK_CHANNEL)
+        {
+            QByteArray payload = QByteArray::fromRawData(reinterpret_cast<const char *>(_data + payloadPos), static_cast<int>(payloadSize));
+            QDataStream stream(payload);
+            stream.setByteOrder(QDataStream::LittleEndian);
+            quint32 id;
+            quint8 busId;
+            quint8 nodeId;
+            quint16 index;
+            quint8 subIndex;
+            Channel channel;
+            stream >> id >> busId >> nodeId >> index >> subIndex;
+            stream >> channel.name >> channel.unit >> channel.scale >> channel.q1516;
+            if (stream.status() != QDataStream::Ok || id != static_cast<quint32>(_channels.count()))
+            {
+                break;
+            }
+            channel.objectId = NodeObjectId(busId, nodeId, index, subIndex);
+            _channels.append(channel);
+            _blocks.append(QVector<SampleBlock>());
+        }
+        else if (type == BLOCK_SAMPLES && payloadSize >= 8)
+        {
+            const quint32 channel = qFromLittleEndian<quint32>(_data + payloadPos);
+            const quint32 count = qFromLittleEndian<quint32>(_data + payloadPos + 4);
+            if (channel < static_cast<quint32>(_blocks.count()) && count > 0 && 8 + static_cast<qint64>(count) * 16 <= payloadSize)
+            {
+                SampleBlock block;
+                block.offset = payloadPos + 8;
+                block.count = static_cast<int>(count);
+                _blocks[static_cast<int>(channel)].append(block);
+            }
+        }
+        // unknown blocks are skipped
+
+        pos = payloadPos + payloadSize;
+    }
+    return true;
+}
+
+const QList<DLCaptureFile::Channel> &DLCaptureFile::channels() const
+{
+    return _channels;
+}
+
+qint64 DLCaptureFile::sampleCount(int channel) const
+{
+    qint64 count = 0;
+    if (channel < 0 || channel >= _blocks.count())
+    {
+        return 0;
+    }
+    for (const SampleBlock &block : _blocks.at(channel))
+    {
+        count += block.count;
+    }
+    return count;
+}
+
+/**
+ * @brief Cursor over the samples of a channel of an opened file, to be deleted by the caller
+ * and not used after the file is closed
+ */
+DLSampleCursor *DLCaptureFile::cursor(int channel) const
+{
+    if (_mode != MODE_READING || channel < 0 || channel >= _blocks.count())
+    {
+        return nullptr;
+    }
+    return new Cursor(_data, _blocks.at(channel));
+}
+
+/**
+ * @brief Exports all channels of an opened file to CSV, see DLExport::exportCSV
+ */
+bool DLCaptureFile::exportCSV(const QString &fileName) const
+{
+    QList<DLExport::Column> columns;
+    for (int channel = 0; channel < _channels.count(); channel++)
+    {
+        columns.append({_channels.at(channel).name + " (" + _channels.at(channel).unit + ")", cursor(channel)});
+    }
+    bool ok = DLExport::exportCSV(columns, fileName);
+    for (const DLExport::Column &column : qAsConst(columns))
+    {
+        delete column.cursor;
+    }
+    return ok;
+}
+
+/**
+ * @brief Exports all channels of an opened file as columns, see DLExport::exportColumns
+ */
+bool DLCaptureFile::exportColumns(const QString &directory) const
+{
+    QList<DLExport::Column> columns;
+    for (int channel = 0; channel < _channels.count(); channel++)
+    {
+        columns.append({_channels.at(channel).name, cursor(channel)});
+    }
+    bool ok = DLExport::exportColumns(columns, directory);
+    for (const DLExport::Column &column : qAsConst(columns))
+    {
+        delete column.cursor;
+    }
+    return ok;
+}
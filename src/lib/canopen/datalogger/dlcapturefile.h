@@ -0,0 +1,129 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef DLCAPTUREFILE_H
+#define DLCAPTUREFILE_H
+
+#include "canopen_global.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QList>
+#include <QVector>
+
+#include "nodeobjectid.h"
+
+class DLSampleCursor;
+
+/**
+ * @brief Append only binary capture of data logger channels
+ *
+ * The file starts with a magic and a version, followed by blocks, each one
+ * prefixed with its type and payload size. Channel blocks describe a channel
+ * (object id, name, unit, scale), sample blocks hold up to SamplesPerBlock
+ * samples of one channel stored by columns (time stamps then values, little
+ * endian). Samples blocks of a channel are time ordered. Channels can be added
+ * at any time and a file truncated by a crash is read up to its last complete
+ * block. Files are memory mapped for reading.
+ */
+class CANOPEN_EXPORT DLCaptureFile
+{
+public:
+    DLCaptureFile();
+    ~DLCaptureFile();
+
+    enum
+    {
+        SamplesPerBlock = 1024
+    };
+
+    struct Channel
+    {
+        NodeObjectId objectId;
+        QString name;
+        QString unit;
+        double scale;
+        bool q1516;
+    };
+
+    const QString &fileName() const;
+    bool isOpen() const;
+    void close();
+
+    // writing
+    bool create(const QString &fileName);
+    int addChannel(const Channel &channel);
+    void append(int channel, qint64 timeUs, double value);
+    void flush(int maxAgeMs = 0);
+
+    // reading
+    bool open(const QString &fileName);
+    const QList<Channel> &channels() const;
+    qint64 sampleCount(int channel) const;
+    DLSampleCursor *cursor(int channel) const;
+
+    bool exportCSV(const QString &fileName) const;
+    bool exportColumns(const QString &directory) const;
+
+private:
+    Q_DISABLE_COPY(DLCaptureFile)
+
+    enum Mode
+    {
+        MODE_CLOSED,
+        MODE_WRITING,
+        MODE_READING
+    };
+    enum BlockType : quint32
+    {
+        BLOCK_CHANNEL = 1,
+        BLOCK_SAMPLES = 2
+    };
+
+    QFile _file;
+    QString _fileName;
+    Mode _mode;
+    QList<Channel> _channels;
+
+    // writing, samples waiting for a full block or a flush
+    struct PendingSamples
+    {
+        QVector<qint64> times;
+        QVector<double> values;
+    };
+    QVector<PendingSamples> _pending;
+    QElapsedTimer _flushTimer;
+    void writeBlock(BlockType type, const QByteArray &payload);
+    void writeSamples(int channel);
+
+    // reading
+    const uchar *_data;
+    qint64 _size;
+    QByteArray _readData;  // used if the file cannot be mapped
+    struct SampleBlock
+    {
+        qint64 offset;  // offset of first time stamp
+        int count;
+    };
+    QVector<QVector<SampleBlock>> _blocks;
+    bool readBlocks();
+
+    class Cursor;
+};
+
+#endif  // DLCAPTUREFILE_H
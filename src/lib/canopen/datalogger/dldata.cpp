@@ -20,10 +20,10 @@
 
 #include "canopen.h"
 
+#include "dlexport.h"
 #include "indexdb.h"
 
 #include <QFile>
-#include <QTextStream>
 
 DLData::DLData(const NodeObjectId &objectId)
     : _objectId(objectId)
@@ -47,8 +47,6 @@ DLData::DLData(const NodeObjectId &objectId)
             _unit = _nodeSubIndex->unit();
         }
     }
-
-    resetMinMax();
 }
 
 const NodeObjectId &DLData::objectId() const
@@ -121,6 +119,9 @@ void DLData::setUnit(const QString &unit)
     _unit = unit;
 }
 
+/**
+ * @brief Exports the values in a CSV file, one row per sample, times in s relative to the first sample
+ */
 void DLData::exportCSVData(const QString &fileName)
 {
     QFile file(fileName);
@@ -129,18 +130,29 @@ void DLData::exportCSVData(const QString &fileName)
         return;
     }
 
-    quint64 firstDateTime = _times.first().toMSecsSinceEpoch();
-
-    QTextStream stream(&file);
-    stream << "Time (s)"
-           << ";" << _name << " (" << _unit << ")" << '\n';
+    QByteArray buffer;
+    buffer.reserve(1 << 17);
+    buffer.append("Time (s);");
+    buffer.append(QString(_name + " (" + _unit + ")").toUtf8());
+    buffer.append('\n');
 
-    int minCount = qMin(_values.count(), _times.count());
-    for (int i = 0; i < minCount; i++)
+    DLSeriesCursor cursor(_series);
+    const qint64 firstMs = cursor.atEnd() ? 0 : cursor.time() / 1000;
+    for (; !cursor.atEnd(); cursor.next())
     {
-        quint64 time = _times[i].toMSecsSinceEpoch() - firstDateTime;
-        stream << time / 1000.0 << ';' << QString::number(_values[i], 'f') << '\n';
+        buffer.append(QByteArray::number(static_cast<double>(cursor.time() / 1000 - firstMs) / 1000.0));
+        buffer.append(';');
+        buffer.append(QByteArray::number(cursor.value(), 'f'));
+        buffer.append('\n');
+
+        if (buffer.size() > (1 << 16))
+        {
+            file.write(buffer);
+            buffer.clear();
+        }
     }
+
+    file.write(buffer);
     file.close();
 }
 
@@ -156,90 +168,83 @@ void DLData::setHasChanged(bool hasChanged)
 
 double DLData::firstValue() const
 {
-    if (_values.isEmpty())
-    {
-        return 0.0;
-    }
-    return _values.first();
+    return _series.firstValue();
 }
 
 double DLData::lastValue() const
 {
-    if (_values.isEmpty())
-    {
-        return 0.0;
-    }
-    return _values.last();
+    return _series.lastValue();
 }
 
 int DLData::valuesCount() const
 {
-    return _values.size();
+    return _series.count();
 }
 
 QDateTime DLData::firstDateTime() const
 {
-    if (_values.isEmpty())
+    if (_series.isEmpty())
     {
         return QDateTime();
     }
-    return _times.first();
+    return QDateTime::fromMSecsSinceEpoch(_series.firstTime() / 1000);
 }
 
 QDateTime DLData::lastDateTime() const
 {
-    if (_values.isEmpty())
+    if (_series.isEmpty())
     {
         return QDateTime();
     }
-    return _times.last();
+    return QDateTime::fromMSecsSinceEpoch(_series.lastTime() / 1000);
 }
 
-const QList<qreal> &DLData::values() const
+const DLTimeSeries &DLData::series() const
 {
-    return _values;
+    return _series;
 }
 
-const QList<QDateTime> &DLData::times() const
+void DLData::appendData(qreal value, const QDateTime &dateTime)
 {
-    return _times;
+    _series.append(dateTime.toMSecsSinceEpoch() * 1000, value);
 }
 
-void DLData::appendData(qreal value, const QDateTime &dateTime)
+/**
+ * @brief Appends a value
+ * @param value value
+ * @param timeUs time stamp in micro seconds since epoch
+ */
+void DLData::appendData(qreal value, qint64 timeUs)
 {
-    _values.append(value);
-    _times.append(dateTime);
-
-    _min = qMin(_min, value);
-    _max = qMax(_max, value);
+    _series.append(timeUs, value);
 }
 
 void DLData::clear()
 {
-    _values.clear();
-    _times.clear();
-    resetMinMax();
+    _series.clear();
 }
 
 bool DLData::isEmpty() const
 {
-    return _values.isEmpty();
+    return _series.isEmpty();
 }
 
 qreal DLData::min() const
 {
-    return _min;
+    if (_series.isEmpty())
+    {
+        return std::numeric_limits<int>::max();
+    }
+    return _series.min();
 }
 
 qreal DLData::max() const
 {
-    return _max;
-}
-
-void DLData::resetMinMax()
-{
-    _min = std::numeric_limits<int>::max();
-    _max = std::numeric_limits<int>::min();
+    if (_series.isEmpty())
+    {
+        return std::numeric_limits<int>::min();
+    }
+    return _series.max();
 }
 
 bool DLData::isQ1516() const
@@ -25,6 +25,8 @@
 
 #include "node.h"
 
+#include "dltimeseries.h"
+
 #include <QColor>
 
 class CANOPEN_EXPORT DLData
@@ -48,24 +50,23 @@ public:
     void setColor(const QColor &color);
 
     // values and times access
-    const QList<qreal> &values() const;
+    const DLTimeSeries &series() const;
     double firstValue() const;
     double lastValue() const;
     int valuesCount() const;
 
-    const QList<QDateTime> &times() const;
     QDateTime firstDateTime() const;
     QDateTime lastDateTime() const;
 
     // add / remove dada
     void appendData(qreal value, const QDateTime &dateTime);
+    void appendData(qreal value, qint64 timeUs);
     void clear();
     bool isEmpty() const;
 
     // stats
     qreal min() const;
     qreal max() const;
-    void resetMinMax();
 
     bool isQ1516() const;
     void setQ1516(bool q1516);
@@ -92,11 +93,7 @@ protected:
     QColor _color;
     qreal _scale;
 
-    QList<qreal> _values;
-    QList<QDateTime> _times;
-
-    qreal _min;
-    qreal _max;
+    DLTimeSeries _series;
 
     bool _q1516;
     QString _unit;
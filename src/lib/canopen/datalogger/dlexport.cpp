@@ -0,0 +1,224 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "dlexport.h"
+
+#include "dltimeseries.h"
+
+#include <QDir>
+#include <QFile>
+#include <QRegExp>
+#include <QtEndian>
+
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <vector>
+
+DLSampleCursor::~DLSampleCursor()
+{
+}
+
+DLSeriesCursor::DLSeriesCursor(const DLTimeSeries &series)
+    : _series(series)
+{
+    _index = 0;
+}
+
+bool DLSeriesCursor::atEnd() const
+{
+    return _index >= _series.count();
+}
+
+qint64 DLSeriesCursor::time() const
+{
+    return _series.time(_index);
+}
+
+double DLSeriesCursor::value() const
+{
+    return _series.value(_index);
+}
+
+void DLSeriesCursor::next()
+{
+    _index++;
+}
+
+/**
+ * @brief Exports columns to a CSV file, one row per ms with a sample in at least one column
+ *
+ * Columns are merged with a k-way merge on their time stamps. Several samples of
+ * a column in the same ms are reduced to the last one, empty cells are left for
+ * columns without sample in the row ms. Cursors are consumed.
+ * @return false if the file cannot be written
+ */
+bool DLExport::exportCSV(const QList<Column> &columns, const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+
+    QByteArray buffer;
+    buffer.reserve(1 << 17);
+    buffer.append("Time (s);");
+    for (const Column &column : columns)
+    {
+        buffer.append(column.title.toUtf8());
+        buffer.append(';');
+    }
+    buffer.append('\n');
+
+    // heap of (ms, column) of the next sample of each column
+    typedef std::pair<qint64, int> HeapEntry;
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> heap;
+    for (int c = 0; c < columns.count(); c++)
+    {
+        if (!columns.at(c).cursor->atEnd())
+        {
+            heap.push(HeapEntry(columns.at(c).cursor->time() / 1000, c));
+        }
+    }
+
+    const qint64 firstMs = heap.empty() ? 0 : heap.top().first;
+    QVector<double> rowValues(columns.count());
+    QVector<bool> rowSet(columns.count(), false);
+    while (!heap.empty())
+    {
+        const qint64 rowMs = heap.top().first;
+        while (!heap.empty() && heap.top().first == rowMs)
+        {
+            const int c = heap.top().second;
+            heap.pop();
+
+            DLSampleCursor *cursor = columns.at(c).cursor;
+            do
+            {
+                rowValues[c] = cursor->value();
+                cursor->next();
+            } while (!cursor->atEnd() && cursor->time() / 1000 == rowMs);
+            rowSet[c] = true;
+
+            if (!cursor->atEnd())
+            {
+                heap.push(HeapEntry(cursor->time() / 1000, c));
+            }
+        }
+
+        buffer.append(QByteArray::number(static_cast<double>(rowMs - firstMs) / 1000.0, 'f', 3));
+        buffer.append(';');
+        for (int c = 0; c < columns.count(); c++)
+        {
+            if (rowSet[c])
+            {
+                buffer.append(QByteArray::number(rowValues[c], 'f'));
+                rowSet[c] = false;
+            }
+            buffer.append(';');
+        }
+        buffer.append('\n');
+
+        if (buffer.size() > (1 << 16))
+        {
+            file.write(buffer);
+            buffer.clear();
+        }
+    }
+
+    file.write(buffer);
+    file.close();
+    return file.error() == QFile::NoError;
+}
+
+/**
+ * @brief Exports each column as two numpy arrays, time stamps in us since epoch (int64) and values (float64)
+ *
+ * Files are named '<n>_<title>.time.npy' and '<n>_<title>.value.npy' in directory,
+ * readable by numpy.load() or any npy reader. Cursors are consumed.
+ * @return false if a file cannot be written
+ */
+bool DLExport::exportColumns(const QList<Column> &columns, const QString &directory)
+{
+    QDir().mkpath(directory);
+    for (int c = 0; c < columns.count(); c++)
+    {
+        QString baseName = columns.at(c).title;
+        baseName.replace(QRegExp("[^A-Za-z0-9_.-]+"), "_");
+        baseName = QString("%1/%2_%3").arg(directory).arg(c).arg(baseName);
+        if (!writeNpyColumn(columns.at(c).cursor, baseName + ".time.npy", baseName + ".value.npy"))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// npy v1.0 header, padded to a fixed size to be written once the sample count is known
+static QByteArray npyHeader(const char *descr, qint64 count)
+{
+    const int headerSize = 128;
+    QByteArray header("\x93NUMPY\x01\x00", 8);
+    QByteArray dict = QByteArray("{'descr': '") + descr + "', 'fortran_order': False, 'shape': (" + QByteArray::number(count) + ",), }";
+    dict = dict.leftJustified(headerSize - 10 - 1, ' ') + '\n';
+    header.append(static_cast<char>(dict.size() & 0xFF));
+    header.append(static_cast<char>(dict.size() >> 8));
+    header.append(dict);
+    return header;
+}
+
+bool DLExport::writeNpyColumn(DLSampleCursor *cursor, const QString &timeFileName, const QString &valueFileName)
+{
+    QFile timeFile(timeFileName);
+    QFile valueFile(valueFileName);
+    if (!timeFile.open(QIODevice::WriteOnly) || !valueFile.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+    timeFile.write(npyHeader("<i8", 0));
+    valueFile.write(npyHeader("<f8", 0));
+
+    const int blockSize = 4096;
+    QByteArray timeBuffer(blockSize * 8, Qt::Uninitialized);
+    QByteArray valueBuffer(blockSize * 8, Qt::Uninitialized);
+    qint64 count = 0;
+    while (!cursor->atEnd())
+    {
+        int n = 0;
+        for (; n < blockSize && !cursor->atEnd(); n++, cursor->next())
+        {
+            const double value = cursor->value();
+            quint64 valueBits;
+            memcpy(&valueBits, &value, sizeof(valueBits));
+            qToLittleEndian<qint64>(cursor->time(), timeBuffer.data() + n * 8);
+            qToLittleEndian<quint64>(valueBits, valueBuffer.data() + n * 8);
+        }
+        timeFile.write(timeBuffer.constData(), n * 8);
+        valueFile.write(valueBuffer.constData(), n * 8);
+        count += n;
+    }
+
+    timeFile.seek(0);
+    timeFile.write(npyHeader("<i8", count));
+    valueFile.seek(0);
+    valueFile.write(npyHeader("<f8", count));
+    timeFile.close();
+    valueFile.close();
+    return timeFile.error() == QFile::NoError && valueFile.error() == QFile::NoError;
+}
@@ -0,0 +1,80 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef DLEXPORT_H
+#define DLEXPORT_H
+
+#include "canopen_global.h"
+
+#include <QList>
+#include <QString>
+
+class DLTimeSeries;
+
+/**
+ * @brief Forward iterator over the time ordered samples of a channel
+ */
+class CANOPEN_EXPORT DLSampleCursor
+{
+public:
+    virtual ~DLSampleCursor();
+
+    virtual bool atEnd() const = 0;
+    virtual qint64 time() const = 0;  // us since epoch
+    virtual double value() const = 0;
+    virtual void next() = 0;
+};
+
+/**
+ * @brief Cursor over a DLTimeSeries, the series must not be modified while iterated
+ */
+class CANOPEN_EXPORT DLSeriesCursor : public DLSampleCursor
+{
+public:
+    DLSeriesCursor(const DLTimeSeries &series);
+
+    bool atEnd() const override;
+    qint64 time() const override;
+    double value() const override;
+    void next() override;
+
+private:
+    const DLTimeSeries &_series;
+    int _index;
+};
+
+/**
+ * @brief Streaming exports of channels, memory use does not depend on the number of samples
+ */
+class CANOPEN_EXPORT DLExport
+{
+public:
+    struct Column
+    {
+        QString title;
+        DLSampleCursor *cursor;
+    };
+
+    static bool exportCSV(const QList<Column> &columns, const QString &fileName);
+    static bool exportColumns(const QList<Column> &columns, const QString &directory);
+
+private:
+    static bool writeNpyColumn(DLSampleCursor *cursor, const QString &timeFileName, const QString &valueFileName);
+};
+
+#endif  // DLEXPORT_H
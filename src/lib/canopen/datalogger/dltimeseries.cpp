@@ -0,0 +1,336 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "dltimeseries.h"
+
+#include <algorithm>
+#include <limits>
+
+DLTimeSeries::DLTimeSeries()
+{
+    _count = 0;
+    _min = 0.0;
+    _max = 0.0;
+}
+
+DLTimeSeries::~DLTimeSeries()
+{
+    qDeleteAll(_chunks);
+}
+
+double DLTimeSeries::Summary::mean() const
+{
+    if (count == 0)
+    {
+        return 0.0;
+    }
+    return sum / count;
+}
+
+/**
+ * @brief Appends a sample, a time stamp older than the last one is clamped to keep the series sorted
+ * @param timeUs time stamp in micro seconds since epoch
+ * @param value sample value
+ */
+void DLTimeSeries::append(qint64 timeUs, double value)
+{
+    if (_count > 0)
+    {
+        timeUs = qMax(timeUs, lastTime());
+        _min = qMin(_min, value);
+        _max = qMax(_max, value);
+    }
+    else
+    {
+        _min = value;
+        _max = value;
+    }
+
+    int offset = _count % ChunkSize;
+    if (offset == 0)
+    {
+        Chunk *chunk = new Chunk;
+        chunk->summary = {timeUs, timeUs, value, value, 0.0, 0};
+        _chunks.append(chunk);
+    }
+
+    Chunk *chunk = _chunks.last();
+    chunk->times[offset] = timeUs;
+    chunk->values[offset] = value;
+
+    Summary &summary = chunk->summary;
+    summary.lastTime = timeUs;
+    summary.min = qMin(summary.min, value);
+    summary.max = qMax(summary.max, value);
+    summary.sum += value;
+    summary.count++;
+
+    _count++;
+    if (_count % PyramidFanout == 0)
+    {
+        updatePyramid();
+    }
+}
+
+void DLTimeSeries::clear()
+{
+    qDeleteAll(_chunks);
+    _chunks.clear();
+    _pyramid.clear();
+    _count = 0;
+    _min = 0.0;
+    _max = 0.0;
+}
+
+int DLTimeSeries::count() const
+{
+    return _count;
+}
+
+bool DLTimeSeries::isEmpty() const
+{
+    return _count == 0;
+}
+
+qint64 DLTimeSeries::time(int index) const
+{
+    return _chunks.at(index / ChunkSize)->times[index % ChunkSize];
+}
+
+double DLTimeSeries::value(int index) const
+{
+    return _chunks.at(index / ChunkSize)->values[index % ChunkSize];
+}
+
+qint64 DLTimeSeries::firstTime() const
+{
+    if (_count == 0)
+    {
+        return 0;
+    }
+    return _chunks.first()->summary.firstTime;
+}
+
+qint64 DLTimeSeries::lastTime() const
+{
+    if (_count == 0)
+    {
+        return 0;
+    }
+    return _chunks.last()->summary.lastTime;
+}
+
+double DLTimeSeries::firstValue() const
+{
+    if (_count == 0)
+    {
+        return 0.0;
+    }
+    return _chunks.first()->values[0];
+}
+
+double DLTimeSeries::lastValue() const
+{
+    if (_count == 0)
+    {
+        return 0.0;
+    }
+    return value(_count - 1);
+}
+
+/**
+ * @brief Minimum value of the whole series, 0.0 if empty
+ */
+double DLTimeSeries::min() const
+{
+    return _min;
+}
+
+/**
+ * @brief Maximum value of the whole series, 0.0 if empty
+ */
+double DLTimeSeries::max() const
+{
+    return _max;
+}
+
+int DLTimeSeries::chunkCount() const
+{
+    return _chunks.count();
+}
+
+const DLTimeSeries::Summary &DLTimeSeries::chunkSummary(int chunk) const
+{
+    return _chunks.at(chunk)->summary;
+}
+
+/**
+ * @brief Index of the first sample with a time stamp greater or equal to timeUs
+ * @return count() if all samples are older
+ */
+int DLTimeSeries::lowerBound(qint64 timeUs) const
+{
+    QVector<Chunk *>::const_iterator chunkIt = std::lower_bound(_chunks.cbegin(), _chunks.cend(), timeUs, [](const Chunk *chunk, qint64 time) {
+        return chunk->summary.lastTime < time;
+    });
+    if (chunkIt == _chunks.cend())
+    {
+        return _count;
+    }
+
+    const Chunk *chunk = *chunkIt;
+    const qint64 *timeIt = std::lower_bound(chunk->times, chunk->times + chunk->summary.count, timeUs);
+    return static_cast<int>(chunkIt - _chunks.cbegin()) * ChunkSize + static_cast<int>(timeIt - chunk->times);
+}
+
+/**
+ * @brief Statistics of samples [first, last[, walks at most 2 * PyramidFanout entries per pyramid level
+ */
+DLTimeSeries::Summary DLTimeSeries::summary(int first, int last) const
+{
+    first = qMax(first, 0);
+    last = qMin(last, _count);
+    if (first >= last)
+    {
+        return {0, 0, 0.0, 0.0, 0.0, 0};
+    }
+
+    Summary summary = {time(first), time(last - 1), std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest(), 0.0, last - first};
+
+    // level 0 is raw samples, level n is _pyramid[n - 1]
+    int level = 0;
+    int begin = first;
+    int end = last;
+    while (begin < end)
+    {
+        if (level < _pyramid.count() && end - begin >= PyramidFanout)
+        {
+            while (begin < end && begin % PyramidFanout != 0)
+            {
+                accumulate(level, begin++, summary);
+            }
+            while (begin < end && end % PyramidFanout != 0)
+            {
+                accumulate(level, --end, summary);
+            }
+            begin /= PyramidFanout;
+            end /= PyramidFanout;
+            level++;
+        }
+        else
+        {
+            while (begin < end)
+            {
+                accumulate(level, begin++, summary);
+            }
+        }
+    }
+    return summary;
+}
+
+/**
+ * @brief Statistics of samples with a time stamp in [fromUs, toUs[
+ */
+DLTimeSeries::Summary DLTimeSeries::summary(qint64 fromUs, qint64 toUs) const
+{
+    return summary(lowerBound(fromUs), lowerBound(toUs));
+}
+
+/**
+ * @brief Splits [fromUs, toUs[ in bucketCount time buckets and returns min and max values of each one
+ *
+ * Empty buckets are skipped, bucket time is the time stamp of its first sample.
+ * Intended to draw a series with one bucket per pixel.
+ */
+QVector<DLTimeSeries::MinMaxBucket> DLTimeSeries::minMaxBuckets(qint64 fromUs, qint64 toUs, int bucketCount) const
+{
+    QVector<MinMaxBucket> buckets;
+    if (bucketCount <= 0 || toUs <= fromUs || _count == 0)
+    {
+        return buckets;
+    }
+
+    buckets.reserve(bucketCount);
+    const qint64 duration = toUs - fromUs;
+    int first = lowerBound(fromUs);
+    for (int bucket = 0; bucket < bucketCount && first < _count; bucket++)
+    {
+        qint64 bucketEnd = fromUs + duration * (bucket + 1) / bucketCount;
+        int last = lowerBound(bucketEnd);
+        if (last > first)
+        {
+            const Summary bucketSummary = summary(first, last);
+            buckets.append({bucketSummary.firstTime, bucketSummary.min, bucketSummary.max});
+        }
+        first = last;
+    }
+    return buckets;
+}
+
+void DLTimeSeries::updatePyramid()
+{
+    const int first = _count - PyramidFanout;
+    PyramidEntry entry = {value(first), value(first), 0.0};
+    for (int i = first; i < _count; i++)
+    {
+        const double sampleValue = value(i);
+        entry.min = qMin(entry.min, sampleValue);
+        entry.max = qMax(entry.max, sampleValue);
+        entry.sum += sampleValue;
+    }
+
+    // propagates to upper levels each time PyramidFanout entries are completed
+    for (int level = 0;; level++)
+    {
+        if (level >= _pyramid.count())
+        {
+            _pyramid.append(QVector<PyramidEntry>());
+        }
+        QVector<PyramidEntry> &entries = _pyramid[level];
+        entries.append(entry);
+        if (entries.count() % PyramidFanout != 0)
+        {
+            break;
+        }
+
+        entry = {entries.last().min, entries.last().max, 0.0};
+        for (int i = entries.count() - PyramidFanout; i < entries.count(); i++)
+        {
+            entry.min = qMin(entry.min, entries.at(i).min);
+            entry.max = qMax(entry.max, entries.at(i).max);
+            entry.sum += entries.at(i).sum;
+        }
+    }
+}
+
+void DLTimeSeries::accumulate(int level, int index, Summary &summary) const
+{
+    if (level == 0)
+    {
+        const double sampleValue = value(index);
+        summary.min = qMin(summary.min, sampleValue);
+        summary.max = qMax(summary.max, sampleValue);
+        summary.sum += sampleValue;
+        return;
+    }
+
+    const PyramidEntry &entry = _pyramid.at(level - 1).at(index);
+    summary.min = qMin(summary.min, entry.min);
+    summary.max = qMax(summary.max, entry.max);
+    summary.sum += entry.sum;
+}
@@ -0,0 +1,124 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef DLTIMESERIES_H
+#define DLTIMESERIES_H
+
+#include "canopen_global.h"
+
+#include <QVector>
+
+/**
+ * @brief Append only time series of samples, stored by columns
+ *
+ * Samples are stored in fixed size chunks of time stamps (micro seconds since
+ * epoch) and values, each chunk keeps the min, max and mean of its samples.
+ * Time stamps are kept non decreasing, so a time range lookup is a binary
+ * search. A min/max pyramid, each level summarizing PyramidFanout entries of
+ * the level below, gives the extremums of any index range in O(log n) and
+ * allows to fetch one min/max pair per pixel without walking raw samples.
+ */
+class CANOPEN_EXPORT DLTimeSeries
+{
+public:
+    DLTimeSeries();
+    ~DLTimeSeries();
+
+    enum
+    {
+        ChunkSize = 4096,
+        PyramidFanout = 16
+    };
+
+    struct Summary
+    {
+        qint64 firstTime;
+        qint64 lastTime;
+        double min;
+        double max;
+        double sum;
+        int count;
+
+        double mean() const;
+    };
+
+    struct MinMaxBucket
+    {
+        qint64 time;
+        double min;
+        double max;
+    };
+
+    void append(qint64 timeUs, double value);
+    void clear();
+
+    int count() const;
+    bool isEmpty() const;
+
+    qint64 time(int index) const;
+    double value(int index) const;
+
+    qint64 firstTime() const;
+    qint64 lastTime() const;
+    double firstValue() const;
+    double lastValue() const;
+
+    // stats
+    double min() const;
+    double max() const;
+
+    int chunkCount() const;
+    const Summary &chunkSummary(int chunk) const;
+
+    // range queries
+    int lowerBound(qint64 timeUs) const;
+    Summary summary(int first, int last) const;
+    Summary summary(qint64 fromUs, qint64 toUs) const;
+    QVector<MinMaxBucket> minMaxBuckets(qint64 fromUs, qint64 toUs, int bucketCount) const;
+
+private:
+    Q_DISABLE_COPY(DLTimeSeries)
+
+    struct Chunk
+    {
+        qint64 times[ChunkSize];
+        double values[ChunkSize];
+        Summary summary;
+    };
+
+    struct PyramidEntry
+    {
+        double min;
+        double max;
+        double sum;
+    };
+
+    QVector<Chunk *> _chunks;
+    int _count;
+
+    // _pyramid[0] summarizes PyramidFanout samples, _pyramid[1] PyramidFanout^2...
+    QVector<QVector<PyramidEntry>> _pyramid;
+
+    double _min;
+    double _max;
+
+    void updatePyramid();
+    void accumulate(int level, int index, Summary &summary) const;
+};
+
+#endif  // DLTIMESERIES_H
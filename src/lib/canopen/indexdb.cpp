@@ -164,6 +164,12 @@ NodeObjectId IndexDb::getObjectId(IndexDb::OdObject object, uint opt, uint optMa
 
         case OD_BOOTLOADER_STATUS:
             return {0x2050, 0x3};
+
+        case OD_BOOTLOADER_PAGE_SIZE:
+            return {0x2050, 0x4};
+
+        case OD_BOOTLOADER_PAGE_CHECKSUMS:
+            return {0x2050, 0x5};
     }
     return NodeObjectId();
 }
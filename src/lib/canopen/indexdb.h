@@ -69,7 +69,9 @@ public:
         OD_PROGRAM_CONTROL_1,
         OD_BOOTLOADER_KEY,
         OD_BOOTLOADER_CHECKSUM,
-        OD_BOOTLOADER_STATUS
+        OD_BOOTLOADER_STATUS,
+        OD_BOOTLOADER_PAGE_SIZE,
+        OD_BOOTLOADER_PAGE_CHECKSUMS
     };
 
     static NodeObjectId getObjectId(OdObject object, uint opt = 0, uint optMappingEntry = 0);
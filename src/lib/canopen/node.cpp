@@ -32,6 +32,7 @@ Node::Node(quint8 nodeId, const QString &name, const QString &edsFileName)
 {
     _status = UNKNOWN;
     _bus = nullptr;
+    _liveObjects = nullptr;
     _nodeOd = new NodeOd(this);
 
     if (name.isEmpty())
@@ -53,9 +54,11 @@ Node::Node(quint8 nodeId, const QString &name, const QString &edsFileName)
     _errorControl = new ErrorControl(this);
     _services.append(_errorControl);
 
+    _sdoScheduler = new SdoScheduler(this);
     SDO *sdo = new SDO(this);
     _sdoClients.append(sdo);
     _services.append(sdo);
+    _sdoScheduler->addChannel(sdo);
 
     for (quint8 i = 0; i < 4; i++)
     {
@@ -70,6 +73,7 @@ Node::Node(quint8 nodeId, const QString &name, const QString &edsFileName)
         _tpdos.append(tpdo);
         _services.append(tpdo);
     }
+    _liveObjects = new LiveObjects(this);
 
     _bootloader = new Bootloader(this);
 
@@ -82,6 +86,11 @@ Node::Node(quint8 nodeId, const QString &name, const QString &edsFileName)
 
 Node::~Node()
 {
+    // subscribers destroyed afterwards must not release their objects to it
+    LiveObjects *liveObjects = _liveObjects;
+    _liveObjects = nullptr;
+    delete liveObjects;
+    delete _sdoScheduler;
     qDeleteAll(_sdoClients);
     qDeleteAll(_tpdos);
     qDeleteAll(_rpdos);
@@ -161,6 +170,10 @@ void Node::setStatus(Status status)
     _status = status;
     if (changed)
     {
+        if (_status == PREOP || _status == STARTED)
+        {
+            _sdoScheduler->discoverChannels();
+        }
         emit statusChanged(_status);
     }
 }
@@ -218,10 +231,59 @@ void Node::readObject(const NodeObjectId &id)
 }
 
 void Node::readObject(quint16 index, quint8 subindex, QMetaType::Type dataType)
+{
+    requestReadObject(index, subindex, dataType);
+}
+
+/**
+ * @brief Reads a list of objects with a single completion
+ *
+ * Duplicated objects are read once and objects already pending on a SDO
+ * channel are not requested again. Index and full od subscribers are not
+ * notified for each object only requested by the batch, NodeOd::objectsRead()
+ * is emitted once with all results. Objects that cannot be read (node stopped,
+ * object mapped in a running TPDO or absent from the od) are returned with
+ * their current value.
+ * @param ids list of objects to read
+ * @return batch id given back by NodeOd::objectsRead()
+ */
+quint32 Node::readObjects(const QList<NodeObjectId> &ids)
+{
+    quint32 batchId = _nodeOd->beginReadBatch();
+
+    QSet<quint32> keys;
+    keys.reserve(ids.count());
+    for (const NodeObjectId &id : ids)
+    {
+        quint32 key = (static_cast<quint32>(id.index()) << 8) + id.subIndex();
+        if (keys.contains(key))
+        {
+            continue;
+        }
+        keys.insert(key);
+
+        NodeObjectId objectId(busId(), _nodeId, id.index(), id.subIndex(), id.dataType());
+        if (!_nodeOd->subIndexExist(id.index(), id.subIndex()))
+        {
+            _nodeOd->addToReadBatch(batchId, objectId, false, false);
+            continue;
+        }
+
+        // an answer already expected by someone else is notified to everyone
+        bool inFlight = _sdoScheduler->hasRequest(id.index(), id.subIndex());
+        bool pending = requestReadObject(id.index(), id.subIndex(), id.dataType());
+        _nodeOd->addToReadBatch(batchId, objectId, pending, inFlight);
+    }
+
+    _nodeOd->endReadBatch(batchId);
+    return batchId;
+}
+
+bool Node::requestReadObject(quint16 index, quint8 subindex, QMetaType::Type dataType)
 {
     if (_status == STOPPED || _status == UNKNOWN)
     {
-        return;
+        return false;
     }
 
     TPDO *tpdoMapped = tpdoMappedObject(NodeObjectId(index, subindex, dataType));
@@ -229,7 +291,7 @@ void Node::readObject(quint16 index, quint8 subindex, QMetaType::Type dataType)
     {
         if (tpdoMapped->isEnabled() && _status == STARTED && _bus->sync()->status() == Sync::STARTED)
         {
-            return;
+            return false;
         }
     }
 
@@ -238,7 +300,7 @@ void Node::readObject(quint16 index, quint8 subindex, QMetaType::Type dataType)
     {
         mdataType = _nodeOd->dataType(index, subindex);
     }
-    _sdoClients.at(0)->uploadData(index, subindex, mdataType);
+    return _sdoScheduler->uploadData(index, subindex, mdataType);
 }
 
 void Node::writeObject(const NodeObjectId &id, const QVariant &data)
@@ -282,12 +344,13 @@ void Node::writeObject(quint16 index, quint8 subindex, const QVariant &data)
         }
     }
 
-    _sdoClients.at(0)->downloadData(index, subindex, mdata);
+    _sdoScheduler->downloadData(index, subindex, mdata);
 }
 
 void Node::loadEds(const QString &fileName)
 {
     _nodeOd->loadEds(fileName);
+    discoverSdoChannels();
     emit edsFileChanged(fileName);
 }
 
@@ -296,6 +359,44 @@ const QString &Node::edsFileName() const
     return _nodeOd->edsFileName();
 }
 
+SdoScheduler *Node::sdoScheduler() const
+{
+    return _sdoScheduler;
+}
+
+/**
+ * @brief Creates a SDO channel for each additional SDO server described in the OD
+ * and reads their COB-IDs, channels are used as soon as their COB-IDs are known
+ */
+void Node::discoverSdoChannels()
+{
+    for (quint8 channel = 1; channel < 128; channel++)
+    {
+        if (!_nodeOd->indexExist(0x1200 + channel))
+        {
+            continue;
+        }
+
+        bool exist = false;
+        for (SDO *sdo : qAsConst(_sdoClients))
+        {
+            if (sdo->channel() == channel)
+            {
+                exist = true;
+                break;
+            }
+        }
+        if (!exist)
+        {
+            SDO *sdo = new SDO(this, channel);
+            _sdoClients.append(sdo);
+            _services.append(sdo);
+            _sdoScheduler->addChannel(sdo);
+        }
+    }
+    _sdoScheduler->discoverChannels();
+}
+
 void Node::addProfile(NodeProfile *nodeProfile)
 {
     _nodeProfiles.append(nodeProfile);
@@ -364,6 +465,11 @@ TPDO *Node::tpdoMappedObject(const NodeObjectId &object) const
     return nullptr;
 }
 
+LiveObjects *Node::liveObjects() const
+{
+    return _liveObjects;
+}
+
 Bootloader *Node::bootloader() const
 {
     return _bootloader;
@@ -381,10 +487,13 @@ void Node::reset()
     {
         service->reset();
     }
+    _sdoScheduler->reset();
+    _liveObjects->reset();
     for (NodeProfile *nodeProfile : qAsConst(_nodeProfiles))
     {
         nodeProfile->reset();
     }
+    _sdoScheduler->discoverChannels();
 }
 
 void Node::sendPreop()
@@ -36,6 +36,8 @@ class NMT;
 class ErrorControl;
 class NodeProfile;
 class Bootloader;
+class SdoScheduler;
+class LiveObjects;
 
 class CANOPEN_EXPORT Node : public QObject
 {
@@ -94,12 +96,17 @@ public:
     NodeOd *nodeOd() const;
     void readObject(const NodeObjectId &id);
     void readObject(quint16 index, quint8 subindex, QMetaType::Type dataType = QMetaType::UnknownType);
+    quint32 readObjects(const QList<NodeObjectId> &ids);
     void writeObject(const NodeObjectId &id, const QVariant &data);
     void writeObject(quint16 index, quint8 subindex, const QVariant &data);
 
     void loadEds(const QString &fileName);
     const QString &edsFileName() const;
 
+    // SDO channels
+    SdoScheduler *sdoScheduler() const;
+    void discoverSdoChannels();
+
     // Profiles
     void addProfile(NodeProfile *nodeProfile);
     const QList<NodeProfile *> &profiles() const;
@@ -112,6 +119,9 @@ public:
     RPDO *rpdoMappedObject(const NodeObjectId &object) const;
     TPDO *tpdoMappedObject(const NodeObjectId &object) const;
 
+    // Polled objects
+    LiveObjects *liveObjects() const;
+
     Bootloader *bootloader() const;
 
     QList<Service *> services() const;
@@ -144,8 +154,10 @@ protected:
 
     // services
     QList<SDO *> _sdoClients;
+    SdoScheduler *_sdoScheduler;
     QList<TPDO *> _tpdos;
     QList<RPDO *> _rpdos;
+    LiveObjects *_liveObjects;
     Emergency *_emergency;
     NMT *_nmt;
     ErrorControl *_errorControl;
@@ -155,6 +167,7 @@ protected:
     QList<NodeProfile *> _nodeProfiles;
 
     NodeOd *_nodeOd;
+    bool requestReadObject(quint16 index, quint8 subindex, QMetaType::Type dataType);
 };
 
 #endif  // NODE_H
@@ -283,6 +283,8 @@ quint8 NodeObjectId::bitSize() const
         case QMetaType::Double:
         case QMetaType::Long:
         case QMetaType::ULong:
+        case QMetaType::LongLong:
+        case QMetaType::ULongLong:
             return 64;
 
         default:
@@ -22,7 +22,9 @@
 #include "model/deviceconfiguration.h"
 #include "node.h"
 #include "nodeodsubscriber.h"
+#include "nodeodtemplate.h"
 #include "parser/edsparser.h"
+#include "services/liveobjects.h"
 #include "writer/dcfwriter.h"
 
 #include <QDebug>
@@ -32,16 +34,24 @@
 NodeOd::NodeOd(Node *node)
     : _node(node)
 {
+    _nextReadBatchId = 1;
+    _unsubscribeCount = 0;
+
+    _notifyTimer = new QTimer(this);
+    _notifyTimer->setSingleShot(true);
+    _notifyTimer->setInterval(0);
+    connect(_notifyTimer, &QTimer::timeout, this, &NodeOd::flushNotifications);
+
     createMandatoryObjects();
 }
 
 NodeOd::~NodeOd()
 {
     // Remove reference of this instance to all subcriber
-    QMultiMap<quint32, Subscriber>::iterator itSub = _subscribers.begin();
-    while (itSub != _subscribers.end())
+    QHash<NodeOdSubscriber *, int>::const_iterator itSub = _subscriptionCount.cbegin();
+    while (itSub != _subscriptionCount.cend())
     {
-        itSub.value().object->_nodeInterrest = nullptr;
+        itSub.key()->_nodeInterrest = nullptr;
         ++itSub;
     }
 
@@ -56,72 +66,77 @@ Node *NodeOd::node() const
 
 void NodeOd::resetAllObjects()
 {
+    cancelReadBatches();
     for (NodeIndex *index : qAsConst(_nodeIndexes))
     {
         for (NodeSubIndex *subIndex : index->subIndexes())
         {
             subIndex->resetValue();
-            updateObjectFromDevice(subIndex->index(), subIndex->subIndex(), subIndex->value(), NodeOd::Read);
+            subIndex->clearError();
+            notifyObjectUpdated(subIndex, NodeOd::Read);
         }
     }
 }
 
 bool NodeOd::loadEds(const QString &fileName)
 {
-    QString mfileName(fileName);
-    mfileName = QFileInfo(mfileName).canonicalFilePath();
-
-    EdsParser parser;
-    DeviceDescription *deviceDescription = parser.parse(mfileName);
-    if (deviceDescription == nullptr)
+    // parsed once for all nodes using the same eds, descriptions are shared with the template
+    QSharedPointer<const NodeOdTemplate> odTemplate = NodeOdTemplate::load(fileName);
+    if (odTemplate.isNull())
     {
         return false;
     }
-    _edsFileInfos = deviceDescription->fileInfos();
+    _odTemplate = odTemplate;
+    _edsFileInfos = odTemplate->fileInfos();
+    _edsFileName = odTemplate->fileName();
 
-    DeviceConfiguration *deviceConfiguration = DeviceConfiguration::fromDeviceDescription(deviceDescription, _node->nodeId());
-    _edsFileName = mfileName;
-
-    for (Index *odIndex : deviceConfiguration->indexes())
+    const quint8 nodeId = _node->nodeId();
+    for (NodeIndex *templateIndex : odTemplate->indexes())
     {
         NodeIndex *nodeIndex;
-        nodeIndex = index(odIndex->index());
+        nodeIndex = index(templateIndex->index());
         if (nodeIndex == nullptr)
         {
-            nodeIndex = new NodeIndex(odIndex->index());
+            nodeIndex = new NodeIndex(templateIndex->index());
         }
-        nodeIndex->setName(odIndex->name());
-        nodeIndex->setObjectType(static_cast<NodeIndex::ObjectType>(odIndex->objectType()));
+        nodeIndex->setName(templateIndex->name());
+        nodeIndex->setObjectType(templateIndex->objectType());
         addIndex(nodeIndex);
 
-        for (SubIndex *odSubIndex : odIndex->subIndexes())
+        for (NodeSubIndex *templateSubIndex : templateIndex->subIndexes())
         {
             NodeSubIndex *nodeSubIndex;
-            nodeSubIndex = nodeIndex->subIndex(odSubIndex->subIndex());
+            nodeSubIndex = nodeIndex->subIndex(templateSubIndex->subIndex());
             if (nodeSubIndex == nullptr)
             {
-                nodeSubIndex = new NodeSubIndex(odSubIndex->subIndex());
+                nodeSubIndex = new NodeSubIndex(templateSubIndex->subIndex());
+            }
+            nodeSubIndex->shareDescription(*templateSubIndex);
+            if (odTemplate->hasNodeId(templateIndex->index(), templateSubIndex->subIndex()))
+            {
+                // only descriptions relative to node id are copied
+                nodeSubIndex->setDefaultValue(templateSubIndex->defaultValue().toUInt() + nodeId);
             }
             if (!nodeSubIndex->value().isValid())
             {
-                nodeSubIndex->setValue(odSubIndex->value());
+                nodeSubIndex->setValue(nodeSubIndex->defaultValue());
             }
-            nodeSubIndex->setDefaultValue(odSubIndex->value());
-            nodeSubIndex->setName(odSubIndex->name());
-            nodeSubIndex->setAccessType(static_cast<NodeSubIndex::AccessType>(odSubIndex->accessType()));
-            nodeSubIndex->setDataType(static_cast<NodeSubIndex::DataType>(odSubIndex->dataType()));
-            nodeSubIndex->setLowLimit(odSubIndex->lowLimit());
-            nodeSubIndex->setHighLimit(odSubIndex->highLimit());
             nodeIndex->addSubIndex(nodeSubIndex);
-
-            nodeSubIndex->setQ1516(IndexDb::isQ1516(nodeSubIndex->objectId(), _node->profileNumber()));
-            nodeSubIndex->setScale(IndexDb::scale(nodeSubIndex->objectId(), _node->profileNumber()));
-            nodeSubIndex->setUnit(IndexDb::unit(nodeSubIndex->objectId(), _node->profileNumber()));
         }
     }
 
-    delete deviceDescription;
-    delete deviceConfiguration;
+    // interpretation depends on the profile of the node, kept shared while identical to the template one
+    const quint16 profileNumber = _node->profileNumber();
+    for (NodeIndex *templateIndex : odTemplate->indexes())
+    {
+        NodeIndex *nodeIndex = index(templateIndex->index());
+        for (NodeSubIndex *nodeSubIndex : nodeIndex->subIndexes())
+        {
+            nodeSubIndex->setQ1516(IndexDb::isQ1516(nodeSubIndex->objectId(), profileNumber));
+            nodeSubIndex->setScale(IndexDb::scale(nodeSubIndex->objectId(), profileNumber));
+            nodeSubIndex->setUnit(IndexDb::unit(nodeSubIndex->objectId(), profileNumber));
+        }
+    }
 
     return true;
 }
@@ -451,44 +466,104 @@ QDateTime NodeOd::lastModification(quint16 index, quint8 subIndex) const
     return nodeSubIndex->lastModification();
 }
 
-void NodeOd::subscribe(NodeOdSubscriber *object, quint16 notifyIndex, quint8 notifySubIndex)
+/**
+ * @brief Subscribes to an object, an index (0xFF subindex) or the full od (0xFFFF index)
+ * @param refreshPeriodMs if not 0, the object is kept up to date by the node at this period
+ */
+void NodeOd::subscribe(NodeOdSubscriber *object, quint16 notifyIndex, quint8 notifySubIndex, int refreshPeriodMs)
 {
-    Subscriber subscriber;
-    subscriber.object = object;
-    subscriber.notifyIndex = notifyIndex;
-    subscriber.notifySubIndex = notifySubIndex;
     quint32 key = (static_cast<quint32>(notifyIndex) << 8) + notifySubIndex;
-    _subscribers.insert(key, subscriber);
+    _subscribers[key].append(object);
+    _subscriptionCount[object]++;
+
+    if (refreshPeriodMs > 0)
+    {
+        setRefreshPeriod(object, notifyIndex, notifySubIndex, refreshPeriodMs);
+    }
+}
+
+/**
+ * @brief Requests an object to be read periodically for a subscriber, 0 to cancel the request
+ *
+ * Requests of all subscribers are merged by the node live objects, each object
+ * is read once at the fastest requested period. Only applies to sub indexes.
+ */
+void NodeOd::setRefreshPeriod(NodeOdSubscriber *object, quint16 index, quint8 subIndex, int refreshPeriodMs)
+{
+    LiveObjects *liveObjects = _node->liveObjects();
+    if (liveObjects == nullptr || index == 0xFFFF || subIndex == 0xFF)
+    {
+        return;  // node is being destroyed or not an object
+    }
+
+    if (refreshPeriodMs > 0)
+    {
+        if (subIndexExist(index, subIndex))
+        {
+            liveObjects->requestObject(object, NodeObjectId(index, subIndex), refreshPeriodMs);
+        }
+    }
+    else
+    {
+        liveObjects->releaseObject(object, NodeObjectId(index, subIndex));
+    }
 }
 
 void NodeOd::unsubscribe(NodeOdSubscriber *object)
 {
-    QMultiMap<quint32, Subscriber>::iterator itSub = _subscribers.begin();
-    while (itSub != _subscribers.end())
+    if (_node->liveObjects() != nullptr)
+    {
+        _node->liveObjects()->releaseAll(object);
+    }
+    if (!_subscriptionCount.remove(object))
+    {
+        return;
+    }
+    _unsubscribeCount++;
+
+    QHash<quint32, QVector<NodeOdSubscriber *>>::iterator itKey = _subscribers.begin();
+    while (itKey != _subscribers.end())
     {
-        if (itSub.value().object == object)
+        (*itKey).removeAll(object);
+        if ((*itKey).isEmpty())
         {
-            itSub = _subscribers.erase(itSub);
+            itKey = _subscribers.erase(itKey);
         }
         else
         {
-            ++itSub;
+            ++itKey;
         }
     }
 }
 
 void NodeOd::unsubscribe(NodeOdSubscriber *object, quint16 notifyIndex, quint8 notifySubIndex)
 {
-    QMultiMap<quint32, Subscriber>::iterator itSub = _subscribers.begin();
-    while (itSub != _subscribers.end())
+    quint32 key = (static_cast<quint32>(notifyIndex) << 8) + notifySubIndex;
+    QHash<quint32, QVector<NodeOdSubscriber *>>::iterator itKey = _subscribers.find(key);
+    if (itKey == _subscribers.end())
     {
-        if ((*itSub).object == object && (*itSub).notifyIndex == notifyIndex && (*itSub).notifySubIndex == notifySubIndex)
-        {
-            itSub = _subscribers.erase(itSub);
-        }
-        else
+        return;
+    }
+
+    int count = (*itKey).removeAll(object);
+    if ((*itKey).isEmpty())
+    {
+        _subscribers.erase(itKey);
+    }
+    if (count == 0)
+    {
+        return;
+    }
+    _unsubscribeCount++;
+    setRefreshPeriod(object, notifyIndex, notifySubIndex, 0);
+
+    QHash<NodeOdSubscriber *, int>::iterator itCount = _subscriptionCount.find(object);
+    if (itCount != _subscriptionCount.end())
+    {
+        itCount.value() -= count;
+        if (itCount.value() <= 0)
         {
-            ++itSub;
+            _subscriptionCount.erase(itCount);
         }
     }
 }
@@ -511,14 +586,83 @@ void NodeOd::updateObjectFromDevice(quint16 index, quint8 subindex, const QVaria
         nodeSubIndex->setError(static_cast<quint32>(value.toUInt()));
     }
 
-    quint32 key = (static_cast<quint32>(index) << 8) + subindex;
-    notifySubscribers(key, index, subindex, flags);  // notify subscribers to index/subindex
+    notifyObjectUpdated(nodeSubIndex, flags);
+}
+
+/**
+ * @brief Typed value update, used by PDO decoding to avoid QVariant and QDateTime on each frame
+ * @param timeStamp modification time in us since epoch, 0 for now
+ */
+void NodeOd::updateObjectFromDevice(quint16 index, quint8 subindex, const NodeValue &value, NodeOd::FlagsRequest flags, qint64 timeStamp)
+{
+    NodeSubIndex *nodeSubIndex = subIndex(index, subindex);
+    if (nodeSubIndex == nullptr)
+    {
+        return;
+    }
+
+    updateObjectFromDevice(nodeSubIndex, value, flags, timeStamp);
+}
 
-    key = (static_cast<quint32>(index) << 8) + 0xFFU;
-    notifySubscribers(key, index, subindex, flags);  // notify subscribers to index with all subindex
+/**
+ * @brief Typed value update of an object already resolved, as done by precompiled PDO mappings
+ */
+void NodeOd::updateObjectFromDevice(NodeSubIndex *nodeSubIndex, const NodeValue &value, NodeOd::FlagsRequest flags, qint64 timeStamp)
+{
+    nodeSubIndex->clearError();
+    nodeSubIndex->setValue(value, timeStamp);
 
-    key = (static_cast<quint32>(0xFFFFU) << 8) + 0xFFU;
-    notifySubscribers(key, index, subindex, flags);  // notify subscribers to the full od
+    notifyObjectUpdated(nodeSubIndex, flags);
+}
+
+void NodeOd::notifyObjectUpdated(NodeSubIndex *nodeSubIndex, NodeOd::FlagsRequest flags)
+{
+    const quint16 index = nodeSubIndex->index();
+    const quint8 subindex = nodeSubIndex->subIndex();
+    quint32 objectKey = (static_cast<quint32>(index) << 8) + subindex;
+
+    // SDO read answer of an object pending in a batch, index and full od subscribers are notified once with the batch
+    bool notifyAll = true;
+    bool batchObject = false;
+    if (!_readBatchKeys.isEmpty() && (flags & (NodeOd::Write | NodeOd::Pdo)) == 0)
+    {
+        QHash<quint32, bool>::iterator itKey = _readBatchKeys.find(objectKey);
+        if (itKey != _readBatchKeys.end())
+        {
+            notifyAll = itKey.value();
+            batchObject = true;
+            _readBatchKeys.erase(itKey);
+        }
+    }
+
+    // PDO updates are delivered on the next flush to coalesced subscribers, SDO answers keep their flags and stay synchronous
+    const bool coalesce = ((flags & NodeOd::Pdo) != 0);
+    const NodeObjectId objId(_node->busId(), _node->nodeId(), index, subindex);
+    bool deferred = notifySubscribers(objectKey, objId, flags, coalesce);  // notify subscribers to index/subindex
+
+    if (notifyAll)
+    {
+        quint32 key = (static_cast<quint32>(index) << 8) + 0xFFU;
+        deferred |= notifySubscribers(key, objId, flags, coalesce);  // notify subscribers to index with all subindex
+
+        key = (static_cast<quint32>(0xFFFFU) << 8) + 0xFFU;
+        deferred |= notifySubscribers(key, objId, flags, coalesce);  // notify subscribers to the full od
+    }
+
+    if (deferred)
+    {
+        markDirty(nodeSubIndex);
+    }
+
+    if (batchObject)
+    {
+        completeReadBatchObject(objectKey);
+    }
+}
+
+bool NodeOd::isReadBatchPending(quint32 batchId) const
+{
+    return _readBatches.contains(batchId);
 }
 
 void NodeOd::createMandatoryObjects()
@@ -695,6 +839,19 @@ void NodeOd::createBootloaderObjects()
     subIndexbootloader->setName("Status");
     bootloader->addSubIndex(subIndexbootloader);
 
+    // delta update, optional
+    subIndexbootloader = new NodeSubIndex(4);
+    subIndexbootloader->setDataType(NodeSubIndex::UNSIGNED32);
+    subIndexbootloader->setAccessType(NodeSubIndex::AccessType::READ);
+    subIndexbootloader->setName("Page size");
+    bootloader->addSubIndex(subIndexbootloader);
+
+    subIndexbootloader = new NodeSubIndex(5);
+    subIndexbootloader->setDataType(NodeSubIndex::DDOMAIN);
+    subIndexbootloader->setAccessType(NodeSubIndex::AccessType::READ);
+    subIndexbootloader->setName("Page checksums");
+    bootloader->addSubIndex(subIndexbootloader);
+
     if (!indexExist(bootloader->_index))
     {
         addIndex(bootloader);
@@ -706,15 +863,247 @@ const QMap<QString, QString> &NodeOd::edsFileInfos() const
     return _edsFileInfos;
 }
 
-void NodeOd::notifySubscribers(quint32 key, quint16 notifyIndex, quint8 notifySubIndex, NodeOd::FlagsRequest flags)
+/**
+ * @brief Notifies synchronous subscribers of a key
+ * @param coalesce true to skip coalesced subscribers, they are notified by the next flush
+ * @return true if a coalesced subscriber was skipped
+ */
+bool NodeOd::notifySubscribers(quint32 key, const NodeObjectId &objId, NodeOd::FlagsRequest flags, bool coalesce)
+{
+    QHash<quint32, QVector<NodeOdSubscriber *>>::const_iterator itKey = _subscribers.constFind(key);
+    if (itKey == _subscribers.cend())
+    {
+        return false;
+    }
+
+    // shared copy, subscribers may unsubscribe while notified
+    const QVector<NodeOdSubscriber *> subscribers = itKey.value();
+    const quint32 unsubscribeCount = _unsubscribeCount;
+    bool deferred = false;
+    for (NodeOdSubscriber *subscriber : subscribers)
+    {
+        if (unsubscribeCount != _unsubscribeCount && !_subscriptionCount.contains(subscriber))
+        {
+            continue;
+        }
+        if (coalesce && subscriber->_notifyMode == NodeOdSubscriber::NotifyCoalesced)
+        {
+            deferred = true;
+            continue;
+        }
+        subscriber->notifySubscriber(objId, flags);
+    }
+    return deferred;
+}
+
+int NodeOd::notifyPeriod() const
+{
+    return _notifyTimer->interval();
+}
+
+/**
+ * @brief Sets the period of coalesced notifications
+ * @param ms period in ms, 0 to notify on the next event loop iteration
+ */
+void NodeOd::setNotifyPeriod(int ms)
+{
+    _notifyTimer->setInterval(qMax(0, ms));
+}
+
+void NodeOd::markDirty(NodeSubIndex *nodeSubIndex)
+{
+    int slot = nodeSubIndex->_notifySlot;
+    if (slot < 0)
+    {
+        slot = _notifySlots.count();
+        nodeSubIndex->_notifySlot = slot;
+        _notifySlots.append(nodeSubIndex);
+        _dirtyBits.resize(_notifySlots.count());
+    }
+
+    if (!_dirtyBits.testBit(slot))
+    {
+        _dirtyBits.setBit(slot);
+        _dirtySlots.append(slot);
+    }
+    if (!_notifyTimer->isActive())
+    {
+        _notifyTimer->start();
+    }
+}
+
+/**
+ * @brief Delivers dirty objects to coalesced subscribers, one list of objects per subscriber
+ */
+void NodeOd::flushNotifications()
+{
+    QVector<int> dirtySlots;
+    dirtySlots.swap(_dirtySlots);
+
+    QHash<NodeOdSubscriber *, QList<NodeObjectId>> changes;
+    for (int slot : qAsConst(dirtySlots))
+    {
+        _dirtyBits.clearBit(slot);
+        NodeSubIndex *nodeSubIndex = _notifySlots.at(slot);
+        const quint16 index = nodeSubIndex->index();
+        const NodeObjectId objId(_node->busId(), _node->nodeId(), index, nodeSubIndex->subIndex());
+
+        const quint32 keys[] = {(static_cast<quint32>(index) << 8) + nodeSubIndex->subIndex(),
+                                (static_cast<quint32>(index) << 8) + 0xFFU,
+                                (static_cast<quint32>(0xFFFFU) << 8) + 0xFFU};
+        for (quint32 key : keys)
+        {
+            QHash<quint32, QVector<NodeOdSubscriber *>>::const_iterator itKey = _subscribers.constFind(key);
+            if (itKey == _subscribers.cend())
+            {
+                continue;
+            }
+            for (NodeOdSubscriber *subscriber : itKey.value())
+            {
+                if (subscriber->_notifyMode != NodeOdSubscriber::NotifyCoalesced)
+                {
+                    continue;
+                }
+                QList<NodeObjectId> &objIds = changes[subscriber];
+                if (objIds.isEmpty() || objIds.last().key() != objId.key())
+                {
+                    objIds.append(objId);
+                }
+            }
+        }
+    }
+
+    QHash<NodeOdSubscriber *, QList<NodeObjectId>>::const_iterator itChange = changes.cbegin();
+    while (itChange != changes.cend())
+    {
+        // a previous subscriber may have unsubscribed or deleted this one
+        if (_subscriptionCount.contains(itChange.key()))
+        {
+            itChange.key()->notifySubscriber(itChange.value());
+        }
+        ++itChange;
+    }
+}
+
+quint32 NodeOd::beginReadBatch()
 {
-    QList<Subscriber> interrestedSubscribers = _subscribers.values(key);
-    QList<Subscriber>::const_iterator subscriber = interrestedSubscribers.cbegin();
-    while (subscriber != interrestedSubscribers.cend())
+    quint32 batchId = _nextReadBatchId++;
+    if (_nextReadBatchId == 0)
     {
-        NodeOdSubscriber *nodeOdSubscriber = (*subscriber).object;
-        NodeObjectId objId(_node->busId(), _node->nodeId(), notifyIndex, notifySubIndex);
-        nodeOdSubscriber->notifySubscriber(objId, flags);
-        ++subscriber;
+        _nextReadBatchId = 1;
     }
+
+    ReadBatch batch;
+    batch.ended = false;
+    _readBatches.insert(batchId, batch);
+    return batchId;
+}
+
+/**
+ * @brief Adds an object to a batch
+ * @param pending true if a SDO upload is requested for this object, otherwise current value is returned
+ * @param notifyAll true if the answer is also expected outside of the batch, index and full od subscribers are then notified
+ */
+void NodeOd::addToReadBatch(quint32 batchId, const NodeObjectId &objectId, bool pending, bool notifyAll)
+{
+    QMap<quint32, ReadBatch>::iterator itBatch = _readBatches.find(batchId);
+    if (itBatch == _readBatches.end())
+    {
+        return;
+    }
+
+    (*itBatch).objectIds.append(objectId);
+    if (!pending)
+    {
+        return;
+    }
+
+    quint32 key = (static_cast<quint32>(objectId.index()) << 8) + objectId.subIndex();
+    (*itBatch).pendingKeys.insert(key);
+    QHash<quint32, bool>::iterator itKey = _readBatchKeys.find(key);
+    if (itKey == _readBatchKeys.end())
+    {
+        _readBatchKeys.insert(key, notifyAll);
+    }
+    else
+    {
+        itKey.value() = itKey.value() || notifyAll;
+    }
+}
+
+void NodeOd::endReadBatch(quint32 batchId)
+{
+    QMap<quint32, ReadBatch>::iterator itBatch = _readBatches.find(batchId);
+    if (itBatch == _readBatches.end())
+    {
+        return;
+    }
+
+    (*itBatch).ended = true;
+    if ((*itBatch).pendingKeys.isEmpty())
+    {
+        finishReadBatch(batchId);
+    }
+}
+
+/**
+ * @brief Terminates all pending batches, objects still waiting for an answer are returned in error
+ */
+void NodeOd::cancelReadBatches()
+{
+    _readBatchKeys.clear();
+    const QList<quint32> batchIds = _readBatches.keys();
+    for (quint32 batchId : batchIds)
+    {
+        finishReadBatch(batchId);
+    }
+}
+
+void NodeOd::completeReadBatchObject(quint32 key)
+{
+    QList<quint32> finishedBatchIds;
+    QMap<quint32, ReadBatch>::iterator itBatch = _readBatches.begin();
+    while (itBatch != _readBatches.end())
+    {
+        if ((*itBatch).pendingKeys.remove(key) && (*itBatch).pendingKeys.isEmpty() && (*itBatch).ended)
+        {
+            finishedBatchIds.append(itBatch.key());
+        }
+        ++itBatch;
+    }
+
+    for (quint32 batchId : finishedBatchIds)
+    {
+        finishReadBatch(batchId);
+    }
+}
+
+void NodeOd::finishReadBatch(quint32 batchId)
+{
+    ReadBatch batch = _readBatches.take(batchId);
+
+    QList<ReadResult> results;
+    results.reserve(batch.objectIds.count());
+    for (const NodeObjectId &objectId : qAsConst(batch.objectIds))
+    {
+        ReadResult result;
+        result.objectId = objectId;
+        quint32 key = (static_cast<quint32>(objectId.index()) << 8) + objectId.subIndex();
+        if (batch.pendingKeys.contains(key))
+        {
+            result.error = SDO::CO_SDO_ABORT_CODE_NO_DATA_AVAILABLE;
+        }
+        else if (!subIndexExist(objectId.index(), objectId.subIndex()))
+        {
+            result.error = SDO::CO_SDO_ABORT_CODE_NO_OBJECT;
+        }
+        else
+        {
+            result.value = value(objectId);
+            result.error = errorObject(objectId);
+        }
+        results.append(result);
+    }
+
+    emit objectsRead(batchId, results);
 }
@@ -23,8 +23,13 @@
 
 #include <QObject>
 
+#include <QBitArray>
+#include <QHash>
 #include <QMap>
-#include <QMultiMap>
+#include <QSet>
+#include <QSharedPointer>
+#include <QTimer>
+#include <QVector>
 
 #include "nodeindex.h"
 #include "nodeobjectid.h"
@@ -32,6 +37,7 @@
 
 class Node;
 class NodeOdSubscriber;
+class NodeOdTemplate;
 
 class CANOPEN_EXPORT NodeOd : public QObject
 {
@@ -92,29 +98,72 @@ public:
         Sdo = 0x08,
         Pdo = 0x10
     };
-    void subscribe(NodeOdSubscriber *object, quint16 notifyIndex, quint8 notifySubIndex);
+    void subscribe(NodeOdSubscriber *object, quint16 notifyIndex, quint8 notifySubIndex, int refreshPeriodMs = 0);
+    void setRefreshPeriod(NodeOdSubscriber *object, quint16 index, quint8 subIndex, int refreshPeriodMs);
     void unsubscribe(NodeOdSubscriber *object);
     void unsubscribe(NodeOdSubscriber *object, quint16 notifyIndex, quint8 notifySubIndex);
     void updateObjectFromDevice(quint16 index, quint8 subindex, const QVariant &value, NodeOd::FlagsRequest flags, const QDateTime &modificationDate = QDateTime());
+    void updateObjectFromDevice(quint16 index, quint8 subindex, const NodeValue &value, NodeOd::FlagsRequest flags, qint64 timeStamp = 0);
+    void updateObjectFromDevice(NodeSubIndex *nodeSubIndex, const NodeValue &value, NodeOd::FlagsRequest flags, qint64 timeStamp = 0);
+
+    // coalesced notifications period, 0 for the next event loop iteration
+    int notifyPeriod() const;
+    void setNotifyPeriod(int ms);
+
+    // batch read, started with Node::readObjects()
+    struct ReadResult
+    {
+        NodeObjectId objectId;
+        QVariant value;
+        quint32 error;
+    };
+    bool isReadBatchPending(quint32 batchId) const;
 
     // default objects
     void createMandatoryObjects();
     void createBootloaderObjects();
 
+signals:
+    void objectsRead(quint32 batchId, const QList<NodeOd::ReadResult> &results);
+
 private:
+    friend class Node;
     Node *_node;
     QMap<quint16, NodeIndex *> _nodeIndexes;
     QString _edsFileName;
     QMap<QString, QString> _edsFileInfos;
-
-    struct Subscriber
+    QSharedPointer<const NodeOdTemplate> _odTemplate;  // keeps the template cached while used
+
+    // subscribers by key (index << 8) + subIndex, 0xFF subIndex for a whole index, 0xFFFFFF for the full od
+    QHash<quint32, QVector<NodeOdSubscriber *>> _subscribers;
+    QHash<NodeOdSubscriber *, int> _subscriptionCount;
+    quint32 _unsubscribeCount;
+    bool notifySubscribers(quint32 key, const NodeObjectId &objId, NodeOd::FlagsRequest flags, bool coalesce);
+    void notifyObjectUpdated(NodeSubIndex *nodeSubIndex, NodeOd::FlagsRequest flags);
+
+    // PDO updates for coalesced subscribers, dirty objects are flushed by _notifyTimer
+    QVector<NodeSubIndex *> _notifySlots;
+    QBitArray _dirtyBits;
+    QVector<int> _dirtySlots;
+    QTimer *_notifyTimer;
+    void markDirty(NodeSubIndex *nodeSubIndex);
+    void flushNotifications();
+
+    struct ReadBatch
     {
-        NodeOdSubscriber *object;
-        quint16 notifyIndex;
-        quint8 notifySubIndex;
+        QList<NodeObjectId> objectIds;
+        QSet<quint32> pendingKeys;
+        bool ended;
     };
-    QMultiMap<quint32, Subscriber> _subscribers;
-    void notifySubscribers(quint32 key, quint16 notifyIndex, quint8 notifySubIndex, NodeOd::FlagsRequest flags);
+    quint32 _nextReadBatchId;
+    QMap<quint32, ReadBatch> _readBatches;
+    QHash<quint32, bool> _readBatchKeys;  // pending object key -> notify index and full od subscribers
+    quint32 beginReadBatch();
+    void addToReadBatch(quint32 batchId, const NodeObjectId &objectId, bool pending, bool notifyAll);
+    void endReadBatch(quint32 batchId);
+    void cancelReadBatches();
+    void completeReadBatchObject(quint32 key);
+    void finishReadBatch(quint32 batchId);
 };
 
 #endif  // NODEOD_H
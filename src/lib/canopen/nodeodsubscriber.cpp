@@ -26,6 +26,7 @@
 NodeOdSubscriber::NodeOdSubscriber()
 {
     _nodeInterrest = nullptr;
+    _notifyMode = NotifySynchronous;
 }
 
 NodeOdSubscriber::~NodeOdSubscriber()
@@ -38,6 +39,57 @@ void NodeOdSubscriber::notifySubscriber(const NodeObjectId &objId, NodeOd::Flags
     this->odNotify(objId, flags);
 }
 
+void NodeOdSubscriber::notifySubscriber(const QList<NodeObjectId> &objIds)
+{
+    this->odNotifyChanged(objIds);
+}
+
+void NodeOdSubscriber::notifyRefreshPeriod(const NodeObjectId &objId, int achievedPeriodMs)
+{
+    this->odRefreshPeriodChanged(objId, achievedPeriodMs);
+}
+
+NodeOdSubscriber::NotifyMode NodeOdSubscriber::notifyMode() const
+{
+    return _notifyMode;
+}
+
+/**
+ * @brief Sets PDO updates delivery mode
+ *
+ * Synchronous subscribers get each PDO update immediately through odNotify().
+ * Coalesced subscribers get objects updated by PDOs once per NodeOd notify
+ * period through odNotifyChanged(), suitable for display. SDO answers are
+ * always synchronous.
+ */
+void NodeOdSubscriber::setNotifyMode(NotifyMode notifyMode)
+{
+    _notifyMode = notifyMode;
+}
+
+/**
+ * @brief Coalesced PDO updates, calls odNotify() for each object by default
+ * @param objIds objects updated since the last call
+ */
+void NodeOdSubscriber::odNotifyChanged(const QList<NodeObjectId> &objIds)
+{
+    for (const NodeObjectId &objId : objIds)
+    {
+        this->odNotify(objId, NodeOd::Pdo);
+    }
+}
+
+/**
+ * @brief Period at which an object with a refresh request is actually updated, does nothing by default
+ * @param objId object of the node
+ * @param achievedPeriodMs measured update period in ms
+ */
+void NodeOdSubscriber::odRefreshPeriodChanged(const NodeObjectId &objId, int achievedPeriodMs)
+{
+    Q_UNUSED(objId)
+    Q_UNUSED(achievedPeriodMs)
+}
+
 Node *NodeOdSubscriber::nodeInterrest() const
 {
     return _nodeInterrest;
@@ -56,6 +108,13 @@ void NodeOdSubscriber::setNodeInterrest(Node *nodeInterrest)
                 objId.setBusIdNodeId(0xFF, 0xFF);
             }
         }
+        for (RefreshRequest &request : _refreshRequests)
+        {
+            if (request.objId.node() == _nodeInterrest)
+            {
+                request.objId.setBusIdNodeId(0xFF, 0xFF);
+            }
+        }
     }
 
     _nodeInterrest = nodeInterrest;
@@ -72,6 +131,13 @@ void NodeOdSubscriber::setNodeInterrest(Node *nodeInterrest)
                 this->odNotify(objId, NodeOd::Read);
             }
         }
+        for (const RefreshRequest &request : qAsConst(_refreshRequests))
+        {
+            if (request.objId.isNodeIndependant())
+            {
+                _nodeInterrest->nodeOd()->setRefreshPeriod(this, request.objId.index(), request.objId.subIndex(), request.periodMs);
+            }
+        }
     }
 }
 
@@ -107,14 +173,18 @@ void NodeOdSubscriber::writeObject(quint16 index, quint8 subindex, const QVarian
     }
 }
 
-void NodeOdSubscriber::registerObjId(const NodeObjectId &objId)
+void NodeOdSubscriber::registerObjId(const NodeObjectId &objId, int refreshPeriodMs)
 {
     registerKey(objId);
+    if (refreshPeriodMs > 0)
+    {
+        setRefreshPeriod(objId, refreshPeriodMs);
+    }
 }
 
-void NodeOdSubscriber::registerSubIndex(quint16 index, quint8 subindex)
+void NodeOdSubscriber::registerSubIndex(quint16 index, quint8 subindex, int refreshPeriodMs)
 {
-    registerKey(NodeObjectId(index, subindex));
+    registerObjId(NodeObjectId(index, subindex), refreshPeriodMs);
 }
 
 void NodeOdSubscriber::registerIndex(quint16 index)
@@ -144,6 +214,17 @@ void NodeOdSubscriber::unRegisterIndex(quint16 index)
 
 void NodeOdSubscriber::unRegisterFullOd()
 {
+    // requests on other nodes than _nodeInterrest, the later are released with unsubscribe
+    for (const RefreshRequest &request : qAsConst(_refreshRequests))
+    {
+        Node *node = request.objId.node();
+        if (node != nullptr && node != _nodeInterrest)
+        {
+            node->nodeOd()->setRefreshPeriod(this, request.objId.index(), request.objId.subIndex(), 0);
+        }
+    }
+    _refreshRequests.clear();
+
     _indexSubIndexList.clear();
     _objIdList.clear();
     if (_nodeInterrest != nullptr)
@@ -157,6 +238,80 @@ QList<NodeObjectId> NodeOdSubscriber::objIdList() const
     return _objIdList;
 }
 
+/**
+ * @brief Refresh period requested for an object, 0 if not refreshed
+ */
+int NodeOdSubscriber::refreshPeriod(const NodeObjectId &objId) const
+{
+    for (const RefreshRequest &request : _refreshRequests)
+    {
+        if (request.objId == objId)
+        {
+            return request.periodMs;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Requests an object to be read periodically, 0 to cancel the request
+ *
+ * The node reads each object once at the fastest period requested by all its
+ * subscribers, notifications are received as for any subscribed object and
+ * the achieved period is reported with odRefreshPeriodChanged(). A node
+ * independent object follows nodeInterrest().
+ * @param objId object, a sub index
+ * @param refreshPeriodMs requested period in ms
+ */
+void NodeOdSubscriber::setRefreshPeriod(const NodeObjectId &objId, int refreshPeriodMs)
+{
+    refreshPeriodMs = qMax(refreshPeriodMs, 0);
+    int i = 0;
+    while (i < _refreshRequests.count() && !(_refreshRequests.at(i).objId == objId))
+    {
+        i++;
+    }
+
+    if (i < _refreshRequests.count())
+    {
+        if (_refreshRequests.at(i).periodMs == refreshPeriodMs)
+        {
+            return;
+        }
+        if (refreshPeriodMs == 0)
+        {
+            _refreshRequests.removeAt(i);
+        }
+        else
+        {
+            _refreshRequests[i].periodMs = refreshPeriodMs;
+        }
+    }
+    else
+    {
+        if (refreshPeriodMs == 0)
+        {
+            return;
+        }
+        _refreshRequests.append({objId, refreshPeriodMs});
+    }
+
+    Node *node = _nodeInterrest;
+    if (!objId.isNodeIndependant() && (node == nullptr || node->busId() != objId.busId() || node->nodeId() != objId.nodeId()))
+    {
+        node = objId.node();
+    }
+    if (node != nullptr)
+    {
+        node->nodeOd()->setRefreshPeriod(this, objId.index(), objId.subIndex(), refreshPeriodMs);
+    }
+}
+
+void NodeOdSubscriber::setRefreshPeriod(quint16 index, quint8 subindex, int refreshPeriodMs)
+{
+    setRefreshPeriod(NodeObjectId(index, subindex), refreshPeriodMs);
+}
+
 void NodeOdSubscriber::registerKey(const NodeObjectId &objId)
 {
     quint64 key = objId.key();
@@ -188,6 +343,8 @@ void NodeOdSubscriber::registerKey(const NodeObjectId &objId)
 
 void NodeOdSubscriber::unRegisterKey(const NodeObjectId &objId)
 {
+    setRefreshPeriod(objId, 0);
+
     quint64 key = objId.key();
     if (!_indexSubIndexList.contains(key))
     {
@@ -37,6 +37,17 @@ public:
     virtual ~NodeOdSubscriber();
 
     void notifySubscriber(const NodeObjectId &objId, NodeOd::FlagsRequest flags);
+    void notifySubscriber(const QList<NodeObjectId> &objIds);
+    void notifyRefreshPeriod(const NodeObjectId &objId, int achievedPeriodMs);
+
+    // PDO updates delivery, synchronous by default
+    enum NotifyMode
+    {
+        NotifySynchronous,
+        NotifyCoalesced
+    };
+    NotifyMode notifyMode() const;
+    void setNotifyMode(NotifyMode notifyMode);
 
     QList<NodeObjectId> objIdList() const;
 
@@ -49,8 +60,8 @@ protected:
     void writeObject(const NodeObjectId &id, const QVariant &data);
     void writeObject(quint16 index, quint8 subindex, const QVariant &data);
 
-    void registerObjId(const NodeObjectId &objId);
-    void registerSubIndex(quint16 index, quint8 subindex);
+    void registerObjId(const NodeObjectId &objId, int refreshPeriodMs = 0);
+    void registerSubIndex(quint16 index, quint8 subindex, int refreshPeriodMs = 0);
     void registerIndex(quint16 index);
     void registerFullOd();
 
@@ -59,14 +70,28 @@ protected:
     void unRegisterIndex(quint16 index);
     void unRegisterFullOd();
 
+    // periodic refresh, requests of all subscribers of a node are merged
+    int refreshPeriod(const NodeObjectId &objId) const;
+    void setRefreshPeriod(const NodeObjectId &objId, int refreshPeriodMs);
+    void setRefreshPeriod(quint16 index, quint8 subindex, int refreshPeriodMs);
+
     virtual void odNotify(const NodeObjectId &objId, NodeOd::FlagsRequest flags) = 0;  // TODO constify flags param
+    virtual void odNotifyChanged(const QList<NodeObjectId> &objIds);
+    virtual void odRefreshPeriodChanged(const NodeObjectId &objId, int achievedPeriodMs);
 
 private:
     friend class NodeOd;
 
     Node *_nodeInterrest;
+    NotifyMode _notifyMode;
     QSet<quint64> _indexSubIndexList;
     QList<NodeObjectId> _objIdList;
+    struct RefreshRequest
+    {
+        NodeObjectId objId;
+        int periodMs;
+    };
+    QList<RefreshRequest> _refreshRequests;
     void registerKey(const NodeObjectId &objId);
     void unRegisterKey(const NodeObjectId &objId);
 };
@@ -0,0 +1,190 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "nodeodtemplate.h"
+
+#include "indexdb.h"
+#include "parser/edsparser.h"
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+
+QHash<QString, QWeakPointer<const NodeOdTemplate>> NodeOdTemplate::_templates;
+QMutex NodeOdTemplate::_templatesMutex;
+
+NodeOdTemplate::NodeOdTemplate()
+{
+}
+
+NodeOdTemplate::~NodeOdTemplate()
+{
+    qDeleteAll(_indexes);
+}
+
+/**
+ * @brief Returns the template of an eds file, parsed only if not already used by a node or if modified
+ * @param fileName eds file path
+ * @return shared template, null if the file cannot be read
+ */
+QSharedPointer<const NodeOdTemplate> NodeOdTemplate::load(const QString &fileName)
+{
+    const QString canonicalFileName = QFileInfo(fileName).canonicalFilePath();
+    if (canonicalFileName.isEmpty())
+    {
+        return QSharedPointer<const NodeOdTemplate>();
+    }
+
+    QFile file(canonicalFileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return QSharedPointer<const NodeOdTemplate>();
+    }
+    QCryptographicHash hasher(QCryptographicHash::Md5);
+    hasher.addData(&file);
+    const QByteArray hash = hasher.result();
+    file.close();
+
+    // kept locked while parsing, nodes loading the same file wait for the first one
+    QMutexLocker locker(&_templatesMutex);
+
+    QSharedPointer<const NodeOdTemplate> odTemplate = _templates.value(canonicalFileName).toStrongRef();
+    if (!odTemplate.isNull() && odTemplate->hash() == hash)
+    {
+        return odTemplate;
+    }
+
+    NodeOdTemplate *newTemplate = new NodeOdTemplate();
+    newTemplate->_hash = hash;
+    if (!newTemplate->build(canonicalFileName))
+    {
+        delete newTemplate;
+        return QSharedPointer<const NodeOdTemplate>();
+    }
+    odTemplate = QSharedPointer<const NodeOdTemplate>(newTemplate);
+
+    // drop templates not used anymore
+    QHash<QString, QWeakPointer<const NodeOdTemplate>>::iterator it = _templates.begin();
+    while (it != _templates.end())
+    {
+        if ((*it).isNull())
+        {
+            it = _templates.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    _templates.insert(canonicalFileName, odTemplate);
+
+    return odTemplate;
+}
+
+/**
+ * @brief Canonical path of the eds file
+ */
+const QString &NodeOdTemplate::fileName() const
+{
+    return _fileName;
+}
+
+/**
+ * @brief Hash of the eds file content when parsed
+ */
+const QByteArray &NodeOdTemplate::hash() const
+{
+    return _hash;
+}
+
+const QMap<QString, QString> &NodeOdTemplate::fileInfos() const
+{
+    return _fileInfos;
+}
+
+/**
+ * @brief Prototype indexes, sub-indexes of nodes share their description
+ */
+const QMap<quint16, NodeIndex *> &NodeOdTemplate::indexes() const
+{
+    return _indexes;
+}
+
+/**
+ * @brief Default value relative to node id ($NODEID in eds), prototype default value is the offset
+ */
+bool NodeOdTemplate::hasNodeId(quint16 index, quint8 subIndex) const
+{
+    return _nodeIdObjects.contains((static_cast<quint32>(index) << 8) + subIndex);
+}
+
+bool NodeOdTemplate::build(const QString &fileName)
+{
+    EdsParser parser;
+    DeviceDescription *deviceDescription = parser.parse(fileName);
+    if (deviceDescription == nullptr)
+    {
+        return false;
+    }
+
+    _fileName = fileName;
+    _fileInfos = deviceDescription->fileInfos();
+    const quint16 profileNumber = static_cast<quint16>(deviceDescription->subIndexValue(0x1000, 0, 0).toUInt() & 0x0000FFFFU);
+
+    for (Index *odIndex : deviceDescription->indexes())
+    {
+        NodeIndex *nodeIndex = new NodeIndex(odIndex->index());
+        nodeIndex->setName(odIndex->name());
+        nodeIndex->setObjectType(static_cast<NodeIndex::ObjectType>(odIndex->objectType()));
+        _indexes.insert(nodeIndex->index(), nodeIndex);
+
+        for (SubIndex *odSubIndex : odIndex->subIndexes())
+        {
+            NodeSubIndex *nodeSubIndex = new NodeSubIndex(odSubIndex->subIndex());
+            if (odSubIndex->hasNodeId())
+            {
+                QString value = odSubIndex->value().toString();
+                uint8_t base = 10;
+                if (value.startsWith("0x"))
+                {
+                    base = 16;
+                }
+                nodeSubIndex->setDefaultValue(value.toUInt(nullptr, base));
+                _nodeIdObjects.insert((static_cast<quint32>(odIndex->index()) << 8) + odSubIndex->subIndex());
+            }
+            else
+            {
+                nodeSubIndex->setDefaultValue(odSubIndex->value());
+            }
+            nodeSubIndex->setName(odSubIndex->name());
+            nodeSubIndex->setAccessType(static_cast<NodeSubIndex::AccessType>(odSubIndex->accessType()));
+            nodeSubIndex->setDataType(static_cast<NodeSubIndex::DataType>(odSubIndex->dataType()));
+            nodeSubIndex->setLowLimit(odSubIndex->lowLimit());
+            nodeSubIndex->setHighLimit(odSubIndex->highLimit());
+            nodeIndex->addSubIndex(nodeSubIndex);
+
+            nodeSubIndex->setQ1516(IndexDb::isQ1516(nodeSubIndex->objectId(), profileNumber));
+            nodeSubIndex->setScale(IndexDb::scale(nodeSubIndex->objectId(), profileNumber));
+            nodeSubIndex->setUnit(IndexDb::unit(nodeSubIndex->objectId(), profileNumber));
+        }
+    }
+
+    delete deviceDescription;
+    return true;
+}
@@ -0,0 +1,71 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NODEODTEMPLATE_H
+#define NODEODTEMPLATE_H
+
+#include "canopen_global.h"
+
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QSet>
+#include <QSharedPointer>
+#include <QWeakPointer>
+
+#include "nodeindex.h"
+
+/**
+ * @brief Immutable object dictionary parsed from an eds file, shared by all nodes loaded from it
+ *
+ * Templates are cached by canonical path and content hash, an eds file is parsed
+ * once whatever the number of nodes using it. Nodes share the description of
+ * each sub-index with the template and only own their values. A template is
+ * freed with the last node using it.
+ */
+class CANOPEN_EXPORT NodeOdTemplate
+{
+    Q_DISABLE_COPY(NodeOdTemplate)
+public:
+    ~NodeOdTemplate();
+
+    static QSharedPointer<const NodeOdTemplate> load(const QString &fileName);
+
+    const QString &fileName() const;
+    const QByteArray &hash() const;
+    const QMap<QString, QString> &fileInfos() const;
+
+    const QMap<quint16, NodeIndex *> &indexes() const;
+    bool hasNodeId(quint16 index, quint8 subIndex) const;
+
+private:
+    NodeOdTemplate();
+
+    QString _fileName;
+    QByteArray _hash;
+    QMap<QString, QString> _fileInfos;
+    QMap<quint16, NodeIndex *> _indexes;
+    QSet<quint32> _nodeIdObjects;  // (index << 8) + subIndex of objects with default value relative to node id
+
+    bool build(const QString &fileName);
+
+    static QHash<QString, QWeakPointer<const NodeOdTemplate>> _templates;
+    static QMutex _templatesMutex;
+};
+
+#endif  // NODEODTEMPLATE_H
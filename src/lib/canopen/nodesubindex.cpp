@@ -21,38 +21,48 @@
 #include "nodeindex.h"
 #include "nodeod.h"
 
+// strict comparison, a value of an other type is not the same even if convertible
+static bool sameVariant(const QVariant &a, const QVariant &b)
+{
+    return a.userType() == b.userType() && a == b;
+}
+
 NodeSubIndex::NodeSubIndex(quint8 subIndex)
 {
     _nodeIndex = nullptr;
+    _notifySlot = -1;
 
     _subIndex = subIndex;
-    _accessType = NOACESS;
-    _dataType = NONE;
+
+    _timeStamp = 0;
+    _sequence = 0;
+    _valueOutdated = false;
 
     _error = 0;
-    _q1516 = false;
-    _scale = 1.0;
+
+    _description = new Description();
+    _description->accessType = NOACESS;
+    _description->dataType = NONE;
+    _description->q1516 = false;
+    _description->scale = 1.0;
 }
 
 NodeSubIndex::NodeSubIndex(const NodeSubIndex &other)
 {
     _nodeIndex = nullptr;
+    _notifySlot = -1;
 
     _subIndex = other.subIndex();
-    _name = other.name();
-    _accessType = other.accessType();
 
-    _value = other._value;
-    _defaultValue = other._defaultValue;
-    _dataType = other._dataType;
-
-    _lowLimit = other._lowLimit;
-    _highLimit = other._highLimit;
-
-    _lastModification = other._lastModification;
+    _nodeValue = other._nodeValue;
+    _timeStamp = other._timeStamp;
+    _sequence = other._sequence;
+    _value = other.value();
+    _valueOutdated = false;
 
     _error = 0;
-    _q1516 = false;
+
+    _description = other._description;
 }
 
 /**
@@ -141,7 +151,7 @@ void NodeSubIndex::setSubIndex(uint8_t subIndex)
  */
 const QString &NodeSubIndex::name() const
 {
-    return _name;
+    return _description->name;
 }
 
 /**
@@ -150,7 +160,10 @@ const QString &NodeSubIndex::name() const
  */
 void NodeSubIndex::setName(const QString &name)
 {
-    _name = name;
+    if (_description.constData()->name != name)
+    {
+        _description->name = name;
+    }
 }
 
 /**
@@ -159,7 +172,7 @@ void NodeSubIndex::setName(const QString &name)
  */
 NodeSubIndex::AccessType NodeSubIndex::accessType() const
 {
-    return _accessType;
+    return _description->accessType;
 }
 
 /**
@@ -168,7 +181,10 @@ NodeSubIndex::AccessType NodeSubIndex::accessType() const
  */
 void NodeSubIndex::setAccessType(AccessType accessType)
 {
-    _accessType = accessType;
+    if (_description.constData()->accessType != accessType)
+    {
+        _description->accessType = accessType;
+    }
 }
 
 /**
@@ -177,7 +193,7 @@ void NodeSubIndex::setAccessType(AccessType accessType)
  */
 bool NodeSubIndex::isReadable() const
 {
-    return (_accessType & READ) != 0;
+    return (_description->accessType & READ) != 0;
 }
 
 /**
@@ -186,7 +202,7 @@ bool NodeSubIndex::isReadable() const
  */
 bool NodeSubIndex::isWritable() const
 {
-    return (_accessType & WRITE) != 0;
+    return (_description->accessType & WRITE) != 0;
 }
 
 /**
@@ -195,7 +211,7 @@ bool NodeSubIndex::isWritable() const
  */
 bool NodeSubIndex::hasTPDOAccess() const
 {
-    return (_accessType & TPDO) != 0;
+    return (_description->accessType & TPDO) != 0;
 }
 
 /**
@@ -204,26 +220,26 @@ bool NodeSubIndex::hasTPDOAccess() const
  */
 bool NodeSubIndex::hasRPDOAccess() const
 {
-    return (_accessType & RPDO) != 0;
+    return (_description->accessType & RPDO) != 0;
 }
 
 QString NodeSubIndex::accessString() const
 {
     QString acces;
 
-    if ((_accessType & READ) != 0)
+    if ((_description->accessType & READ) != 0)
     {
         acces += "R";
     }
-    if ((_accessType & WRITE) != 0)
+    if ((_description->accessType & WRITE) != 0)
     {
         acces += "W";
     }
-    if ((_accessType & TPDO) != 0)
+    if ((_description->accessType & TPDO) != 0)
     {
         acces += " TPDO";
     }
-    if ((_accessType & RPDO) != 0)
+    if ((_description->accessType & RPDO) != 0)
     {
         acces += " RPDO";
     }
@@ -232,11 +248,16 @@ QString NodeSubIndex::accessString() const
 }
 
 /**
- * @brief _value getter
+ * @brief _value getter, built from the typed value cell on first access after an update
  * @return return sub-index value
  */
 const QVariant &NodeSubIndex::value() const
 {
+    if (_valueOutdated)
+    {
+        _value = _nodeValue.toVariant();
+        _valueOutdated = false;
+    }
     return _value;
 }
 
@@ -246,15 +267,10 @@ const QVariant &NodeSubIndex::value() const
  */
 void NodeSubIndex::setValue(const QVariant &value, const QDateTime &modificationDate)
 {
-    _value.setValue(value);
-    if (modificationDate.isNull())
-    {
-        _lastModification = QDateTime::currentDateTime();
-    }
-    else
-    {
-        _lastModification = modificationDate;
-    }
+    _nodeValue = NodeValue::fromVariant(value);
+    _value = value;
+    _valueOutdated = false;
+    touch(modificationDate.isNull() ? 0 : modificationDate.toMSecsSinceEpoch() * 1000);
 }
 
 /**
@@ -263,8 +279,53 @@ void NodeSubIndex::setValue(const QVariant &value, const QDateTime &modification
  */
 void NodeSubIndex::clearValue()
 {
+    _nodeValue = NodeValue();
     _value.clear();
-    _lastModification = QDateTime::currentDateTime();
+    _valueOutdated = false;
+    touch(0);
+}
+
+/**
+ * @brief Typed value cell, invalid for strings and domains
+ */
+const NodeValue &NodeSubIndex::nodeValue() const
+{
+    return _nodeValue;
+}
+
+/**
+ * @brief Typed value setter, the QVariant value is only built when read
+ * @param value new value
+ * @param timeStamp modification time in us since epoch, 0 for now
+ */
+void NodeSubIndex::setValue(const NodeValue &value, qint64 timeStamp)
+{
+    _nodeValue = value;
+    _valueOutdated = true;
+    touch(timeStamp);
+}
+
+/**
+ * @brief Last modification time
+ * @return time in us since epoch
+ */
+qint64 NodeSubIndex::timeStamp() const
+{
+    return _timeStamp;
+}
+
+/**
+ * @brief Modification counter, incremented on each value update
+ */
+quint32 NodeSubIndex::sequence() const
+{
+    return _sequence;
+}
+
+void NodeSubIndex::touch(qint64 timeStamp)
+{
+    _timeStamp = (timeStamp != 0) ? timeStamp : QDateTime::currentMSecsSinceEpoch() * 1000;
+    _sequence++;
 }
 
 /**
@@ -273,7 +334,7 @@ void NodeSubIndex::clearValue()
  */
 const QVariant &NodeSubIndex::defaultValue() const
 {
-    return _defaultValue;
+    return _description->defaultValue;
 }
 
 /**
@@ -282,7 +343,10 @@ const QVariant &NodeSubIndex::defaultValue() const
  */
 void NodeSubIndex::setDefaultValue(const QVariant &value)
 {
-    _defaultValue.setValue(value);
+    if (!sameVariant(_description.constData()->defaultValue, value))
+    {
+        _description->defaultValue = value;
+    }
 }
 
 /**
@@ -291,8 +355,7 @@ void NodeSubIndex::setDefaultValue(const QVariant &value)
  */
 void NodeSubIndex::resetValue()
 {
-    _value.setValue(_defaultValue);
-    _lastModification = QDateTime::currentDateTime();
+    setValue(_description.constData()->defaultValue);
 }
 
 /**
@@ -328,7 +391,7 @@ void NodeSubIndex::clearError()
  */
 NodeSubIndex::DataType NodeSubIndex::dataType() const
 {
-    return _dataType;
+    return _description->dataType;
 }
 
 /**
@@ -337,7 +400,10 @@ NodeSubIndex::DataType NodeSubIndex::dataType() const
  */
 void NodeSubIndex::setDataType(DataType dataType)
 {
-    _dataType = dataType;
+    if (_description.constData()->dataType != dataType)
+    {
+        _description->dataType = dataType;
+    }
 }
 
 /**
@@ -407,7 +473,7 @@ QString NodeSubIndex::dataTypeStr(DataType dataType)
 
 bool NodeSubIndex::isNumeric() const
 {
-    switch (_dataType)
+    switch (_description->dataType)
     {
         case INTEGER8:
         case INTEGER16:
@@ -436,7 +502,7 @@ bool NodeSubIndex::isNumeric() const
 
 QMetaType::Type NodeSubIndex::metaType() const
 {
-    return NodeOd::dataTypeCiaToQt(_dataType);
+    return NodeOd::dataTypeCiaToQt(_description->dataType);
 }
 
 /**
@@ -445,7 +511,7 @@ QMetaType::Type NodeSubIndex::metaType() const
  */
 const QVariant &NodeSubIndex::lowLimit() const
 {
-    return _lowLimit;
+    return _description->lowLimit;
 }
 
 /**
@@ -454,7 +520,10 @@ const QVariant &NodeSubIndex::lowLimit() const
  */
 void NodeSubIndex::setLowLimit(const QVariant &lowLimit)
 {
-    _lowLimit = lowLimit;
+    if (!sameVariant(_description.constData()->lowLimit, lowLimit))
+    {
+        _description->lowLimit = lowLimit;
+    }
 }
 
 /**
@@ -463,7 +532,7 @@ void NodeSubIndex::setLowLimit(const QVariant &lowLimit)
  */
 bool NodeSubIndex::hasLowLimit() const
 {
-    return _lowLimit.isValid();
+    return _description->lowLimit.isValid();
 }
 
 /**
@@ -472,7 +541,7 @@ bool NodeSubIndex::hasLowLimit() const
  */
 const QVariant &NodeSubIndex::highLimit() const
 {
-    return _highLimit;
+    return _description->highLimit;
 }
 
 /**
@@ -481,7 +550,10 @@ const QVariant &NodeSubIndex::highLimit() const
  */
 void NodeSubIndex::setHighLimit(const QVariant &highLimit)
 {
-    _highLimit = highLimit;
+    if (!sameVariant(_description.constData()->highLimit, highLimit))
+    {
+        _description->highLimit = highLimit;
+    }
 }
 
 /**
@@ -490,7 +562,7 @@ void NodeSubIndex::setHighLimit(const QVariant &highLimit)
  */
 bool NodeSubIndex::hasHighLimit() const
 {
-    return _highLimit.isValid();
+    return _description->highLimit.isValid();
 }
 
 /**
@@ -499,7 +571,7 @@ bool NodeSubIndex::hasHighLimit() const
  */
 int NodeSubIndex::byteLength() const
 {
-    switch (_dataType)
+    switch (_description->dataType)
     {
         case NodeSubIndex::NONE:
             break;
@@ -562,7 +634,7 @@ int NodeSubIndex::byteLength() const
 
 int NodeSubIndex::bitLength() const
 {
-    switch (_dataType)
+    switch (_description->dataType)
     {
         case NodeSubIndex::NONE:
             break;
@@ -627,7 +699,7 @@ int NodeSubIndex::bitLength() const
 
 double NodeSubIndex::minType() const
 {
-    switch (_dataType)
+    switch (_description->dataType)
     {
         case NodeSubIndex::INTEGER8:
             return -((int64_t)1 << 7);
@@ -676,7 +748,7 @@ double NodeSubIndex::minType() const
 
 double NodeSubIndex::maxType() const
 {
-    switch (_dataType)
+    switch (_description->dataType)
     {
         case NodeSubIndex::INTEGER8:
             return ((int64_t)1 << 7) - 1;
@@ -739,35 +811,63 @@ double NodeSubIndex::maxType() const
 
 bool NodeSubIndex::isQ1516() const
 {
-    return _q1516;
+    return _description->q1516;
 }
 
 void NodeSubIndex::setQ1516(bool q1516)
 {
-    _q1516 = q1516;
+    if (_description.constData()->q1516 != q1516)
+    {
+        _description->q1516 = q1516;
+    }
 }
 
 double NodeSubIndex::scale() const
 {
-    return _scale;
+    return _description->scale;
 }
 
 void NodeSubIndex::setScale(double scale)
 {
-    _scale = scale;
+    if (_description.constData()->scale != scale)
+    {
+        _description->scale = scale;
+    }
 }
 
 QString NodeSubIndex::unit() const
 {
-    return _unit;
+    return _description->unit;
 }
 
 void NodeSubIndex::setUnit(const QString &unit)
 {
-    _unit = unit;
+    if (_description.constData()->unit != unit)
+    {
+        _description->unit = unit;
+    }
+}
+
+QDateTime NodeSubIndex::lastModification() const
+{
+    return QDateTime::fromMSecsSinceEpoch(_timeStamp / 1000);
+}
+
+/**
+ * @brief Shares the description (name, types, access, limits, default value and interpretation) of an other sub-index,
+ * copied again only if modified later
+ * @param other sub-index to share description with
+ */
+void NodeSubIndex::shareDescription(const NodeSubIndex &other)
+{
+    _description = other._description;
 }
 
-const QDateTime &NodeSubIndex::lastModification() const
+/**
+ * @brief Description shared with an other sub-index
+ * @return true if both sub-indexes use the same description block
+ */
+bool NodeSubIndex::sharesDescription(const NodeSubIndex &other) const
 {
-    return _lastModification;
+    return _description.constData() == other._description.constData();
 }
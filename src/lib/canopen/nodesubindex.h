@@ -21,10 +21,12 @@
 
 #include "canopen_global.h"
 
-#include <QTime>
+#include <QDateTime>
+#include <QSharedDataPointer>
 #include <QVariant>
 
 #include "nodeobjectid.h"
+#include "nodevalue.h"
 
 class Node;
 class NodeOd;
@@ -72,6 +74,12 @@ public:
     void setValue(const QVariant &value, const QDateTime &modificationDate = QDateTime());
     void clearValue();
 
+    // typed value cell, updated without allocation
+    const NodeValue &nodeValue() const;
+    void setValue(const NodeValue &value, qint64 timeStamp);
+    qint64 timeStamp() const;
+    quint32 sequence() const;
+
     const QVariant &defaultValue() const;
     void setDefaultValue(const QVariant &value);
     void resetValue();
@@ -139,31 +147,45 @@ public:
     QString unit() const;
     void setUnit(const QString &unit);
 
-    const QDateTime &lastModification() const;
+    QDateTime lastModification() const;
+
+    // Description sharing
+    void shareDescription(const NodeSubIndex &other);
+    bool sharesDescription(const NodeSubIndex &other) const;
 
 private:
     friend class NodeIndex;
+    friend class NodeOd;
     NodeIndex *_nodeIndex;
+    int _notifySlot;  // dirty bit of coalesced notifications, allocated by NodeOd on first use
 
     quint8 _subIndex;
-    QString _name;
-    AccessType _accessType;
 
-    QVariant _value;
-    QVariant _defaultValue;
-    DataType _dataType;
+    NodeValue _nodeValue;
+    qint64 _timeStamp;  // us since epoch, same clock as CanFrame::timeStamp()
+    quint32 _sequence;
+    mutable QVariant _value;  // strings and domains, or cache of _nodeValue
+    mutable bool _valueOutdated;
+    void touch(qint64 timeStamp);
 
     quint32 _error;
 
-    QVariant _lowLimit;
-    QVariant _highLimit;
-
-    QDateTime _lastModification;
-
-    // TODO add enum for interpretation
-    bool _q1516;
-    double _scale;
-    QString _unit;
+    // description, shared by nodes loaded from the same eds and detached on first change
+    struct Description : public QSharedData
+    {
+        QString name;
+        AccessType accessType;
+        QVariant defaultValue;
+        DataType dataType;
+        QVariant lowLimit;
+        QVariant highLimit;
+
+        // TODO add enum for interpretation
+        bool q1516;
+        double scale;
+        QString unit;
+    };
+    QSharedDataPointer<Description> _description;
 };
 
 #endif  // NODESUBINDEX_H
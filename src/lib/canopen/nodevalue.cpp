@@ -0,0 +1,408 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2019-2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "nodevalue.h"
+
+#include <QtEndian>
+
+NodeValue::NodeValue()
+{
+    _data.u64 = 0;
+    _type = QMetaType::UnknownType;
+}
+
+/**
+ * @brief Decodes a value from a little endian buffer, as found in SDO and PDO payloads
+ * @param data buffer, at least QMetaType::sizeOf(type) bytes long
+ * @param type Qt meta type of the value
+ * @return decoded value, invalid for unsupported types
+ */
+NodeValue NodeValue::fromLittleEndian(const uchar *data, QMetaType::Type type)
+{
+    switch (type)
+    {
+        case QMetaType::Bool:
+            return fromNative<bool>(type, data[0] != 0);
+
+        case QMetaType::Char:
+        case QMetaType::SChar:
+            return fromNative<qint8>(type, static_cast<qint8>(data[0]));
+
+        case QMetaType::UChar:
+            return fromNative<quint8>(type, data[0]);
+
+        case QMetaType::Short:
+            return fromNative<qint16>(type, qFromLittleEndian<qint16>(data));
+
+        case QMetaType::UShort:
+            return fromNative<quint16>(type, qFromLittleEndian<quint16>(data));
+
+        case QMetaType::Int:
+            return fromNative<qint32>(type, qFromLittleEndian<qint32>(data));
+
+        case QMetaType::UInt:
+            return fromNative<quint32>(type, qFromLittleEndian<quint32>(data));
+
+        case QMetaType::Long:
+            return fromNative<long>(type, static_cast<long>(sizeof(long) == 8 ? qFromLittleEndian<qint64>(data) : qFromLittleEndian<qint32>(data)));
+
+        case QMetaType::ULong:
+            return fromNative<ulong>(type, static_cast<ulong>(sizeof(ulong) == 8 ? qFromLittleEndian<quint64>(data) : qFromLittleEndian<quint32>(data)));
+
+        case QMetaType::LongLong:
+            return fromNative<qint64>(type, qFromLittleEndian<qint64>(data));
+
+        case QMetaType::ULongLong:
+            return fromNative<quint64>(type, qFromLittleEndian<quint64>(data));
+
+        case QMetaType::Float:
+        {
+            quint32 raw = qFromLittleEndian<quint32>(data);
+            float value;
+            std::memcpy(&value, &raw, sizeof(value));
+            return fromNative<float>(type, value);
+        }
+
+        case QMetaType::Double:
+        {
+            quint64 raw = qFromLittleEndian<quint64>(data);
+            double value;
+            std::memcpy(&value, &raw, sizeof(value));
+            return fromNative<double>(type, value);
+        }
+
+        default:
+            return NodeValue();
+    }
+}
+
+/**
+ * @brief Converts a QVariant holding a basic type, keeps the variant type
+ * @return converted value, invalid for strings, domains and other types
+ */
+NodeValue NodeValue::fromVariant(const QVariant &value)
+{
+    QMetaType::Type type = static_cast<QMetaType::Type>(value.userType());
+    switch (type)
+    {
+        case QMetaType::Bool:
+            return fromNative<bool>(type, value.toBool());
+
+        case QMetaType::Char:
+            return fromNative<qint8>(type, static_cast<qint8>(value.value<char>()));
+
+        case QMetaType::SChar:
+            return fromNative<qint8>(type, value.value<signed char>());
+
+        case QMetaType::UChar:
+            return fromNative<quint8>(type, value.value<uchar>());
+
+        case QMetaType::Short:
+            return fromNative<qint16>(type, value.value<short>());
+
+        case QMetaType::UShort:
+            return fromNative<quint16>(type, value.value<ushort>());
+
+        case QMetaType::Int:
+            return fromNative<qint32>(type, value.toInt());
+
+        case QMetaType::UInt:
+            return fromNative<quint32>(type, value.toUInt());
+
+        case QMetaType::Long:
+            return fromNative<long>(type, value.value<long>());
+
+        case QMetaType::ULong:
+            return fromNative<ulong>(type, value.value<ulong>());
+
+        case QMetaType::LongLong:
+            return fromNative<qint64>(type, value.toLongLong());
+
+        case QMetaType::ULongLong:
+            return fromNative<quint64>(type, value.toULongLong());
+
+        case QMetaType::Float:
+            return fromNative<float>(type, value.toFloat());
+
+        case QMetaType::Double:
+            return fromNative<double>(type, value.toDouble());
+
+        default:
+            return NodeValue();
+    }
+}
+
+/**
+ * @brief Builds a value from the raw bits of a PDO mapped object
+ * @param bits raw little endian bits, aligned on bit 0
+ * @param bitLength mapped length, signed integers shorter than their type are sign extended
+ * @param type Qt meta type of the value
+ * @return value, invalid for unsupported types
+ */
+NodeValue NodeValue::fromBits(quint64 bits, int bitLength, QMetaType::Type type)
+{
+    if ((bitLength > 0) && (bitLength < 64))
+    {
+        bits &= (Q_UINT64_C(1) << bitLength) - 1;
+    }
+
+    switch (type)
+    {
+        case QMetaType::Bool:
+            return fromNative<bool>(type, bits != 0);
+
+        case QMetaType::Char:
+        case QMetaType::SChar:
+        case QMetaType::Short:
+        case QMetaType::Int:
+        case QMetaType::Long:
+        case QMetaType::LongLong:
+        {
+            if ((bitLength > 0) && (bitLength < 64) && ((bits >> (bitLength - 1)) & 1U) != 0)
+            {
+                bits |= ~Q_UINT64_C(0) << bitLength;
+            }
+            qint64 value = static_cast<qint64>(bits);
+            switch (type)
+            {
+                case QMetaType::Short:
+                    return fromNative<qint16>(type, static_cast<qint16>(value));
+                case QMetaType::Int:
+                    return fromNative<qint32>(type, static_cast<qint32>(value));
+                case QMetaType::Long:
+                    return fromNative<long>(type, static_cast<long>(value));
+                case QMetaType::LongLong:
+                    return fromNative<qint64>(type, value);
+                default:
+                    return fromNative<qint8>(type, static_cast<qint8>(value));
+            }
+        }
+
+        case QMetaType::UChar:
+            return fromNative<quint8>(type, static_cast<quint8>(bits));
+
+        case QMetaType::UShort:
+            return fromNative<quint16>(type, static_cast<quint16>(bits));
+
+        case QMetaType::UInt:
+            return fromNative<quint32>(type, static_cast<quint32>(bits));
+
+        case QMetaType::ULong:
+            return fromNative<ulong>(type, static_cast<ulong>(bits));
+
+        case QMetaType::ULongLong:
+            return fromNative<quint64>(type, bits);
+
+        case QMetaType::Float:
+        {
+            quint32 raw = static_cast<quint32>(bits);
+            float value;
+            std::memcpy(&value, &raw, sizeof(value));
+            return fromNative<float>(type, value);
+        }
+
+        case QMetaType::Double:
+        {
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return fromNative<double>(type, value);
+        }
+
+        default:
+            return NodeValue();
+    }
+}
+
+bool NodeValue::isSupportedType(QMetaType::Type type)
+{
+    switch (type)
+    {
+        case QMetaType::Bool:
+        case QMetaType::Char:
+        case QMetaType::SChar:
+        case QMetaType::UChar:
+        case QMetaType::Short:
+        case QMetaType::UShort:
+        case QMetaType::Int:
+        case QMetaType::UInt:
+        case QMetaType::Long:
+        case QMetaType::ULong:
+        case QMetaType::LongLong:
+        case QMetaType::ULongLong:
+        case QMetaType::Float:
+        case QMetaType::Double:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+bool NodeValue::isValid() const
+{
+    return _type != QMetaType::UnknownType;
+}
+
+QMetaType::Type NodeValue::type() const
+{
+    return static_cast<QMetaType::Type>(_type);
+}
+
+qint64 NodeValue::toInt64() const
+{
+    switch (_type)
+    {
+        case QMetaType::Bool:
+            return native<bool>() ? 1 : 0;
+
+        case QMetaType::Char:
+        case QMetaType::SChar:
+            return native<qint8>();
+
+        case QMetaType::UChar:
+            return native<quint8>();
+
+        case QMetaType::Short:
+            return native<qint16>();
+
+        case QMetaType::UShort:
+            return native<quint16>();
+
+        case QMetaType::Int:
+            return native<qint32>();
+
+        case QMetaType::UInt:
+            return native<quint32>();
+
+        case QMetaType::Long:
+            return native<long>();
+
+        case QMetaType::ULong:
+            return static_cast<qint64>(native<ulong>());
+
+        case QMetaType::LongLong:
+            return native<qint64>();
+
+        case QMetaType::ULongLong:
+            return static_cast<qint64>(native<quint64>());
+
+        case QMetaType::Float:
+            return static_cast<qint64>(native<float>());
+
+        case QMetaType::Double:
+            return static_cast<qint64>(native<double>());
+
+        default:
+            return 0;
+    }
+}
+
+quint64 NodeValue::toUInt64() const
+{
+    switch (_type)
+    {
+        case QMetaType::ULong:
+            return native<ulong>();
+
+        case QMetaType::ULongLong:
+            return native<quint64>();
+
+        default:
+            return static_cast<quint64>(toInt64());
+    }
+}
+
+double NodeValue::toDouble() const
+{
+    switch (_type)
+    {
+        case QMetaType::ULong:
+            return static_cast<double>(native<ulong>());
+
+        case QMetaType::ULongLong:
+            return static_cast<double>(native<quint64>());
+
+        case QMetaType::Float:
+            return static_cast<double>(native<float>());
+
+        case QMetaType::Double:
+            return native<double>();
+
+        default:
+            return static_cast<double>(toInt64());
+    }
+}
+
+/**
+ * @brief QVariant of the value type, basic types are stored inside the variant without allocation
+ */
+QVariant NodeValue::toVariant() const
+{
+    if (!isValid())
+    {
+        return QVariant();
+    }
+    return QVariant(static_cast<int>(_type), &_data);
+}
+
+/**
+ * @brief Raw bits of the value converted to the given type, as sent in a PDO
+ * @param type Qt meta type of the mapped object
+ * @return bits aligned on bit 0, to be masked to the mapped length
+ */
+quint64 NodeValue::toBits(QMetaType::Type type) const
+{
+    switch (type)
+    {
+        case QMetaType::Bool:
+            return (toInt64() != 0) ? 1U : 0U;
+
+        case QMetaType::Float:
+        {
+            float value = static_cast<float>(toDouble());
+            quint32 raw;
+            std::memcpy(&raw, &value, sizeof(raw));
+            return raw;
+        }
+
+        case QMetaType::Double:
+        {
+            double value = toDouble();
+            quint64 raw;
+            std::memcpy(&raw, &value, sizeof(raw));
+            return raw;
+        }
+
+        default:
+            if (_type == QMetaType::Float || _type == QMetaType::Double)
+            {
+                return static_cast<quint64>(static_cast<qint64>(toDouble()));
+            }
+            return toUInt64();
+    }
+}
+
+bool NodeValue::operator==(const NodeValue &other) const
+{
+    return (_type == other._type) && (_data.u64 == other._data.u64);
+}
+
+bool NodeValue::operator!=(const NodeValue &other) const
+{
+    return !(*this == other);
+}
@@ -0,0 +1,94 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2019-2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NODEVALUE_H
+#define NODEVALUE_H
+
+#include "canopen_global.h"
+
+#include <QMetaType>
+#include <QVariant>
+
+#include <cstring>
+
+/**
+ * @brief Compact typed value of an object, without allocation
+ *
+ * Holds one of the CANopen basic types up to 64 bits in its native
+ * representation, tagged with its Qt meta type. Strings and domains are not
+ * handled and give an invalid value. QVariant conversions are only needed at
+ * the GUI or scripting boundary.
+ */
+class CANOPEN_EXPORT NodeValue
+{
+public:
+    NodeValue();
+
+    template <typename T>
+    static NodeValue fromNative(QMetaType::Type type, T value);
+    static NodeValue fromLittleEndian(const uchar *data, QMetaType::Type type);
+    static NodeValue fromVariant(const QVariant &value);
+    static NodeValue fromBits(quint64 bits, int bitLength, QMetaType::Type type);
+    static bool isSupportedType(QMetaType::Type type);
+
+    bool isValid() const;
+    QMetaType::Type type() const;
+
+    qint64 toInt64() const;
+    quint64 toUInt64() const;
+    double toDouble() const;
+    QVariant toVariant() const;
+    quint64 toBits(QMetaType::Type type) const;
+
+    bool operator==(const NodeValue &other) const;
+    bool operator!=(const NodeValue &other) const;
+
+private:
+    union
+    {
+        qint64 i64;
+        quint64 u64;
+        double f64;
+    } _data;
+    quint16 _type;
+
+    template <typename T>
+    T native() const;
+};
+
+template <typename T>
+inline NodeValue NodeValue::fromNative(QMetaType::Type type, T value)
+{
+    static_assert(sizeof(T) <= sizeof(_data), "value too large for NodeValue");
+    NodeValue nodeValue;
+    nodeValue._type = static_cast<quint16>(type);
+    std::memcpy(&nodeValue._data, &value, sizeof(T));
+    return nodeValue;
+}
+
+template <typename T>
+inline T NodeValue::native() const
+{
+    T value;
+    std::memcpy(&value, &_data, sizeof(T));
+    return value;
+}
+
+Q_DECLARE_TYPEINFO(NodeValue, Q_PRIMITIVE_TYPE);
+
+#endif  // NODEVALUE_H
@@ -31,8 +31,33 @@ Mode::Mode(NodeProfile402 *nodeProfile402)
     _controlWordObjectId.setBusIdNodeId(_nodeProfile402->busId(), _nodeProfile402->nodeId());
 }
 
+/**
+ * @brief Objects which change continuously in this mode, updated while the profile is started
+ */
+QList<NodeObjectId> Mode::realTimeObjects() const
+{
+    return QList<NodeObjectId>();
+}
+
 void Mode::readRealTimeObjects()
 {
+    const QList<NodeObjectId> objIds = realTimeObjects();
+    for (const NodeObjectId &objId : objIds)
+    {
+        _nodeProfile402->node()->readObject(objId);
+    }
+}
+
+/**
+ * @brief Requests real time objects to be refreshed at the given period, 0 to stop
+ */
+void Mode::setRealTimeRefreshPeriod(int ms)
+{
+    const QList<NodeObjectId> objIds = realTimeObjects();
+    for (const NodeObjectId &objId : objIds)
+    {
+        setRefreshPeriod(objId, ms);
+    }
 }
 
 void Mode::readAllObjects()
@@ -35,7 +35,9 @@ public:
     virtual quint16 getSpecificCwFlag() = 0;
     virtual void setCwDefaultflag() = 0;
 
-    virtual void readRealTimeObjects();
+    virtual QList<NodeObjectId> realTimeObjects() const;
+    void readRealTimeObjects();
+    void setRealTimeRefreshPeriod(int ms);
     virtual void readAllObjects();
     virtual void reset();
 
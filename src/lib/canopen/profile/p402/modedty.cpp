@@ -100,9 +100,9 @@ void ModeDty::setCwDefaultflag()
     _cmdControlWordFlag = 0;
 }
 
-void ModeDty::readRealTimeObjects()
+QList<NodeObjectId> ModeDty::realTimeObjects() const
 {
-    _nodeProfile402->node()->readObject(_demandObjectId);
+    return {_demandObjectId};
 }
 
 void ModeDty::readAllObjects()
@@ -74,7 +74,7 @@ protected:
 
     // Mode interface
 public:
-    void readRealTimeObjects() override;
+    QList<NodeObjectId> realTimeObjects() const override;
     void readAllObjects() override;
 };
 
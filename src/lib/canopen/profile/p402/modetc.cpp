@@ -104,10 +104,9 @@ void ModeTc::odNotify(const NodeObjectId &objId, NodeOd::FlagsRequest flags)
     Q_UNUSED(flags)
 }
 
-void ModeTc::readRealTimeObjects()
+QList<NodeObjectId> ModeTc::realTimeObjects() const
 {
-    _nodeProfile402->node()->readObject(_torqueDemandObjectId);
-    _nodeProfile402->node()->readObject(_torqueActualValueObjectId);
+    return {_torqueDemandObjectId, _torqueActualValueObjectId};
 }
 
 void ModeTc::readAllObjects()
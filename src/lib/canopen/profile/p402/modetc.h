@@ -63,7 +63,7 @@ protected:
 
     // Mode interface
 public:
-    void readRealTimeObjects() override;
+    QList<NodeObjectId> realTimeObjects() const override;
     void readAllObjects() override;
 };
 
@@ -44,10 +44,9 @@ void ModeTq::setCwDefaultflag()
     _cmdControlWordFlag = 0;
 }
 
-void ModeTq::readRealTimeObjects()
+QList<NodeObjectId> ModeTq::realTimeObjects() const
 {
-    _nodeProfile402->node()->readObject(_torqueDemandObjectId);
-    _nodeProfile402->node()->readObject(_torqueActualValueObjectId);
+    return {_torqueDemandObjectId, _torqueActualValueObjectId};
 }
 
 void ModeTq::readAllObjects()
@@ -226,10 +226,9 @@ void ModeVl::setCwDefaultflag()
     _cmdControlWordFlag = CW_VL_EnableRamp | CW_VL_UnlockRamp | CW_VL_ReferenceRamp;
 }
 
-void ModeVl::readRealTimeObjects()
+QList<NodeObjectId> ModeVl::realTimeObjects() const
 {
-    _nodeProfile402->node()->readObject(_velocityDemandObjectId);
-    _nodeProfile402->node()->readObject(_velocityActualObjectId);
+    return {_velocityDemandObjectId, _velocityActualObjectId};
 }
 
 void ModeVl::readAllObjects()
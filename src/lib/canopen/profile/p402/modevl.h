@@ -89,7 +89,7 @@ public:
     void setTarget(qint32 target) override;
     quint16 getSpecificCwFlag() override;
     void setCwDefaultflag() override;
-    void readRealTimeObjects() override;
+    QList<NodeObjectId> realTimeObjects() const override;
     void readAllObjects() override;
     void reset() override;
 
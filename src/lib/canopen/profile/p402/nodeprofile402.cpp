@@ -106,8 +106,7 @@ NodeProfile402::NodeProfile402(Node *node, quint8 axis)
     _stateMachineCurrent = State402::STATE_NotReadyToSwitchOn;
 
     _nodeProfileState = State::NODEPROFILE_STOPED;
-
-    connect(&_nodeProfleTimer, &QTimer::timeout, this, &NodeProfile402::readRealTimeObjects);
+    _realTimePeriodMs = 0;
 
     setNodeInterrest(node);
 
@@ -897,20 +896,35 @@ void NodeProfile402::readModeOfOperationDisplay()
     _node->readObject(_modesOfOperationDisplayObjectId);
 }
 
+/**
+ * @brief Starts refreshing status word and real time objects of the current mode
+ * @param msec refresh period in ms
+ */
 void NodeProfile402::start(int msec)
 {
-    _nodeProfleTimer.start(msec);
+    setRealTimeRefreshPeriod(msec);
     _nodeProfileState = State::NODEPROFILE_STARTED;
     emit stateChanged();
 }
 
 void NodeProfile402::stop()
 {
-    _nodeProfleTimer.stop();
+    setRealTimeRefreshPeriod(0);
     _nodeProfileState = State::NODEPROFILE_STOPED;
     emit stateChanged();
 }
 
+void NodeProfile402::setRealTimeRefreshPeriod(int ms)
+{
+    _realTimePeriodMs = ms;
+    setRefreshPeriod(_statusWordObjectId, ms);
+    Mode *mode = _modes.value(_modeCurrent);
+    if (mode != nullptr)
+    {
+        mode->setRealTimeRefreshPeriod(ms);
+    }
+}
+
 bool NodeProfile402::status() const
 {
     return true;
@@ -1005,7 +1019,14 @@ void NodeProfile402::odNotify(const NodeObjectId &objId, NodeOd::FlagsRequest fl
         }
         if (_modeCurrent != mode)
         {
+            // real time objects refreshed follow the current mode
+            Mode *oldMode = _modes.value(_modeCurrent);
+            if (oldMode != nullptr && _realTimePeriodMs > 0)
+            {
+                oldMode->setRealTimeRefreshPeriod(0);
+            }
             _modeCurrent = mode;
+            setRealTimeRefreshPeriod(_realTimePeriodMs);
             emit modeChanged(_modeCurrent);
         }
 
@@ -168,7 +168,7 @@ private:
 
     // STATE
     State _nodeProfileState;
-    QTimer _nodeProfleTimer;
+    int _realTimePeriodMs;  // refresh period of real time objects, 0 when stopped
 
     enum StateState
     {
@@ -199,6 +199,7 @@ private:
     void decodeEventStatusWord(quint16 statusWord);
     void decodeStateMachineStatusWord(quint16 statusWord);
     void decodeSupportedDriveModes(quint32 supportedDriveModes);
+    void setRealTimeRefreshPeriod(int ms);
 
 public slots:
     void readModeOfOperationDisplay();
@@ -19,9 +19,7 @@
 #include "emergency.h"
 #include "canopenbus.h"
 
-#include <QDataStream>
 #include <QDebug>
-#include <QIODevice>
 
 Emergency::Emergency(Node *node)
     : Service(node)
@@ -40,18 +38,15 @@ QString Emergency::type() const
     return QLatin1String("Emergency");
 }
 
-void Emergency::parseFrame(const QCanBusFrame &frame)
+void Emergency::parseFrame(const CanFrame &frame)
 {
-    uint16_t errorCode;
-    u_int8_t errorClass;
-    QByteArray errorDesc;
-
-    QByteArray payload = frame.payload();
-    QDataStream request(&payload, QIODevice::ReadOnly);
-    request.setByteOrder(QDataStream::LittleEndian);
-
-    request >> errorCode;
-    request >> errorClass;
-    errorDesc = payload.mid(3);
+    if (frame.size() < 3)
+    {
+        return;
+    }
+
+    uint16_t errorCode = frame.u16At(0);
+    u_int8_t errorClass = frame.at(2);
+    QByteArray errorDesc(reinterpret_cast<const char *>(frame.data()) + 3, frame.size() - 3);
     qDebug() << "Emergency" << errorCode << errorClass << errorDesc;
 }
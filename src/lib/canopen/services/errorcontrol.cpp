@@ -46,11 +46,11 @@ QString ErrorControl::type() const
     return QLatin1String("ErrorControl");
 }
 
-void ErrorControl::parseFrame(const QCanBusFrame &frame)
+void ErrorControl::parseFrame(const CanFrame &frame)
 {
-    if (frame.payload().size() == 1)
+    if (frame.size() == 1)
     {
-        if (static_cast<uint8_t>(frame.payload().at(0)) == 0x0)
+        if (frame.at(0) == 0x0)
         {
             // BootUp
             _node->setStatus(Node::Status::PREOP);
@@ -101,9 +101,9 @@ void ErrorControl::receiveHeartBeat()
     }
 
     // heartbeat consumers
-    QCanBusFrame frameNodeGuarding;
+    CanFrame frameNodeGuarding;
     frameNodeGuarding.setFrameId(_cobId + _node->nodeId());
-    frameNodeGuarding.setFrameType(QCanBusFrame::RemoteRequestFrame);
+    frameNodeGuarding.setFrameType(CanFrame::RemoteRequestFrame);
     bus()->writeFrame(frameNodeGuarding);
 }
 
@@ -114,9 +114,9 @@ void ErrorControl::sendNodeGuarding()
         return;
     }
 
-    QCanBusFrame frameNodeGuarding;
+    CanFrame frameNodeGuarding;
     frameNodeGuarding.setFrameId(_cobId + _node->nodeId());
-    frameNodeGuarding.setFrameType(QCanBusFrame::RemoteRequestFrame);
+    frameNodeGuarding.setFrameType(CanFrame::RemoteRequestFrame);
     bus()->writeFrame(frameNodeGuarding);
 }
 
@@ -125,11 +125,11 @@ void ErrorControl::lifeGuardingEvent()
     // qDebug() << ">>ErrorControl::lifeGuardingEvent : node error, dont answer";
 }
 
-void ErrorControl::manageErrorControl(const QCanBusFrame &frame)
+void ErrorControl::manageErrorControl(const CanFrame &frame)
 {
-    if (frame.payload().size() == 1)
+    if (frame.size() == 1)
     {
-        bool actualToggleBit = (frame.payload().at(0) >> 7) != 0;
+        bool actualToggleBit = (frame.at(0) >> 7) != 0;
         if (_oldToggleBit == actualToggleBit)
         {
             // ERROR TogleBit -> connection lost
@@ -137,7 +137,7 @@ void ErrorControl::manageErrorControl(const QCanBusFrame &frame)
         }
         _oldToggleBit = actualToggleBit;
 
-        switch (frame.payload().at(0) & 0x7F)
+        switch (frame.at(0) & 0x7F)
         {
             case 4:  // Stopped
                 _node->setStatus(Node::Status::STOPPED);
@@ -36,7 +36,7 @@ public:
 
     QString type() const override;
 
-    void parseFrame(const QCanBusFrame &frame) override;
+    void parseFrame(const CanFrame &frame) override;
 
 private slots:
     void sendNodeGuarding();
@@ -44,7 +44,7 @@ private slots:
 
 private:
     void receiveHeartBeat();
-    void manageErrorControl(const QCanBusFrame &frame);
+    void manageErrorControl(const CanFrame &frame);
 
     uint32_t _cobId;
     bool _oldToggleBit;
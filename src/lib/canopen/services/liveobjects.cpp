@@ -0,0 +1,758 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "liveobjects.h"
+
+#include "canopenbus.h"
+#include "node.h"
+#include "sdoscheduler.h"
+#include "tpdo.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <QMap>
+
+#define TPDO_COMM_PARAM_INDEX 0x1800
+#define TPDO_MAPPING_PARAM_INDEX 0x1A00
+#define PDO_COB_ID_INVALID 0x80000000U
+#define PDO_COB_ID_MASK 0x3FFFFFFFU
+
+enum
+{
+    UPDATE_DELAY_MS = 100,  // requests done in a row are packed once
+    REPORT_PERIOD_MS = 1000  // achieved periods are reported at most once per second
+};
+
+LiveObjects::LiveObjects(Node *node)
+    : _node(node)
+{
+    _pdoEnabled = true;
+    _discovered = false;
+    _discoverBatchId = 0;
+
+    _updateTimer.setSingleShot(true);
+    _updateTimer.setInterval(UPDATE_DELAY_MS);
+    connect(&_updateTimer, &QTimer::timeout, this, &LiveObjects::updatePdos);
+
+    _pollTimer.setSingleShot(true);
+    _pollTimer.setTimerType(Qt::PreciseTimer);
+    connect(&_pollTimer, &QTimer::timeout, this, &LiveObjects::pollSdo);
+    _clock.start();
+
+    // updates of live objects are watched to measure their achieved period
+    setNodeInterrest(_node);
+
+    connect(_node, &Node::statusChanged, this, &LiveObjects::updateStatus);
+    connect(_node->nodeOd(), &NodeOd::objectsRead, this, &LiveObjects::receiveComParams);
+    for (TPDO *tpdo : _node->tpdos())
+    {
+        connect(tpdo, &PDO::mappingChanged, this, &LiveObjects::tpdoMappingChanged);
+        connect(tpdo, &PDO::errorOccurred, this, &LiveObjects::tpdoErrorOccurred);
+    }
+}
+
+LiveObjects::~LiveObjects()
+{
+}
+
+/**
+ * @brief Requests an object to be kept up to date
+ * @param requester requester, each requester has its own period for an object
+ * @param objId object of the node
+ * @param periodMs requested refresh period in ms
+ */
+void LiveObjects::requestObject(NodeOdSubscriber *requester, const NodeObjectId &objId, int periodMs)
+{
+    periodMs = qMax(periodMs, 1);
+    quint32 objectKey = key(objId);
+    QHash<quint32, LiveObject>::iterator it = _objects.find(objectKey);
+    int oldPeriodMs = 0;
+    if (it == _objects.end())
+    {
+        LiveObject liveObject;
+        liveObject.objId = NodeObjectId(_node->busId(), _node->nodeId(), objId.index(), objId.subIndex(), _node->nodeOd()->dataType(objId.index(), objId.subIndex()));
+        liveObject.periodMs = periodMs;
+        liveObject.tpdo = nullptr;
+        liveObject.nextPollMs = 0;
+        liveObject.lastUpdateMs = -1;
+        liveObject.achievedPeriodMs = 0.0;
+        liveObject.reportedPeriodMs = 0;
+        liveObject.lastReportMs = 0;
+        it = _objects.insert(objectKey, liveObject);
+        registerSubIndex(objId.index(), objId.subIndex());
+    }
+    else
+    {
+        oldPeriodMs = (*it).periodMs;
+    }
+
+    (*it).periods.insert(requester, periodMs);
+    updatePeriod(*it);
+    if ((*it).periodMs != oldPeriodMs)
+    {
+        scheduleUpdate();
+        spreadPolls();
+    }
+}
+
+void LiveObjects::releaseObject(NodeOdSubscriber *requester, const NodeObjectId &objId)
+{
+    QHash<quint32, LiveObject>::iterator it = _objects.find(key(objId));
+    if (it == _objects.end() || (*it).periods.remove(requester) == 0)
+    {
+        return;
+    }
+
+    int oldPeriodMs = (*it).periodMs;
+    if ((*it).periods.isEmpty())
+    {
+        _objects.erase(it);
+        unRegisterSubIndex(objId.index(), objId.subIndex());
+        scheduleUpdate();
+    }
+    else
+    {
+        updatePeriod(*it);
+        if ((*it).periodMs != oldPeriodMs)
+        {
+            scheduleUpdate();
+        }
+    }
+    spreadPolls();
+}
+
+void LiveObjects::releaseAll(NodeOdSubscriber *requester)
+{
+    bool changed = false;
+    QList<NodeObjectId> releasedObjects;
+    QHash<quint32, LiveObject>::iterator it = _objects.begin();
+    while (it != _objects.end())
+    {
+        if ((*it).periods.remove(requester) == 0)
+        {
+            ++it;
+            continue;
+        }
+
+        changed = true;
+        if ((*it).periods.isEmpty())
+        {
+            releasedObjects.append((*it).objId);
+            it = _objects.erase(it);
+        }
+        else
+        {
+            updatePeriod(*it);
+            ++it;
+        }
+    }
+
+    for (const NodeObjectId &objId : qAsConst(releasedObjects))
+    {
+        unRegisterSubIndex(objId.index(), objId.subIndex());
+    }
+    if (changed)
+    {
+        scheduleUpdate();
+        spreadPolls();
+    }
+}
+
+bool LiveObjects::isLive(const NodeObjectId &objId) const
+{
+    return _objects.contains(key(objId));
+}
+
+/**
+ * @brief Fastest period requested for an object, 0 if not requested
+ */
+int LiveObjects::periodMs(const NodeObjectId &objId) const
+{
+    QHash<quint32, LiveObject>::const_iterator it = _objects.constFind(key(objId));
+    if (it == _objects.cend())
+    {
+        return 0;
+    }
+    return (*it).periodMs;
+}
+
+/**
+ * @brief Measured update period of an object, from TPDO or SDO, 0 if not measured yet
+ */
+int LiveObjects::achievedPeriodMs(const NodeObjectId &objId) const
+{
+    QHash<quint32, LiveObject>::const_iterator it = _objects.constFind(key(objId));
+    if (it == _objects.cend())
+    {
+        return 0;
+    }
+    return qRound((*it).achievedPeriodMs);
+}
+
+/**
+ * @brief Checks if an object is currently received from a TPDO configured by this manager
+ */
+bool LiveObjects::isPdoMapped(const NodeObjectId &objId) const
+{
+    QHash<quint32, LiveObject>::const_iterator it = _objects.constFind(key(objId));
+    if (it == _objects.cend())
+    {
+        return false;
+    }
+    return isPdoActive(*it);
+}
+
+QList<NodeObjectId> LiveObjects::sdoPolledObjects() const
+{
+    QList<NodeObjectId> objects;
+    bool pdosRunning = arePdosRunning();
+    for (const LiveObject &liveObject : _objects)
+    {
+        if (!pdosRunning || !isPdoActive(liveObject))
+        {
+            objects.append(liveObject.objId);
+        }
+    }
+    return objects;
+}
+
+bool LiveObjects::isPdoEnabled() const
+{
+    return _pdoEnabled;
+}
+
+/**
+ * @brief Allows or not to use free TPDOs, all objects are read with SDO when disabled
+ */
+void LiveObjects::setPdoEnabled(bool pdoEnabled)
+{
+    if (_pdoEnabled == pdoEnabled)
+    {
+        return;
+    }
+    _pdoEnabled = pdoEnabled;
+    scheduleUpdate();
+}
+
+/**
+ * @brief Forgets TPDOs configuration, device may have been reset, requests are kept
+ */
+void LiveObjects::reset()
+{
+    _ownedTpdos.clear();
+    _freeTpdos.clear();
+    _failedTpdos.clear();
+    _discovered = false;
+    _discoverBatchId = 0;
+
+    for (LiveObject &liveObject : _objects)
+    {
+        liveObject.tpdo = nullptr;
+    }
+    if (!_objects.isEmpty())
+    {
+        scheduleUpdate();
+    }
+}
+
+/**
+ * @brief Packs objects in TPDOs, fastest objects first, a new TPDO is only used when the others are full
+ */
+void LiveObjects::updatePdos()
+{
+    bool canConfigure = (_node->status() == Node::PREOP || _node->status() == Node::STARTED) && (_node->bus() != nullptr) && _node->bus()->canWrite();
+    if (_pdoEnabled && !_objects.isEmpty() && canConfigure && !_discovered)
+    {
+        discoverTpdos();
+        return;
+    }
+    if (_discoverBatchId != 0)
+    {
+        return;  // updated when free TPDOs are known
+    }
+
+    // TPDOs are only changed when the node is reachable, objects stay on their TPDO otherwise
+    if (!canConfigure)
+    {
+        return;
+    }
+
+    QList<LiveObject *> candidates;
+    if (_pdoEnabled)
+    {
+        for (LiveObject &liveObject : _objects)
+        {
+            NodeSubIndex *nodeSubIndex = _node->nodeOd()->subIndex(liveObject.objId.index(), liveObject.objId.subIndex());
+            if (nodeSubIndex != nullptr && nodeSubIndex->hasTPDOAccess())
+            {
+                candidates.append(&liveObject);
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const LiveObject *a, const LiveObject *b) {
+        return a->periodMs < b->periodMs;
+    });
+
+    QList<TPDO *> tpdos;
+    for (TPDO *tpdo : _node->tpdos())
+    {
+        if (_ownedTpdos.contains(tpdo) || _freeTpdos.contains(tpdo))
+        {
+            tpdos.append(tpdo);
+        }
+    }
+
+    QVector<QList<NodeObjectId>> plan(tpdos.count());
+    QVector<int> planPeriods(tpdos.count(), 0);
+    for (LiveObject &liveObject : _objects)
+    {
+        liveObject.tpdo = nullptr;
+    }
+    for (LiveObject *liveObject : qAsConst(candidates))
+    {
+        for (int i = 0; i < tpdos.count(); i++)
+        {
+            QList<NodeObjectId> &objects = plan[i];
+            if (tpdos.at(i)->canInsertObjectAtBitPos(objects, liveObject->objId, PDO::mappingBitSize(objects)))
+            {
+                if (objects.isEmpty())
+                {
+                    planPeriods[i] = liveObject->periodMs;
+                }
+                objects.append(liveObject->objId);
+                liveObject->tpdo = tpdos.at(i);
+                break;
+            }
+        }
+    }
+
+    for (int i = 0; i < tpdos.count(); i++)
+    {
+        TPDO *tpdo = tpdos.at(i);
+        QHash<TPDO *, OwnedTpdo>::const_iterator owned = _ownedTpdos.constFind(tpdo);
+        if (plan.at(i).isEmpty())
+        {
+            if (owned != _ownedTpdos.cend())
+            {
+                releaseTpdo(tpdo);
+            }
+            continue;
+        }
+        if (owned == _ownedTpdos.cend() || !sameObjects((*owned).objects, plan.at(i)) || (*owned).periodMs != planPeriods.at(i))
+        {
+            configureTpdo(tpdo, plan.at(i), planPeriods.at(i));
+        }
+    }
+
+    spreadPolls();
+    emit liveObjectsChanged();
+}
+
+/**
+ * @brief Reads objects not received by an active TPDO which are due, each one at its period
+ */
+void LiveObjects::pollSdo()
+{
+    const qint64 now = _clock.elapsed();
+    const bool pdosRunning = arePdosRunning();
+    SdoScheduler *sdoScheduler = _node->sdoScheduler();
+    for (LiveObject &liveObject : _objects)
+    {
+        if (!isSdoPolled(liveObject, pdosRunning) || now < liveObject.nextPollMs)
+        {
+            continue;
+        }
+
+        // a read still in progress is not queued twice, the achieved period shows the overload
+        if (!sdoScheduler->hasRequest(liveObject.objId.index(), liveObject.objId.subIndex()))
+        {
+            _node->readObject(liveObject.objId);
+        }
+        liveObject.nextPollMs += liveObject.periodMs;
+        if (liveObject.nextPollMs <= now)
+        {
+            liveObject.nextPollMs = now + liveObject.periodMs;  // late reads are not caught up in a burst
+        }
+    }
+    schedulePoll();
+}
+
+void LiveObjects::updateStatus()
+{
+    if (_node->status() == Node::PREOP || _node->status() == Node::STARTED)
+    {
+        if (!_objects.isEmpty())
+        {
+            scheduleUpdate();
+        }
+    }
+    spreadPolls();
+    emit liveObjectsChanged();
+}
+
+void LiveObjects::receiveComParams(quint32 batchId, const QList<NodeOd::ReadResult> &results)
+{
+    Q_UNUSED(results)
+    if (_discoverBatchId == 0 || batchId != _discoverBatchId)
+    {
+        return;
+    }
+    selectFreeTpdos();
+}
+
+void LiveObjects::tpdoMappingChanged()
+{
+    TPDO *tpdo = qobject_cast<TPDO *>(sender());
+    QHash<TPDO *, OwnedTpdo>::iterator owned = _ownedTpdos.find(tpdo);
+    if (owned == _ownedTpdos.end())
+    {
+        return;
+    }
+
+    bool sameMapping = sameObjects(tpdo->currentMappind(), (*owned).objects);
+    if ((*owned).state == TPDO_CONFIGURING)
+    {
+        if (sameMapping)
+        {
+            // mapping written and PDO enabled, sets its rate
+            (*owned).state = TPDO_ACTIVE;
+            tpdo->setTransmissionType(TPDO::TPDO_EVENT_MS);
+            tpdo->setEventTimerMs(static_cast<quint32>((*owned).periodMs));
+            spreadPolls();
+            emit liveObjectsChanged();
+        }
+        return;
+    }
+
+    if (!sameMapping)
+    {
+        // mapping modified by someone else, this TPDO is left to its new user
+        _ownedTpdos.erase(owned);
+        _failedTpdos.append(tpdo);
+        for (LiveObject &liveObject : _objects)
+        {
+            if (liveObject.tpdo == tpdo)
+            {
+                liveObject.tpdo = nullptr;
+            }
+        }
+        scheduleUpdate();
+        emit liveObjectsChanged();
+    }
+}
+
+void LiveObjects::tpdoErrorOccurred(PDO::ErrorPdo error)
+{
+    Q_UNUSED(error)
+    TPDO *tpdo = qobject_cast<TPDO *>(sender());
+    if (!_ownedTpdos.contains(tpdo))
+    {
+        return;
+    }
+
+    // device refused the configuration, objects go back to SDO and the TPDO is not used anymore
+    releaseTpdo(tpdo);
+    _freeTpdos.removeOne(tpdo);
+    _failedTpdos.append(tpdo);
+    for (LiveObject &liveObject : _objects)
+    {
+        if (liveObject.tpdo == tpdo)
+        {
+            liveObject.tpdo = nullptr;
+        }
+    }
+    scheduleUpdate();
+    emit liveObjectsChanged();
+}
+
+quint32 LiveObjects::key(const NodeObjectId &objId)
+{
+    return (static_cast<quint32>(objId.index()) << 8) + objId.subIndex();
+}
+
+bool LiveObjects::sameObjects(const QList<NodeObjectId> &a, const QList<NodeObjectId> &b)
+{
+    if (a.count() != b.count())
+    {
+        return false;
+    }
+    for (int i = 0; i < a.count(); i++)
+    {
+        if (a.at(i).index() != b.at(i).index() || a.at(i).subIndex() != b.at(i).subIndex())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void LiveObjects::updatePeriod(LiveObject &liveObject)
+{
+    int periodMs = std::numeric_limits<int>::max();
+    for (int requestedPeriodMs : qAsConst(liveObject.periods))
+    {
+        periodMs = qMin(periodMs, requestedPeriodMs);
+    }
+    liveObject.periodMs = periodMs;
+}
+
+void LiveObjects::scheduleUpdate()
+{
+    if (!_updateTimer.isActive())
+    {
+        _updateTimer.start();
+    }
+}
+
+/**
+ * @brief Reads COB-ID and mapping count of all TPDOs to find the free ones
+ */
+void LiveObjects::discoverTpdos()
+{
+    if (_discoverBatchId != 0)
+    {
+        return;
+    }
+
+    NodeOd *nodeOd = _node->nodeOd();
+    QList<NodeObjectId> objects;
+    for (TPDO *tpdo : _node->tpdos())
+    {
+        quint16 commIndex = TPDO_COMM_PARAM_INDEX + tpdo->pdoNumber();
+        quint16 mappingIndex = TPDO_MAPPING_PARAM_INDEX + tpdo->pdoNumber();
+        if (nodeOd->subIndexExist(commIndex, 0x01) && nodeOd->subIndexExist(mappingIndex, 0x00))
+        {
+            objects.append(NodeObjectId(commIndex, 0x01, QMetaType::UInt));
+            objects.append(NodeObjectId(mappingIndex, 0x00, QMetaType::UChar));
+        }
+    }
+
+    quint32 batchId = _node->readObjects(objects);
+    if (_node->nodeOd()->isReadBatchPending(batchId))
+    {
+        _discoverBatchId = batchId;
+    }
+    else
+    {
+        selectFreeTpdos();
+    }
+}
+
+/**
+ * @brief A TPDO is free if it is disabled or has an empty mapping, its COB-ID must be the default one to be received
+ */
+void LiveObjects::selectFreeTpdos()
+{
+    _discoverBatchId = 0;
+    _discovered = true;
+    _freeTpdos.clear();
+
+    NodeOd *nodeOd = _node->nodeOd();
+    for (TPDO *tpdo : _node->tpdos())
+    {
+        if (_ownedTpdos.contains(tpdo) || _failedTpdos.contains(tpdo))
+        {
+            continue;
+        }
+
+        quint16 commIndex = TPDO_COMM_PARAM_INDEX + tpdo->pdoNumber();
+        quint16 mappingIndex = TPDO_MAPPING_PARAM_INDEX + tpdo->pdoNumber();
+        if (!nodeOd->subIndexExist(commIndex, 0x01) || nodeOd->errorObject(commIndex, 0x01) != 0 || nodeOd->errorObject(mappingIndex, 0x00) != 0)
+        {
+            continue;
+        }
+
+        quint32 cobId = nodeOd->value(commIndex, 0x01).toUInt();
+        if ((cobId & PDO_COB_ID_MASK) != tpdo->cobId())
+        {
+            continue;
+        }
+        if ((cobId & PDO_COB_ID_INVALID) == 0 && nodeOd->value(mappingIndex, 0x00).toUInt() != 0)
+        {
+            continue;
+        }
+        _freeTpdos.append(tpdo);
+    }
+
+    updatePdos();
+}
+
+/**
+ * @brief Disables a TPDO configured by this manager, it stays available for a next packing
+ */
+void LiveObjects::releaseTpdo(TPDO *tpdo)
+{
+    _ownedTpdos.remove(tpdo);
+    tpdo->setEnabled(false);
+    if (!_freeTpdos.contains(tpdo))
+    {
+        _freeTpdos.append(tpdo);
+    }
+}
+
+void LiveObjects::configureTpdo(TPDO *tpdo, const QList<NodeObjectId> &objects, int periodMs)
+{
+    _freeTpdos.removeOne(tpdo);
+
+    QHash<TPDO *, OwnedTpdo>::iterator it = _ownedTpdos.find(tpdo);
+    bool sameMapping = (it != _ownedTpdos.end()) && ((*it).state == TPDO_ACTIVE) && sameObjects((*it).objects, objects);
+    if (it == _ownedTpdos.end())
+    {
+        it = _ownedTpdos.insert(tpdo, OwnedTpdo());
+    }
+    OwnedTpdo &owned = *it;
+    owned.objects = objects;
+    owned.periodMs = periodMs;
+    if (sameMapping)
+    {
+        tpdo->setEventTimerMs(static_cast<quint32>(periodMs));
+        return;
+    }
+
+    // objects are read with SDO until the mapping is written
+    owned.state = TPDO_CONFIGURING;
+    tpdo->writeMapping(objects);
+}
+
+/**
+ * @brief Spreads SDO reads of objects sharing a period evenly over this period, to avoid bursts on the bus
+ */
+void LiveObjects::spreadPolls()
+{
+    const bool pdosRunning = arePdosRunning();
+    QMap<int, QList<LiveObject *>> objectsByPeriod;
+    for (LiveObject &liveObject : _objects)
+    {
+        if (isSdoPolled(liveObject, pdosRunning))
+        {
+            objectsByPeriod[liveObject.periodMs].append(&liveObject);
+        }
+    }
+
+    const qint64 now = _clock.elapsed();
+    QMap<int, QList<LiveObject *>>::const_iterator it = objectsByPeriod.cbegin();
+    while (it != objectsByPeriod.cend())
+    {
+        const QList<LiveObject *> &objects = it.value();
+        for (int i = 0; i < objects.count(); i++)
+        {
+            objects.at(i)->nextPollMs = now + static_cast<qint64>(it.key()) * i / objects.count();
+        }
+        ++it;
+    }
+
+    schedulePoll();
+}
+
+/**
+ * @brief Wakes up the poll timer for the next due SDO read, stops it if nothing is read with SDO
+ */
+void LiveObjects::schedulePoll()
+{
+    const bool pdosRunning = arePdosRunning();
+    qint64 nextPollMs = std::numeric_limits<qint64>::max();
+    for (const LiveObject &liveObject : qAsConst(_objects))
+    {
+        if (isSdoPolled(liveObject, pdosRunning))
+        {
+            nextPollMs = qMin(nextPollMs, liveObject.nextPollMs);
+        }
+    }
+
+    if (nextPollMs == std::numeric_limits<qint64>::max())
+    {
+        _pollTimer.stop();
+        return;
+    }
+    _pollTimer.start(static_cast<int>(qMax(nextPollMs - _clock.elapsed(), static_cast<qint64>(0))));
+}
+
+bool LiveObjects::arePdosRunning() const
+{
+    return _node->status() == Node::STARTED;
+}
+
+bool LiveObjects::isPdoActive(const LiveObject &liveObject) const
+{
+    if (liveObject.tpdo == nullptr)
+    {
+        return false;
+    }
+    QHash<TPDO *, OwnedTpdo>::const_iterator owned = _ownedTpdos.constFind(liveObject.tpdo);
+    return (owned != _ownedTpdos.cend()) && ((*owned).state == TPDO_ACTIVE);
+}
+
+bool LiveObjects::isSdoPolled(const LiveObject &liveObject, bool pdosRunning) const
+{
+    return !pdosRunning || !isPdoActive(liveObject);
+}
+
+/**
+ * @brief Measures the update period of live objects, requesters are notified of significant changes
+ */
+void LiveObjects::odNotify(const NodeObjectId &objId, NodeOd::FlagsRequest flags)
+{
+    if ((flags & NodeOd::Error) != 0 || (flags & (NodeOd::Read | NodeOd::Pdo)) == 0)
+    {
+        return;
+    }
+    QHash<quint32, LiveObject>::iterator it = _objects.find(key(objId));
+    if (it == _objects.end())
+    {
+        return;
+    }
+
+    LiveObject &liveObject = *it;
+    const qint64 now = _clock.elapsed();
+    if (liveObject.lastUpdateMs >= 0)
+    {
+        const double periodMs = static_cast<double>(now - liveObject.lastUpdateMs);
+        if (liveObject.achievedPeriodMs == 0.0)
+        {
+            liveObject.achievedPeriodMs = periodMs;
+        }
+        else
+        {
+            liveObject.achievedPeriodMs += (periodMs - liveObject.achievedPeriodMs) / 8.0;
+        }
+    }
+    liveObject.lastUpdateMs = now;
+    if (liveObject.achievedPeriodMs == 0.0)
+    {
+        return;
+    }
+
+    // reported when it differs by more than 10 % of the last reported period
+    const int achievedPeriodMs = qMax(qRound(liveObject.achievedPeriodMs), 1);
+    const int reportedPeriodMs = liveObject.reportedPeriodMs;
+    if (reportedPeriodMs != 0 && (qAbs(achievedPeriodMs - reportedPeriodMs) * 10 <= reportedPeriodMs || now - liveObject.lastReportMs < REPORT_PERIOD_MS))
+    {
+        return;
+    }
+    liveObject.reportedPeriodMs = achievedPeriodMs;
+    liveObject.lastReportMs = now;
+
+    // a requester may release the object when notified
+    const NodeObjectId reportedObjId = liveObject.objId;
+    const QList<NodeOdSubscriber *> requesters = liveObject.periods.keys();
+    for (NodeOdSubscriber *requester : requesters)
+    {
+        requester->notifyRefreshPeriod(reportedObjId, achievedPeriodMs);
+    }
+}
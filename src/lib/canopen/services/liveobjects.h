@@ -0,0 +1,143 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef LIVEOBJECTS_H
+#define LIVEOBJECTS_H
+
+#include "canopen_global.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+
+#include "nodeobjectid.h"
+#include "nodeod.h"
+#include "nodeodsubscriber.h"
+#include "pdo.h"
+
+class Node;
+class TPDO;
+
+/**
+ * @brief Keeps objects requested for polling up to date, with TPDOs when possible
+ *
+ * Each requester asks for objects with a period, the fastest period of all
+ * requesters is kept per object. The union of requested objects is packed into
+ * TPDOs found free on the device (invalid COB-ID or empty mapping, default
+ * COB-ID), objects with close periods share a TPDO configured as event driven
+ * with an event timer. Objects which cannot be mapped, or while PDOs are not
+ * running, are read with SDO at their period. SDO reads of objects sharing a
+ * period are spread over it, and the period at which each object is actually
+ * updated is measured and reported to its requesters.
+ */
+class CANOPEN_EXPORT LiveObjects : public QObject, public NodeOdSubscriber
+{
+    Q_OBJECT
+public:
+    LiveObjects(Node *node);
+    ~LiveObjects() override;
+
+    void requestObject(NodeOdSubscriber *requester, const NodeObjectId &objId, int periodMs);
+    void releaseObject(NodeOdSubscriber *requester, const NodeObjectId &objId);
+    void releaseAll(NodeOdSubscriber *requester);
+
+    bool isLive(const NodeObjectId &objId) const;
+    int periodMs(const NodeObjectId &objId) const;
+    int achievedPeriodMs(const NodeObjectId &objId) const;
+    bool isPdoMapped(const NodeObjectId &objId) const;
+    QList<NodeObjectId> sdoPolledObjects() const;
+
+    bool isPdoEnabled() const;
+    void setPdoEnabled(bool pdoEnabled);
+
+    void reset();
+
+signals:
+    void liveObjectsChanged();
+
+protected slots:
+    void updatePdos();
+    void pollSdo();
+    void updateStatus();
+    void receiveComParams(quint32 batchId, const QList<NodeOd::ReadResult> &results);
+    void tpdoMappingChanged();
+    void tpdoErrorOccurred(PDO::ErrorPdo error);
+
+protected:
+    Node *_node;
+    bool _pdoEnabled;
+
+    struct LiveObject
+    {
+        NodeObjectId objId;
+        QHash<NodeOdSubscriber *, int> periods;  // period requested by each requester
+        int periodMs;                            // fastest requested period
+        TPDO *tpdo;                              // TPDO transmitting the object, nullptr if read with SDO
+        qint64 nextPollMs;
+        qint64 lastUpdateMs;      // -1 until a first update
+        double achievedPeriodMs;  // moving average of update periods, 0.0 until measured
+        int reportedPeriodMs;
+        qint64 lastReportMs;
+    };
+    QHash<quint32, LiveObject> _objects;
+
+    // TPDOs configured by this manager
+    enum TpdoState
+    {
+        TPDO_CONFIGURING,
+        TPDO_ACTIVE
+    };
+    struct OwnedTpdo
+    {
+        QList<NodeObjectId> objects;
+        int periodMs;
+        TpdoState state;
+    };
+    QHash<TPDO *, OwnedTpdo> _ownedTpdos;
+
+    // discovery of free TPDOs
+    bool _discovered;
+    quint32 _discoverBatchId;
+    QList<TPDO *> _freeTpdos;
+    QList<TPDO *> _failedTpdos;
+
+    QTimer _updateTimer;
+    QTimer _pollTimer;
+    QElapsedTimer _clock;
+
+    static quint32 key(const NodeObjectId &objId);
+    static bool sameObjects(const QList<NodeObjectId> &a, const QList<NodeObjectId> &b);
+    void updatePeriod(LiveObject &liveObject);
+    void scheduleUpdate();
+    void discoverTpdos();
+    void selectFreeTpdos();
+    void releaseTpdo(TPDO *tpdo);
+    void configureTpdo(TPDO *tpdo, const QList<NodeObjectId> &objects, int periodMs);
+    void spreadPolls();
+    void schedulePoll();
+    bool arePdosRunning() const;
+    bool isPdoActive(const LiveObject &liveObject) const;
+    bool isSdoPolled(const LiveObject &liveObject, bool pdosRunning) const;
+
+    // NodeOdSubscriber interface
+protected:
+    void odNotify(const NodeObjectId &objId, NodeOd::FlagsRequest flags) override;
+};
+
+#endif  // LIVEOBJECTS_H
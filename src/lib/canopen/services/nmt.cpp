@@ -78,13 +78,13 @@ void NMT::sendResetNode()
 
 void NMT::sendNodeGuarding()
 {
-    QCanBusFrame frameNodeGuarding;
+    CanFrame frameNodeGuarding;
     frameNodeGuarding.setFrameId(0x700 + _nodeId);
-    frameNodeGuarding.setFrameType(QCanBusFrame::RemoteRequestFrame);
+    frameNodeGuarding.setFrameType(CanFrame::RemoteRequestFrame);
     bus()->writeFrame(frameNodeGuarding);
 }
 
-void NMT::parseFrame(const QCanBusFrame &frame)
+void NMT::parseFrame(const CanFrame &frame)
 {
     Q_UNUSED(frame)
 }
@@ -99,7 +99,7 @@ void NMT::sendNmt(quint8 cmd)
     QByteArray nmtStopPayload;
     nmtStopPayload.append(static_cast<char>(cmd));
     nmtStopPayload.append(static_cast<char>(_nodeId));
-    QCanBusFrame frameNmt;
+    CanFrame frameNmt;
     frameNmt.setFrameId(_cobId);
     frameNmt.setPayload(nmtStopPayload);
     bus()->writeFrame(frameNmt);
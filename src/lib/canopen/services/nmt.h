@@ -40,7 +40,7 @@ public:
 
     QString type() const override;
 
-    void parseFrame(const QCanBusFrame &frame) override;
+    void parseFrame(const CanFrame &frame) override;
 
 private:
     uint32_t _cobId;
@@ -25,6 +25,9 @@
 #include "../profile/nodeprofilefactory.h"
 #include "canopenbus.h"
 
+// delay for the answers of the last node guarding requests of a bus exploration
+#define EXPLORE_BUS_ANSWER_DELAY_MS 100
+
 NodeDiscover::NodeDiscover(CanOpenBus *bus)
     : Service(bus)
 {
@@ -34,6 +37,8 @@ NodeDiscover::NodeDiscover(CanOpenBus *bus)
     }
 
     _exploreBusNodeId = 0;
+    _exploreBusWaitAnswers = false;
+    _exploring = false;
     connect(&_exploreBusTimer, &QTimer::timeout, this, &NodeDiscover::exploreBusNext);
 
     _exploreNodeState = -1;
@@ -50,18 +55,18 @@ QString NodeDiscover::type() const
     return QLatin1String("NodeDiscover");
 }
 
-void NodeDiscover::parseFrame(const QCanBusFrame &frame)
+void NodeDiscover::parseFrame(const CanFrame &frame)
 {
-    if ((frame.frameId() >= 0x701) && (frame.frameId() <= 0x7FF) && frame.frameType() == QCanBusFrame::DataFrame)
+    if ((frame.frameId() >= 0x701) && (frame.frameId() <= 0x7FF) && frame.frameType() == CanFrame::DataFrame)
     {
         uint8_t nodeId = frame.frameId() & 0x7F;
         if (!bus()->existNode(nodeId))
         {
             Node *node = new Node(nodeId);
 
-            if (frame.payload().size() == 1)
+            if (frame.size() == 1)
             {
-                switch (frame.payload().at(0) & 0x7F)
+                switch (frame.at(0) & 0x7F)
                 {
                     case 0:  // Bootup
                         node->setStatus(Node::Status::INIT);
@@ -90,12 +95,18 @@ void NodeDiscover::parseFrame(const QCanBusFrame &frame)
     }
 }
 
+/**
+ * @brief Requests the state of all node ids, nodes that answer are added and explored
+ *
+ * explorationFinished() is emitted once all the nodes found are explored.
+ */
 void NodeDiscover::exploreBus()
 {
-    if (_exploreBusNodeId != 0)
+    if (_exploreBusNodeId != 0 || _exploreBusWaitAnswers)
     {
         return;
     }
+    _exploring = true;
     _exploreBusNodeId = 1;
     _exploreBusTimer.start(8);
 }
@@ -112,6 +123,14 @@ void NodeDiscover::exploreNode(quint8 nodeId)
     }
 }
 
+/**
+ * @brief True while a bus exploration or the exploration of a node is in progress
+ */
+bool NodeDiscover::isExploring() const
+{
+    return _exploreBusNodeId != 0 || _exploreBusWaitAnswers || _exploreNodeState != -1;
+}
+
 void NodeDiscover::exploreBusNext()
 {
     if (!bus()->canWrite())
@@ -123,12 +142,14 @@ void NodeDiscover::exploreBusNext()
     {
         _exploreBusNodeId = 0;
         _exploreBusTimer.stop();
+        _exploreBusWaitAnswers = true;
+        QTimer::singleShot(EXPLORE_BUS_ANSWER_DELAY_MS, this, &NodeDiscover::exploreBusAnswersEnd);
         return;
     }
 
-    QCanBusFrame frameNodeGuarding;
+    CanFrame frameNodeGuarding;
     frameNodeGuarding.setFrameId(0x700 + _exploreBusNodeId);
-    frameNodeGuarding.setFrameType(QCanBusFrame::RemoteRequestFrame);
+    frameNodeGuarding.setFrameType(CanFrame::RemoteRequestFrame);
     bus()->writeFrame(frameNodeGuarding);
 
     _exploreBusNodeId++;
@@ -154,6 +175,7 @@ void NodeDiscover::exploreNodeNext()
         {
             node->nodeOd()->loadEds(file);
             node->reset();
+            node->discoverSdoChannels();
             NodeProfileFactory::profileFactory(node);
         }
 
@@ -161,6 +183,7 @@ void NodeDiscover::exploreNodeNext()
         {
             _exploreNodeState = -1;
             _exploreNodeTimer.stop();
+            checkExplorationFinished();
         }
         else
         {
@@ -183,3 +206,18 @@ void NodeDiscover::exploreNodeNext()
         }
     }
 }
+
+void NodeDiscover::exploreBusAnswersEnd()
+{
+    _exploreBusWaitAnswers = false;
+    checkExplorationFinished();
+}
+
+void NodeDiscover::checkExplorationFinished()
+{
+    if (_exploring && !isExploring())
+    {
+        _exploring = false;
+        emit explorationFinished();
+    }
+}
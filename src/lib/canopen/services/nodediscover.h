@@ -37,25 +37,34 @@ public:
 
     QString type() const override;
 
-    void parseFrame(const QCanBusFrame &frame) override;
+    void parseFrame(const CanFrame &frame) override;
 
     void exploreBus();
     void exploreNode(quint8 nodeId);
+    bool isExploring() const;
+
+signals:
+    void explorationFinished();
 
 protected slots:
     void exploreBusNext();
     void exploreNodeNext();
+    void exploreBusAnswersEnd();
 
 protected:
     // explorer bus
     quint8 _exploreBusNodeId;
     QTimer _exploreBusTimer;
+    bool _exploreBusWaitAnswers;  // last node guarding requests sent, answers may still come
+    bool _exploring;              // explorationFinished() to emit
 
     // explorer node
     QQueue<quint8> _nodeIdToExplore;
     quint8 _exploreNodeCurrentId;
     QTimer _exploreNodeTimer;
     int _exploreNodeState;
+
+    void checkExplorationFinished();
 };
 
 #endif  // NODEDISCOVER_H
@@ -21,8 +21,8 @@
 #include "canopenbus.h"
 #include "services/services.h"
 
-#include <QDataStream>
 #include <QDebug>
+#include <QtEndian>
 
 enum
 {
@@ -41,6 +41,7 @@ PDO::PDO(Node *node, quint8 number)
     _stateMapping = STATE_FREE;
 
     _objectIdFsm = 0;
+    _mappedBitSize = 0;
 
     _waitingConf.transType = 0;
     _waitingConf.eventTimer = 0;
@@ -64,6 +65,8 @@ void PDO::reset()
     _stateMapping = STATE_FREE;
 
     _currentMappedObjectsId.clear();
+    _mappedObjects.clear();
+    _mappedBitSize = 0;
     _objectToMap.clear();
     createListObjectMapped();
 }
@@ -426,11 +429,9 @@ bool PDO::createListObjectMapped()
         setError(ERROR_COBID_NOT_VALID);
         return false;
     }
-    if (isRPDO())
-    {
-        clearDataWaiting();
-    }
     _currentMappedObjectsId.clear();
+    _mappedObjects.clear();
+    _mappedBitSize = 0;
     NodeObjectId objectMapping(_objectMappingId, 0);
     quint8 numberEntries = static_cast<quint8>(_node->nodeOd()->value(objectMapping).toUInt());
 
@@ -446,8 +447,41 @@ bool PDO::createListObjectMapped()
         {
             NodeObjectId object(_node->busId(), _node->nodeId(), indexMapping, subIndexMapping, _node->nodeOd()->dataType(indexMapping, subIndexMapping));
             _currentMappedObjectsId.append(object);
+
+            // length given by the mapping entry, bit granular, type length if not set
+            MappedObject mappedObject;
+            mappedObject.bitOffset = static_cast<quint16>(_mappedBitSize);
+            mappedObject.bitLength = static_cast<quint8>(mapping & PDO_DATASIZE_MASK);
+            if (mappedObject.bitLength == 0)
+            {
+                mappedObject.bitLength = object.bitSize();
+            }
+            mappedObject.dataType = object.dataType();
+            mappedObject.byteSlice = isByteSliceType(mappedObject.dataType);
+            mappedObject.nodeSubIndex = _node->nodeOd()->subIndex(indexMapping, subIndexMapping);
+
+            bool decodable;
+            if (mappedObject.byteSlice)
+            {
+                // strings and domains are byte aligned slices of the payload
+                decodable = ((mappedObject.bitLength % 8) == 0) && ((_mappedBitSize % 8) == 0);
+            }
+            else
+            {
+                decodable = (mappedObject.bitLength <= 64) && NodeValue::isSupportedType(mappedObject.dataType);
+            }
+            if (mappedObject.bitLength == 0 || !decodable || _mappedBitSize + mappedObject.bitLength > CanFrame::MaxPayloadSize * 8)
+            {
+                mappedObject.nodeSubIndex = nullptr;
+            }
+            _mappedObjects.append(mappedObject);
+            _mappedBitSize += mappedObject.bitLength;
         }
     }
+    if (isRPDO())
+    {
+        clearDataWaiting();
+    }
 
     if (_node->nodeOd()->indexExist(objectMapping.index()))
     {
@@ -462,6 +496,57 @@ bool PDO::checkIndex(quint16 index)
 {
     return index != 0;
 }
+
+/**
+ * @brief Types mapped as a slice of bytes of the payload, sized by the mapping length
+ */
+bool PDO::isByteSliceType(QMetaType::Type type)
+{
+    return (type == QMetaType::QString) || (type == QMetaType::QByteArray);
+}
+
+/**
+ * @brief Reads a mapped object from a PDO payload
+ * @param data payload copied in a zero padded buffer of PDO_BUFFER_SIZE bytes
+ * @param bitOffset position of the object in the payload
+ * @param bitLength length of the object, up to 64 bits
+ * @return raw bits aligned on bit 0, bits above bitLength are not cleared
+ */
+quint64 PDO::loadBits(const quint8 *data, int bitOffset, int bitLength)
+{
+    const int byteOffset = bitOffset >> 3;
+    const int shift = bitOffset & 7;
+    quint64 bits = qFromLittleEndian<quint64>(data + byteOffset) >> shift;
+    if (shift + bitLength > 64)
+    {
+        bits |= static_cast<quint64>(data[byteOffset + 8]) << (64 - shift);
+    }
+    return bits;
+}
+
+/**
+ * @brief Writes a mapped object in a PDO payload, other bits are kept
+ * @param data payload buffer of PDO_BUFFER_SIZE bytes
+ * @param bitOffset position of the object in the payload
+ * @param bitLength length of the object, up to 64 bits
+ * @param bits raw bits aligned on bit 0
+ */
+void PDO::storeBits(quint8 *data, int bitOffset, int bitLength, quint64 bits)
+{
+    const int byteOffset = bitOffset >> 3;
+    const int shift = bitOffset & 7;
+    const quint64 mask = (bitLength >= 64) ? ~Q_UINT64_C(0) : ((Q_UINT64_C(1) << bitLength) - 1);
+    bits &= mask;
+
+    quint64 word = qFromLittleEndian<quint64>(data + byteOffset);
+    word = (word & ~(mask << shift)) | (bits << shift);
+    qToLittleEndian<quint64>(word, data + byteOffset);
+    if (shift + bitLength > 64)
+    {
+        const quint8 highMask = static_cast<quint8>(mask >> (64 - shift));
+        data[byteOffset + 8] = static_cast<quint8>((data[byteOffset + 8] & ~highMask) | static_cast<quint8>(bits >> (64 - shift)));
+    }
+}
 /**
  * @brief management response from device after processMapping
  */
@@ -21,6 +21,8 @@
 
 #include "canopen_global.h"
 
+#include <QVector>
+
 #include "nodeodsubscriber.h"
 #include "service.h"
 
@@ -131,6 +133,26 @@ protected:
     QList<NodeObjectId> _currentMappedObjectsId;
     QList<NodeObjectId> _objectToMap;
 
+    // mapping compiled by createListObjectMapped(), one entry per object of _currentMappedObjectsId
+    struct MappedObject
+    {
+        NodeSubIndex *nodeSubIndex;  // nullptr if absent from od or not decodable
+        quint16 bitOffset;
+        quint8 bitLength;
+        QMetaType::Type dataType;
+        bool byteSlice;  // string or domain, copied as bytes instead of decoded as bits
+    };
+    QVector<MappedObject> _mappedObjects;
+    int _mappedBitSize;
+
+    enum
+    {
+        PDO_BUFFER_SIZE = CanFrame::MaxPayloadSize + 8  // room for an unaligned 64 bits access at the end of the payload
+    };
+    static bool isByteSliceType(QMetaType::Type type);
+    static quint64 loadBits(const quint8 *data, int bitOffset, int bitLength);
+    static void storeBits(quint8 *data, int bitOffset, int bitLength, quint64 bits);
+
     enum CommParam
     {
         PDO_COMM_NUMBER = 0x00,
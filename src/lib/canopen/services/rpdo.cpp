@@ -19,9 +19,9 @@
 #include "rpdo.h"
 
 #include "canopenbus.h"
-#include <QDataStream>
 #include <QDebug>
-#include <QIODevice>
+
+#include <cstring>
 
 RPDO::RPDO(Node *node, quint8 number)
     : PDO(node, number)
@@ -42,12 +42,20 @@ RPDO::RPDO(Node *node, quint8 number)
                        {_node->busId(), _node->nodeId(), _objectCommId, PDO_COMM_EVENT_TIMER}};
 }
 
+RPDO::~RPDO()
+{
+    if (_bus != nullptr)
+    {
+        _bus->rpdoProcessImage()->removeRpdo(this);
+    }
+}
+
 QString RPDO::type() const
 {
     return QLatin1String("RPDO") + QString::number(_pdoNumber + 1, 10);
 }
 
-void RPDO::parseFrame(const QCanBusFrame &frame)
+void RPDO::parseFrame(const CanFrame &frame)
 {
     Q_UNUSED(frame)
 }
@@ -80,8 +88,15 @@ void RPDO::odNotify(const NodeObjectId &objId, NodeOd::FlagsRequest flags)
 
 void RPDO::setBus(CanOpenBus *bus)
 {
+    if (_bus != nullptr)
+    {
+        _bus->rpdoProcessImage()->removeRpdo(this);
+    }
     _bus = bus;
-    connect(_bus->sync(), &Sync::signalBeforeSync, this, &RPDO::prepareAndSendData);
+    if (_bus != nullptr)
+    {
+        _bus->rpdoProcessImage()->addRpdo(this);
+    }
 }
 
 /**
@@ -115,18 +130,26 @@ quint8 RPDO::transmissionType()
 
 void RPDO::receiveSync()
 {
-    if ((_currentMappedObjectsId.isEmpty()) || (!isEnabled()))
+    if ((_mappedObjects.isEmpty()) || (!isEnabled()))
     {
         return;
     }
 
     // Update data of object in NodeOd after a sync
-    for (const NodeObjectId &objectIterator : qAsConst(_currentMappedObjectsId))
+    for (int i = 0; i < _mappedObjects.count(); i++)
     {
-        if (_dataObjectCurrentMapped.contains(objectIterator.key()) && _node->nodeOd()->indexExist(objectIterator.index())
-            && _node->nodeOd()->subIndexExist(objectIterator.index(), objectIterator.subIndex()))
+        NodeSubIndex *nodeSubIndex = _mappedObjects.at(i).nodeSubIndex;
+        if (nodeSubIndex == nullptr)
+        {
+            continue;
+        }
+        if (_pendingValues.at(i).isValid())
         {
-            _node->nodeOd()->index(objectIterator.index())->subIndex(objectIterator.subIndex())->setValue(_dataObjectCurrentMapped.value(objectIterator.key()));
+            nodeSubIndex->setValue(_pendingValues.at(i), 0);
+        }
+        else if (_pendingSlices.at(i).isValid())
+        {
+            nodeSubIndex->setValue(_pendingSlices.at(i));
         }
     }
 }
@@ -144,15 +167,19 @@ void RPDO::write(const NodeObjectId &object, const QVariant &data)
         return;
     }
 
-    for (const NodeObjectId &objectIterator : qAsConst(_currentMappedObjectsId))
+    for (int i = 0; i < _currentMappedObjectsId.count(); i++)
     {
+        const NodeObjectId &objectIterator = _currentMappedObjectsId.at(i);
         if (objectIterator.index() == object.index() && objectIterator.subIndex() == object.subIndex())
         {
-            if (_dataObjectCurrentMapped.contains(objectIterator.key()))
+            if (_mappedObjects.at(i).byteSlice)
+            {
+                _pendingSlices[i] = data;
+            }
+            else
             {
-                _dataObjectCurrentMapped.remove(objectIterator.key());
+                _pendingValues[i] = NodeValue::fromVariant(data);
             }
-            _dataObjectCurrentMapped.insert(object.key(), data);
             return;
         }
     }
@@ -163,118 +190,50 @@ void RPDO::write(const NodeObjectId &object, const QVariant &data)
  */
 void RPDO::clearDataWaiting()
 {
-    _dataObjectCurrentMapped.clear();
+    _pendingValues.fill(NodeValue(), _mappedObjects.count());
+    _pendingSlices.fill(QVariant(), _mappedObjects.count());
 }
 
 /**
- * @brief Prepares the data before the sync signal
+ * @brief Encodes the frame to send before the next sync, called by the process image of the bus
+ * @return false if the RPDO is not active
  */
-void RPDO::prepareAndSendData()
+bool RPDO::encodeFrame(CanFrame &frame)
 {
-    if ((_currentMappedObjectsId.isEmpty()) || (!isEnabled()) || _node->status() != Node::STARTED)
+    if ((_mappedObjects.isEmpty()) || (!isEnabled()) || _node->status() != Node::STARTED)
     {
-        return;
+        return false;
+    }
+    if (_mappedBitSize > maxMappingBitSize())
+    {
+        setError(ERROR_EXCEED_PDO_LENGTH);
     }
 
-    QDataStream request(&_rpdoDataToSendReqPayload, QIODevice::WriteOnly);
-    request.setByteOrder(QDataStream::LittleEndian);
-
-    for (const NodeObjectId &objectIterator : qAsConst(_currentMappedObjectsId))
+    quint8 data[PDO_BUFFER_SIZE] = {0};
+    for (int i = 0; i < _mappedObjects.count(); i++)
     {
-        quint8 size = static_cast<quint8>(QMetaType::sizeOf(objectIterator.dataType()));
-        if (size > 8)
-        {
-            setError(ERROR_EXCEED_PDO_LENGTH);
-        }
-        if (_dataObjectCurrentMapped.contains(objectIterator.key()))
+        const MappedObject &mappedObject = _mappedObjects.at(i);
+        if (mappedObject.nodeSubIndex == nullptr)
         {
-            convertQVariantToQDataStream(request, _dataObjectCurrentMapped.value(objectIterator.key()), _node->nodeOd()->dataType(objectIterator));
+            continue;
         }
-        else
+
+        if (mappedObject.byteSlice)
         {
-            convertQVariantToQDataStream(request, _node->nodeOd()->value(objectIterator), _node->nodeOd()->dataType(objectIterator));
+            // zero padded if shorter than the mapping
+            const QVariant &slice = _pendingSlices.at(i).isValid() ? _pendingSlices.at(i) : mappedObject.nodeSubIndex->value();
+            const QByteArray bytes = slice.toByteArray();
+            std::memcpy(data + mappedObject.bitOffset / 8, bytes.constData(), static_cast<size_t>(qMin(bytes.size(), mappedObject.bitLength / 8)));
+            continue;
         }
-    }
-    sendData();
-}
 
-/**
- * @brief Send data on bus
- */
-bool RPDO::sendData()
-{
-    if (!bus()->canWrite())
-    {
-        return false;
+        const NodeValue &value = _pendingValues.at(i).isValid() ? _pendingValues.at(i) : mappedObject.nodeSubIndex->nodeValue();
+        storeBits(data, mappedObject.bitOffset, mappedObject.bitLength, value.toBits(mappedObject.dataType));
     }
+    int bitSize = qMin(_mappedBitSize, static_cast<int>(CanFrame::MaxPayloadSize) * 8);
 
-    QCanBusFrame frame;
-    frame.setFrameId(_cobId);
-    frame.setPayload(_rpdoDataToSendReqPayload);
-    return bus()->writeFrame(frame);
-}
-
-/**
- * @brief Convert QVariant To QDataStream
- * @param request -> value converted
- * @param data value to convert
- * @param data QMetaType
- */
-void RPDO::convertQVariantToQDataStream(QDataStream &request, const QVariant &data, QMetaType::Type type)
-{
-    switch (type)
-    {
-        case QMetaType::Long:
-        case QMetaType::LongLong:
-        case QMetaType::Int:
-            request << data.value<int>();
-            break;
-
-        case QMetaType::ULong:
-        case QMetaType::ULongLong:
-        case QMetaType::UInt:
-            request << data.value<unsigned int>();
-            break;
-
-        case QMetaType::Double:
-            request << data.value<double>();
-            break;
-
-        case QMetaType::Short:
-            request << data.value<short>();
-            break;
-
-        case QMetaType::Char:
-            request << data.value<char>();
-            break;
-
-        case QMetaType::UShort:
-            request << data.value<unsigned short>();
-            break;
-
-        case QMetaType::UChar:
-            request << data.value<unsigned char>();
-            break;
-
-        case QMetaType::Float:
-            request << data.value<float>();
-            break;
-
-        case QMetaType::SChar:
-            request << data.value<signed char>();
-            break;
-
-        case QMetaType::QString:
-            request << data;
-            break;
-
-        case QMetaType::QByteArray:
-            request << data;
-            break;
-
-        default:
-            break;
-    }
+    frame = CanFrame(_cobId, data, (bitSize + 7) / 8);
+    return true;
 }
 
 bool RPDO::isTPDO() const
@@ -32,6 +32,7 @@ class CANOPEN_EXPORT RPDO : public PDO
     Q_OBJECT
 public:
     RPDO(Node *node, quint8 number);
+    ~RPDO() override;
 
     enum TransmissionType
     {
@@ -46,20 +47,19 @@ public:
     void write(const NodeObjectId &object, const QVariant &data);
     void clearDataWaiting() override;
 
+    bool encodeFrame(CanFrame &frame);
+
 protected slots:
     void receiveSync();
-    void prepareAndSendData();
 
 private:
-    QMap<quint64, QVariant> _dataObjectCurrentMapped;
-    QByteArray _rpdoDataToSendReqPayload;
-    bool sendData();
-    void convertQVariantToQDataStream(QDataStream &request, const QVariant &data, QMetaType::Type type);
+    QVector<NodeValue> _pendingValues;  // values written and not yet applied by a sync, one per mapped object
+    QVector<QVariant> _pendingSlices;   // same for string and domain objects
 
     // Service interface
 public:
     QString type() const override;
-    void parseFrame(const QCanBusFrame &frame) override;
+    void parseFrame(const CanFrame &frame) override;
     void setBus(CanOpenBus *bus) override;
 
     // PDO interface
@@ -0,0 +1,97 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "rpdoprocessimage.h"
+
+#include "canopenbus.h"
+#include "rpdo.h"
+
+RpdoProcessImage::RpdoProcessImage(CanOpenBus *bus)
+{
+    _bus = bus;
+    _lastBatchSize = 0;
+    _batchCount = 0;
+    _droppedBatchCount = 0;
+}
+
+void RpdoProcessImage::addRpdo(RPDO *rpdo)
+{
+    if (!_rpdos.contains(rpdo))
+    {
+        _rpdos.append(rpdo);
+        _batch.reserve(_rpdos.count());
+    }
+}
+
+void RpdoProcessImage::removeRpdo(RPDO *rpdo)
+{
+    _rpdos.removeOne(rpdo);
+}
+
+/**
+ * @brief Encodes active RPDOs of all nodes and sends them as one batch
+ * @return number of frames sent
+ */
+int RpdoProcessImage::sendOutputs()
+{
+    _batch.resize(_rpdos.count());
+
+    int count = 0;
+    for (RPDO *rpdo : qAsConst(_rpdos))
+    {
+        if (rpdo->encodeFrame(_batch[count]))
+        {
+            count++;
+        }
+    }
+
+    _lastBatchSize = count;
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    if (!_bus->writeFrames(_batch.constData(), count))
+    {
+        _droppedBatchCount++;
+        return 0;
+    }
+    _batchCount++;
+    return count;
+}
+
+/**
+ * @brief Number of frames of the last batch
+ */
+int RpdoProcessImage::lastBatchSize() const
+{
+    return _lastBatchSize;
+}
+
+quint64 RpdoProcessImage::batchCount() const
+{
+    return _batchCount;
+}
+
+/**
+ * @brief Number of batches not sent, bus not writable or emission queue full
+ */
+quint64 RpdoProcessImage::droppedBatchCount() const
+{
+    return _droppedBatchCount;
+}
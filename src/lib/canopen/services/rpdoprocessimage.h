@@ -0,0 +1,65 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef RPDOPROCESSIMAGE_H
+#define RPDOPROCESSIMAGE_H
+
+#include "canopen_global.h"
+
+#include <QList>
+#include <QVector>
+
+#include "busdriver/canframe.h"
+
+class CanOpenBus;
+class RPDO;
+
+/**
+ * @brief Cyclic output stage of a bus, sends RPDOs of all nodes in one batch per SYNC
+ *
+ * RPDOs register to the process image of their bus instead of reacting to the
+ * SYNC pre-sync signal one by one. At each pre-sync phase the payloads of all
+ * active RPDOs are encoded into a contiguous frame batch which is posted at
+ * once to the bus worker, and written with a single driver call (sendmmsg with
+ * SocketCAN) right before the SYNC frame.
+ */
+class CANOPEN_EXPORT RpdoProcessImage
+{
+public:
+    RpdoProcessImage(CanOpenBus *bus);
+
+    void addRpdo(RPDO *rpdo);
+    void removeRpdo(RPDO *rpdo);
+
+    int sendOutputs();
+
+    int lastBatchSize() const;
+    quint64 batchCount() const;
+    quint64 droppedBatchCount() const;
+
+private:
+    CanOpenBus *_bus;
+    QList<RPDO *> _rpdos;
+    QVector<CanFrame> _batch;
+
+    int _lastBatchSize;
+    quint64 _batchCount;
+    quint64 _droppedBatchCount;
+};
+
+#endif  // RPDOPROCESSIMAGE_H
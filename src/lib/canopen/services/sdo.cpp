@@ -25,6 +25,9 @@
 #include <QIODevice>
 #include <QThread>
 
+#include <array>
+#include <cstring>
+
 enum CCS : quint8  // CCS : Client Command Specifier from Client to Server
 {
     SDO_CCS_CLIENT_DOWNLOAD_INITIATE = 0x20,  // ccs:1
@@ -95,32 +98,87 @@ enum FlagBlock : quint8
     BLOCK_SEQNO_MASK = 0x7F      // Max segment by sub-block
 };
 
-SDO::SDO(Node *node)
+#define SDO_RATE_LIMIT_RETRY_MS 5
+#define SDO_BLOCK_TX_QUEUE_LIMIT 128  // frames pending in the bus emission queue above which block segments are held back
+#define SDO_BLOCK_BURST_MIN 4         // segments posted at once after repeated segment losses
+
+/**
+ * @brief CRC-16 of SDO block transfers (CCITT, polynomial 0x1021, initial value 0), updated incrementally
+ */
+static quint16 sdoBlockCrc(quint16 crc, const char *data, quint32 size)
+{
+    // built once, static initialization is thread safe
+    static const std::array<quint16, 256> table = []()
+    {
+        std::array<quint16, 256> crcTable;
+        for (int i = 0; i < 256; i++)
+        {
+            quint16 value = static_cast<quint16>(i << 8);
+            for (int bit = 0; bit < 8; bit++)
+            {
+                value = (value & 0x8000) ? static_cast<quint16>((value << 1) ^ 0x1021) : static_cast<quint16>(value << 1);
+            }
+            crcTable[static_cast<size_t>(i)] = value;
+        }
+        return crcTable;
+    }();
+
+    for (quint32 i = 0; i < size; i++)
+    {
+        crc = static_cast<quint16>((crc << 8) ^ table[static_cast<size_t>(((crc >> 8) ^ static_cast<quint8>(data[i])) & 0xFF)]);
+    }
+    return crc;
+}
+
+SDO::SDO(Node *node, quint8 channel)
     : Service(node)
 {
     _nodeId = node->nodeId();
-    _cobIdClientToServer = 0x600;
-    _cobIdServerToClient = 0x580;
-    _cobIds.append(_cobIdClientToServer + _nodeId);
-    _cobIds.append(_cobIdServerToClient + _nodeId);
+    _channel = channel;
+    if (_channel == 0)
+    {
+        // default SDO server, predefined connection set
+        _cobIdClientToServer = 0x600 + _nodeId;
+        _cobIdServerToClient = 0x580 + _nodeId;
+        _cobIds.append(_cobIdClientToServer);
+        _cobIds.append(_cobIdServerToClient);
+    }
+    else
+    {
+        // additional SDO server, disabled until its COB-IDs are known
+        _cobIdClientToServer = 0;
+        _cobIdServerToClient = 0;
+    }
 
     _timeoutTimer = new QTimer(this);
+    _serverFrameCount = 0;
     connect(_timeoutTimer, &QTimer::timeout, this, &SDO::timeout);
 
     _subBlockDownloadTimer = new QTimer(this);
+    _subBlockDownloadTimer->setSingleShot(true);
     connect(_subBlockDownloadTimer, &QTimer::timeout, this, &SDO::sdoBlockDownloadSubBlock);
 
+    _rateLimitTimer = new QTimer(this);
+    _rateLimitTimer->setSingleShot(true);
+    connect(_rateLimitTimer, &QTimer::timeout, this, &SDO::nextRequest);
+
     _status = SDO_STATE_FREE;
     _requestCurrent = nullptr;
 
     _maxErrorAttempt = 3;
     _blockDownloadIntervalMs = 1;
     _timeoutMs = 1800;
+    _blockThreshold = 64;
+    _blockTransferSupported = true;
+
+    resetStatistics();
 }
 
 SDO::~SDO()
 {
     delete _timeoutTimer;
+    qDeleteAll(_requestQueue);
+    delete _requestCurrent;
 }
 
 QString SDO::type() const
@@ -138,18 +196,75 @@ quint32 SDO::cobIdServerToClient() const
     return _cobIdServerToClient;
 }
 
+quint8 SDO::channel() const
+{
+    return _channel;
+}
+
+bool SDO::isEnabled() const
+{
+    return !_cobIds.isEmpty();
+}
+
+/**
+ * @brief Sets COB-IDs of this channel, as read from SDO server parameter 0x1200 + channel
+ * @param cobIdClientToServer COB-ID client -> server (rx of the device)
+ * @param cobIdServerToClient COB-ID server -> client (tx of the device)
+ */
+void SDO::setCobIds(quint32 cobIdClientToServer, quint32 cobIdServerToClient)
+{
+    CanOpenBus *canOpenBus = bus();
+    if (canOpenBus != nullptr && isEnabled())
+    {
+        canOpenBus->dispatcher()->removeService(this);
+    }
+
+    _cobIdClientToServer = cobIdClientToServer;
+    _cobIdServerToClient = cobIdServerToClient;
+    _cobIds.clear();
+    _cobIds.append(_cobIdClientToServer);
+    _cobIds.append(_cobIdServerToClient);
+
+    if (canOpenBus != nullptr)
+    {
+        canOpenBus->dispatcher()->addService(this);
+    }
+}
+
+/**
+ * @brief Disables an additional channel, pending requests are dropped
+ */
+void SDO::disable()
+{
+    if (_channel == 0 || !isEnabled())
+    {
+        return;
+    }
+
+    reset();
+    CanOpenBus *canOpenBus = bus();
+    if (canOpenBus != nullptr)
+    {
+        canOpenBus->dispatcher()->removeService(this);
+    }
+    _cobIds.clear();
+    _cobIdClientToServer = 0;
+    _cobIdServerToClient = 0;
+}
+
 /**
  * @brief Dispatcher frame
  * @param frame
  */
-void SDO::parseFrame(const QCanBusFrame &frame)
+void SDO::parseFrame(const CanFrame &frame)
 {
-    if (frame.frameId() == _cobIdClientToServer + _nodeId)
+    if (frame.frameId() == _cobIdClientToServer)
     {
         processingFrameFromClient(frame);
     }
-    else if (frame.frameId() == _cobIdServerToClient + _nodeId)
+    else if (frame.frameId() == _cobIdServerToClient)
     {
+        _serverFrameCount++;
         processingFrameFromServer(frame);
     }
     else
@@ -161,8 +276,12 @@ void SDO::parseFrame(const QCanBusFrame &frame)
 void SDO::reset()
 {
     _timeoutTimer->stop();
+    _subBlockDownloadTimer->stop();
+    _rateLimitTimer->stop();
     qDeleteAll(_requestQueue);
     _requestQueue.clear();
+    delete _requestCurrent;
+    _requestCurrent = nullptr;
     _status = SDO_STATE_FREE;
 }
 
@@ -170,7 +289,7 @@ void SDO::reset()
  * @brief Dispatcher frame SDO from client
  * @param frame
  */
-void SDO::processingFrameFromClient(const QCanBusFrame &frame)
+void SDO::processingFrameFromClient(const CanFrame &frame)
 {
     Q_UNUSED(frame)
 }
@@ -179,14 +298,14 @@ void SDO::processingFrameFromClient(const QCanBusFrame &frame)
  * @brief Dispatcher frame SDO from Server (device)
  * @param frame
  */
-void SDO::processingFrameFromServer(const QCanBusFrame &frame)
+void SDO::processingFrameFromServer(const CanFrame &frame)
 {
     if (_requestCurrent == nullptr)
     {
         return;
     }
 
-    if (frame.payload().size() != 8)
+    if (frame.size() != 8)
     {
         sendErrorSdoToDevice(SDOAbortCodes::CO_SDO_ABORT_CODE_GENERAL_ERROR);
         return;
@@ -197,7 +316,7 @@ void SDO::processingFrameFromServer(const QCanBusFrame &frame)
         return;
     }
 
-    quint8 scs = static_cast<quint8>(frame.payload().at(0) & SDO_CSS_MASK);
+    quint8 scs = static_cast<quint8>(frame.at(0) & SDO_CSS_MASK);
 
     _timeoutTimer->stop();
     switch (scs)
@@ -228,7 +347,23 @@ void SDO::processingFrameFromServer(const QCanBusFrame &frame)
 
         case SCS::SDO_SCS_CLIENT_ABORT:
         {
-            SDOAbortCodes error = static_cast<SDOAbortCodes>(arrangeDataUpload(frame.payload().mid(4, 4), QMetaType::Type::UInt).toUInt());
+            SDOAbortCodes error = static_cast<SDOAbortCodes>(frame.u32At(4));
+            if (_requestCurrent->block && (_requestCurrent->state == STATE_UPLOAD || _requestCurrent->state == STATE_DOWNLOAD)
+                && (error == CO_SDO_ABORT_CODE_CMD_NOT_VALID || error == CO_SDO_ABORT_CODE_UNSUPPORTED_ACCESS))
+            {
+                // block transfer refused at initiate, fallback to segmented transfer for this server
+                _blockTransferSupported = false;
+                if (_requestCurrent->state == STATE_UPLOAD)
+                {
+                    _requestCurrent->dataByte.clear();
+                    uploadDispatcher();
+                }
+                else
+                {
+                    downloadDispatcher();
+                }
+                break;
+            }
             qDebug() << "ABORT received : Index :" << QString::number(indexFromFrame(frame), 16).toUpper()
                      << ", SubIndex :" << QString::number(subIndexFromFrame(frame), 16).toUpper() << ", abort :" << QString::number(error, 16).toUpper() << sdoAbort(error);
 
@@ -245,6 +380,34 @@ bool SDO::hasRequestPending() const
     return (!_requestQueue.isEmpty());
 }
 
+/**
+ * @brief Checks if a request on the given object is queued or in progress
+ */
+bool SDO::hasRequest(quint16 index, quint8 subindex) const
+{
+    if (_status == SDO_STATE_NOT_FREE && _requestCurrent != nullptr && _requestCurrent->state != STATE_FREE && _requestCurrent->index == index
+        && _requestCurrent->subIndex == subindex)
+    {
+        return true;
+    }
+    for (RequestSdo *req : _requestQueue)
+    {
+        if (req->index == index && req->subIndex == subindex)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Number of requests queued or in progress
+ */
+int SDO::pendingRequestCount() const
+{
+    return _requestQueue.count() + ((_status == SDO_STATE_NOT_FREE) ? 1 : 0);
+}
+
 /**
  * @brief Status
  * @return status
@@ -254,6 +417,44 @@ SDO::Status SDO::status() const
     return _status;
 }
 
+const SDO::Statistics &SDO::statistics() const
+{
+    return _statistics;
+}
+
+void SDO::resetStatistics()
+{
+    _statistics.bytes = 0;
+    _statistics.requests = 0;
+    _statistics.errors = 0;
+    _statistics.busyTimeUs = 0;
+}
+
+void SDO::accountRequest(bool error)
+{
+    if (error)
+    {
+        _statistics.errors++;
+    }
+    else
+    {
+        _statistics.requests++;
+        if (_requestCurrent->state == STATE_UPLOAD)
+        {
+            _statistics.bytes += static_cast<quint64>(_requestCurrent->dataByte.size());
+        }
+        else
+        {
+            _statistics.bytes += _requestCurrent->size;
+        }
+    }
+    if (_requestElapsed.isValid())
+    {
+        _statistics.busyTimeUs += _requestElapsed.nsecsElapsed() / 1000;
+        _requestElapsed.invalidate();
+    }
+}
+
 QString SDO::sdoAbort(SDOAbortCodes error) const
 {
     switch (error)
@@ -334,10 +535,16 @@ QString SDO::sdoAbort(SDOAbortCodes error) const
  */
 bool SDO::uploadData(quint16 index, quint8 subindex, QMetaType::Type dataType)
 {
+    // an upload of the same object queued or in progress gives the awaited answer
     bool existing = false;
+    if (_status == SDO_STATE_NOT_FREE && _requestCurrent != nullptr && _requestCurrent->index == index && _requestCurrent->subIndex == subindex)
+    {
+        existing = (_requestCurrent->state == STATE_UPLOAD || _requestCurrent->state == STATE_UPLOAD_SEGMENT || _requestCurrent->state == STATE_BLOCK_UPLOAD
+                    || _requestCurrent->state == STATE_BLOCK_UPLOAD_END_SUB || _requestCurrent->state == STATE_BLOCK_UPLOAD_END);
+    }
     for (RequestSdo *req : qAsConst(_requestQueue))
     {
-        if (req->index == index && req->subIndex == subindex)
+        if (req->index == index && req->subIndex == subindex && req->state == STATE_UPLOAD)
         {
             existing = true;
         }
@@ -351,6 +558,7 @@ bool SDO::uploadData(quint16 index, quint8 subindex, QMetaType::Type dataType)
         request->dataType = dataType;
         request->size = static_cast<quint32>(QMetaType::sizeOf(QMetaType::Type(dataType)));
         request->state = STATE_UPLOAD;
+        request->block = false;
         _requestQueue.enqueue(request);
     }
 
@@ -374,6 +582,7 @@ bool SDO::downloadData(quint16 index, quint8 subindex, const QVariant &data)
     request->data = data;
     request->dataType = QMetaType::Type(data.type());
     request->state = STATE_DOWNLOAD;
+    request->block = false;
 
     if (request->dataType != QMetaType::Type::QByteArray)
     {
@@ -406,8 +615,17 @@ bool SDO::uploadDispatcher()
         subIndex = _node->nodeOd()->index(_requestCurrent->index)->subIndex(_requestCurrent->subIndex);
     }
 
-    if ((subIndex != nullptr) && (subIndex->dataType() == NodeSubIndex::DDOMAIN))
+    // size of the last known value, 0 if never read
+    int knownSize = 0;
+    if (subIndex != nullptr)
     {
+        knownSize = subIndex->isNumeric() ? subIndex->byteLength() : subIndex->value().toByteArray().size();
+    }
+
+    _requestCurrent->block = false;
+    if (isBlockCandidate(subIndex) && ((knownSize == 0 && subIndex->dataType() == NodeSubIndex::DDOMAIN) || knownSize > _blockThreshold))
+    {
+        _requestCurrent->block = true;
         cmd = CCS::SDO_CCS_CLIENT_BLOCK_UPLOAD;
         _requestCurrent->blksize = BLOCK_BLOCK_SIZE;
         sendSdoRequest(cmd, _requestCurrent->index, _requestCurrent->subIndex, _requestCurrent->blksize, 0);
@@ -415,6 +633,7 @@ bool SDO::uploadDispatcher()
     }
     else
     {
+        // the server chooses expedited or segmented transfer
         cmd = CCS::SDO_CCS_CLIENT_UPLOAD_INITIATE;
         sendSdoRequest(cmd, _requestCurrent->index, _requestCurrent->subIndex);
         _requestCurrent->state = STATE_UPLOAD;
@@ -428,14 +647,9 @@ bool SDO::uploadDispatcher()
  * @param frame
  * @return index
  */
-quint16 SDO::indexFromFrame(const QCanBusFrame &frame)
+quint16 SDO::indexFromFrame(const CanFrame &frame)
 {
-    quint16 index = 0;
-    QByteArray sdoWriteReqPayload = frame.payload().mid(1, 2);
-    QDataStream request(&sdoWriteReqPayload, QIODevice::ReadOnly);
-    request.setByteOrder(QDataStream::LittleEndian);
-    request >> index;
-    return index;
+    return frame.u16At(1);
 }
 
 /**
@@ -443,9 +657,9 @@ quint16 SDO::indexFromFrame(const QCanBusFrame &frame)
  * @param frame
  * @return index
  */
-quint8 SDO::subIndexFromFrame(const QCanBusFrame &frame)
+quint8 SDO::subIndexFromFrame(const CanFrame &frame)
 {
-    return static_cast<quint8>(frame.payload().at(3));
+    return frame.at(3);
 }
 
 /**
@@ -453,10 +667,10 @@ quint8 SDO::subIndexFromFrame(const QCanBusFrame &frame)
  * @param frame
  * @return 0->ok 1->nok
  */
-bool SDO::sdoUploadInitiate(const QCanBusFrame &frame)
+bool SDO::sdoUploadInitiate(const CanFrame &frame)
 {
-    quint8 transferType = (static_cast<quint8>(frame.payload().at(0) & Flag::SDO_E_MASK)) >> 1;
-    quint8 sizeIndicator = static_cast<quint8>(frame.payload().at(0) & Flag::SDO_S_SIZE_MASK);
+    quint8 transferType = (static_cast<quint8>(frame.at(0) & Flag::SDO_E_MASK)) >> 1;
+    quint8 sizeIndicator = static_cast<quint8>(frame.at(0) & Flag::SDO_S_SIZE_MASK);
     quint8 cmd = 0;
     quint16 index = indexFromFrame(frame);
     quint8 subindex = subIndexFromFrame(frame);
@@ -471,8 +685,8 @@ bool SDO::sdoUploadInitiate(const QCanBusFrame &frame)
     {
         if (sizeIndicator == 1)  // data set size is indicated
         {
-            _requestCurrent->stay = (4 - (((frame.payload().at(0)) & SDO_N_NUMBER_INIT_MASK) >> 2));
-            _requestCurrent->dataByte.append(frame.payload().mid(4, static_cast<quint8>(_requestCurrent->stay)));
+            _requestCurrent->stay = (4 - (((frame.at(0)) & SDO_N_NUMBER_INIT_MASK) >> 2));
+            _requestCurrent->dataByte.append(reinterpret_cast<const char *>(frame.data()) + 4, static_cast<quint8>(_requestCurrent->stay));
         }
         else
         {
@@ -487,10 +701,7 @@ bool SDO::sdoUploadInitiate(const QCanBusFrame &frame)
             // NOT USED -> ERROR d is reserved for further use.
         }
 
-        QByteArray sdoWriteReqPayload = frame.payload().mid(4, 4);
-        QDataStream request(&sdoWriteReqPayload, QIODevice::ReadOnly);
-        request.setByteOrder(QDataStream::LittleEndian);
-        request >> _requestCurrent->size;
+        _requestCurrent->size = frame.u32At(4);
         _requestCurrent->stay = _requestCurrent->size;
 
         cmd = CCS::SDO_CCS_CLIENT_UPLOAD_SEGMENT;
@@ -516,11 +727,11 @@ bool SDO::sdoUploadInitiate(const QCanBusFrame &frame)
  * @param frame
  * @return 0->ok 1->nok
  */
-bool SDO::sdoUploadSegment(const QCanBusFrame &frame)
+bool SDO::sdoUploadSegment(const CanFrame &frame)
 {
     quint8 cmd = 0;
     quint8 size = 0;
-    quint8 toggle = static_cast<quint8>((frame.payload().at(0) & SDO_TOGGLE_MASK));
+    quint8 toggle = static_cast<quint8>((frame.at(0) & SDO_TOGGLE_MASK));
 
     if (_requestCurrent->state != STATE_UPLOAD_SEGMENT)
     {
@@ -535,12 +746,12 @@ bool SDO::sdoUploadSegment(const QCanBusFrame &frame)
         return false;
     }
 
-    size = (SDO_SG_SIZE - (((frame.payload().at(0)) & SDO_N_NUMBER_SEG_MASK) >> 1));
+    size = (SDO_SG_SIZE - (((frame.at(0)) & SDO_N_NUMBER_SEG_MASK) >> 1));
 
-    _requestCurrent->dataByte.append(frame.payload().mid(1, size));
+    _requestCurrent->dataByte.append(reinterpret_cast<const char *>(frame.data()) + 1, size);
     _requestCurrent->stay -= size;
 
-    if ((frame.payload().at(0) & SDO_C_MORE_MASK) == SDO_C_MORE)  // no more segments to be uploaded
+    if ((frame.at(0) & SDO_C_MORE_MASK) == SDO_C_MORE)  // no more segments to be uploaded
     {
         _requestCurrent->state = STATE_UPLOAD;
         endRequest();
@@ -563,13 +774,13 @@ bool SDO::sdoUploadSegment(const QCanBusFrame &frame)
  * @param frame
  * @return 0->ok 1->nok
  */
-bool SDO::sdoBlockUpload(const QCanBusFrame &frame)
+bool SDO::sdoBlockUpload(const CanFrame &frame)
 {
     quint8 cmd = 0;
     quint16 index = indexFromFrame(frame);
     quint8 subindex = subIndexFromFrame(frame);
 
-    quint8 ss = static_cast<quint8>(frame.payload().at(0) & SS::SDO_SCS_SERVER_BLOCK_UPLOAD_SS_END_RESP);
+    quint8 ss = static_cast<quint8>(frame.at(0) & SS::SDO_SCS_SERVER_BLOCK_UPLOAD_SS_END_RESP);
     if ((ss == SS::SDO_SCS_SERVER_BLOCK_UPLOAD_SS_INIT_RESP) && (_requestCurrent->state == STATE_UPLOAD))
     {
         if ((index != _requestCurrent->index) || (subindex != _requestCurrent->subIndex))
@@ -577,12 +788,9 @@ bool SDO::sdoBlockUpload(const QCanBusFrame &frame)
             sendErrorSdoToDevice(CO_SDO_ABORT_CODE_CMD_NOT_VALID);
             return false;
         }
-        if (static_cast<quint8>(frame.payload().at(0) & BLOCK_SIZE) == BLOCK_SIZE)
+        if (static_cast<quint8>(frame.at(0) & BLOCK_SIZE) == BLOCK_SIZE)
         {
-            QByteArray sdoWriteReqPayload = frame.payload().mid(4, 4);
-            QDataStream request(&sdoWriteReqPayload, QIODevice::ReadOnly);
-            request.setByteOrder(QDataStream::LittleEndian);
-            request >> _requestCurrent->size;
+            _requestCurrent->size = frame.u32At(4);
             _requestCurrent->stay = _requestCurrent->size;
         }
         else
@@ -603,7 +811,7 @@ bool SDO::sdoBlockUpload(const QCanBusFrame &frame)
     }
     else if ((ss == SS::SDO_SCS_SERVER_BLOCK_UPLOAD_SS_END_RESP) && (_requestCurrent->state == STATE_BLOCK_UPLOAD_END))
     {
-        quint8 n = (frame.payload().at(0) & BLOCK_N_NUMBER_MASK) >> 2;
+        quint8 n = (frame.at(0) & BLOCK_N_NUMBER_MASK) >> 2;
         if (n != _requestCurrent->stay)
         {
             sendErrorSdoToDevice(CO_SDO_ABORT_CODE_INVALID_BLOCK_SIZE);
@@ -631,13 +839,13 @@ bool SDO::sdoBlockUpload(const QCanBusFrame &frame)
  * @param frame
  * @return 0->ok 1->nok
  */
-bool SDO::sdoBlockUploadSubBlock(const QCanBusFrame &frame)
+bool SDO::sdoBlockUploadSubBlock(const CanFrame &frame)
 {
     quint8 cmd = 0;
     quint8 moreBlockSegments = 0;
     quint8 reveiveSeqno = 0;
 
-    reveiveSeqno = frame.payload().at(0) & BLOCK_SEQNO_MASK;
+    reveiveSeqno = frame.at(0) & BLOCK_SEQNO_MASK;
     if ((_requestCurrent->seqno != reveiveSeqno) && (!_requestCurrent->error))
     {
         // ERROR SEQUENCE NUMBER
@@ -649,10 +857,10 @@ bool SDO::sdoBlockUploadSubBlock(const QCanBusFrame &frame)
     else if (!_requestCurrent->error)
     {
         _requestCurrent->ackseq = _requestCurrent->seqno;
-        _requestCurrent->dataByteBySegment.append(frame.payload().mid(1, SDO_SG_SIZE));
+        _requestCurrent->dataByteBySegment.append(reinterpret_cast<const char *>(frame.data()) + 1, SDO_SG_SIZE);
     }
 
-    moreBlockSegments = (frame.payload().at(0) & BLOCK_C_MORE_SEG);
+    moreBlockSegments = (frame.at(0) & BLOCK_C_MORE_SEG);
     if ((_requestCurrent->seqno >= _requestCurrent->blksize) || (moreBlockSegments == BLOCK_C_MORE_SEG))
     {
         if (!_requestCurrent->error)
@@ -714,21 +922,23 @@ bool SDO::downloadDispatcher()
         subIndex = _node->nodeOd()->index(_requestCurrent->index)->subIndex(_requestCurrent->subIndex);
     }
 
-    if ((subIndex != nullptr) && (subIndex->dataType() == NodeSubIndex::DDOMAIN))
+    _requestCurrent->block = false;
+    if (isBlockCandidate(subIndex) && _requestCurrent->size > static_cast<quint32>(_blockThreshold))
     {
+        _requestCurrent->block = true;
         cmd = CCS::SDO_CCS_CLIENT_BLOCK_DOWNLOAD;
         cmd |= FlagBlock::BLOCK_SIZE;
+        cmd |= FlagBlock::BLOCK_CRC;
 
-        QByteArray size;
-        QDataStream req(&size, QIODevice::WriteOnly);
-        req.setByteOrder(QDataStream::LittleEndian);
-        arrangeDataDownload(req, QVariant(static_cast<quint32>(_requestCurrent->size)));
-
-        sendSdoRequest(cmd, _requestCurrent->index, _requestCurrent->subIndex, size);
+        sendSdoRequest(cmd, _requestCurrent->index, _requestCurrent->subIndex, _requestCurrent->size);
 
         _requestCurrent->seqno = 1;
         _requestCurrent->stay = _requestCurrent->size;
         _requestCurrent->attemptCount = 0;
+        _requestCurrent->ackOffset = 0;
+        _requestCurrent->crc = 0;
+        _requestCurrent->crcSupported = false;
+        _requestCurrent->burst = BLOCK_BLOCK_SIZE;
     }
     else
     {
@@ -747,12 +957,7 @@ bool SDO::downloadDispatcher()
             cmd = CCS::SDO_CCS_CLIENT_DOWNLOAD_INITIATE;
             cmd |= Flag::SDO_S_SIZE;
 
-            QByteArray size;
-            QDataStream req(&size, QIODevice::WriteOnly);
-            req.setByteOrder(QDataStream::LittleEndian);
-            arrangeDataDownload(req, QVariant(static_cast<quint32>(_requestCurrent->size)));
-
-            sendSdoRequest(cmd, _requestCurrent->index, _requestCurrent->subIndex, size);
+            sendSdoRequest(cmd, _requestCurrent->index, _requestCurrent->subIndex, _requestCurrent->size);
             _requestCurrent->stay = _requestCurrent->size;
             _requestCurrent->state = STATE_DOWNLOAD_SEGMENT;
         }
@@ -761,15 +966,39 @@ bool SDO::downloadDispatcher()
     return true;
 }
 
+/**
+ * @brief Block transfers are only used on domains and strings, when the server accepts them
+ * @param subIndex object description, nullptr if unknown
+ */
+bool SDO::isBlockCandidate(NodeSubIndex *subIndex) const
+{
+    if (!_blockTransferSupported || subIndex == nullptr)
+    {
+        return false;
+    }
+    switch (subIndex->dataType())
+    {
+        case NodeSubIndex::DDOMAIN:
+        case NodeSubIndex::OCTET_STRING:
+        case NodeSubIndex::VISIBLE_STRING:
+        case NodeSubIndex::UNICODE_STRING:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
 /**
  * @brief Management SDO Initialte Download protocol
  * @param frame
  * @return 0->ok 1->nok
  */
-bool SDO::sdoDownloadInitiate(const QCanBusFrame &frame)
+bool SDO::sdoDownloadInitiate(const CanFrame &frame)
 {
     quint32 seek = 0;
-    QByteArray buffer;
+    const char *segment = nullptr;
+    int segmentSize = 0;
     quint8 cmd = 0;
     quint16 index = indexFromFrame(frame);
     quint8 subindex = subIndexFromFrame(frame);
@@ -791,20 +1020,20 @@ bool SDO::sdoDownloadInitiate(const QCanBusFrame &frame)
         }
 
         seek = _requestCurrent->size - _requestCurrent->stay;
-        buffer.clear();
-        buffer = _requestCurrent->dataByte.mid(static_cast<int32_t>(seek), SDO_SG_SIZE);
+        segment = _requestCurrent->dataByte.constData() + seek;
+        segmentSize = static_cast<int>(qMin(_requestCurrent->stay, static_cast<quint32>(SDO_SG_SIZE)));
 
         if (_requestCurrent->stay < SDO_SG_SIZE)  // no more segments to be downloaded
         {
             _requestCurrent->state = STATE_DOWNLOAD;
             cmd |= SDO_C_MORE;
-            sendSdoRequest(cmd, buffer);
+            sendSdoRequest(cmd, segment, segmentSize);
             endRequest();
             return true;
         }
 
         _requestCurrent->state = STATE_DOWNLOAD_SEGMENT;
-        sendSdoRequest(cmd, buffer);
+        sendSdoRequest(cmd, segment, segmentSize);
         _requestCurrent->stay -= SDO_SG_SIZE;
     }
     else if (_requestCurrent->state == STATE_DOWNLOAD)
@@ -821,10 +1050,11 @@ bool SDO::sdoDownloadInitiate(const QCanBusFrame &frame)
  * @param frame
  * @return 0->ok 1->nok
  */
-bool SDO::sdoDownloadSegment(const QCanBusFrame &frame)
+bool SDO::sdoDownloadSegment(const CanFrame &frame)
 {
     quint32 seek = 0;
-    QByteArray buffer;
+    const char *segment = nullptr;
+    int segmentSize = 0;
     quint8 cmd = 0;
     quint8 toggle = 0;
 
@@ -835,7 +1065,7 @@ bool SDO::sdoDownloadSegment(const QCanBusFrame &frame)
         return false;
     }
 
-    toggle = static_cast<quint8>((frame.payload().at(0) & SDO_TOGGLE_MASK));
+    toggle = static_cast<quint8>((frame.at(0) & SDO_TOGGLE_MASK));
     if (toggle != _requestCurrent->toggle)
     {
         sendErrorSdoToDevice(CO_SDO_ABORT_CODE_BIT_NOT_ALTERNATED);
@@ -847,21 +1077,21 @@ bool SDO::sdoDownloadSegment(const QCanBusFrame &frame)
     cmd |= _requestCurrent->toggle & SDO_TOGGLE_MASK;
 
     seek = _requestCurrent->size - _requestCurrent->stay;
-    buffer.clear();
-    buffer = _requestCurrent->dataByte.mid(static_cast<int32_t>(seek), SDO_SG_SIZE);
+    segment = _requestCurrent->dataByte.constData() + seek;
+    segmentSize = static_cast<int>(qMin(_requestCurrent->stay, static_cast<quint32>(SDO_SG_SIZE)));
 
     if (_requestCurrent->stay < SDO_SG_SIZE)
     {
         _requestCurrent->state = STATE_DOWNLOAD;
         cmd |= ((SDO_SG_SIZE - _requestCurrent->stay) << 1) & SDO_N_NUMBER_SEG_MASK;
         cmd |= SDO_C_MORE;  // no more segments to be downloaded
-        sendSdoRequest(cmd, buffer);
+        sendSdoRequest(cmd, segment, segmentSize);
         endRequest();
         return true;
     }
 
     _requestCurrent->state = STATE_DOWNLOAD_SEGMENT;
-    sendSdoRequest(cmd, buffer);
+    sendSdoRequest(cmd, segment, segmentSize);
     _requestCurrent->stay -= SDO_SG_SIZE;
 
     return true;
@@ -872,12 +1102,12 @@ bool SDO::sdoDownloadSegment(const QCanBusFrame &frame)
  * @param frame
  * @return 0->ok 1->nok
  */
-bool SDO::sdoBlockDownload(const QCanBusFrame &frame)
+bool SDO::sdoBlockDownload(const CanFrame &frame)
 {
     quint16 index = 0;
     quint8 subindex = 0;
 
-    quint8 ss = static_cast<quint8>(frame.payload().at(0) & SS::SDO_SCS_SERVER_BLOCK_DOWNLOAD_SS_MASK);
+    quint8 ss = static_cast<quint8>(frame.at(0) & SS::SDO_SCS_SERVER_BLOCK_DOWNLOAD_SS_MASK);
 
     if (_requestCurrent == nullptr)
     {
@@ -896,53 +1126,74 @@ bool SDO::sdoBlockDownload(const QCanBusFrame &frame)
             return false;
         }
 
-        _requestCurrent->blksize = static_cast<quint8>(frame.payload().at(4));
-        if (_requestCurrent->blksize > BLOCK_BLOCK_SIZE)
+        _requestCurrent->blksize = frame.at(4);
+        if (_requestCurrent->blksize == 0 || _requestCurrent->blksize > BLOCK_BLOCK_SIZE)
         {
             sendErrorSdoToDevice(CO_SDO_ABORT_CODE_INVALID_BLOCK_SIZE);
             return false;
         }
+        _requestCurrent->crcSupported = ((frame.at(0) & FlagBlock::BLOCK_CRC) != 0);
 
         _requestCurrent->state = STATE_BLOCK_DOWNLOAD;
         _requestCurrent->seqno = 1;
-        _subBlockDownloadTimer->start(_blockDownloadIntervalMs);
         _timeoutTimer->stop();
+        sdoBlockDownloadSubBlock();
     }
     else if (ss == SS::SDO_SCS_SERVER_BLOCK_DOWNLOAD_SS_RESP)
     {
-        _requestCurrent->blksize = static_cast<quint8>(frame.payload().at(2));
-        if (_requestCurrent->blksize > BLOCK_BLOCK_SIZE)
+        if (_requestCurrent->state != STATE_BLOCK_DOWNLOAD && _requestCurrent->state != STATE_BLOCK_DOWNLOAD_END)
+        {
+            sendErrorSdoToDevice(CO_SDO_ABORT_CODE_CMD_NOT_VALID);
+            return false;
+        }
+
+        quint8 blksize = frame.at(2);
+        if (blksize == 0 || blksize > BLOCK_BLOCK_SIZE)
         {
             sendErrorSdoToDevice(CO_SDO_ABORT_CODE_INVALID_BLOCK_SIZE);
             return false;
         }
 
-        quint8 ackseq = static_cast<quint8>(frame.payload().at(1));
-        if (ackseq > BLOCK_BLOCK_SIZE)
+        quint8 sent = _requestCurrent->seqno - 1;
+        quint8 ackseq = frame.at(1);
+        if (ackseq > sent)
         {
             sendErrorSdoToDevice(CO_SDO_ABORT_CODE_INVALID_SEQ_NUMBER);
             return false;
         }
-        if (ackseq != (_requestCurrent->seqno - 1))
+
+        // segments up to ackseq are received, the CRC follows the acknowledged data
+        quint32 acked = qMin(static_cast<quint32>(ackseq) * SDO_SG_SIZE, _requestCurrent->size - _requestCurrent->ackOffset);
+        _requestCurrent->crc = sdoBlockCrc(_requestCurrent->crc, _requestCurrent->dataByte.constData() + _requestCurrent->ackOffset, acked);
+        _requestCurrent->ackOffset += acked;
+        _requestCurrent->stay = _requestCurrent->size - _requestCurrent->ackOffset;
+        _requestCurrent->blksize = blksize;
+
+        if (ackseq != sent)
         {
-            // ERROR sequence detection from server -> Re-Send block
+            // segments lost, the next sub-block resumes after the last one received with smaller bursts
             qDebug() << ">>SDO::sdoBlockDownload, Error sequence detection from server, ackseq : " << ackseq << "attempt:" << _requestCurrent->attemptCount;
-            _requestCurrent->stay += (_requestCurrent->seqno - 1) * SDO_SG_SIZE;
             _requestCurrent->state = STATE_BLOCK_DOWNLOAD;
+            _requestCurrent->burst = qMax(static_cast<quint8>(SDO_BLOCK_BURST_MIN), static_cast<quint8>(_requestCurrent->burst / 2));
             _requestCurrent->attemptCount++;
-            if (_requestCurrent->attemptCount == _maxErrorAttempt)
+            if (_requestCurrent->attemptCount >= _maxErrorAttempt)
             {
                 _requestCurrent->attemptCount = 0;
                 sendErrorSdoToDevice(CO_SDO_ABORT_CODE_INVALID_SEQ_NUMBER);
                 return false;
             }
         }
+        else
+        {
+            _requestCurrent->attemptCount = 0;
+            _requestCurrent->burst = qMin(static_cast<quint8>(BLOCK_BLOCK_SIZE), static_cast<quint8>(_requestCurrent->burst + SDO_BLOCK_BURST_MIN));
+        }
 
         if (_requestCurrent->state == STATE_BLOCK_DOWNLOAD)
         {
             _requestCurrent->seqno = 1;
-            _subBlockDownloadTimer->start(_blockDownloadIntervalMs);
             _timeoutTimer->stop();
+            sdoBlockDownloadSubBlock();
         }
         else if (_requestCurrent->state == STATE_BLOCK_DOWNLOAD_END)
         {
@@ -959,48 +1210,96 @@ bool SDO::sdoBlockDownload(const QCanBusFrame &frame)
 }
 
 /**
- * @brief Send a sub block
+ * @brief Sends the segments of the current sub-block
+ *
+ * Segments are built in place from the request data and posted to the bus
+ * emission queue in bursts. When the queue already holds enough frames
+ * (driver slower than the transfer) or the bus SDO load limit is reached,
+ * the transfer yields and retries after blockDownloadIntervalMs. It times
+ * out if no segment can be posted for timeoutMs.
  */
 void SDO::sdoBlockDownloadSubBlock()
 {
-    quint32 seek = 0;
-    QByteArray buffer;
+    if (_requestCurrent == nullptr || _requestCurrent->state != STATE_BLOCK_DOWNLOAD)
+    {
+        return;
+    }
 
-    if (_requestCurrent == nullptr)
+    quint32 pending = bus()->worker()->txPendingCount();
+    if (pending >= SDO_BLOCK_TX_QUEUE_LIMIT || bus()->isSdoRateLimited())
     {
-        _subBlockDownloadTimer->stop();
+        sdoBlockDownloadYield();
         return;
     }
 
-    if (_requestCurrent->seqno <= _requestCurrent->blksize)
+    int count = _requestCurrent->blksize - _requestCurrent->seqno + 1;
+    count = qMin(count, static_cast<int>(_requestCurrent->burst));
+    count = qMin(count, static_cast<int>(SDO_BLOCK_TX_QUEUE_LIMIT - pending));
+    if (count <= 0)
     {
-        seek = _requestCurrent->size - _requestCurrent->stay;
-        buffer.clear();
-        buffer = _requestCurrent->dataByte.mid(static_cast<int32_t>(seek), SDO_SG_SIZE);
+        return;
+    }
 
-        sendSdoRequest(true, _requestCurrent->seqno, buffer);
-        _requestCurrent->stay -= SDO_SG_SIZE;
-        _requestCurrent->seqno++;
+    CanFrame frames[BLOCK_BLOCK_SIZE];
+    const char *data = _requestCurrent->dataByte.constData();
+    quint32 stay = _requestCurrent->stay;
+    quint8 seqno = _requestCurrent->seqno;
+    bool last = false;
+    int frameCount = 0;
+    while (frameCount < count && !last)
+    {
+        quint32 segSize = qMin(stay, static_cast<quint32>(SDO_SG_SIZE));
+        last = (stay <= SDO_SG_SIZE);
 
-        if (_requestCurrent->stay <= SDO_SG_SIZE)
-        {
-            seek = _requestCurrent->size - _requestCurrent->stay;
-            buffer.clear();
-            buffer = _requestCurrent->dataByte.mid(static_cast<int32_t>(seek), SDO_SG_SIZE);
-
-            sendSdoRequest(false, _requestCurrent->seqno, buffer);
-            _requestCurrent->state = STATE_BLOCK_DOWNLOAD_END;
-            _requestCurrent->seqno++;
-            _subBlockDownloadTimer->stop();
-            return;
-        }
+        CanFrame &frame = frames[frameCount];
+        frame.setFrameId(_cobIdClientToServer);
+        frame.setSize(8);
+        quint8 *payload = frame.data();
+        payload[0] = last ? static_cast<quint8>(seqno | BLOCK_C_MORE_SEG) : seqno;
+        memcpy(payload + 1, data + (_requestCurrent->size - stay), segSize);
+        memset(payload + 1 + segSize, 0, SDO_SG_SIZE - segSize);
+
+        stay -= segSize;
+        seqno++;
+        frameCount++;
+    }
+
+    if (!bus()->writeFrames(frames, frameCount))
+    {
+        sdoBlockDownloadYield();
+        return;
+    }
+    _timeoutTimer->stop();
+    _requestCurrent->stay = stay;
+    _requestCurrent->seqno = seqno;
+
+    if (last)
+    {
+        _requestCurrent->state = STATE_BLOCK_DOWNLOAD_END;
+        _timeoutTimer->start(_timeoutMs);
+    }
+    else if (_requestCurrent->seqno > _requestCurrent->blksize)
+    {
+        // sub-block complete, waiting for the server response
+        _timeoutTimer->start(_timeoutMs);
     }
     else
     {
-        _subBlockDownloadTimer->stop();
-        _requestCurrent->state = STATE_BLOCK_DOWNLOAD;
+        // next burst of the sub-block from the event loop, other transfers of the bus are interleaved
+        _subBlockDownloadTimer->start(0);
+    }
+}
+
+/**
+ * @brief Retries the sub-block later, the timeout is armed by the first yield only
+ */
+void SDO::sdoBlockDownloadYield()
+{
+    if (!_timeoutTimer->isActive())
+    {
         _timeoutTimer->start(_timeoutMs);
     }
+    _subBlockDownloadTimer->start(_blockDownloadIntervalMs);
 }
 
 /**
@@ -1008,11 +1307,12 @@ void SDO::sdoBlockDownloadSubBlock()
  */
 bool SDO::sdoBlockDownloadEnd()
 {
+    quint32 lastSegSize = ((_requestCurrent->size - 1) % SDO_SG_SIZE) + 1;
     quint8 cmd = 0;
     cmd = CCS::SDO_CCS_CLIENT_BLOCK_DOWNLOAD;
     cmd |= CS::SDO_CCS_CLIENT_BLOCK_DOWNLOAD_CS_END_REQ;
-    cmd |= (SDO_SG_SIZE - _requestCurrent->stay) << 2;
-    quint16 crc = 0;
+    cmd |= ((SDO_SG_SIZE - lastSegSize) << 2) & BLOCK_N_NUMBER_MASK;
+    quint16 crc = _requestCurrent->crcSupported ? _requestCurrent->crc : 0;
     return sendSdoRequest(cmd, crc);
 }
 
@@ -1044,10 +1344,12 @@ void SDO::setErrorToObject(SDOAbortCodes error)
         flags += NodeOd::FlagsRequest::Write;
     }
 
+    // completed before notification, a subscriber may request the same object again
+    _requestCurrent->state = STATE_FREE;
     _node->nodeOd()->updateObjectFromDevice(_requestCurrent->index, _requestCurrent->subIndex, QVariant(error), static_cast<NodeOd::FlagsRequest>(flags));
 
+    accountRequest(true);
     _status = SDO_STATE_FREE;
-    _requestCurrent->state = STATE_FREE;
     _timeoutTimer->stop();
     nextRequest();
 }
@@ -1057,16 +1359,21 @@ void SDO::setErrorToObject(SDOAbortCodes error)
  */
 void SDO::endRequest()
 {
-    if (_requestCurrent->state == STATE_UPLOAD)
+    // completed before notification, a subscriber may request the same object again
+    RequestState state = _requestCurrent->state;
+    _requestCurrent->state = STATE_FREE;
+
+    if (state == STATE_UPLOAD)
     {
         _node->nodeOd()->updateObjectFromDevice(
             _requestCurrent->index, _requestCurrent->subIndex, arrangeDataUpload(_requestCurrent->dataByte, _requestCurrent->dataType), NodeOd::FlagsRequest::Read);
     }
-    else if (_requestCurrent->state == STATE_DOWNLOAD)
+    else if (state == STATE_DOWNLOAD)
     {
         _node->nodeOd()->updateObjectFromDevice(_requestCurrent->index, _requestCurrent->subIndex, _requestCurrent->data, NodeOd::FlagsRequest::Write);
     }
 
+    accountRequest(false);
     _status = SDO_STATE_FREE;
     _timeoutTimer->stop();
     nextRequest();
@@ -1082,9 +1389,24 @@ void SDO::nextRequest()
         return;
     }
 
+    // previous request is finished
+    delete _requestCurrent;
+    _requestCurrent = nullptr;
+
     if (!_requestQueue.isEmpty())
     {
+        // do not start new transfers while the bus is overloaded
+        if (bus() != nullptr && bus()->isSdoRateLimited())
+        {
+            if (!_rateLimitTimer->isActive())
+            {
+                _rateLimitTimer->start(SDO_RATE_LIMIT_RETRY_MS);
+            }
+            return;
+        }
+
         _requestCurrent = _requestQueue.dequeue();
+        _requestElapsed.start();
         if (_requestCurrent->state == STATE_UPLOAD)
         {
             _status = SDO_STATE_NOT_FREE;
@@ -1096,10 +1418,6 @@ void SDO::nextRequest()
             downloadDispatcher();
         }
     }
-    else
-    {
-        _requestCurrent = nullptr;
-    }
 }
 
 /**
@@ -1107,6 +1425,14 @@ void SDO::nextRequest()
  */
 void SDO::timeout()
 {
+    // timer delayed by a busy thread, the answer may already be received by the bus I/O thread
+    const quint32 serverFrameCount = _serverFrameCount;
+    if (bus()->processPendingFrames() && (_serverFrameCount != serverFrameCount || _requestCurrent == nullptr))
+    {
+        return;
+    }
+
+    _subBlockDownloadTimer->stop();
     uint32_t error = CO_SDO_ABORT_CODE_TIMED_OUT;
     sendSdoRequest(CCS::SDO_CCS_CLIENT_ABORT, _requestCurrent->index, _requestCurrent->subIndex, error);
     setErrorToObject(static_cast<SDOAbortCodes>(error));
@@ -1126,22 +1452,12 @@ bool SDO::sendSdoRequest(quint8 cmd, quint16 index, quint8 subindex)
         return false;
     }
 
-    QByteArray sdoWriteReqPayload;
-    QDataStream request(&sdoWriteReqPayload, QIODevice::WriteOnly);
-    request.setByteOrder(QDataStream::LittleEndian);
-    request << cmd;
-    request << index;
-    request << subindex;
-
-    // the frame must be a size of 8
-    for (int i = sdoWriteReqPayload.size(); i < 8; i++)
-    {
-        request << static_cast<quint8>(0);
-    }
-
-    QCanBusFrame frame;
-    frame.setFrameId(_cobIdClientToServer + _nodeId);
-    frame.setPayload(sdoWriteReqPayload);
+    CanFrame frame;
+    frame.setFrameId(_cobIdClientToServer);
+    frame.setSize(8);
+    frame.data()[0] = cmd;
+    frame.setU16At(1, index);
+    frame.data()[3] = subindex;
 
     _timeoutTimer->start(_timeoutMs);
     return bus()->writeFrame(frame);
@@ -1159,20 +1475,10 @@ bool SDO::sendSdoRequest(quint8 cmd)
         return false;
     }
 
-    QByteArray sdoWriteReqPayload;
-    QDataStream request(&sdoWriteReqPayload, QIODevice::WriteOnly);
-    request.setByteOrder(QDataStream::LittleEndian);
-    request << cmd;
-
-    // the frame must be a size of 8
-    for (int i = sdoWriteReqPayload.size(); i < 8; i++)
-    {
-        request << static_cast<quint8>(0);
-    }
-
-    QCanBusFrame frame;
-    frame.setFrameId(_cobIdClientToServer + _nodeId);
-    frame.setPayload(sdoWriteReqPayload);
+    CanFrame frame;
+    frame.setFrameId(_cobIdClientToServer);
+    frame.setSize(8);
+    frame.data()[0] = cmd;
 
     _timeoutTimer->start(_timeoutMs);
     return bus()->writeFrame(frame);
@@ -1193,23 +1499,13 @@ bool SDO::sendSdoRequest(quint8 cmd, quint16 index, quint8 subindex, const QByte
         return false;
     }
 
-    QByteArray sdoWriteReqPayload;
-    QDataStream request(&sdoWriteReqPayload, QIODevice::WriteOnly);
-    request.setByteOrder(QDataStream::LittleEndian);
-    request << cmd;
-    request << index;
-    request << subindex;
-    request.writeRawData(data.data(), data.size());
-
-    // the frame must be a size of 8
-    for (int i = sdoWriteReqPayload.size(); i < 8; i++)
-    {
-        request << static_cast<quint8>(0);
-    }
-
-    QCanBusFrame frame;
-    frame.setFrameId(_cobIdClientToServer + _nodeId);
-    frame.setPayload(sdoWriteReqPayload);
+    CanFrame frame;
+    frame.setFrameId(_cobIdClientToServer);
+    frame.setSize(8);
+    frame.data()[0] = cmd;
+    frame.setU16At(1, index);
+    frame.data()[3] = subindex;
+    memcpy(frame.data() + 4, data.constData(), static_cast<size_t>(qMin(data.size(), 4)));
 
     _timeoutTimer->start(_timeoutMs);
     return bus()->writeFrame(frame);
@@ -1218,29 +1514,22 @@ bool SDO::sendSdoRequest(quint8 cmd, quint16 index, quint8 subindex, const QByte
 /**
  * @brief Management SDO download segment
  * @param cmd
- * @param data
+ * @param data segment data, 7 bytes at most
+ * @param size
  * @return bool value successful or not
  */
-bool SDO::sendSdoRequest(quint8 cmd, const QByteArray &data)
+bool SDO::sendSdoRequest(quint8 cmd, const char *data, int size)
 {
     if (!bus()->canWrite())
     {
         return false;
     }
 
-    QByteArray sdoWriteReqPayload;
-    QDataStream request(&sdoWriteReqPayload, QIODevice::WriteOnly);
-    request << cmd;
-    request.writeRawData(data.data(), data.size());
-
-    for (int i = sdoWriteReqPayload.size(); i < 8; i++)
-    {
-        request << static_cast<quint8>(0);
-    }
-
-    QCanBusFrame frame;
-    frame.setFrameId(_cobIdClientToServer + _nodeId);
-    frame.setPayload(sdoWriteReqPayload);
+    CanFrame frame;
+    frame.setFrameId(_cobIdClientToServer);
+    frame.setSize(8);
+    frame.data()[0] = cmd;
+    memcpy(frame.data() + 1, data, static_cast<size_t>(qBound(0, size, 7)));
     _timeoutTimer->start(_timeoutMs);
     return bus()->writeFrame(frame);
 }
@@ -1248,7 +1537,7 @@ bool SDO::sendSdoRequest(quint8 cmd, const QByteArray &data)
 /**
  * @brief Management SDO block download end
  * @param cmd
- * @param crc NOT USED = 0
+ * @param crc CRC of the whole data, 0 if not supported by the server
  * @return bool value successful or not
  */
 bool SDO::sendSdoRequest(quint8 cmd, quint16 &crc)
@@ -1258,21 +1547,11 @@ bool SDO::sendSdoRequest(quint8 cmd, quint16 &crc)
         return false;
     }
 
-    QByteArray sdoWriteReqPayload;
-    QDataStream request(&sdoWriteReqPayload, QIODevice::WriteOnly);
-    request.setByteOrder(QDataStream::LittleEndian);
-    request << cmd;
-    request << crc;
-
-    // the frame must be a size of 8
-    for (int i = sdoWriteReqPayload.size(); i < 8; i++)
-    {
-        request << static_cast<quint8>(0);
-    }
-
-    QCanBusFrame frame;
-    frame.setFrameId(_cobIdClientToServer + _nodeId);
-    frame.setPayload(sdoWriteReqPayload);
+    CanFrame frame;
+    frame.setFrameId(_cobIdClientToServer);
+    frame.setSize(8);
+    frame.data()[0] = cmd;
+    frame.setU16At(1, crc);
 
     _timeoutTimer->start(_timeoutMs);
     return bus()->writeFrame(frame);
@@ -1294,24 +1573,14 @@ bool SDO::sendSdoRequest(quint8 cmd, quint16 index, quint8 subindex, quint8 blks
         return false;
     }
 
-    QByteArray sdoWriteReqPayload;
-    QDataStream request(&sdoWriteReqPayload, QIODevice::WriteOnly);
-    request.setByteOrder(QDataStream::LittleEndian);
-    request << cmd;
-    request << index;
-    request << subindex;
-    request << blksize;
-    request << pst;
-
-    // the frame must be a size of 8
-    for (int i = sdoWriteReqPayload.size(); i < 8; i++)
-    {
-        request << static_cast<quint8>(0);
-    }
-
-    QCanBusFrame frame;
-    frame.setFrameId(_cobIdClientToServer + _nodeId);
-    frame.setPayload(sdoWriteReqPayload);
+    CanFrame frame;
+    frame.setFrameId(_cobIdClientToServer);
+    frame.setSize(8);
+    frame.data()[0] = cmd;
+    frame.setU16At(1, index);
+    frame.data()[3] = subindex;
+    frame.data()[4] = blksize;
+    frame.data()[5] = pst;
 
     _timeoutTimer->start(_timeoutMs);
     return bus()->writeFrame(frame);
@@ -1331,93 +1600,38 @@ bool SDO::sendSdoRequest(quint8 cmd, quint8 &ackseq, quint8 blksize)
         return false;
     }
 
-    QByteArray sdoWriteReqPayload;
-    QDataStream request(&sdoWriteReqPayload, QIODevice::WriteOnly);
-    request.setByteOrder(QDataStream::LittleEndian);
-    request << cmd;
-    request << ackseq;
-    request << blksize;
-
-    // the frame must be a size of 8
-    for (int i = sdoWriteReqPayload.size(); i < 8; i++)
-    {
-        request << static_cast<quint8>(0);
-    }
-
-    QCanBusFrame frame;
-    frame.setFrameId(_cobIdClientToServer + _nodeId);
-    frame.setPayload(sdoWriteReqPayload);
-
-    return bus()->writeFrame(frame);
-}
-
-/**
- * @brief Management SDO block download sub-block
- * @param moreSegments indicates whether there are still more segments to be downloaded.
- * @param seqno number of sequence
- * @param segData sequence data
- * @bool return value successful or not
- */
-bool SDO::sendSdoRequest(bool moreSegments, quint8 seqno, const QByteArray &segData)
-{
-    if (!bus()->canWrite())
-    {
-        return false;
-    }
-
-    QByteArray sdoWriteReqPayload;
-    QDataStream request(&sdoWriteReqPayload, QIODevice::WriteOnly);
-    QCanBusFrame frame;
-
-    if (!moreSegments)
-    {
-        _timeoutTimer->start(_timeoutMs);
-        seqno |= 0x80;
-        request << static_cast<quint8>(seqno);
-    }
-    else
-    {
-        request << static_cast<quint8>(seqno);
-    }
-    request.writeRawData(segData.data(), segData.size());
-
-    // the frame must be a size of 8
-    for (int i = sdoWriteReqPayload.size(); i < 8; i++)
-    {
-        sdoWriteReqPayload.append(static_cast<char>(0));
-    }
-    frame.setFrameId(_cobIdClientToServer + _nodeId);
-    frame.setPayload(sdoWriteReqPayload);
+    CanFrame frame;
+    frame.setFrameId(_cobIdClientToServer);
+    frame.setSize(8);
+    frame.data()[0] = cmd;
+    frame.data()[1] = ackseq;
+    frame.data()[2] = blksize;
 
     return bus()->writeFrame(frame);
 }
 
 /**
- * @brief SDO abort transfer
+ * @brief SDO abort transfer, SDO download initiate with data size
  * @param cmd
  * @param index
  * @param subindex
- * @param error SDO/CIA on uint32
+ * @param value SDO/CIA abort code or data size on uint32
  * @bool return value successful or not
  */
-bool SDO::sendSdoRequest(quint8 cmd, quint16 index, quint8 subindex, quint32 error)
+bool SDO::sendSdoRequest(quint8 cmd, quint16 index, quint8 subindex, quint32 value)
 {
     if (!bus()->canWrite())
     {
         return false;
     }
 
-    QByteArray sdoWriteReqPayload;
-    QDataStream request(&sdoWriteReqPayload, QIODevice::WriteOnly);
-    request.setByteOrder(QDataStream::LittleEndian);
-    request << cmd;
-    request << index;
-    request << subindex;
-    request << error;
-
-    QCanBusFrame frame;
-    frame.setFrameId(_cobIdClientToServer + _nodeId);
-    frame.setPayload(sdoWriteReqPayload);
+    CanFrame frame;
+    frame.setFrameId(_cobIdClientToServer);
+    frame.setSize(8);
+    frame.data()[0] = cmd;
+    frame.setU16At(1, index);
+    frame.data()[3] = subindex;
+    frame.setU32At(4, value);
 
     _timeoutTimer->start(_timeoutMs);
     return bus()->writeFrame(frame);
@@ -1621,11 +1835,32 @@ void SDO::setTimeoutMs(int timeoutMs)
     _timeoutMs = timeoutMs;
 }
 
+int SDO::blockThreshold() const
+{
+    return _blockThreshold;
+}
+
+/**
+ * @brief Sets the size in bytes above which block transfers are used for domains and strings
+ */
+void SDO::setBlockThreshold(int blockThreshold)
+{
+    _blockThreshold = blockThreshold;
+}
+
+bool SDO::isBlockTransferSupported() const
+{
+    return _blockTransferSupported;
+}
+
 int SDO::blockDownloadIntervalMs() const
 {
     return _blockDownloadIntervalMs;
 }
 
+/**
+ * @brief Sets the delay before retrying block segments held back by a full emission queue or the bus SDO load limit
+ */
 void SDO::setBlockDownloadIntervalMs(int blockDownloadIntervalMs)
 {
     _blockDownloadIntervalMs = blockDownloadIntervalMs;
@@ -23,6 +23,7 @@
 
 #include "service.h"
 
+#include <QElapsedTimer>
 #include <QQueue>
 #include <QTimer>
 
@@ -32,9 +33,15 @@ class CANOPEN_EXPORT SDO : public Service
 {
     Q_OBJECT
 public:
-    SDO(Node *node);
+    SDO(Node *node, quint8 channel = 0);
     ~SDO() override;
 
+    // Channel, 0 is the default SDO server, n > 0 uses server parameters 0x1200 + n
+    quint8 channel() const;
+    bool isEnabled() const;
+    void setCobIds(quint32 cobIdClientToServer, quint32 cobIdServerToClient);
+    void disable();
+
     // Settings
     int maxErrorAttempt() const;
     void setMaxErrorAttempt(int maxErrorAttempt);
@@ -45,10 +52,16 @@ public:
     int timeoutMs() const;
     void setTimeoutMs(int timeoutMs);
 
+    int blockThreshold() const;
+    void setBlockThreshold(int blockThreshold);
+    bool isBlockTransferSupported() const;
+
     quint32 cobIdClientToServer() const;
     quint32 cobIdServerToClient() const;
 
     bool hasRequestPending() const;
+    bool hasRequest(quint16 index, quint8 subindex) const;
+    int pendingRequestCount() const;
 
     bool uploadData(quint16 index, quint8 subindex, QMetaType::Type dataType);
     bool downloadData(quint16 index, quint8 subindex, const QVariant &data);
@@ -60,6 +73,17 @@ public:
     };
     Status status() const;
 
+    // Throughput counters
+    struct Statistics
+    {
+        quint64 bytes;
+        quint32 requests;
+        quint32 errors;
+        qint64 busyTimeUs;
+    };
+    const Statistics &statistics() const;
+    void resetStatistics();
+
     // ================= sdo abort codes ====================
     enum SDOAbortCodes : quint32
     {
@@ -117,9 +141,10 @@ private:
     quint32 _cobIdClientToServer;
     quint32 _cobIdServerToClient;
     quint8 _nodeId;
+    quint8 _channel;
 
-    void processingFrameFromClient(const QCanBusFrame &frame);
-    void processingFrameFromServer(const QCanBusFrame &frame);
+    void processingFrameFromClient(const CanFrame &frame);
+    void processingFrameFromServer(const CanFrame &frame);
 
     enum RequestState
     {
@@ -156,6 +181,11 @@ private:
         quint8 ackseq;             // sequence number of segment
         bool error;
         quint8 attemptCount;
+        bool block;
+        quint32 ackOffset;  // bytes acknowledged by the server, start of the current sub-block (download)
+        quint16 crc;        // CRC of the acknowledged bytes (download)
+        bool crcSupported;  // server checks the CRC (download)
+        quint8 burst;       // segments posted at once, reduced when the server loses segments (download)
     };
 
     RequestSdo *_requestCurrent;
@@ -164,6 +194,7 @@ private:
 
     bool uploadDispatcher();
     bool downloadDispatcher();
+    bool isBlockCandidate(NodeSubIndex *subIndex) const;
 
     void sendErrorSdoToDevice(SDOAbortCodes error);
     void setErrorToObject(SDOAbortCodes error);
@@ -171,31 +202,37 @@ private:
     void nextRequest();
 
     QTimer *_timeoutTimer;
+    quint32 _serverFrameCount;
     void timeout();
 
     QTimer *_subBlockDownloadTimer;
-
-    quint16 indexFromFrame(const QCanBusFrame &frame);
-    quint8 subIndexFromFrame(const QCanBusFrame &frame);
-    bool sdoUploadInitiate(const QCanBusFrame &frame);
-    bool sdoUploadSegment(const QCanBusFrame &frame);
-    bool sdoDownloadInitiate(const QCanBusFrame &frame);
-    bool sdoDownloadSegment(const QCanBusFrame &frame);
-    bool sdoBlockDownload(const QCanBusFrame &frame);
+    QTimer *_rateLimitTimer;
+
+    Statistics _statistics;
+    QElapsedTimer _requestElapsed;
+    void accountRequest(bool error);
+
+    quint16 indexFromFrame(const CanFrame &frame);
+    quint8 subIndexFromFrame(const CanFrame &frame);
+    bool sdoUploadInitiate(const CanFrame &frame);
+    bool sdoUploadSegment(const CanFrame &frame);
+    bool sdoDownloadInitiate(const CanFrame &frame);
+    bool sdoDownloadSegment(const CanFrame &frame);
+    bool sdoBlockDownload(const CanFrame &frame);
     void sdoBlockDownloadSubBlock();
+    void sdoBlockDownloadYield();
     bool sdoBlockDownloadEnd();
-    bool sdoBlockUpload(const QCanBusFrame &frame);
-    bool sdoBlockUploadSubBlock(const QCanBusFrame &frame);
+    bool sdoBlockUpload(const CanFrame &frame);
+    bool sdoBlockUploadSubBlock(const CanFrame &frame);
 
     bool sendSdoRequest(quint8 cmd, quint16 index, quint8 subindex);                              // SDO upload initiate
     bool sendSdoRequest(quint8 cmd);                                                              // SDO upload segment, SDO block upload initiate, SDO block upload ends
     bool sendSdoRequest(quint8 cmd, quint16 index, quint8 subindex, const QByteArray &data);      // SDO download initiate, SDO block download initiate
-    bool sendSdoRequest(quint8 cmd, const QByteArray &data);                                      // SDO download segment
+    bool sendSdoRequest(quint8 cmd, const char *data, int size);                                  // SDO download segment
     bool sendSdoRequest(quint8 cmd, quint16 index, quint8 subindex, quint8 blksize, quint8 pst);  // SDO block upload initiate
     bool sendSdoRequest(quint8 cmd, quint8 &ackseq, quint8 blksize);                              // SDO block upload sub-block
-    bool sendSdoRequest(bool moreSegments, quint8 seqno, const QByteArray &segData);              // SDO block download sub-block
     bool sendSdoRequest(quint8 cmd, quint16 &crc);                                                // SDO block download end
-    bool sendSdoRequest(quint8 cmd, quint16 index, quint8 subindex, quint32 error);               // SDO abort transfer
+    bool sendSdoRequest(quint8 cmd, quint16 index, quint8 subindex, quint32 value);               // SDO abort transfer, SDO download initiate with size
     quint8 calculateBlockSize(quint32 size);
 
     QVariant arrangeDataUpload(QByteArray, QMetaType::Type type);
@@ -205,11 +242,13 @@ private:
     int _maxErrorAttempt;
     int _blockDownloadIntervalMs;
     int _timeoutMs;
+    int _blockThreshold;
+    bool _blockTransferSupported;
 
     // Service interface
     QString type() const override;
     void reset() override;
-    void parseFrame(const QCanBusFrame &frame) override;
+    void parseFrame(const CanFrame &frame) override;
 };
 
 #endif  // SDO_H
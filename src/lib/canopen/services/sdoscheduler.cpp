@@ -0,0 +1,257 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "sdoscheduler.h"
+
+#include "node.h"
+
+#define SDO_SERVER_PARAM_INDEX 0x1200
+#define SDO_SERVER_PARAM_COB_ID_CLIENT_TO_SERVER 0x01
+#define SDO_SERVER_PARAM_COB_ID_SERVER_TO_CLIENT 0x02
+#define SDO_COB_ID_INVALID 0x80000000U
+#define SDO_COB_ID_EXTENDED 0x20000000U
+
+SdoScheduler::SdoScheduler(Node *node)
+    : _node(node)
+{
+    setNodeInterrest(node);
+}
+
+SdoScheduler::~SdoScheduler()
+{
+}
+
+/**
+ * @brief Adds a channel, SDO objects stay owned by the node
+ */
+void SdoScheduler::addChannel(SDO *sdo)
+{
+    _channels.append(sdo);
+    if (sdo->channel() != 0)
+    {
+        quint16 index = SDO_SERVER_PARAM_INDEX + sdo->channel();
+        registerSubIndex(index, SDO_SERVER_PARAM_COB_ID_SERVER_TO_CLIENT);
+    }
+}
+
+const QList<SDO *> &SdoScheduler::channels() const
+{
+    return _channels;
+}
+
+int SdoScheduler::enabledChannelCount() const
+{
+    int count = 0;
+    for (SDO *sdo : _channels)
+    {
+        if (sdo->isEnabled())
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Reads COB-IDs of additional SDO servers, each channel is enabled when they are received
+ */
+void SdoScheduler::discoverChannels()
+{
+    for (SDO *sdo : qAsConst(_channels))
+    {
+        if (sdo->channel() == 0 || sdo->isEnabled())
+        {
+            continue;
+        }
+        quint16 index = SDO_SERVER_PARAM_INDEX + sdo->channel();
+        readObject(index, SDO_SERVER_PARAM_COB_ID_CLIENT_TO_SERVER, QMetaType::UInt);
+        readObject(index, SDO_SERVER_PARAM_COB_ID_SERVER_TO_CLIENT, QMetaType::UInt);
+    }
+}
+
+/**
+ * @brief Disables additional channels, the device may have changed its configuration
+ */
+void SdoScheduler::reset()
+{
+    for (SDO *sdo : qAsConst(_channels))
+    {
+        sdo->disable();
+    }
+}
+
+bool SdoScheduler::uploadData(quint16 index, quint8 subindex, QMetaType::Type dataType)
+{
+    SDO *sdo = selectChannel(index, subindex);
+    if (sdo == nullptr)
+    {
+        return false;
+    }
+    return sdo->uploadData(index, subindex, dataType);
+}
+
+bool SdoScheduler::downloadData(quint16 index, quint8 subindex, const QVariant &data)
+{
+    SDO *sdo = selectChannel(index, subindex);
+    if (sdo == nullptr)
+    {
+        return false;
+    }
+    return sdo->downloadData(index, subindex, data);
+}
+
+bool SdoScheduler::hasRequestPending() const
+{
+    for (SDO *sdo : _channels)
+    {
+        if (sdo->pendingRequestCount() > 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Checks if a request on the given object is queued or in progress on any channel
+ */
+bool SdoScheduler::hasRequest(quint16 index, quint8 subindex) const
+{
+    for (SDO *sdo : _channels)
+    {
+        if (sdo->isEnabled() && sdo->hasRequest(index, subindex))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+SDO::Statistics SdoScheduler::statistics() const
+{
+    SDO::Statistics statistics = {0, 0, 0, 0};
+    for (SDO *sdo : _channels)
+    {
+        const SDO::Statistics &channelStatistics = sdo->statistics();
+        statistics.bytes += channelStatistics.bytes;
+        statistics.requests += channelStatistics.requests;
+        statistics.errors += channelStatistics.errors;
+        statistics.busyTimeUs = qMax(statistics.busyTimeUs, channelStatistics.busyTimeUs);
+    }
+    return statistics;
+}
+
+/**
+ * @brief Node SDO throughput in bytes per second, channels busy time overlaps
+ */
+double SdoScheduler::throughput() const
+{
+    SDO::Statistics stats = statistics();
+    if (stats.busyTimeUs == 0)
+    {
+        return 0.0;
+    }
+    return static_cast<double>(stats.bytes) * 1000000.0 / static_cast<double>(stats.busyTimeUs);
+}
+
+void SdoScheduler::resetStatistics()
+{
+    for (SDO *sdo : qAsConst(_channels))
+    {
+        sdo->resetStatistics();
+    }
+}
+
+SDO *SdoScheduler::selectChannel(quint16 index, quint8 subindex) const
+{
+    SDO *bestSdo = nullptr;
+    for (SDO *sdo : _channels)
+    {
+        if (!sdo->isEnabled())
+        {
+            continue;
+        }
+        if (sdo->hasRequest(index, subindex))
+        {
+            return sdo;
+        }
+        if (bestSdo == nullptr || sdo->pendingRequestCount() < bestSdo->pendingRequestCount())
+        {
+            bestSdo = sdo;
+        }
+    }
+    return bestSdo;
+}
+
+SDO *SdoScheduler::channel(quint8 number) const
+{
+    for (SDO *sdo : _channels)
+    {
+        if (sdo->channel() == number)
+        {
+            return sdo;
+        }
+    }
+    return nullptr;
+}
+
+void SdoScheduler::odNotify(const NodeObjectId &objId, NodeOd::FlagsRequest flags)
+{
+    // server -> client COB-ID is read last, client -> server one is already known
+    if ((flags & NodeOd::Read) == 0 || (flags & NodeOd::Error) != 0)
+    {
+        return;
+    }
+    if (objId.subIndex() != SDO_SERVER_PARAM_COB_ID_SERVER_TO_CLIENT)
+    {
+        return;
+    }
+
+    SDO *sdo = channel(static_cast<quint8>(objId.index() - SDO_SERVER_PARAM_INDEX));
+    if (sdo == nullptr || sdo->isEnabled())
+    {
+        return;
+    }
+
+    NodeOd *nodeOd = _node->nodeOd();
+    if (nodeOd->errorObject(objId.index(), SDO_SERVER_PARAM_COB_ID_CLIENT_TO_SERVER) != 0)
+    {
+        return;
+    }
+    quint32 cobIdClientToServer = nodeOd->value(objId.index(), SDO_SERVER_PARAM_COB_ID_CLIENT_TO_SERVER).toUInt();
+    quint32 cobIdServerToClient = nodeOd->value(objId.index(), SDO_SERVER_PARAM_COB_ID_SERVER_TO_CLIENT).toUInt();
+    if (((cobIdClientToServer | cobIdServerToClient) & SDO_COB_ID_INVALID) != 0)
+    {
+        return;
+    }
+
+    quint32 mask = ((cobIdClientToServer & SDO_COB_ID_EXTENDED) != 0) ? 0x1FFFFFFFU : 0x7FFU;
+    cobIdClientToServer &= mask;
+    cobIdServerToClient &= mask;
+
+    // never share COB-IDs with another channel
+    for (SDO *otherSdo : qAsConst(_channels))
+    {
+        if (otherSdo->isEnabled() && (otherSdo->cobIdClientToServer() == cobIdClientToServer || otherSdo->cobIdServerToClient() == cobIdServerToClient))
+        {
+            return;
+        }
+    }
+
+    sdo->setCobIds(cobIdClientToServer, cobIdServerToClient);
+}
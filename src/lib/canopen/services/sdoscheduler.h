@@ -0,0 +1,75 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef SDOSCHEDULER_H
+#define SDOSCHEDULER_H
+
+#include "canopen_global.h"
+
+#include <QObject>
+
+#include "nodeodsubscriber.h"
+#include "sdo.h"
+
+class Node;
+
+/**
+ * @brief Dispatches SDO requests of a node over all its SDO channels
+ *
+ * Channel 0 is the default SDO server. Additional servers (0x1201 to 0x127F)
+ * present in the OD are enabled once their COB-IDs are read from the device.
+ * Requests on an object already pending on a channel stay on that channel to
+ * keep their order, others go to the least loaded channel. Each node has its
+ * own scheduler, so transfers of all nodes of a bus run in parallel.
+ */
+class CANOPEN_EXPORT SdoScheduler : public QObject, public NodeOdSubscriber
+{
+    Q_OBJECT
+public:
+    SdoScheduler(Node *node);
+    ~SdoScheduler() override;
+
+    void addChannel(SDO *sdo);
+    const QList<SDO *> &channels() const;
+    int enabledChannelCount() const;
+
+    void discoverChannels();
+    void reset();
+
+    bool uploadData(quint16 index, quint8 subindex, QMetaType::Type dataType);
+    bool downloadData(quint16 index, quint8 subindex, const QVariant &data);
+    bool hasRequestPending() const;
+    bool hasRequest(quint16 index, quint8 subindex) const;
+
+    // throughput counters of all channels
+    SDO::Statistics statistics() const;
+    double throughput() const;
+    void resetStatistics();
+
+protected:
+    Node *_node;
+    QList<SDO *> _channels;
+
+    SDO *selectChannel(quint16 index, quint8 subindex) const;
+    SDO *channel(quint8 number) const;
+
+    // NodeOdSubscriber interface
+    void odNotify(const NodeObjectId &objId, NodeOd::FlagsRequest flags) override;
+};
+
+#endif  // SDOSCHEDULER_H
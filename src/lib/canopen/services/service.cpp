@@ -59,22 +59,6 @@ CanOpenBus *Service::bus() const
     return _bus;
 }
 
-CanBusDriver *Service::canDevice() const
-{
-    if (_bus != nullptr)
-    {
-        return _bus->canBusDriver();
-    }
-    if (_node != nullptr)
-    {
-        if (_node->bus() != nullptr)
-        {
-            return _node->bus()->canBusDriver();
-        }
-    }
-    return nullptr;
-}
-
 Node *Service::node() const
 {
     return _node;
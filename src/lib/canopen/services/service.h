@@ -25,7 +25,7 @@
 
 #include "busdriver/canbusdriver.h"
 
-#include "busdriver/qcanbusframe.h"
+#include "busdriver/canframe.h"
 #include <QString>
 
 class CanOpenBus;
@@ -45,12 +45,11 @@ public:
 
     virtual QString type() const = 0;
 
-    virtual void parseFrame(const QCanBusFrame &frame) = 0;
+    virtual void parseFrame(const CanFrame &frame) = 0;
 
     const QList<quint32> &cobIds() const;
 
     CanOpenBus *bus() const;
-    CanBusDriver *canDevice() const;
     Node *node() const;
 
 protected:
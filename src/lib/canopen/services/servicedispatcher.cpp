@@ -22,9 +22,12 @@
 #include "node.h"
 #include <QDebug>
 
+#include <cstring>
+
 ServiceDispatcher::ServiceDispatcher(CanOpenBus *bus)
     : Service(bus)
 {
+    std::memset(_dispatchTable, 0, sizeof(_dispatchTable));
 }
 
 ServiceDispatcher::~ServiceDispatcher()
@@ -41,6 +44,7 @@ void ServiceDispatcher::addService(Service *service)
     for (quint32 cobId : service->cobIds())
     {
         _servicesMap.insert(cobId, service);
+        updateDispatchEntry(cobId);
     }
 }
 
@@ -49,16 +53,78 @@ void ServiceDispatcher::removeService(Service *service)
     for (quint32 cobId : service->cobIds())
     {
         _servicesMap.remove(cobId, service);
+        updateDispatchEntry(cobId);
+    }
+}
+
+void ServiceDispatcher::parseFrame(const CanFrame &frame)
+{
+    const quint32 frameId = frame.frameId();
+    if (Q_LIKELY(frameId < StandardCobIdCount))
+    {
+        // local copy, a service may add or remove services while parsing
+        const DispatchEntry entry = _dispatchTable[frameId];
+        if (Q_LIKELY(entry.count != OverflowMarker))
+        {
+            for (quint8 i = 0; i < entry.count; i++)
+            {
+                entry.services[i]->parseFrame(frame);
+            }
+            return;
+        }
+    }
+
+    // extended frame ids fast path, no services registered is the common case
+    if (_overflowTable.isEmpty())
+    {
+        return;
+    }
+    QHash<quint32, QVector<Service *>>::const_iterator it = _overflowTable.constFind(frameId);
+    if (it != _overflowTable.constEnd())
+    {
+        const QVector<Service *> services = it.value();
+        dispatch(services, frame);
+    }
+}
+
+/**
+ * @brief Rebuilds the dispatch entry of one COB-ID from the services map
+ * @param cobId COB-ID to update
+ */
+void ServiceDispatcher::updateDispatchEntry(quint32 cobId)
+{
+    const QList<Service *> services = _servicesMap.values(cobId);
+
+    if (cobId < StandardCobIdCount && services.count() <= InlineServiceCount)
+    {
+        DispatchEntry &entry = _dispatchTable[cobId];
+        entry.count = static_cast<quint8>(services.count());
+        for (int i = 0; i < services.count(); i++)
+        {
+            entry.services[i] = services.at(i);
+        }
+        _overflowTable.remove(cobId);
+        return;
+    }
+
+    if (cobId < StandardCobIdCount)
+    {
+        _dispatchTable[cobId].count = OverflowMarker;
+    }
+    if (services.isEmpty())
+    {
+        _overflowTable.remove(cobId);
+    }
+    else
+    {
+        _overflowTable.insert(cobId, services.toVector());
     }
 }
 
-void ServiceDispatcher::parseFrame(const QCanBusFrame &frame)
+void ServiceDispatcher::dispatch(const QVector<Service *> &services, const CanFrame &frame)
 {
-    QList<Service *> interrestedServices = _servicesMap.values(frame.frameId());
-    QList<Service *>::const_iterator service = interrestedServices.cbegin();
-    while (service != interrestedServices.cend())
+    for (Service *service : services)
     {
-        (*service)->parseFrame(frame);
-        ++service;
+        service->parseFrame(frame);
     }
 }
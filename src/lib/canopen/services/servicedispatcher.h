@@ -23,7 +23,9 @@
 
 #include "service.h"
 
+#include <QHash>
 #include <QMultiMap>
+#include <QVector>
 
 class CANOPEN_EXPORT ServiceDispatcher : public Service
 {
@@ -37,10 +39,31 @@ public:
     void addService(Service *service);
     void removeService(Service *service);
 
-    void parseFrame(const QCanBusFrame &frame) override;
+    void parseFrame(const CanFrame &frame) override;
 
 protected:
     QMultiMap<quint32, Service *> _servicesMap;
+
+    enum
+    {
+        StandardCobIdCount = 0x800,
+        InlineServiceCount = 4,
+        OverflowMarker = 0xFF
+    };
+
+    // flat dispatch table for 11 bits COB-IDs, rebuilt on add/remove only
+    struct DispatchEntry
+    {
+        quint8 count;
+        Service *services[InlineServiceCount];
+    };
+    DispatchEntry _dispatchTable[StandardCobIdCount];
+
+    // extended COB-IDs and standard COB-IDs with more than InlineServiceCount services
+    QHash<quint32, QVector<Service *>> _overflowTable;
+
+    void updateDispatchEntry(quint32 cobId);
+    void dispatch(const QVector<Service *> &services, const CanFrame &frame);
 };
 
 #endif  // SERVICEDISPATCHER_H
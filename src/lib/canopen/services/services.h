@@ -23,11 +23,14 @@
 
 #include "emergency.h"
 #include "errorcontrol.h"
+#include "liveobjects.h"
 #include "nmt.h"
 #include "nodediscover.h"
 #include "pdo.h"
 #include "rpdo.h"
+#include "rpdoprocessimage.h"
 #include "sdo.h"
+#include "sdoscheduler.h"
 #include "sync.h"
 #include "timestamp.h"
 #include "tpdo.h"
@@ -20,6 +20,8 @@
 
 #include "canopenbus.h"
 
+#include <QTimer>
+
 const quint8 ONE_SHOT_TIMER = 20;
 
 Sync::Sync(CanOpenBus *bus)
@@ -28,20 +30,19 @@ Sync::Sync(CanOpenBus *bus)
     _syncCobId = 0x80;
     _cobIds.append(_syncCobId);
     _status = STOPPED;
-
-    _syncTimer = new QTimer();
-    _syncTimer->setTimerType(Qt::PreciseTimer);
-    connect(_syncTimer, &QTimer::timeout, this, &Sync::sendSync);
-
-    _signalBeforeSync = new QTimer();
-    _signalBeforeSync->setTimerType(Qt::PreciseTimer);
-    connect(_signalBeforeSync, &QTimer::timeout, this, &Sync::signalBeforeSync);
+    _counterOverflow = 0;
+    _counter = 0;
+    _periodMs = 0;
+
+    _producer = new SyncProducer(bus->worker());
+    connect(_producer, &SyncProducer::preSync, this, &Sync::preparePreSync, Qt::QueuedConnection);
+    connect(_producer, &SyncProducer::syncSent, this, &Sync::producerSyncSent, Qt::QueuedConnection);
+    connect(bus, &CanOpenBus::connectedChanged, this, &Sync::updateBusConnection);
 }
 
 Sync::~Sync()
 {
-    delete _syncTimer;
-    delete _signalBeforeSync;
+    delete _producer;
 }
 
 QString Sync::type() const
@@ -49,17 +50,28 @@ QString Sync::type() const
     return QLatin1String("Sync");
 }
 
+/**
+ * @brief Starts cyclic SYNC emission by the real time producer thread
+ *
+ * signalBeforeSync() is emitted in the pre-sync phase of each cycle to let
+ * application values be updated, then RPDOs of all nodes are sent in one batch
+ * by the process image of the bus before the SYNC.
+ *
+ * If the bus is not connected or cannot write, the emission is deferred and
+ * starts when the bus connects.
+ */
 void Sync::startSync(int ms)
 {
-    _syncTimer->start(ms);
-    _signalBeforeSync->start((ms * 3) / 4);
+    _producer->stopProducer();
+    _periodMs = ms;
     _status = STARTED;
+    updateBusConnection(bus()->isConnected());
 }
 
 void Sync::stopSync()
 {
-    _syncTimer->stop();
-    _signalBeforeSync->stop();
+    _periodMs = 0;
+    _producer->stopProducer();
     _status = STOPPED;
 }
 
@@ -68,6 +80,60 @@ Sync::Status Sync::status()
     return _status;
 }
 
+quint8 Sync::counterOverflow() const
+{
+    return _counterOverflow;
+}
+
+/**
+ * @brief Sets the synchronous counter overflow value, as object 0x1019 of a SYNC producer
+ * @param counterOverflow 0 to emit SYNC without counter, 2 to 240 otherwise
+ * @return false if the value is reserved
+ *
+ * Applied at next startSync().
+ */
+bool Sync::setCounterOverflow(quint8 counterOverflow)
+{
+    if (counterOverflow == 1 || counterOverflow > 240)
+    {
+        return false;
+    }
+    _counterOverflow = counterOverflow;
+    _counter = 0;
+    return true;
+}
+
+quint8 Sync::counter() const
+{
+    return _counter;
+}
+
+/**
+ * @brief Sets the duration of the RPDO preparation phase before each SYNC, -1 for a quarter of the period
+ */
+void Sync::setPreSyncLeadUs(int preSyncLeadUs)
+{
+    _producer->setPreSyncLeadUs(preSyncLeadUs);
+}
+
+/**
+ * @brief Sets the SCHED_FIFO priority of the SYNC producer thread, 0 for the default scheduling policy
+ */
+void Sync::setRealTimePriority(int priority)
+{
+    _producer->setRealTimePriority(priority);
+}
+
+SyncProducer::Statistics Sync::statistics() const
+{
+    return _producer->statistics();
+}
+
+void Sync::resetStatistics()
+{
+    _producer->resetStatistics();
+}
+
 void Sync::sendSync()
 {
     if (!bus()->canWrite())
@@ -75,8 +141,14 @@ void Sync::sendSync()
         return;
     }
 
-    QCanBusFrame frameSync;
+    CanFrame frameSync;
     frameSync.setFrameId(_syncCobId);
+    if (_counterOverflow != 0)
+    {
+        _counter = (_counter >= _counterOverflow) ? 1 : _counter + 1;
+        frameSync.setSize(1);
+        frameSync.data()[0] = _counter;
+    }
     bus()->writeFrame(frameSync);
     emit syncEmitted();
 }
@@ -95,13 +167,70 @@ void Sync::sendSyncOne()
     }
     _status = STARTED;
     emit signalBeforeSync();
+    bus()->rpdoProcessImage()->sendOutputs();
     QTimer::singleShot(ONE_SHOT_TIMER, this, &Sync::sendSyncOneTimeout);
 }
 
-void Sync::parseFrame(const QCanBusFrame &frame)
+void Sync::preparePreSync(quint32 cycle)
+{
+    if (_status != STARTED)
+    {
+        return;
+    }
+    emit signalBeforeSync();
+    bus()->rpdoProcessImage()->sendOutputs();
+    _producer->acknowledgePreSync(cycle, bus()->worker()->txPostedCount());
+}
+
+void Sync::producerSyncSent(quint8 counter)
+{
+    if (_status != STARTED)
+    {
+        return;
+    }
+
+    CanFrame frameSync;
+    frameSync.setFrameId(_syncCobId);
+    if (_counterOverflow != 0)
+    {
+        frameSync.setSize(1);
+        frameSync.data()[0] = counter;
+    }
+    bus()->journalSentFrame(frameSync);
+
+    _counter = counter;
+    emit syncEmitted();
+}
+
+void Sync::updateBusConnection(bool connected)
+{
+    if (_periodMs <= 0)
+    {
+        return;
+    }
+
+    if (!connected || !bus()->canWrite())
+    {
+        _producer->stopProducer();
+        return;
+    }
+
+    if (!_producer->isRunning())
+    {
+        _producer->setCobId(_syncCobId);
+        _producer->setCounterOverflow(_counterOverflow);
+        _producer->startProducer(_periodMs * 1000);
+    }
+}
+
+void Sync::parseFrame(const CanFrame &frame)
 {
-    if (frame.frameId() == _syncCobId && frame.payload().isEmpty())
+    if (frame.frameId() == _syncCobId && frame.size() <= 1)
     {
+        if (frame.size() == 1)
+        {
+            _counter = frame.at(0);
+        }
         emit syncEmitted();
     }
 }
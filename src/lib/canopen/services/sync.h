@@ -22,8 +22,7 @@
 #include "canopen_global.h"
 
 #include "service.h"
-
-#include <QTimer>
+#include "syncproducer.h"
 
 class CANOPEN_EXPORT Sync : public Service
 {
@@ -35,6 +34,15 @@ public:
     void startSync(int ms);
     void stopSync();
 
+    quint8 counterOverflow() const;
+    bool setCounterOverflow(quint8 counterOverflow);
+    quint8 counter() const;
+    void setPreSyncLeadUs(int preSyncLeadUs);
+    void setRealTimePriority(int priority);
+
+    SyncProducer::Statistics statistics() const;
+    void resetStatistics();
+
     enum Status
     {
         STARTED,
@@ -44,7 +52,7 @@ public:
     Status status();
     QString type() const override;
 
-    void parseFrame(const QCanBusFrame &frame) override;
+    void parseFrame(const CanFrame &frame) override;
 
 public slots:
     void sendSyncOne();
@@ -52,6 +60,9 @@ public slots:
 private slots:
     void sendSync();
     void sendSyncOneTimeout();
+    void preparePreSync(quint32 cycle);
+    void producerSyncSent(quint8 counter);
+    void updateBusConnection(bool connected);
 
 signals:
     void syncEmitted();
@@ -60,9 +71,11 @@ signals:
 
 private:
     Status _status;
-    QTimer *_syncTimer;
-    QTimer *_signalBeforeSync;
+    int _periodMs;  // cyclic period requested by startSync(), 0 when stopped
+    SyncProducer *_producer;
     uint32_t _syncCobId;
+    quint8 _counterOverflow;  // 0x1019, 0 when SYNC has no counter
+    quint8 _counter;          // last counter emitted or received
 };
 
 #endif  // SYNC_H
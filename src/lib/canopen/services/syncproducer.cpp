@@ -0,0 +1,341 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "syncproducer.h"
+
+#include "canopenbusworker.h"
+
+#include <QtAlgorithms>
+
+#include <algorithm>
+
+#ifdef Q_OS_LINUX
+#    include <cerrno>
+#    include <pthread.h>
+#    include <sched.h>
+#    include <time.h>
+#else
+#    include <chrono>
+#    include <thread>
+#endif
+
+// longest sleep without checking for a stop request
+const qint64 SLEEP_SLICE_NS = 50000000;
+
+static qint64 monotonicNs()
+{
+#ifdef Q_OS_LINUX
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<qint64>(now.tv_sec) * 1000000000 + now.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+SyncProducer::SyncProducer(CanOpenBusWorker *worker, QObject *parent)
+    : QThread(parent)
+{
+    _worker = worker;
+
+    _cobId = 0x80;
+    _counterOverflow = 0;
+    _preSyncLeadUs = -1;
+    _realTimePriority = 0;
+    _periodUs = 0;
+
+    _preSyncAck.storeRelease(0);
+    _preSyncTxMark.storeRelease(0);
+    _resetStatistics.storeRelease(0);
+    clearStatistics(_statistics);
+    clearStatistics(_publishedStatistics);
+
+    setObjectName("SyncProducer");
+}
+
+SyncProducer::~SyncProducer()
+{
+    stopProducer();
+}
+
+void SyncProducer::setCobId(quint32 cobId)
+{
+    _cobId = cobId;
+}
+
+/**
+ * @brief Sets the synchronous counter overflow value (0x1019), 0 to emit SYNC without counter
+ */
+void SyncProducer::setCounterOverflow(quint8 counterOverflow)
+{
+    _counterOverflow = counterOverflow;
+}
+
+/**
+ * @brief Sets the duration of the pre-sync phase, -1 for a quarter of the period
+ */
+void SyncProducer::setPreSyncLeadUs(int preSyncLeadUs)
+{
+    _preSyncLeadUs = preSyncLeadUs;
+}
+
+/**
+ * @brief Sets the SCHED_FIFO priority of the producer thread, 0 to keep the default scheduling policy
+ */
+void SyncProducer::setRealTimePriority(int priority)
+{
+    _realTimePriority = priority;
+}
+
+void SyncProducer::startProducer(int periodUs)
+{
+    stopProducer();
+    if (periodUs <= 0)
+    {
+        return;
+    }
+    _periodUs = periodUs;
+    start(QThread::TimeCriticalPriority);
+}
+
+void SyncProducer::stopProducer()
+{
+    requestInterruption();
+    wait();
+}
+
+/**
+ * @brief Marks RPDOs of a cycle as prepared, to be called by the bus thread after preSync()
+ * @param cycle cycle number given by preSync()
+ * @param txMark CanOpenBusWorker::txPostedCount() once RPDOs are posted
+ */
+void SyncProducer::acknowledgePreSync(quint32 cycle, quint32 txMark)
+{
+    _preSyncTxMark.storeRelease(txMark);
+    _preSyncAck.storeRelease(cycle);
+}
+
+/**
+ * @brief Exclusive upper limit of a jitter histogram bucket in us, -1 for the last unbounded bucket
+ */
+int SyncProducer::histogramBucketLimitUs(int bucket)
+{
+    if (bucket >= HistogramBuckets - 1)
+    {
+        return -1;
+    }
+    return 1 << bucket;
+}
+
+double SyncProducer::Statistics::meanJitterUs() const
+{
+    if (syncCount == 0)
+    {
+        return 0.0;
+    }
+    return static_cast<double>(sumJitterNs) / static_cast<double>(syncCount) / 1000.0;
+}
+
+SyncProducer::Statistics SyncProducer::statistics() const
+{
+    QMutexLocker locker(&_statisticsMutex);
+    return _publishedStatistics;
+}
+
+void SyncProducer::resetStatistics()
+{
+    _resetStatistics.storeRelease(1);
+    if (!isRunning())
+    {
+        QMutexLocker locker(&_statisticsMutex);
+        bool realTime = _publishedStatistics.realTime;
+        clearStatistics(_publishedStatistics);
+        _publishedStatistics.realTime = realTime;
+    }
+}
+
+void SyncProducer::clearStatistics(Statistics &statistics)
+{
+    statistics.syncCount = 0;
+    statistics.missedPreSync = 0;
+    statistics.lateOutputs = 0;
+    statistics.overruns = 0;
+    statistics.minJitterNs = 0;
+    statistics.maxJitterNs = 0;
+    statistics.sumJitterNs = 0;
+    std::fill(statistics.histogram, statistics.histogram + HistogramBuckets, 0U);
+    statistics.realTime = false;
+}
+
+void SyncProducer::accountJitter(qint64 jitterNs)
+{
+    jitterNs = qMax(jitterNs, Q_INT64_C(0));
+
+    if (_statistics.syncCount == 1 || jitterNs < _statistics.minJitterNs)
+    {
+        _statistics.minJitterNs = jitterNs;
+    }
+    _statistics.maxJitterNs = qMax(_statistics.maxJitterNs, jitterNs);
+    _statistics.sumJitterNs += jitterNs;
+
+    quint64 jitterUs = static_cast<quint64>(jitterNs / 1000);
+    int bucket = 0;
+    if (jitterUs != 0)
+    {
+        bucket = qMin(64 - static_cast<int>(qCountLeadingZeroBits(jitterUs)), HistogramBuckets - 1);
+    }
+    _statistics.histogram[bucket]++;
+}
+
+/**
+ * @brief Copies statistics for readers, skipped if a reader holds the lock to never block the producer
+ */
+void SyncProducer::publishStatistics()
+{
+    if (_statisticsMutex.tryLock())
+    {
+        _publishedStatistics = _statistics;
+        _statisticsMutex.unlock();
+    }
+}
+
+bool SyncProducer::setRealTimeScheduling()
+{
+#ifdef Q_OS_LINUX
+    struct sched_param param;
+    param.sched_priority = qBound(sched_get_priority_min(SCHED_FIFO), _realTimePriority, sched_get_priority_max(SCHED_FIFO));
+    return (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0);
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Sleeps up to an absolute monotonic deadline
+ * @return false if a stop was requested before the deadline
+ */
+bool SyncProducer::sleepUntil(qint64 deadlineNs)
+{
+    forever
+    {
+        if (isInterruptionRequested())
+        {
+            return false;
+        }
+
+        qint64 wakeNs = qMin(deadlineNs, monotonicNs() + SLEEP_SLICE_NS);
+#ifdef Q_OS_LINUX
+        struct timespec wake;
+        wake.tv_sec = static_cast<time_t>(wakeNs / 1000000000);
+        wake.tv_nsec = static_cast<long>(wakeNs % 1000000000);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, nullptr) == EINTR)
+        {
+        }
+#else
+        std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(wakeNs))));
+#endif
+        if (wakeNs == deadlineNs)
+        {
+            return true;
+        }
+    }
+}
+
+/**
+ * @brief Producer loop, one pre-sync phase and one SYNC per period on absolute deadlines
+ */
+void SyncProducer::run()
+{
+    clearStatistics(_statistics);
+    _statistics.realTime = (_realTimePriority > 0) && setRealTimeScheduling();
+    _resetStatistics.storeRelease(0);
+    publishStatistics();
+
+    const qint64 periodNs = static_cast<qint64>(_periodUs) * 1000;
+    qint64 leadNs = (_preSyncLeadUs < 0) ? periodNs / 4 : qMin(static_cast<qint64>(_preSyncLeadUs) * 1000, periodNs);
+
+    CanFrame frameSync;
+    frameSync.setFrameId(_cobId);
+    quint8 counter = 0;
+
+    quint32 cycle = _preSyncAck.loadAcquire();
+    quint32 lastTxFailed = _worker->txFailedCount();
+    qint64 deadlineNs = monotonicNs() + periodNs;
+    while (!isInterruptionRequested())
+    {
+        // pre-sync phase, RPDOs are prepared by the bus thread
+        cycle++;
+        if (!sleepUntil(deadlineNs - leadNs))
+        {
+            break;
+        }
+        emit preSync(cycle);
+
+        if (!sleepUntil(deadlineNs))
+        {
+            break;
+        }
+        qint64 wakeNs = monotonicNs();
+
+        // outputs of the cycle must have left the host before the SYNC
+        bool preSyncMissed = (static_cast<qint32>(cycle - _preSyncAck.loadAcquire()) > 0);
+        // frames refused by the driver since the last SYNC are outputs that did not leave
+        quint32 txFailed = _worker->txFailedCount();
+        quint32 txProcessed = _worker->txWrittenCount() + txFailed;
+        bool outputsLate = !preSyncMissed && ((static_cast<qint32>(_preSyncTxMark.loadAcquire() - txProcessed) > 0) || (txFailed != lastTxFailed));
+        lastTxFailed = txFailed;
+
+        if (_counterOverflow != 0)
+        {
+            counter = (counter >= _counterOverflow) ? 1 : counter + 1;
+            frameSync.setSize(1);
+            frameSync.data()[0] = counter;
+        }
+        _worker->postFrame(frameSync);
+
+        if (_resetStatistics.testAndSetOrdered(1, 0))
+        {
+            bool realTime = _statistics.realTime;
+            clearStatistics(_statistics);
+            _statistics.realTime = realTime;
+        }
+        _statistics.syncCount++;
+        if (preSyncMissed)
+        {
+            _statistics.missedPreSync++;
+        }
+        if (outputsLate)
+        {
+            _statistics.lateOutputs++;
+        }
+        accountJitter(wakeNs - deadlineNs);
+
+        // keeps the phase, periods already elapsed are skipped instead of emitted in a burst
+        deadlineNs += periodNs;
+        qint64 nowNs = monotonicNs();
+        if (nowNs >= deadlineNs)
+        {
+            qint64 skipped = (nowNs - deadlineNs) / periodNs + 1;
+            deadlineNs += skipped * periodNs;
+            _statistics.overruns += static_cast<quint64>(skipped);
+        }
+        publishStatistics();
+
+        emit syncSent(counter);
+    }
+}
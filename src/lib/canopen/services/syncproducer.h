@@ -0,0 +1,116 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef SYNCPRODUCER_H
+#define SYNCPRODUCER_H
+
+#include "canopen_global.h"
+
+#include <QAtomicInteger>
+#include <QMutex>
+#include <QThread>
+
+class CanOpenBusWorker;
+
+/**
+ * @brief Real time SYNC generator thread
+ *
+ * SYNC frames are emitted on absolute deadlines of the monotonic clock
+ * (clock_nanosleep with TIMER_ABSTIME on Linux), optionally with SCHED_FIFO
+ * priority, and posted directly to the bus I/O worker. The period does not
+ * drift and does not depend on the load of the thread owning the bus.
+ *
+ * Each cycle has a pre-sync phase starting preSyncLeadUs before the SYNC
+ * deadline, preSync() is emitted to let the bus thread prepare synchronous
+ * RPDOs. The bus thread acknowledges the cycle once RPDOs are posted, a cycle
+ * not acknowledged at SYNC time is counted as a missed pre-sync deadline, and
+ * RPDOs posted but not yet written by the bus worker as late outputs.
+ */
+class CANOPEN_EXPORT SyncProducer : public QThread
+{
+    Q_OBJECT
+public:
+    SyncProducer(CanOpenBusWorker *worker, QObject *parent = nullptr);
+    ~SyncProducer() override;
+
+    // configuration, applied at next startProducer()
+    void setCobId(quint32 cobId);
+    void setCounterOverflow(quint8 counterOverflow);
+    void setPreSyncLeadUs(int preSyncLeadUs);
+    void setRealTimePriority(int priority);
+
+    void startProducer(int periodUs);
+    void stopProducer();
+
+    void acknowledgePreSync(quint32 cycle, quint32 txMark);
+
+    enum
+    {
+        HistogramBuckets = 18  // [0, 1[ us, then power of two buckets, last one is >= 65.536 ms
+    };
+    static int histogramBucketLimitUs(int bucket);
+
+    struct Statistics
+    {
+        quint64 syncCount;
+        quint64 missedPreSync;  // SYNC emitted before RPDOs of the cycle were prepared
+        quint64 lateOutputs;    // RPDOs prepared but not yet written by the driver at SYNC time, or dropped by it
+        quint64 overruns;       // periods skipped because the thread woke up too late
+        qint64 minJitterNs;
+        qint64 maxJitterNs;
+        qint64 sumJitterNs;
+        quint32 histogram[HistogramBuckets];  // wake up latency after SYNC deadline
+        bool realTime;                        // SCHED_FIFO priority granted
+
+        double meanJitterUs() const;
+    };
+    Statistics statistics() const;
+    void resetStatistics();
+
+signals:
+    void preSync(quint32 cycle);
+    void syncSent(quint8 counter);
+
+protected:
+    void run() override;
+
+private:
+    CanOpenBusWorker *_worker;
+
+    quint32 _cobId;
+    quint8 _counterOverflow;
+    int _preSyncLeadUs;
+    int _realTimePriority;
+    int _periodUs;
+
+    QAtomicInteger<quint32> _preSyncAck;
+    QAtomicInteger<quint32> _preSyncTxMark;  // worker tx count once RPDOs of the acknowledged cycle are posted
+    QAtomicInt _resetStatistics;
+
+    Statistics _statistics;  // owned by the producer thread
+    Statistics _publishedStatistics;
+    mutable QMutex _statisticsMutex;
+
+    static void clearStatistics(Statistics &statistics);
+    void accountJitter(qint64 jitterNs);
+    void publishStatistics();
+    bool setRealTimeScheduling();
+    bool sleepUntil(qint64 deadlineNs);
+};
+
+#endif  // SYNCPRODUCER_H
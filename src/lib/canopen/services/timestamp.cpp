@@ -28,7 +28,7 @@ QString TimeStamp::type() const
     return QLatin1String("Emergency");
 }
 
-void TimeStamp::parseFrame(const QCanBusFrame &frame)
+void TimeStamp::parseFrame(const CanFrame &frame)
 {
     Q_UNUSED(frame)
 }
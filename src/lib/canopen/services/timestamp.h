@@ -31,7 +31,7 @@ public:
 
     QString type() const override;
 
-    void parseFrame(const QCanBusFrame &frame) override;
+    void parseFrame(const CanFrame &frame) override;
 };
 
 #endif  // TIMESTAMP_H
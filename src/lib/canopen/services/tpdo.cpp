@@ -18,12 +18,13 @@
 
 #include "tpdo.h"
 
+#include <QDateTime>
 #include <QDebug>
-#include <QIODevice>
+
+#include <cstring>
 
 #include "canopenbus.h"
 #include "sdo.h"
-#include <QDataStream>
 
 TPDO::TPDO(Node *node, quint8 number)
     : PDO(node, number)
@@ -50,25 +51,48 @@ QString TPDO::type() const
     return QLatin1String("TPDO") + QString::number(_pdoNumber + 1, 10);
 }
 
-void TPDO::parseFrame(const QCanBusFrame &frame)
+void TPDO::parseFrame(const CanFrame &frame)
 {
-    if (_currentMappedObjectsId.isEmpty())
+    if (_mappedObjects.isEmpty())
     {
         return;
     }
-    quint8 offset = 0;
 
-    for (const NodeObjectId &mappedObjectId : _currentMappedObjectsId)
+    quint8 data[PDO_BUFFER_SIZE] = {0};
+    std::memcpy(data, frame.data(), static_cast<size_t>(frame.size()));
+    const int frameBitSize = frame.size() * 8;
+
+    // shared copy, a subscriber may change the mapping while notified
+    const QVector<MappedObject> mappedObjects = _mappedObjects;
+    NodeOd *nodeOd = _node->nodeOd();
+    for (const MappedObject &mappedObject : mappedObjects)
     {
-        QByteArray data = frame.payload().mid(offset, QMetaType::sizeOf(mappedObjectId.dataType()));
-        QVariant vata = convertQByteArrayToQVariant(data, mappedObjectId.dataType());
+        if (mappedObject.bitOffset + mappedObject.bitLength > frameBitSize)
+        {
+            return;
+        }
+        if (mappedObject.nodeSubIndex == nullptr)
+        {
+            continue;
+        }
+
+        if (mappedObject.byteSlice)
+        {
+            QByteArray bytes(reinterpret_cast<const char *>(data) + mappedObject.bitOffset / 8, mappedObject.bitLength / 8);
+            QVariant value = (mappedObject.dataType == QMetaType::QString) ? QVariant(QString(bytes)) : QVariant(bytes);
+            nodeOd->updateObjectFromDevice(mappedObject.nodeSubIndex->index(),
+                                           mappedObject.nodeSubIndex->subIndex(),
+                                           value,
+                                           NodeOd::FlagsRequest::Pdo,
+                                           QDateTime::fromMSecsSinceEpoch(frame.timeStamp() / 1000));
+            continue;
+        }
 
-        _node->nodeOd()->updateObjectFromDevice(mappedObjectId.index(),
-                                                mappedObjectId.subIndex(),
-                                                vata,
-                                                NodeOd::FlagsRequest::Pdo,
-                                                QDateTime::fromMSecsSinceEpoch(frame.timeStamp().seconds() * 1000 + frame.timeStamp().microSeconds() / 1000));
-        offset += QMetaType::sizeOf(mappedObjectId.dataType());
+        quint64 bits = loadBits(data, mappedObject.bitOffset, mappedObject.bitLength);
+        nodeOd->updateObjectFromDevice(mappedObject.nodeSubIndex,
+                                       NodeValue::fromBits(bits, mappedObject.bitLength, mappedObject.dataType),
+                                       NodeOd::FlagsRequest::Pdo,
+                                       frame.timeStamp());
     }
 }
 
@@ -151,119 +175,3 @@ void TPDO::receiveSync()
 {
 }
 
-QVariant TPDO::convertQByteArrayToQVariant(QByteArray data, QMetaType::Type type)
-{
-    QDataStream dataStream(&data, QIODevice::ReadOnly);
-    dataStream.setByteOrder(QDataStream::LittleEndian);
-
-    switch (type)
-    {
-        case QMetaType::Int:
-        {
-            int a;
-            dataStream >> a;
-            return QVariant(a);
-        }
-
-        case QMetaType::UInt:
-        {
-            unsigned int b;
-            dataStream >> b;
-            return QVariant(b);
-        }
-
-        case QMetaType::LongLong:
-        {
-            qint64 c;
-            dataStream >> c;
-            return QVariant(c);
-        }
-
-        case QMetaType::ULongLong:
-        {
-            quint64 d;
-            dataStream >> d;
-            return QVariant(d);
-        }
-
-        case QMetaType::Double:
-        {
-            double e;
-            dataStream >> e;
-            return QVariant(e);
-        }
-
-        case QMetaType::Long:
-        {
-            long f;
-            memcpy(&f, data.constData(), sizeof(long));
-            QVariant w;
-            w.setValue(f);
-            return w;
-        }
-
-        case QMetaType::Short:
-        {
-            short g;
-            dataStream >> g;
-            return QVariant(g);
-        }
-
-        case QMetaType::Char:
-            return QVariant(data);
-
-        case QMetaType::ULong:
-        {
-            unsigned long i;
-            memcpy(&i, data.constData(), sizeof(unsigned long));
-            QVariant y;
-            y.setValue(i);
-            return y;
-        }
-
-        case QMetaType::UShort:
-        {
-            unsigned short j;
-            memcpy(&j, data.constData(), sizeof(unsigned short));
-            QVariant z;
-            z.setValue(j);
-            return z;
-        }
-
-        case QMetaType::UChar:
-        {
-            unsigned char k;
-            memcpy(&k, data.constData(), sizeof(unsigned char));
-            QVariant n;
-            n.setValue(k);
-            return n;
-        }
-
-        case QMetaType::Float:
-        {
-            float l;
-            dataStream >> l;
-            return QVariant(l);
-        }
-
-        case QMetaType::SChar:
-        {
-            signed char m;
-            memcpy(&m, data.constData(), sizeof(signed char));
-            QVariant x;
-            x.setValue(m);
-            return x;
-        }
-
-        case QMetaType::QString:
-            return QVariant(QString(data));
-
-        case QMetaType::QByteArray:
-            return QVariant(data);
-
-        default:
-            break;
-    }
-
-    return QVariant();
-}
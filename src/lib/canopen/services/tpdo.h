@@ -50,13 +50,10 @@ public:
 protected slots:
     void receiveSync();
 
-private:
-    QVariant convertQByteArrayToQVariant(QByteArray data, QMetaType::Type type);
-
     // Service interface
 public:
     QString type() const override;
-    void parseFrame(const QCanBusFrame &frame) override;
+    void parseFrame(const CanFrame &frame) override;
     void setBus(CanOpenBus *bus) override;
 
     // PDO interface
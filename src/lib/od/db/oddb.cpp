@@ -22,19 +22,38 @@
 
 #include <QCollator>
 #include <QCoreApplication>
-#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
 #include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
 #include <QProcessEnvironment>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#define ODDB_CACHE_MAGIC 0x45445349U  // 'EDSI'
+#define ODDB_CACHE_VERSION 1U
 
 OdDb *OdDb::_instance = nullptr;
 
 OdDb::OdDb()
 {
+    _cacheLoaded = false;
+    _cacheChanged = false;
+    _dirty = true;
+    _watcher = nullptr;
+}
+
+OdDb::~OdDb()
+{
+    delete _watcher;
 }
 
 void OdDb::init()
 {
-    addDirectory(QProcessEnvironment::systemEnvironment().value("EDS_PATH").split(QDir::listSeparator()));
+    addDirectory(QProcessEnvironment::systemEnvironment().value("EDS_PATH").split(QDir::listSeparator(), QString::SkipEmptyParts));
 
     QString edsPath = QCoreApplication::applicationDirPath() + "/../eds";
     if (QDir(edsPath).exists())
@@ -48,6 +67,9 @@ void OdDb::init()
     }
 }
 
+/**
+ * @brief adds a directory to search eds files in, it is scanned on next index use
+ */
 void OdDb::addDirectory(const QString &directory)
 {
     addDirectory(QStringList(directory));
@@ -55,105 +77,304 @@ void OdDb::addDirectory(const QString &directory)
 
 void OdDb::addDirectory(const QStringList &directories)
 {
-    for (const QString &directory : directories)
-    {
-        instance()->searchFile(directory);
-    }
     instance()->_directoryList.append(directories);
+    instance()->_dirty = true;
 }
 
-void OdDb::searchFile(const QString &directory)
+QString OdDb::file(quint32 deviceType, quint32 vendorID, quint32 productCode, quint32 revisionNumber)
 {
-    QDirIterator it(directory, QStringList() << "*.eds", QDir::Files | QDir::NoSymLinks | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    instance()->update();
 
-    while (it.hasNext())
+    QList<QPair<quint32, QString>> values = instance()->_mapFiles.values(deviceKey(deviceType, vendorID, productCode));
+
+    if (!values.isEmpty())
     {
-        const QString &file = it.next();
-        EdsParser parser;
+        quint32 rev = revisionNumber;
+        do
+        {
+            for (const auto &value : values)
+            {
+                if (value.first == rev)
+                {
+                    return value.second;
+                }
+            }
+            if (rev == 0)
+            {
+                break;
+            }
+            rev--;
+        } while (true);
+    }
 
-        DeviceDescription *deviceDescription = parser.parse(file);
+    return QString();
+}
 
-        QByteArray bytesId;
-        bytesId.append(deviceDescription->subIndexValue(0x1000, 0, "0").toByteArray());
-        bytesId.append(deviceDescription->subIndexValue(0x1018, 1, "0").toByteArray());
-        bytesId.append(deviceDescription->subIndexValue(0x1018, 2, "0").toByteArray());
-        uint revision = deviceDescription->subIndexValue(0x1018, 3).toUInt();
-        QByteArray hash = QCryptographicHash::hash(bytesId, QCryptographicHash::Md4);
+/**
+ * @brief rescans eds directories, only new and modified files are parsed
+ */
+void OdDb::refreshFile()
+{
+    instance()->_dirty = true;
+    instance()->update();
+}
 
-        QList<QPair<quint32, QString>> values = instance()->_mapFiles.values(hash);
-        bool exists = false;
-        if (!values.isEmpty())
+const QList<QString> &OdDb::edsFiles()
+{
+    instance()->update();
+    return instance()->_edsFiles;
+}
+
+/**
+ * @brief persistent index file, shared by all applications
+ */
+QString OdDb::cacheFilePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/udtstudio/edsindex";
+}
+
+/**
+ * @brief loads the cache on first use and rebuilds the index if directories changed
+ */
+void OdDb::update()
+{
+    if (!_cacheLoaded)
+    {
+        _cacheLoaded = true;
+        loadCache();
+    }
+    if (!_dirty)
+    {
+        return;
+    }
+    _dirty = false;
+
+    _mapFiles.clear();
+    _edsFiles.clear();
+    QSet<QString> foundFiles;
+    for (const QString &directory : qAsConst(_directoryList))
+    {
+        searchFile(directory, &foundFiles);
+    }
+
+    // removed files, the cache is shared with other tools scanning other directories,
+    // their entries are kept as long as the file exists
+    QStringList scannedPrefixes;
+    for (const QString &directory : qAsConst(_directoryList))
+    {
+        if (!directory.isEmpty())
         {
-            for (const auto &value : values)
+            scannedPrefixes.append(QDir::cleanPath(directory) + QLatin1Char('/'));
+        }
+    }
+    QHash<QString, EdsFile>::iterator it = _cache.begin();
+    while (it != _cache.end())
+    {
+        bool removed = false;
+        if (!foundFiles.contains(it.key()))
+        {
+            const QString file = QDir::cleanPath(it.key());
+            for (const QString &prefix : qAsConst(scannedPrefixes))
             {
-                if (value.first == revision)
+                if (file.startsWith(prefix))
                 {
-                    // eds already exists with this revision number
-                    exists = true;
+                    removed = true;
+                    break;
                 }
             }
+            removed = removed || !QFileInfo::exists(file);
         }
-
-        if (!exists)
+        if (removed)
         {
-            // append eds file
-            QPair<quint32, QString> pair;
-            pair.first = revision;
-            pair.second = file;
-            _mapFiles.insert(hash, pair);
-            _edsFiles.append(file);
+            it = _cache.erase(it);
+            _cacheChanged = true;
+        }
+        else
+        {
+            ++it;
         }
-
-        delete deviceDescription;
     }
 
     QCollator order;
     std::sort(_edsFiles.begin(), _edsFiles.end(), order);
+
+    if (_cacheChanged)
+    {
+        saveCache();
+    }
 }
 
-QString OdDb::file(quint32 deviceType, quint32 vendorID, quint32 productCode, quint32 revisionNumber)
+void OdDb::searchFile(const QString &directory, QSet<QString> *foundFiles)
 {
-    QByteArray bytesId;
-    bytesId.append(QVariant(deviceType).toByteArray());
-    bytesId.append(QVariant(vendorID).toByteArray());
-    bytesId.append(QVariant(productCode).toByteArray());
-    QByteArray hash = QCryptographicHash::hash(bytesId, QCryptographicHash::Md4);
-
-    QList<QPair<quint32, QString>> values = instance()->_mapFiles.values(hash);
+    if (directory.isEmpty() || !QDir(directory).exists())
+    {
+        return;
+    }
 
-    if (!values.isEmpty())
+    QStringList directories(directory);
+    QDirIterator it(directory, QStringList() << "*.eds", QDir::Files | QDir::AllDirs | QDir::NoSymLinks | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext())
     {
-        quint32 rev = revisionNumber;
-        do
+        const QString &file = it.next();
+        const QFileInfo fileInfo = it.fileInfo();
+        if (fileInfo.isDir())
         {
-            for (const auto &value : values)
+            directories.append(file);
+            continue;
+        }
+        if (foundFiles->contains(file))
+        {
+            continue;
+        }
+        foundFiles->insert(file);
+
+        // parsed only if unknown or modified since cached
+        const qint64 modified = fileInfo.lastModified().toMSecsSinceEpoch();
+        QHash<QString, EdsFile>::iterator cached = _cache.find(file);
+        if (cached == _cache.end() || (*cached).modified != modified || (*cached).size != fileInfo.size())
+        {
+            EdsFile edsFile;
+            edsFile.modified = modified;
+            edsFile.size = fileInfo.size();
+            edsFile.valid = readIdentity(file, &edsFile);
+            cached = _cache.insert(file, edsFile);
+            _cacheChanged = true;
+        }
+
+        const EdsFile &edsFile = *cached;
+        if (!edsFile.valid)
+        {
+            continue;
+        }
+
+        const QByteArray key = deviceKey(edsFile.deviceType, edsFile.vendorId, edsFile.productCode);
+        QList<QPair<quint32, QString>> values = _mapFiles.values(key);
+        bool exists = false;
+        for (const auto &value : values)
+        {
+            if (value.first == edsFile.revision)
             {
-                if (value.first == rev)
-                {
-                    return value.second;
-                }
+                // eds already exists with this revision number
+                exists = true;
             }
-            if (rev == 0)
+        }
+
+        if (!exists)
+        {
+            // append eds file
+            _mapFiles.insert(key, qMakePair(edsFile.revision, file));
+            _edsFiles.append(file);
+        }
+    }
+
+    // directories are watched (inotify on linux) to rescan on next use
+    if (QCoreApplication::instance() != nullptr)
+    {
+        if (_watcher == nullptr)
+        {
+            _watcher = new QFileSystemWatcher();
+            QObject::connect(_watcher,
+                             &QFileSystemWatcher::directoryChanged,
+                             [this]()
+                             {
+                                 _dirty = true;
+                             });
+        }
+        for (const QString &watchedDirectory : qAsConst(directories))
+        {
+            if (!_watchedDirectories.contains(watchedDirectory))
             {
-                break;
+                _watchedDirectories.insert(watchedDirectory);
+                _watcher->addPath(watchedDirectory);
             }
-            rev--;
-        } while (true);
+        }
     }
+}
 
-    return QString();
+bool OdDb::readIdentity(const QString &path, EdsFile *edsFile)
+{
+    EdsParser parser;
+    DeviceDescription *deviceDescription = parser.parseHeader(path);
+    if (deviceDescription == nullptr)
+    {
+        return false;
+    }
+
+    edsFile->deviceType = deviceDescription->subIndexValue(0x1000, 0, 0).toUInt();
+    edsFile->vendorId = deviceDescription->subIndexValue(0x1018, 1, 0).toUInt();
+    edsFile->productCode = deviceDescription->subIndexValue(0x1018, 2, 0).toUInt();
+    edsFile->revision = deviceDescription->subIndexValue(0x1018, 3, 0).toUInt();
+    delete deviceDescription;
+    return true;
 }
 
-void OdDb::refreshFile()
+QByteArray OdDb::deviceKey(quint32 deviceType, quint32 vendorId, quint32 productCode)
 {
-    instance()->_mapFiles.clear();
-    for (const QString &directory : qAsConst(instance()->_directoryList))
+    QByteArray key;
+    key.reserve(12);
+    key.append(reinterpret_cast<const char *>(&deviceType), sizeof(deviceType));
+    key.append(reinterpret_cast<const char *>(&vendorId), sizeof(vendorId));
+    key.append(reinterpret_cast<const char *>(&productCode), sizeof(productCode));
+    return key;
+}
+
+void OdDb::loadCache()
+{
+    QFile file(cacheFilePath());
+    if (!file.open(QIODevice::ReadOnly))
     {
-        instance()->searchFile(directory);
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint32 count = 0;
+    stream >> magic >> version >> count;
+    if (magic != ODDB_CACHE_MAGIC || version != ODDB_CACHE_VERSION)
+    {
+        return;
+    }
+
+    _cache.reserve(static_cast<int>(count));
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; i++)
+    {
+        QString path;
+        EdsFile edsFile;
+        stream >> path >> edsFile.modified >> edsFile.size >> edsFile.valid >> edsFile.deviceType >> edsFile.vendorId >> edsFile.productCode >> edsFile.revision;
+        _cache.insert(path, edsFile);
+    }
+    if (stream.status() != QDataStream::Ok)
+    {
+        _cache.clear();  // truncated, rebuilt
     }
 }
 
-const QList<QString> &OdDb::edsFiles()
+void OdDb::saveCache()
 {
-    return instance()->_edsFiles;
+    const QString path = cacheFilePath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    // written aside and renamed, other applications may read it at the same time
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+    stream << static_cast<quint32>(ODDB_CACHE_MAGIC) << static_cast<quint32>(ODDB_CACHE_VERSION) << static_cast<quint32>(_cache.count());
+    QHash<QString, EdsFile>::const_iterator it = _cache.cbegin();
+    while (it != _cache.cend())
+    {
+        const EdsFile &edsFile = it.value();
+        stream << it.key() << edsFile.modified << edsFile.size << edsFile.valid << edsFile.deviceType << edsFile.vendorId << edsFile.productCode << edsFile.revision;
+        ++it;
+    }
+    if (file.commit())
+    {
+        _cacheChanged = false;
+    }
 }
@@ -21,9 +21,21 @@
 
 #include "od_global.h"
 
-#include <QMap>
+#include <QHash>
+#include <QMultiHash>
+#include <QSet>
 #include <QString>
 
+class QFileSystemWatcher;
+
+/**
+ * @brief Index of eds files found in eds directories, by device identity
+ *
+ * Identity of each file (device type, vendor, product code and revision) is
+ * kept in a persistent cache keyed by path, modification time and size, only
+ * new or modified files are parsed. The index is built on first use, and
+ * rebuilt incrementally when a watched directory changes.
+ */
 class OD_EXPORT OdDb
 {
     Q_DISABLE_COPY(OdDb)
@@ -35,6 +47,8 @@ public:
 
     static const QList<QString> &edsFiles();
 
+    static QString cacheFilePath();
+
     static inline OdDb *instance()
     {
         if (OdDb::_instance == nullptr)
@@ -48,17 +62,42 @@ public:
     static inline void release()
     {
         delete OdDb::_instance;
+        OdDb::_instance = nullptr;
     }
 
 private:
     OdDb();
+    ~OdDb();
     void init();
 
-    QMultiMap<QByteArray, QPair<quint32, QString>> _mapFiles;
+    struct EdsFile
+    {
+        qint64 modified;  // ms since epoch
+        qint64 size;
+        bool valid;  // false if identity cannot be read, the file is not parsed again until modified
+        quint32 deviceType;
+        quint32 vendorId;
+        quint32 productCode;
+        quint32 revision;
+    };
+    QHash<QString, EdsFile> _cache;
+    bool _cacheLoaded;
+    bool _cacheChanged;
+    bool _dirty;
+
+    QMultiHash<QByteArray, QPair<quint32, QString>> _mapFiles;
     QList<QString> _edsFiles;
     QList<QString> _directoryList;
 
-    void searchFile(const QString &directory);
+    QFileSystemWatcher *_watcher;
+    QSet<QString> _watchedDirectories;
+
+    void update();
+    void searchFile(const QString &directory, QSet<QString> *foundFiles);
+    static bool readIdentity(const QString &path, EdsFile *edsFile);
+    static QByteArray deviceKey(quint32 deviceType, quint32 vendorId, quint32 productCode);
+    void loadCache();
+    void saveCache();
 
     static OdDb *_instance;
 };
@@ -27,6 +27,7 @@ HEADERS += \
     $$PWD/parser/deviceconfigurationparser.h \
     $$PWD/parser/devicedescriptionparser.h \
     $$PWD/parser/deviceiniparser.h \
+    $$PWD/parser/deviceinitokenizer.h \
     $$PWD/parser/edsparser.h \
     $$PWD/utility/configurationapply.h \
     $$PWD/utility/odmerger.h \
@@ -53,6 +54,7 @@ SOURCES += \
     $$PWD/parser/deviceconfigurationparser.cpp \
     $$PWD/parser/devicedescriptionparser.cpp \
     $$PWD/parser/deviceiniparser.cpp \
+    $$PWD/parser/deviceinitokenizer.cpp \
     $$PWD/parser/edsparser.cpp \
     $$PWD/utility/configurationapply.cpp \
     $$PWD/utility/odmerger.cpp \
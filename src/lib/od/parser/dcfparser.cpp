@@ -18,10 +18,8 @@
 
 #include "dcfparser.h"
 
-#include <QRegularExpression>
-#include <QSettings>
-
 #include "deviceiniparser.h"
+#include "deviceinitokenizer.h"
 
 /**
  * @brief default constructor
@@ -46,39 +44,40 @@ DeviceConfiguration *DcfParser::parse(const QString &path) const
 {
     DeviceConfiguration *deviceConfiguration = new DeviceConfiguration;
 
-    QSettings file(path, QSettings::IniFormat);
-    DeviceIniParser parser(&file);
+    DeviceIniTokenizer tokenizer;
+    if (!tokenizer.open(path))
+    {
+        return deviceConfiguration;
+    }
+    DeviceIniParser parser(&tokenizer);
 
-    // infos
-    for (const QString &group : file.childGroups())
+    while (tokenizer.nextSection())
     {
-        if (group == "DeviceComissioning")
+        const QByteArray &section = tokenizer.section();
+
+        // infos
+        if (DeviceIniTokenizer::equals(section, "DeviceComissioning"))
         {
-            file.beginGroup(group);
             parser.readDeviceComissioning(deviceConfiguration);
-            file.endGroup();
             continue;
         }
 
-        if (group == "FileInfo")
+        if (DeviceIniTokenizer::equals(section, "FileInfo"))
         {
-            file.beginGroup(group);
             parser.readFileInfo(deviceConfiguration);
-            file.endGroup();
             continue;
         }
 
-        if (group == "DummyUsage")
+        if (DeviceIniTokenizer::equals(section, "DummyUsage"))
         {
-            file.beginGroup(group);
             parser.readDummyUsage(deviceConfiguration);
-            file.endGroup();
             continue;
         }
-    }
 
-    // objects
-    parser.readObjects(deviceConfiguration);
+        // objects
+        parser.readObject(deviceConfiguration);
+    }
+    parser.endObjects(deviceConfiguration);
 
     return deviceConfiguration;
 }
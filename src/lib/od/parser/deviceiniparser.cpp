@@ -19,239 +19,317 @@
 #include "deviceiniparser.h"
 
 #include <QDebug>
-#include <QLocale>
-#include <QRegularExpression>
 
 /**
  * @brief constructor
- * @param file to parse
+ * @param tokenizer of the opened file to parse
  */
-DeviceIniParser::DeviceIniParser(QSettings *file)
-    : _file(file)
+DeviceIniParser::DeviceIniParser(DeviceIniTokenizer *tokenizer)
+    : _tokenizer(tokenizer)
 {
 }
 
-/**
- * @brief parsesall indexes and sub-indexes fields and completes device model
- * @param device model
- */
-void DeviceIniParser::readObjects(DeviceModel *deviceModel) const
+DeviceIniParser::~DeviceIniParser()
 {
-    readIndexes(deviceModel);
-    readSubIndexes(deviceModel);
+    for (const QPair<uint16_t, SubIndex *> &pending : qAsConst(_pendingSubIndexes))
+    {
+        delete pending.second;
+    }
 }
 
 /**
- * @brief parses all indexes fields and completes device model
+ * @brief parses the current section if it is an index or a sub-index and completes device model
  * @param device model
+ * @return false if the section is not an object
  */
-void DeviceIniParser::readIndexes(DeviceModel *deviceModel) const
+bool DeviceIniParser::readObject(DeviceModel *deviceModel)
 {
-    QRegularExpression reIndex("^[0-9A-F]{1,4}$");
-    for (const QString &group : _file->childGroups())
+    const QByteArray &section = _tokenizer->section();
+    uint16_t numIndex = 0;
+    uint8_t numSubIndex = 0;
+
+    if (parseIndexSection(section, &numIndex))
     {
-        bool ok = false;
-        uint16_t numIndex = 0;
-        QRegularExpressionMatch matchIndex = reIndex.match(group);
+        Index *index = new Index(numIndex);
+        readIndex(index);
+        deviceModel->addIndex(index);
+        return true;
+    }
 
-        if (matchIndex.hasMatch())
-        {
-            QString matchedIndex = matchIndex.captured(0);
-            numIndex = static_cast<uint16_t>(matchedIndex.toInt(&ok, 16));
-            Index *index = new Index(numIndex);
+    if (parseSubIndexSection(section, &numIndex, &numSubIndex))
+    {
+        SubIndex *subIndex = new SubIndex(numSubIndex);
+        readSubIndex(subIndex);
 
-            _file->beginGroup(group);
-            readIndex(index);
-            _file->endGroup();
+        if (numIndex == 0x2040 && subIndex->subIndex() == 1)  // Communication_config.Node_ID
+        {
+            subIndex->setValue(0);
+        }
 
-            deviceModel->addIndex(index);
+        if (deviceModel->indexExist(numIndex))
+        {
+            deviceModel->index(numIndex)->addSubIndex(subIndex);
         }
+        else
+        {
+            _pendingSubIndexes.append(qMakePair(numIndex, subIndex));
+        }
+        return true;
     }
+
+    return false;
 }
 
 /**
- * @brief parses all sub-indexes fields and completes device model
+ * @brief adds sub-indexes which section was before their index one, drops the ones without index
  * @param device model
  */
-void DeviceIniParser::readSubIndexes(DeviceModel *deviceModel) const
+void DeviceIniParser::endObjects(DeviceModel *deviceModel)
 {
-    QRegularExpression reSub("^([0-9A-F]{4})sub([0-9A-F]+)");
-    for (const QString &group : _file->childGroups())
+    for (const QPair<uint16_t, SubIndex *> &pending : qAsConst(_pendingSubIndexes))
     {
-        bool ok = false;
-        uint8_t numSubIndex = 0;
-        QRegularExpressionMatch matchSub = reSub.match(group);
-
-        if (matchSub.hasMatch())
+        if (deviceModel->indexExist(pending.first))
+        {
+            deviceModel->index(pending.first)->addSubIndex(pending.second);
+        }
+        else
         {
-            QString matchedSub = matchSub.captured(2);
-            numSubIndex = static_cast<uint8_t>(matchedSub.toShort(&ok, 16));
-            SubIndex *subIndex = new SubIndex(numSubIndex);
-
-            _file->beginGroup(group);
-            readSubIndex(subIndex);
-            _file->endGroup();
-
-            matchedSub = matchSub.captured(1);
-            uint16_t numIndex = static_cast<uint16_t>(matchedSub.toUInt(&ok, 16));
-
-            if (numIndex == 0x2040 && subIndex->subIndex() == 1)  // Communication_config.Node_ID
-            {
-                subIndex->setValue(0);
-            }
-
-            if (deviceModel->indexExist(numIndex))
-            {
-                Index *index = deviceModel->index(numIndex);
-                index->addSubIndex(subIndex);
-            }
+            delete pending.second;
         }
     }
+    _pendingSubIndexes.clear();
 }
 
 /**
- * @brief parses an index field and completes index model
- * @param index model
+ * @brief checks if device type and identity (vendor, product code and revision) are known
+ * @param device model
  */
-void DeviceIniParser::readIndex(Index *index) const
+bool DeviceIniParser::hasIdentity(const DeviceModel *deviceModel)
 {
-    uint8_t objectType = 0;
-    uint8_t maxSubIndex = 0;
-    QString name;
+    return deviceModel->subIndex(0x1000, 0) != nullptr && deviceModel->subIndex(0x1018, 1) != nullptr && deviceModel->subIndex(0x1018, 2) != nullptr
+        && deviceModel->subIndex(0x1018, 3) != nullptr;
+}
 
-    for (const QString &key : _file->allKeys())
+/**
+ * @brief sections needed to identify a device, [1000], [1018] and [1018subN]
+ */
+bool DeviceIniParser::isIdentitySection(const QByteArray &section)
+{
+    uint16_t numIndex = 0;
+    uint8_t numSubIndex = 0;
+    if (parseIndexSection(section, &numIndex))
     {
-        bool ok = false;
-        QString value = _file->value(key).toString();
-
-        uint8_t base = 10;
-        if (value.startsWith("0x", Qt::CaseInsensitive))
-        {
-            base = 16;
-        }
-
-        if (key == "ObjectType")
-        {
-            objectType = static_cast<uint8_t>(value.toInt(&ok, base));
-        }
+        return numIndex == 0x1000 || numIndex == 0x1018;
+    }
+    if (parseSubIndexSection(section, &numIndex, &numSubIndex))
+    {
+        return numIndex == 0x1018;
+    }
+    return false;
+}
 
-        else if (key == "ParameterName")
-        {
-            name = value;
-        }
+/**
+ * @brief parses an index section and completes index model, the section also describes sub-index 0
+ * @param index model
+ */
+void DeviceIniParser::readIndex(Index *index) const
+{
+    const ObjectFields fields = readFields();
 
-        else if (key == "SubNumber")
-        {
-            maxSubIndex = static_cast<uint8_t>(value.toInt(&ok, base));
-        }
-    }
+    bool ok = false;
+    QString value = toString(fields.objectType);
+    uint8_t objectType = static_cast<uint8_t>(value.toInt(&ok, isHex(fields.objectType) ? 16 : 10));
+    value = toString(fields.subNumber);
+    uint8_t maxSubIndex = static_cast<uint8_t>(value.toInt(&ok, isHex(fields.subNumber) ? 16 : 10));
 
     SubIndex *subIndex = new SubIndex(static_cast<uint8_t>(0));
-    readSubIndex(subIndex);
+    fillSubIndex(subIndex, fields);
 
     index->setMaxSubIndex(maxSubIndex);
     index->setObjectType(static_cast<Index::Object>(objectType));
-    index->setName(name);
+    index->setName(toString(fields.parameterName));
     index->addSubIndex(subIndex);
 }
 
 /**
- * @brief parses an index field and completes sub-index model
+ * @brief parses a sub-index section and completes sub-index model
  * @param sub-index model
  */
 void DeviceIniParser::readSubIndex(SubIndex *subIndex) const
 {
-    bool hasNodeId = false;
-    bool isHexValue = false;
-    uint8_t accessType = 0;
-    uint16_t dataType = SubIndex::INVALID;
-    QString name;
-    QVariant data;
-    QVariant lowLimit;
-    QVariant highLimit;
-    uint32_t objFlags = 0;
-
-    for (const QString &key : _file->allKeys())
+    fillSubIndex(subIndex, readFields());
+}
+
+/**
+ * @brief parses file infos and completes device model
+ * @param device model
+ */
+void DeviceIniParser::readFileInfo(DeviceModel *deviceModel) const
+{
+    while (_tokenizer->nextKey())
     {
-        QString value = _file->value(key).toString();
+        deviceModel->setFileInfo(toString(_tokenizer->key()), toString(_tokenizer->value()));
+    }
+}
 
-        if (key == "AccessType")
+/**
+ * @brief parses dummy usages and completes device model
+ * @param device model
+ */
+void DeviceIniParser::readDummyUsage(DeviceModel *deviceModel) const
+{
+    while (_tokenizer->nextKey())
+    {
+        deviceModel->setDummyUsage(toString(_tokenizer->key()), toString(_tokenizer->value()));
+    }
+}
+
+void DeviceIniParser::readComments(DeviceModel *deviceModel) const
+{
+    while (_tokenizer->nextKey())
+    {
+        deviceModel->setComment(toString(_tokenizer->key()), toString(_tokenizer->value()));
+    }
+}
+
+/**
+ * @brief parses device infos and completes device description model
+ * @param device description model
+ */
+void DeviceIniParser::readDeviceInfo(DeviceDescription *deviceDescription) const
+{
+    while (_tokenizer->nextKey())
+    {
+        deviceDescription->setDeviceInfo(toString(_tokenizer->key()), toString(_tokenizer->value()));
+    }
+}
+
+/**
+ * @brief parses device comissioning and completes device configuration
+ * @param device configuration model
+ */
+void DeviceIniParser::readDeviceComissioning(DeviceConfiguration *deviceConfiguration) const
+{
+    while (_tokenizer->nextKey())
+    {
+        deviceConfiguration->addDeviceComissioning(toString(_tokenizer->key()), toString(_tokenizer->value()));
+    }
+}
+
+/**
+ * @brief index section name, 1 to 4 hex digits
+ */
+bool DeviceIniParser::parseIndexSection(const QByteArray &section, uint16_t *index)
+{
+    if (section.isEmpty() || section.size() > 4)
+    {
+        return false;
+    }
+
+    bool ok = false;
+    *index = static_cast<uint16_t>(section.toUInt(&ok, 16));
+    return ok;
+}
+
+/**
+ * @brief sub-index section name, 4 hex digits index, 'sub' and hex sub-index
+ */
+bool DeviceIniParser::parseSubIndexSection(const QByteArray &section, uint16_t *index, uint8_t *subIndex)
+{
+    if (section.size() < 8 || section.size() > 9 || qstrnicmp(section.constData() + 4, "sub", 3) != 0)
+    {
+        return false;
+    }
+
+    bool okIndex = false;
+    bool okSubIndex = false;
+    *index = static_cast<uint16_t>(section.left(4).toUInt(&okIndex, 16));
+    *subIndex = static_cast<uint8_t>(section.mid(7).toUInt(&okSubIndex, 16));
+    return okIndex && okSubIndex;
+}
+
+/**
+ * @brief reads all keys of the current section
+ */
+DeviceIniParser::ObjectFields DeviceIniParser::readFields() const
+{
+    ObjectFields fields;
+    while (_tokenizer->nextKey())
+    {
+        const QByteArray &key = _tokenizer->key();
+        const QByteArray &value = _tokenizer->value();
+        if (DeviceIniTokenizer::equals(key, "ParameterName"))
         {
-            QString accessString = _file->value(key).toString();
-
-            if (accessString == "rw" || accessString == "rwr" || accessString == "rww")
-            {
-                accessType += SubIndex::READ + SubIndex::WRITE;
-            }
-            else if (accessString == "wo")
-            {
-                accessType += SubIndex::WRITE;
-            }
-            else if (accessString == "ro")
-            {
-                accessType += SubIndex::READ;
-            }
-            else if (accessString == "const")
-            {
-                accessType += SubIndex::READ;
-                accessType += SubIndex::CONST;
-            }
+            fields.parameterName = value;
         }
-        else if (key == "PDOMapping")
+        else if (DeviceIniTokenizer::equals(key, "ObjectType"))
         {
-            accessType += readPdoMapping();
+            fields.objectType = value;
         }
-        else if (key == "ParameterName")
+        else if (DeviceIniTokenizer::equals(key, "SubNumber"))
         {
-            name = value;
+            fields.subNumber = value;
         }
-        else if (key == "LowLimit")
+        else if (DeviceIniTokenizer::equals(key, "AccessType"))
         {
-            lowLimit = readLowLimit();
+            fields.accessType = value;
         }
-        else if (key == "HighLimit")
+        else if (DeviceIniTokenizer::equals(key, "PDOMapping"))
         {
-            highLimit = readHighLimit();
+            fields.pdoMapping = value;
         }
-        else if (key == "DataType")
+        else if (DeviceIniTokenizer::equals(key, "LowLimit"))
         {
-            dataType = readDataType();
+            fields.lowLimit = value;
         }
-        else if (key == "ObjFlags")
+        else if (DeviceIniTokenizer::equals(key, "HighLimit"))
         {
-            objFlags = readObjFlags();
+            fields.highLimit = value;
+        }
+        else if (DeviceIniTokenizer::equals(key, "DataType"))
+        {
+            fields.dataType = value;
+        }
+        else if (DeviceIniTokenizer::equals(key, "ObjFlags"))
+        {
+            fields.objFlags = value;
+        }
+        else if (DeviceIniTokenizer::equals(key, "DefaultValue"))
+        {
+            fields.defaultValue = value;
         }
-
-        data = readData(&hasNodeId, &isHexValue);
     }
+    return fields;
+}
+
+void DeviceIniParser::fillSubIndex(SubIndex *subIndex, const ObjectFields &fields) const
+{
+    bool hasNodeId = false;
+    bool isHexValue = false;
+    QVariant data = readData(fields, &hasNodeId, &isHexValue);
 
-    subIndex->setAccessType(static_cast<SubIndex::AccessType>(accessType));
-    subIndex->setName(name);
+    subIndex->setAccessType(static_cast<SubIndex::AccessType>(readAccessType(fields) + readPdoMapping(fields)));
+    subIndex->setName(toString(fields.parameterName));
     subIndex->setValue(data);
-    subIndex->setDataType(static_cast<SubIndex::DataType>(dataType));
-    subIndex->setLowLimit(lowLimit);
-    subIndex->setHighLimit(highLimit);
+    subIndex->setDataType(static_cast<SubIndex::DataType>(readDataType(fields)));
+    subIndex->setLowLimit(fields.lowLimit.isNull() ? QVariant() : QVariant(toString(fields.lowLimit)));
+    subIndex->setHighLimit(fields.highLimit.isNull() ? QVariant() : QVariant(toString(fields.highLimit)));
     subIndex->setHasNodeId(hasNodeId);
     subIndex->setHexValue(isHexValue);
-    subIndex->setObjFlags(objFlags);
+    subIndex->setObjFlags(readObjFlags(fields));
 }
 
 /**
  * @brief read data to correct format from dcf or eds file
- * @param dcf or eds file
  * @return data
  */
-QVariant DeviceIniParser::readData(bool *nodeId, bool *isHexValue) const
+QVariant DeviceIniParser::readData(const ObjectFields &fields, bool *nodeId, bool *isHexValue) const
 {
     QString stringValue;
 
-    if (_file->value("DefaultValue").isNull())
-    {
-        stringValue = "";
-    }
-    else if (_file->value("DefaultValue").toString().startsWith("$NODEID"))
+    if (fields.defaultValue.startsWith("$NODEID"))
     {
-        stringValue = _file->value("DefaultValue").toString().mid(8);
+        stringValue = toString(fields.defaultValue.mid(8));
         if (stringValue.isEmpty())
         {
             stringValue = "0";
@@ -260,10 +338,10 @@ QVariant DeviceIniParser::readData(bool *nodeId, bool *isHexValue) const
     }
     else
     {
-        stringValue = _file->value("DefaultValue").toString();
+        stringValue = toString(fields.defaultValue);
     }
 
-    uint16_t dataType = readDataType();
+    uint16_t dataType = readDataType(fields);
 
     int base = 0;
     if (stringValue.startsWith("0x"))
@@ -318,74 +396,43 @@ QVariant DeviceIniParser::readData(bool *nodeId, bool *isHexValue) const
 }
 
 /**
- * @brief parses file infos and completes device model
- * @param device model
- */
-void DeviceIniParser::readFileInfo(DeviceModel *deviceModel) const
-{
-    for (const QString &key : _file->allKeys())
-    {
-        deviceModel->setFileInfo(key, _file->value(key).toString());
-    }
-}
-
-/**
- * @brief parses dummy usages and completes device model
- * @param device model
+ * @brief parses access type value and returns it
+ * @return 8 bits access code, without pdo mapping
  */
-void DeviceIniParser::readDummyUsage(DeviceModel *deviceModel) const
+uint8_t DeviceIniParser::readAccessType(const ObjectFields &fields) const
 {
-    for (const QString &key : _file->allKeys())
+    const QByteArray &accessString = fields.accessType;
+    if (accessString == "rw" || accessString == "rwr" || accessString == "rww")
     {
-        deviceModel->setDummyUsage(key, _file->value(key).toString());
+        return SubIndex::READ + SubIndex::WRITE;
     }
-}
-
-void DeviceIniParser::readComments(DeviceModel *deviceModel) const
-{
-    for (const QString &key : _file->allKeys())
+    if (accessString == "wo")
     {
-        deviceModel->setComment(key, _file->value(key).toString());
+        return SubIndex::WRITE;
     }
-}
-
-/**
- * @brief parses device infos and completes device description model
- * @param device description model
- */
-void DeviceIniParser::readDeviceInfo(DeviceDescription *deviceDescription) const
-{
-    for (const QString &key : _file->allKeys())
+    if (accessString == "ro")
     {
-        deviceDescription->setDeviceInfo(key, _file->value(key).toString());
+        return SubIndex::READ;
     }
-}
-
-/**
- * @brief parses device comissioning and completes device configuration
- * @param device configuration model
- */
-void DeviceIniParser::readDeviceComissioning(DeviceConfiguration *deviceConfiguration) const
-{
-    for (const QString &key : _file->allKeys())
+    if (accessString == "const")
     {
-        deviceConfiguration->addDeviceComissioning(key, _file->value(key).toString());
+        return SubIndex::READ + SubIndex::CONST;
     }
+    return 0;
 }
 
 /**
  * @brief parses pdo mapping value and returns it
  * @return 8 bits pdo mapping code
  */
-uint8_t DeviceIniParser::readPdoMapping() const
+uint8_t DeviceIniParser::readPdoMapping(const ObjectFields &fields) const
 {
-    if (_file->value("PDOMapping") == 0)
+    if (fields.pdoMapping.isNull() || toUInt(fields.pdoMapping) == 0)
     {
         return 0;
     }
 
-    QString accessString = _file->value("AccessType").toString();
-
+    const QByteArray &accessString = fields.accessType;
     if (accessString == "rwr" || accessString == "ro" || accessString == "const")
     {
         return SubIndex::TPDO;
@@ -400,51 +447,35 @@ uint8_t DeviceIniParser::readPdoMapping() const
 }
 
 /**
- * @brief parses low limit value and returns it
- * @return low limit value
+ * @brief parses data type value and returns it
+ * @return 16 bits data type code
  */
-QVariant DeviceIniParser::readLowLimit() const
+uint16_t DeviceIniParser::readDataType(const ObjectFields &fields) const
 {
-    return QVariant(_file->value("LowLimit"));
+    return static_cast<uint16_t>(toUInt(fields.dataType));
 }
 
-/**
- * @brief parses high limit value and returns it
- * @return high limit value
- */
-QVariant DeviceIniParser::readHighLimit() const
+uint32_t DeviceIniParser::readObjFlags(const ObjectFields &fields) const
 {
-    return QVariant(_file->value("HighLimit"));
+    return static_cast<uint32_t>(toUInt(fields.objFlags));
+}
+
+bool DeviceIniParser::isHex(const QByteArray &value)
+{
+    return value.startsWith("0x") || value.startsWith("0X");
 }
 
 /**
- * @brief parses data type value and returns it
- * @return 16 bits data type code^
+ * @brief converts a decimal or 0x prefixed hexadecimal value, 0 if invalid
  */
-uint16_t DeviceIniParser::readDataType() const
+uint DeviceIniParser::toUInt(const QByteArray &value)
 {
-    QString dataType = _file->value("DataType").toString();
-
-    int base = 10;
-    if (dataType.startsWith("0x"))
-    {
-        base = 16;
-    }
-
     bool ok = false;
-    return static_cast<uint16_t>(dataType.toInt(&ok, base));
+    uint number = isHex(value) ? value.mid(2).toUInt(&ok, 16) : value.toUInt(&ok, 10);
+    return ok ? number : 0;
 }
 
-uint32_t DeviceIniParser::readObjFlags() const
+QString DeviceIniParser::toString(const QByteArray &value)
 {
-    QString objFlags = _file->value("ObjFlags").toString();
-
-    int base = 10;
-    if (objFlags.startsWith("0x"))
-    {
-        base = 16;
-    }
-
-    bool ok = false;
-    return static_cast<uint32_t>(objFlags.toInt(&ok, base));
+    return QString::fromLatin1(value.constData(), value.size());
 }
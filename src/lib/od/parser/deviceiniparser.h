@@ -21,35 +21,65 @@
 
 #include "od_global.h"
 
-#include <QSettings>
-#include <QTextStream>
+#include <QList>
+#include <QPair>
 
+#include "deviceinitokenizer.h"
 #include "model/deviceconfiguration.h"
 #include "model/devicedescription.h"
 
 class DeviceIniParser
 {
 public:
-    DeviceIniParser(QSettings *file);
+    DeviceIniParser(DeviceIniTokenizer *tokenizer);
+    ~DeviceIniParser();
+
+    bool readObject(DeviceModel *deviceModel);
+    void endObjects(DeviceModel *deviceModel);
+    static bool hasIdentity(const DeviceModel *deviceModel);
+    static bool isIdentitySection(const QByteArray &section);
 
-    void readObjects(DeviceModel *deviceModel) const;
-    void readIndexes(DeviceModel *deviceModel) const;
-    void readSubIndexes(DeviceModel *deviceModel) const;
     void readIndex(Index *index) const;
     void readSubIndex(SubIndex *subIndex) const;
-    QVariant readData(bool *nodeId, bool *isHexValue) const;
     void readFileInfo(DeviceModel *deviceModel) const;
     void readDummyUsage(DeviceModel *deviceModel) const;
     void readComments(DeviceModel *deviceModel) const;
     void readDeviceInfo(DeviceDescription *deviceDescription) const;
     void readDeviceComissioning(DeviceConfiguration *deviceConfiguration) const;
-    uint8_t readPdoMapping() const;
-    QVariant readLowLimit() const;
-    QVariant readHighLimit() const;
-    uint16_t readDataType() const;
-    uint32_t readObjFlags() const;
 
-    QSettings *_file;
+    static bool parseIndexSection(const QByteArray &section, uint16_t *index);
+    static bool parseSubIndexSection(const QByteArray &section, uint16_t *index, uint8_t *subIndex);
+
+private:
+    DeviceIniTokenizer *_tokenizer;
+    QList<QPair<uint16_t, SubIndex *>> _pendingSubIndexes;  // sub-indexes read before their index
+
+    // raw values of an object section, null if absent
+    struct ObjectFields
+    {
+        QByteArray parameterName;
+        QByteArray objectType;
+        QByteArray subNumber;
+        QByteArray accessType;
+        QByteArray pdoMapping;
+        QByteArray lowLimit;
+        QByteArray highLimit;
+        QByteArray dataType;
+        QByteArray objFlags;
+        QByteArray defaultValue;
+    };
+    ObjectFields readFields() const;
+    void fillSubIndex(SubIndex *subIndex, const ObjectFields &fields) const;
+
+    QVariant readData(const ObjectFields &fields, bool *nodeId, bool *isHexValue) const;
+    uint8_t readAccessType(const ObjectFields &fields) const;
+    uint8_t readPdoMapping(const ObjectFields &fields) const;
+    uint16_t readDataType(const ObjectFields &fields) const;
+    uint32_t readObjFlags(const ObjectFields &fields) const;
+
+    static bool isHex(const QByteArray &value);
+    static uint toUInt(const QByteArray &value);
+    static QString toString(const QByteArray &value);
 };
 
 #endif  // DEVICEINIPARSER_H
@@ -0,0 +1,227 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2019-2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "deviceinitokenizer.h"
+
+#include <cstring>
+
+DeviceIniTokenizer::DeviceIniTokenizer()
+{
+    _map = nullptr;
+    _pos = nullptr;
+    _end = nullptr;
+}
+
+DeviceIniTokenizer::~DeviceIniTokenizer()
+{
+    close();
+}
+
+/**
+ * @brief maps the file in memory, reads it when mapping is not available
+ * @param file path
+ * @return false if the file cannot be opened
+ */
+bool DeviceIniTokenizer::open(const QString &path)
+{
+    close();
+
+    _file.setFileName(path);
+    if (!_file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    const qint64 size = _file.size();
+    if (size > 0)
+    {
+        _map = _file.map(0, size);
+    }
+    if (_map != nullptr)
+    {
+        _pos = reinterpret_cast<const char *>(_map);
+        _end = _pos + size;
+    }
+    else
+    {
+        _content = _file.readAll();
+        _pos = _content.constData();
+        _end = _pos + _content.size();
+    }
+
+    // UTF-8 BOM
+    if (_end - _pos >= 3 && static_cast<uchar>(_pos[0]) == 0xEF && static_cast<uchar>(_pos[1]) == 0xBB && static_cast<uchar>(_pos[2]) == 0xBF)
+    {
+        _pos += 3;
+    }
+    return true;
+}
+
+void DeviceIniTokenizer::close()
+{
+    _section.clear();
+    _key.clear();
+    _value.clear();
+    if (_map != nullptr)
+    {
+        _file.unmap(_map);
+        _map = nullptr;
+    }
+    _content.clear();
+    _file.close();
+    _pos = nullptr;
+    _end = nullptr;
+}
+
+/**
+ * @brief moves to the next section, remaining keys of the current one are skipped
+ * @return false at the end of file
+ */
+bool DeviceIniTokenizer::nextSection()
+{
+    const char *begin = nullptr;
+    const char *end = nullptr;
+    while (readLine(&begin, &end))
+    {
+        if (*begin != '[')
+        {
+            continue;
+        }
+
+        begin++;
+        const char *close = begin;
+        while (close < end && *close != ']')
+        {
+            close++;
+        }
+        trim(&begin, &close);
+        _section = QByteArray::fromRawData(begin, static_cast<int>(close - begin));
+        _key.clear();
+        _value.clear();
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief reads the next key/value pair of the current section
+ * @return false at the end of the section
+ */
+bool DeviceIniTokenizer::nextKey()
+{
+    const char *lineStart = _pos;
+    const char *begin = nullptr;
+    const char *end = nullptr;
+    while (readLine(&begin, &end))
+    {
+        if (*begin == '[')
+        {
+            _pos = lineStart;  // kept for nextSection()
+            return false;
+        }
+
+        const char *equal = static_cast<const char *>(memchr(begin, '=', static_cast<size_t>(end - begin)));
+        lineStart = _pos;
+        if (equal == nullptr)
+        {
+            continue;
+        }
+
+        const char *keyEnd = equal;
+        trim(&begin, &keyEnd);
+        const char *valueBegin = equal + 1;
+        trim(&valueBegin, &end);
+        if (end - valueBegin >= 2 && *valueBegin == '"' && *(end - 1) == '"')
+        {
+            valueBegin++;
+            end--;
+        }
+
+        _key = QByteArray::fromRawData(begin, static_cast<int>(keyEnd - begin));
+        _value = QByteArray::fromRawData(valueBegin, static_cast<int>(end - valueBegin));
+        return true;
+    }
+    return false;
+}
+
+const QByteArray &DeviceIniTokenizer::section() const
+{
+    return _section;
+}
+
+const QByteArray &DeviceIniTokenizer::key() const
+{
+    return _key;
+}
+
+const QByteArray &DeviceIniTokenizer::value() const
+{
+    return _value;
+}
+
+/**
+ * @brief case insensitive comparison of a token with a name, as keys and sections of EDS files
+ */
+bool DeviceIniTokenizer::equals(const QByteArray &token, const char *name)
+{
+    const uint length = qstrlen(name);
+    return static_cast<uint>(token.size()) == length && qstrnicmp(token.constData(), name, length) == 0;
+}
+
+/**
+ * @brief returns the next non empty and non comment line, trimmed
+ */
+bool DeviceIniTokenizer::readLine(const char **begin, const char **end)
+{
+    while (_pos < _end)
+    {
+        const char *lineBegin = _pos;
+        const char *lineEnd = static_cast<const char *>(memchr(_pos, '\n', static_cast<size_t>(_end - _pos)));
+        if (lineEnd == nullptr)
+        {
+            lineEnd = _end;
+            _pos = _end;
+        }
+        else
+        {
+            _pos = lineEnd + 1;
+        }
+
+        trim(&lineBegin, &lineEnd);
+        if (lineBegin == lineEnd || *lineBegin == ';' || *lineBegin == '#')
+        {
+            continue;
+        }
+        *begin = lineBegin;
+        *end = lineEnd;
+        return true;
+    }
+    return false;
+}
+
+void DeviceIniTokenizer::trim(const char **begin, const char **end)
+{
+    while (*begin < *end && (**begin == ' ' || **begin == '\t' || **begin == '\r'))
+    {
+        (*begin)++;
+    }
+    while (*end > *begin && (*(*end - 1) == ' ' || *(*end - 1) == '\t' || *(*end - 1) == '\r'))
+    {
+        (*end)--;
+    }
+}
@@ -0,0 +1,69 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2019-2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef DEVICEINITOKENIZER_H
+#define DEVICEINITOKENIZER_H
+
+#include "od_global.h"
+
+#include <QByteArray>
+#include <QFile>
+
+/**
+ * @brief Single pass tokenizer of EDS/DCF ini files
+ *
+ * The file is memory mapped, sections and key/value pairs are returned as raw
+ * QByteArray views of the mapped content, valid until the file is closed. Keys
+ * and values are trimmed, lines starting with ';' or '#' are comments.
+ */
+class DeviceIniTokenizer
+{
+public:
+    DeviceIniTokenizer();
+    ~DeviceIniTokenizer();
+
+    bool open(const QString &path);
+    void close();
+
+    bool nextSection();
+    bool nextKey();
+
+    const QByteArray &section() const;
+    const QByteArray &key() const;
+    const QByteArray &value() const;
+
+    static bool equals(const QByteArray &token, const char *name);
+
+private:
+    Q_DISABLE_COPY(DeviceIniTokenizer)
+
+    QFile _file;
+    uchar *_map;
+    QByteArray _content;  // file content when mapping is not possible
+    const char *_pos;
+    const char *_end;
+
+    QByteArray _section;
+    QByteArray _key;
+    QByteArray _value;
+
+    bool readLine(const char **begin, const char **end);
+    static void trim(const char **begin, const char **end);
+};
+
+#endif  // DEVICEINITOKENIZER_H
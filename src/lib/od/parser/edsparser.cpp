@@ -18,11 +18,8 @@
 
 #include "edsparser.h"
 
-#include <QFile>
-#include <QRegularExpression>
-#include <QSettings>
-
 #include "deviceiniparser.h"
+#include "deviceinitokenizer.h"
 
 /**
  * @brief default constructor
@@ -45,54 +42,79 @@ EdsParser::~EdsParser()
  */
 DeviceDescription *EdsParser::parse(const QString &path) const
 {
-    if (!QFile(path).exists())
+    return parseFile(path, false);
+}
+
+/**
+ * @brief parse only the header of a .eds file, infos, device type [1000] and identity [1018subN]
+ *
+ * Parsing stops as soon as identity objects are read, intended to index a
+ * library of eds files.
+ * @param eds file name
+ * @return device descritpion model with only header objects
+ */
+DeviceDescription *EdsParser::parseHeader(const QString &path) const
+{
+    return parseFile(path, true);
+}
+
+DeviceDescription *EdsParser::parseFile(const QString &path, bool headerOnly) const
+{
+    DeviceIniTokenizer tokenizer;
+    if (!tokenizer.open(path))
     {
         return nullptr;
     }
 
     DeviceDescription *deviceDescription = new DeviceDescription();
+    DeviceIniParser parser(&tokenizer);
 
-    QSettings iniFile(path, QSettings::IniFormat);
-    DeviceIniParser parser(&iniFile);
-
-    // infos
-    for (const QString &group : iniFile.childGroups())
+    while (tokenizer.nextSection())
     {
-        if (group == "DeviceInfo")
+        const QByteArray &section = tokenizer.section();
+
+        // infos
+        if (DeviceIniTokenizer::equals(section, "DeviceInfo"))
         {
-            iniFile.beginGroup(group);
             parser.readDeviceInfo(deviceDescription);
-            iniFile.endGroup();
             continue;
         }
 
-        if (group == "FileInfo")
+        if (DeviceIniTokenizer::equals(section, "FileInfo"))
         {
-            iniFile.beginGroup(group);
             parser.readFileInfo(deviceDescription);
-            iniFile.endGroup();
             continue;
         }
 
-        if (group == "DummyUsage")
+        if (headerOnly)
+        {
+            if (DeviceIniParser::isIdentitySection(section))
+            {
+                parser.readObject(deviceDescription);
+                if (DeviceIniParser::hasIdentity(deviceDescription))
+                {
+                    break;
+                }
+            }
+            continue;
+        }
+
+        if (DeviceIniTokenizer::equals(section, "DummyUsage"))
         {
-            iniFile.beginGroup(group);
             parser.readDummyUsage(deviceDescription);
-            iniFile.endGroup();
             continue;
         }
 
-        if (group == "Comments")
+        if (DeviceIniTokenizer::equals(section, "Comments"))
         {
-            iniFile.beginGroup(group);
             parser.readComments(deviceDescription);
-            iniFile.endGroup();
             continue;
         }
-    }
 
-    // objects
-    parser.readObjects(deviceDescription);
+        // objects
+        parser.readObject(deviceDescription);
+    }
+    parser.endObjects(deviceDescription);
 
     return deviceDescription;
 }
@@ -30,6 +30,10 @@ public:
     ~EdsParser() override;
 
     DeviceDescription *parse(const QString &path) const override;
+    DeviceDescription *parseHeader(const QString &path) const;
+
+private:
+    DeviceDescription *parseFile(const QString &path, bool headerOnly) const;
 };
 
 #endif  // EDSPARSER_H
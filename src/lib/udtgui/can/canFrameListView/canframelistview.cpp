@@ -64,7 +64,7 @@ CanFrameListView::CanFrameListView(QWidget *parent)
     createActions();
 }
 
-void CanFrameListView::appendCanFrame(const QCanBusFrame &frame)
+void CanFrameListView::appendCanFrame(const CanFrame &frame)
 {
     bool needToScroll = (verticalScrollBar()->value() >= verticalScrollBar()->maximum() - rowHeight(0));
     _canModel->appendCanFrame(frame);
@@ -21,7 +21,7 @@
 
 #include "../../udtgui_global.h"
 
-#include "busdriver/qcanbusframe.h"
+#include "busdriver/canframe.h"
 #include <QAction>
 #include <QTableView>
 
@@ -41,7 +41,7 @@ public:
     QAction *copyAction() const;
 
 public slots:
-    void appendCanFrame(const QCanBusFrame &frame);
+    void appendCanFrame(const CanFrame &frame);
     void clear();
     void copy();
 
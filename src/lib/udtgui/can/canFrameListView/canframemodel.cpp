@@ -28,19 +28,20 @@ CanFrameModel::CanFrameModel(QObject *parent)
     : QAbstractItemModel(parent)
 {
     _bus = nullptr;
-    _frameId = 0;
+    _firstId = 0;
+    _endId = 0;
 }
 
 CanFrameModel::~CanFrameModel()
 {
 }
 
-void CanFrameModel::appendCanFrame(const QCanBusFrame &frame)
+void CanFrameModel::appendCanFrame(const CanFrame &frame)
 {
     beginInsertRows(QModelIndex(), _frames.count(), _frames.count());
     if (_frames.isEmpty())
     {
-        _startTime = frame.timeStamp().seconds();
+        _startTime = frame.timeStamp() / 1000000;
     }
     _frames.append(frame);
     endInsertRows();
@@ -50,6 +51,7 @@ void CanFrameModel::clear()
 {
     emit layoutAboutToBeChanged();
     _frames.clear();
+    _firstId = _endId;
     emit layoutChanged();
 }
 
@@ -66,16 +68,60 @@ void CanFrameModel::setBus(CanOpenBus *bus)
         disconnect(_bus, &CanOpenBus::frameAvailable, this, &CanFrameModel::updateFrames);
     }
     _bus = bus;
-    _frameId = _bus->canFramesLog().count();
+    _firstId = _bus->frameJournal()->firstId();
+    _endId = _bus->frameJournal()->endId();
     connect(bus, &CanOpenBus::frameAvailable, this, &CanFrameModel::updateFrames);
     emit layoutChanged();
 }
 
-void CanFrameModel::updateFrames(int id)
+void CanFrameModel::updateFrames(quint64 endId)
 {
-    beginInsertRows(QModelIndex(), _frameId, id - 1);
-    _frameId = id;
-    endInsertRows();
+    quint64 journalFirstId = _bus->frameJournal()->firstId();
+
+    // frames dropped by journal retention
+    if (journalFirstId > _firstId)
+    {
+        quint64 removed = qMin(journalFirstId, _endId) - _firstId;
+        if (removed > 0)
+        {
+            beginRemoveRows(QModelIndex(), 0, static_cast<int>(removed - 1));
+            _firstId += removed;
+            endRemoveRows();
+        }
+        _firstId = journalFirstId;
+        _endId = qMax(_endId, journalFirstId);
+    }
+
+    if (endId > _endId)
+    {
+        beginInsertRows(QModelIndex(), static_cast<int>(_endId - _firstId), static_cast<int>(endId - _firstId - 1));
+        _endId = endId;
+        endInsertRows();
+    }
+}
+
+const CanFrame *CanFrameModel::frameAt(int row) const
+{
+    if (row < 0)
+    {
+        return nullptr;
+    }
+    if (_bus == nullptr)
+    {
+        // internal data mode
+        if (row >= _frames.count())
+        {
+            return nullptr;
+        }
+        return &_frames.at(row);
+    }
+
+    // bus data mode, read in place from journal
+    if (static_cast<quint64>(row) >= _endId - _firstId)
+    {
+        return nullptr;
+    }
+    return _bus->frameJournal()->frame(_firstId + static_cast<quint64>(row));
 }
 
 int CanFrameModel::columnCount(const QModelIndex &parent) const
@@ -116,23 +162,12 @@ QVariant CanFrameModel::data(const QModelIndex &index, int role) const
         return QVariant();
     }
 
-    if (_bus == nullptr)
+    const CanFrame *canFramePtr = frameAt(index.row());
+    if (canFramePtr == nullptr)
     {
-        // internal data mode
-        if (index.row() >= _frames.count())
-        {
-            return QVariant();
-        }
-    }
-    else
-    {
-        // bus data mode
-        if (index.row() >= _frameId)
-        {
-            return QVariant();
-        }
+        return QVariant();
     }
-    const QCanBusFrame &canFrame = (_bus == nullptr) ? _frames.at(index.row()) : _bus->canFramesLog().at(index.row());
+    const CanFrame &canFrame = *canFramePtr;
 
     switch (role)
     {
@@ -141,7 +176,7 @@ QVariant CanFrameModel::data(const QModelIndex &index, int role) const
             {
                 case Time:
                     return QVariant(
-                        QString("%1.%2").arg(canFrame.timeStamp().seconds() - _startTime).arg(QString::number(canFrame.timeStamp().microSeconds() / 1000).rightJustified(3, '0')));
+                        QString("%1.%2").arg(canFrame.timeStamp() / 1000000 - _startTime).arg(QString::number((canFrame.timeStamp() % 1000000) / 1000).rightJustified(3, '0')));
 
                 case CanId:
                     return QVariant(QString("0x%1 (%2)").arg(QString::number(canFrame.frameId(), 16)).arg(canFrame.frameId()));
@@ -149,21 +184,21 @@ QVariant CanFrameModel::data(const QModelIndex &index, int role) const
                 case Type:
                     switch (canFrame.frameType())
                     {
-                        case QCanBusFrame::UnknownFrame:
+                        case CanFrame::UnknownFrame:
                             return QVariant(tr("unk"));
-                        case QCanBusFrame::DataFrame:
-                            return QVariant(tr("Dat(%1)").arg(canFrame.payload().count()));
-                        case QCanBusFrame::ErrorFrame:
+                        case CanFrame::DataFrame:
+                            return QVariant(tr("Dat(%1)").arg(canFrame.size()));
+                        case CanFrame::ErrorFrame:
                             return QVariant(tr("Err"));
-                        case QCanBusFrame::RemoteRequestFrame:
+                        case CanFrame::RemoteRequestFrame:
                             return QVariant(tr("RTR"));
-                        case QCanBusFrame::InvalidFrame:
+                        case CanFrame::InvalidFrame:
                             return QVariant(tr("NV"));
                     }
                     return QVariant();
 
                 case DataByte:
-                    return QVariant(canFrame.payload().toHex(' ').toUpper());
+                    return QVariant(QByteArray::fromRawData(reinterpret_cast<const char *>(canFrame.data()), canFrame.size()).toHex(' ').toUpper());
 
                 default:
                     return QVariant();
@@ -222,7 +257,7 @@ QModelIndex CanFrameModel::index(int row, int column, const QModelIndex &parent)
     else
     {
         // bus data mode
-        if (row >= _frameId)
+        if (static_cast<quint64>(row) >= _endId - _firstId)
         {
             return QModelIndex();
         }
@@ -244,7 +279,7 @@ int CanFrameModel::rowCount(const QModelIndex &parent) const
         {
             return _frames.count();
         }
-        return _frameId;
+        return static_cast<int>(_endId - _firstId);
     }
     return 0;
 }
@@ -22,8 +22,9 @@
 #include "../../udtgui_global.h"
 
 #include <QAbstractItemModel>
+#include <QVector>
 
-#include "busdriver/qcanbusframe.h"
+#include "busdriver/canframe.h"
 
 #include "canopenbus.h"
 
@@ -34,7 +35,7 @@ public:
     CanFrameModel(QObject *parent = nullptr);
     ~CanFrameModel() override;
 
-    void appendCanFrame(const QCanBusFrame &frame);
+    void appendCanFrame(const CanFrame &frame);
     void clear();
 
     CanOpenBus *bus() const;
@@ -50,7 +51,7 @@ public:
     };
 
 protected slots:
-    void updateFrames(int id);
+    void updateFrames(quint64 endId);
 
     // QAbstractItemModel interface
 public:
@@ -65,9 +66,12 @@ public:
 private:
     qint64 _startTime;
 
-    QList<QCanBusFrame> _frames;
+    QVector<CanFrame> _frames;
 
-    int _frameId;
+    const CanFrame *frameAt(int row) const;
+
+    quint64 _firstId;
+    quint64 _endId;
     CanOpenBus *_bus;
 };
 
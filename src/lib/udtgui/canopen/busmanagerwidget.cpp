@@ -90,15 +90,15 @@ void BusManagerWidget::togleConnect()
 {
     if (_bus != nullptr)
     {
-        if (_bus->canBusDriver() != nullptr)
+        if (_bus->hasDriver())
         {
             if (_bus->isConnected())
             {
-                _bus->canBusDriver()->disconnectDevice();
+                _bus->disconnectDevice();
             }
             else
             {
-                _bus->canBusDriver()->connectDevice();
+                _bus->connectDevice();
             }
         }
     }
@@ -116,7 +116,7 @@ void BusNodesTreeView::indexDbClick(const QModelIndex &index)
     {
         if (!bus->isConnected())
         {
-            bus->canBusDriver()->connectDevice();
+            bus->connectDevice();
         }
         if (bus->isConnected() && bus->nodes().isEmpty())
         {
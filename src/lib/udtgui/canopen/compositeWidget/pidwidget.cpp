@@ -40,7 +40,6 @@ PidWidget::PidWidget(QWidget *parent)
     _nodeProfile402 = nullptr;
     createWidgets();
     connect(&_timerTest, &QTimer::timeout, this, &PidWidget::manageMeasurement);
-    connect(&_readStatusTimer, &QTimer::timeout, this, &PidWidget::readStatus);
     _state = NONE;
     _modePid = MODE_PID_NONE;
 }
@@ -106,14 +105,7 @@ void PidWidget::setMode(PidWidget::ModePid mode)
 
 void PidWidget::toggleStartLogger(bool start)
 {
-    if (start)
-    {
-        _readStatusTimer.start();
-    }
-    else
-    {
-        _readStatusTimer.stop();
-    }
+    setStatusRefreshPeriod(start ? _logTimerSpinBox->value() : 0);
 }
 
 void PidWidget::setLogTimer(int ms)
@@ -121,6 +113,7 @@ void PidWidget::setLogTimer(int ms)
     if (_dataLogger->isStarted())
     {
         _dataLogger->start(ms);
+        setStatusRefreshPeriod(ms);
     }
 }
 
@@ -332,7 +325,8 @@ void PidWidget::manageMeasurement()
             _dataLogger->clear();
             _dataLogger->start(10);
             _timerTest.start(10);
-            _readStatusTimer.start(10);
+            node()->readObject(_actualValue_ObjId);
+            setStatusRefreshPeriod(10);
             _state = LAUCH_DATALOGGER;
             break;
 
@@ -355,7 +349,7 @@ void PidWidget::manageMeasurement()
 
         case PidWidget::STOP_DATALOGGER:
             stopDataLogger();
-            _readStatusTimer.stop();
+            setStatusRefreshPeriod(0);
             _state = NONE;
             break;
     }
@@ -432,14 +426,16 @@ void PidWidget::stopDataLogger()
     disconnect(_nodeProfile402, &NodeProfile402::modeChanged, this, &PidWidget::updateMode);
 }
 
-void PidWidget::readStatus()
+/**
+ * @brief PID status labels are refreshed at the given period, 0 to stop
+ */
+void PidWidget::setStatusRefreshPeriod(int ms)
 {
-    node()->readObject(_actualValue_ObjId);
-    _inputLabel->readObject();
-    _errorLabel->readObject();
-    _integratorLabel->readObject();
-    _outputLabel->readObject();
-    _targetLabel->readObject();
+    _inputLabel->setAutoRefresh(ms);
+    _errorLabel->setAutoRefresh(ms);
+    _integratorLabel->setAutoRefresh(ms);
+    _outputLabel->setAutoRefresh(ms);
+    _targetLabel->setAutoRefresh(ms);
 }
 
 void PidWidget::readAllObject()
@@ -73,8 +73,6 @@ protected:
     NodeProfile402 *_nodeProfile402;
     ModePid _modePid;
 
-    QTimer _readStatusTimer;
-
     DataLogger *_dataLogger;
     DataLoggerWidget *_dataLoggerWidget;
 
@@ -144,7 +142,7 @@ protected:
     void stopSecondMeasurement();
     void stopMeasurement();
     void stopDataLogger();
-    void readStatus();
+    void setStatusRefreshPeriod(int ms);
     void readAllObject();
     void statusNodeChanged(Node::Status status);
 
@@ -72,6 +72,16 @@ DataLoggerChartsWidget::DataLoggerChartsWidget(DataLogger *dataLogger, QWidget *
     setDataLogger(dataLogger);
     _idPending = -1;
 
+    // pan, zoom and resize render again the visible range, coalesced in one render per event loop
+    _renderedFromUs = 0;
+    _renderedToUs = 0;
+    _renderedWidth = 0;
+    _renderTimer.setSingleShot(true);
+    _renderTimer.setInterval(0);
+    connect(&_renderTimer, &QTimer::timeout, this, &DataLoggerChartsWidget::renderSeries);
+    connect(_axisX, &QDateTimeAxis::rangeChanged, &_renderTimer, QOverload<>::of(&QTimer::start));
+    connect(_chart, &QChart::plotAreaChanged, &_renderTimer, QOverload<>::of(&QTimer::start));
+
     setUseOpenGL(true);
 
     connect(&_updateTimer, &QTimer::timeout, this, &DataLoggerChartsWidget::updateSeries);
@@ -100,6 +110,7 @@ void DataLoggerChartsWidget::setDataLogger(DataLogger *dataLogger)
             connect(dataLogger, &DataLogger::dataAdded, this, &DataLoggerChartsWidget::addDataOk);
             connect(dataLogger, &DataLogger::dataAboutToBeRemoved, this, &DataLoggerChartsWidget::removeDataPrepare);
             connect(dataLogger, &DataLogger::dataRemoved, this, &DataLoggerChartsWidget::removeDataOk);
+            connect(dataLogger, &DataLogger::dataChanged, this, &DataLoggerChartsWidget::updateDlData);
         }
     }
     _dataLogger = dataLogger;
@@ -179,48 +190,13 @@ void DataLoggerChartsWidget::setRollingTimeMs(int rollingTimeMs)
 
 void DataLoggerChartsWidget::updateDlData(int id)
 {
-    if (id >= _series.count())
-    {
-        return;
-    }
-
-    DLData *dlData = _dataLogger->data(id);
-    QXYSeries *serie = _series[id];
-    if (dlData->values().count() < serie->count())
+    if (id < 0 || id >= _series.count())
     {
-        serie->clear();
         return;
     }
 
-    // serie->append(dlData->lastDateTime().toMSecsSinceEpoch(), dlData->lastValue());
-
-    if (serie->color() != dlData->color())
-    {
-        serie->setPen(QPen(dlData->color(), 2));
-    }
-
-    updateYaxis();
-
-    qreal min = _dataLogger->min();
-    qreal max = _dataLogger->max();
-    if (min == max)
-    {
-        min -= 0.5;
-        max += 0.5;
-    }
-    if (min < _axisY->min() || min > _axisY->min() || max > _axisY->max() || max < _axisY->max())
-    {
-        _axisY->setRange(min, max);
-        _axisY->applyNiceNumbers();
-        if (_axisY->tickCount() < 4)
-        {
-            _axisY->setMinorTickCount(1);
-        }
-        else
-        {
-            _axisY->setMinorTickCount(0);
-        }
-    }
+    _serieRenderedCounts[id] = -1;
+    _renderTimer.start();
 }
 
 void DataLoggerChartsWidget::addDataPrepare(int id)
@@ -250,7 +226,8 @@ void DataLoggerChartsWidget::addDataOk()
         serie->attachAxis(_axisX);
         serie->attachAxis(_axisY);
         _series.append(serie);
-        _serieLastDates.append(0);
+        _serieRenderedCounts.append(-1);
+        _renderTimer.start();
 
         connect(serie, &QLineSeries::hovered, this, &DataLoggerChartsWidget::tooltip);
     }
@@ -264,7 +241,7 @@ void DataLoggerChartsWidget::removeDataPrepare(int id)
         QXYSeries *serie = _series.at(id);
         _chart->removeSeries(serie);
         _series.removeAt(id);
-        _serieLastDates.removeAt(id);
+        _serieRenderedCounts.removeAt(id);
         serie->deleteLater();
     }
 }
@@ -304,54 +281,141 @@ void DataLoggerChartsWidget::tooltip(QPointF point, bool state)
 
 void DataLoggerChartsWidget::updateSeries()
 {
-    if (_dataLogger == nullptr)
+    if (_dataLogger == nullptr || _series.isEmpty())
     {
         _updateTimer.start();
         return;
     }
-    if (!_dataLogger->isStarted())
+
+    for (int idSerie = 0; idSerie < _series.count(); idSerie++)
+    {
+        const QColor &color = _dataLogger->data(idSerie)->color();
+        if (_series[idSerie]->color() != color)
+        {
+            _series[idSerie]->setPen(QPen(color, 2));
+        }
+    }
+
+    updateYaxis();
+    renderSeries();
+    _updateTimer.start();
+}
+
+/**
+ * @brief Renders series on the visible time range, only if their data, the range or the plot width changed
+ */
+void DataLoggerChartsWidget::renderSeries()
+{
+    if (_dataLogger == nullptr || _series.isEmpty())
     {
-        _updateTimer.start();
         return;
     }
 
+    const qint64 fromUs = _axisX->min().toMSecsSinceEpoch() * 1000;
+    const qint64 toUs = _axisX->max().toMSecsSinceEpoch() * 1000;
+    const int width = qMax(1, qCeil(_chart->plotArea().width()));
+    const bool viewChanged = (fromUs != _renderedFromUs || toUs != _renderedToUs || width != _renderedWidth);
+
     setUpdatesEnabled(false);
 
+    bool rendered = false;
     for (int idSerie = 0; idSerie < _series.count(); idSerie++)
     {
-        DLData *dlData = _dataLogger->data(idSerie);
-        QXYSeries *serie = _series[idSerie];
+        const int count = _dataLogger->data(idSerie)->valuesCount();
+        if (viewChanged || count != _serieRenderedCounts[idSerie])
+        {
+            renderSerie(idSerie, fromUs, toUs, width);
+            _serieRenderedCounts[idSerie] = count;
+            rendered = true;
+        }
+    }
+    _renderedFromUs = fromUs;
+    _renderedToUs = toUs;
+    _renderedWidth = width;
+
+    if (rendered)
+    {
+        updateValueAxis(fromUs, toUs);
+    }
+
+    setUpdatesEnabled(true);
+}
+
+/**
+ * @brief Replaces points of a serie with the visible samples, or with their min/max envelope
+ * (two points per pixel column) if there are more samples than that
+ */
+void DataLoggerChartsWidget::renderSerie(int idSerie, qint64 fromUs, qint64 toUs, int width)
+{
+    const DLTimeSeries &dlSeries = _dataLogger->data(idSerie)->series();
 
-        qint64 lastDateSerie = _serieLastDates[idSerie];
-        qint64 lastDateDlData = dlData->lastDateTime().toMSecsSinceEpoch();
+    // one sample out of each side, lines are drawn up to plot borders
+    const int first = qMax(0, dlSeries.lowerBound(fromUs) - 1);
+    const int last = qMin(dlSeries.count(), dlSeries.lowerBound(toUs) + 1);
 
-        if (lastDateSerie < lastDateDlData)
+    QVector<QPointF> points;
+    if (last - first <= 2 * width)
+    {
+        points.reserve(last - first);
+        for (int i = first; i < last; i++)
         {
-            QList<QPointF> points;
-
-            QList<qreal>::const_iterator valuesIt = dlData->values().cend();
-            QList<QDateTime>::const_iterator timesIt = dlData->times().cend();
-            valuesIt--;
-            timesIt--;
-            while (lastDateSerie < timesIt->toMSecsSinceEpoch())
+            points.append(QPointF(dlSeries.time(i) / 1000, dlSeries.value(i)));
+        }
+    }
+    else
+    {
+        const QVector<DLTimeSeries::MinMaxBucket> buckets = dlSeries.minMaxBuckets(fromUs, toUs, width);
+        points.reserve(buckets.count() * 2 + 2);
+        if (dlSeries.time(first) < fromUs)
+        {
+            points.append(QPointF(dlSeries.time(first) / 1000, dlSeries.value(first)));
+        }
+        for (const DLTimeSeries::MinMaxBucket &bucket : buckets)
+        {
+            points.append(QPointF(bucket.time / 1000, bucket.min));
+            if (bucket.max != bucket.min)
             {
-                points.prepend(QPointF(timesIt->toMSecsSinceEpoch(), *valuesIt));
-                if (timesIt == dlData->times().cbegin())
-                {
-                    break;
-                }
-                valuesIt--;
-                timesIt--;
+                points.append(QPointF(bucket.time / 1000, bucket.max));
             }
-            serie->append(points);
-
-            _serieLastDates[idSerie] = lastDateDlData;
-            updateDlData(idSerie);
+        }
+        if (dlSeries.time(last - 1) >= toUs)
+        {
+            points.append(QPointF(dlSeries.time(last - 1) / 1000, dlSeries.value(last - 1)));
         }
     }
+    _series[idSerie]->replace(points);
+}
 
-    setUpdatesEnabled(true);
-    _updateTimer.start();
+/**
+ * @brief Fits value axis to the visible samples, extremums come from the series summaries
+ */
+void DataLoggerChartsWidget::updateValueAxis(qint64 fromUs, qint64 toUs)
+{
+    qreal min;
+    qreal max;
+    _dataLogger->range(fromUs, toUs, min, max);
+    if (min > max)
+    {
+        return;  // no visible sample
+    }
+    if (min == max)
+    {
+        min -= 0.5;
+        max += 0.5;
+    }
+    if (min != _axisY->min() || max != _axisY->max())
+    {
+        _axisY->setRange(min, max);
+        _axisY->applyNiceNumbers();
+        if (_axisY->tickCount() < 4)
+        {
+            _axisY->setMinorTickCount(1);
+        }
+        else
+        {
+            _axisY->setMinorTickCount(0);
+        }
+    }
 }
 
 void DataLoggerChartsWidget::dropEvent(QDropEvent *event)
@@ -77,6 +77,7 @@ signals:
 
 protected slots:
     void updateSeries();
+    void renderSeries();
     void updateDlData(int id);
 
     void addDataPrepare(int id);
@@ -95,9 +96,17 @@ private:
     QValueAxis *_axisY;
 
     QList<QXYSeries *> _series;
-    QList<qint64> _serieLastDates;
     QTimer _updateTimer;
 
+    // decimated rendering, at most two points per pixel column of the plot area
+    QList<int> _serieRenderedCounts;  // samples count when rendered, -1 to force a render
+    qint64 _renderedFromUs;
+    qint64 _renderedToUs;
+    int _renderedWidth;
+    QTimer _renderTimer;
+    void renderSerie(int idSerie, qint64 fromUs, qint64 toUs, int width);
+    void updateValueAxis(qint64 fromUs, qint64 toUs);
+
     int _idPending;
 
     bool _useOpenGL;
@@ -19,6 +19,7 @@
 #include "dataloggermanagerwidget.h"
 
 #include <QDir>
+#include <QFileDialog>
 #include <QHBoxLayout>
 #include <QStandardPaths>
 
@@ -115,6 +116,32 @@ void DataLoggerManagerWidget::exportAllCSVData()
     _logger->exportCSVData(path);
 }
 
+void DataLoggerManagerWidget::toggleCapture(bool capture)
+{
+    if (!capture)
+    {
+        _logger->stopCapture();
+        return;
+    }
+
+    QString path = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/UDTStudio/";
+    QDir().mkdir(path);
+    path += QDateTime::currentDateTime().toString("yyyy-MM-dd_hh-mm-ss");
+    path += "_capture.udl";
+    _logger->startCapture(path);
+}
+
+void DataLoggerManagerWidget::openCapture()
+{
+    QString path = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/UDTStudio/";
+    QString fileName = QFileDialog::getOpenFileName(this, tr("Open capture file"), path, tr("Capture file (*.udl)"));
+    if (fileName.isEmpty())
+    {
+        return;
+    }
+    _logger->loadCapture(fileName);
+}
+
 DataLoggerChartsWidget *DataLoggerManagerWidget::chartWidget() const
 {
     return _chartWidget;
@@ -279,6 +306,31 @@ void DataLoggerManagerWidget::createWidgets()
         tr("Exports all data entries in '%1' directory as a CSV file").arg(QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/UDTStudio/"));
     connect(_exportCSVAction, &QAction::triggered, this, &DataLoggerManagerWidget::exportAllCSVData);
 
+    // capture
+    _captureAction = _toolBar->addAction(tr("Capture to file"));
+    _captureAction->setCheckable(true);
+    _captureAction->setIcon(QIcon(":/icons/img/icons8-record.png"));
+    _captureAction->setStatusTip(
+        tr("Streams logged data to a capture file in '%1' directory").arg(QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/UDTStudio/"));
+    connect(_captureAction, &QAction::triggered, this, &DataLoggerManagerWidget::toggleCapture);
+    connect(_logger,
+            &DataLogger::captureChanged,
+            this,
+            [=](bool changed)
+            {
+                if (changed != _captureAction->isChecked())
+                {
+                    _captureAction->blockSignals(true);
+                    _captureAction->setChecked(changed);
+                    _captureAction->blockSignals(false);
+                }
+            });
+
+    _openCaptureAction = _toolBar->addAction(tr("Open capture file"));
+    _openCaptureAction->setIcon(QIcon(":/icons/img/icons8-import-file.png"));
+    _openCaptureAction->setStatusTip(tr("Replaces all data with a capture file content"));
+    connect(_openCaptureAction, &QAction::triggered, this, &DataLoggerManagerWidget::openCapture);
+
     // screenshot
     _screenShotAction = _toolBar->addAction(tr("Screenshot"));
     _screenShotAction->setEnabled(true);
@@ -52,6 +52,8 @@ protected slots:
 
     void takeScreenShot();
     void exportAllCSVData();
+    void toggleCapture(bool capture);
+    void openCapture();
 
 protected:
     DataLogger *_logger;
@@ -68,6 +70,8 @@ protected:
     QAction *_rollAction;
     QSpinBox *_rollingTimeSpinBox;
     QAction *_exportCSVAction;
+    QAction *_captureAction;
+    QAction *_openCaptureAction;
     QAction *_screenShotAction;
 };
 
@@ -41,8 +41,12 @@ AbstractIndexWidget::AbstractIndexWidget(const NodeObjectId &objId)
     _scale = 1.0;
 
     _requestRead = false;
+    _refreshPeriodMs = 0;
 
     _widget = nullptr;
+
+    // display only, PDO updates are refreshed once per NodeOd notify period
+    setNotifyMode(NotifyCoalesced);
 }
 
 Node *AbstractIndexWidget::node() const
@@ -424,6 +428,27 @@ void AbstractIndexWidget::readObject()
     nodeInterrest()->readObject(_objId);
 }
 
+int AbstractIndexWidget::autoRefresh() const
+{
+    return _refreshPeriodMs;
+}
+
+/**
+ * @brief Keeps the value up to date by reading it periodically, 0 to stop
+ *
+ * The refresh follows the node and the object of the widget, reads are shared
+ * with other subscribers of the same object.
+ * @param periodMs refresh period in ms
+ */
+void AbstractIndexWidget::setAutoRefresh(int periodMs)
+{
+    _refreshPeriodMs = qMax(periodMs, 0);
+    if (_objId.isASubIndex())
+    {
+        setRefreshPeriod(_objId.index(), _objId.subIndex(), _refreshPeriodMs);
+    }
+}
+
 const NodeObjectId &AbstractIndexWidget::objId() const
 {
     return _objId;
@@ -433,6 +458,7 @@ void AbstractIndexWidget::setObjId(const NodeObjectId &objId)
 {
     if (_objId.isValid())
     {
+        setRefreshPeriod(_objId.index(), _objId.subIndex(), 0);
         unRegisterObjId(_objId);
     }
     _objId = objId;
@@ -440,6 +466,7 @@ void AbstractIndexWidget::setObjId(const NodeObjectId &objId)
     if (objId.isASubIndex())
     {
         registerObjId(_objId);
+        setRefreshPeriod(_objId.index(), _objId.subIndex(), _refreshPeriodMs);
     }
     Node *node = _objId.node();
     if (node != nullptr)
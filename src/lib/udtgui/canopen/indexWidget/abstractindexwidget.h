@@ -79,6 +79,9 @@ public:
 
     void readObject();
 
+    int autoRefresh() const;
+    void setAutoRefresh(int periodMs);
+
 protected:
     enum DisplayAttribute
     {
@@ -113,6 +116,7 @@ protected:
     QVariant _lastValue;
     QVariant _pendingValue;
     bool _requestRead;
+    int _refreshPeriodMs;
 
     DisplayHint _hint;
     uint64_t _bitMask;
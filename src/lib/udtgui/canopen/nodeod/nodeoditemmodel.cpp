@@ -28,6 +28,7 @@ NodeOdItemModel::NodeOdItemModel(QObject *parent)
     _root = nullptr;
     _node = nullptr;
 
+    setNotifyMode(NotifyCoalesced);
     registerFullOd();
 }
 
@@ -133,6 +134,7 @@ void NodeOdItemModel::setNode(Node *node)
     if (_node != nullptr)
     {
         disconnect(_node, nullptr, this, nullptr);
+        disconnect(_node->nodeOd(), nullptr, this, nullptr);
     }
 
     _node = node;
@@ -141,6 +143,7 @@ void NodeOdItemModel::setNode(Node *node)
     if (_node != nullptr)
     {
         _root = new NodeOdItem(_node->nodeOd());
+        connect(_node->nodeOd(), &NodeOd::objectsRead, this, &NodeOdItemModel::updateObjects);
         connect(_node,
                 &QObject::destroyed,
                 this,
@@ -385,6 +388,62 @@ void NodeOdItemModel::odNotify(const NodeObjectId &objId, NodeOd::FlagsRequest f
     }
 }
 
+void NodeOdItemModel::odNotifyChanged(const QList<NodeObjectId> &objIds)
+{
+    updateSubIndexRanges(objIds);
+}
+
+/**
+ * @brief Batch read results
+ */
+void NodeOdItemModel::updateObjects(quint32 batchId, const QList<NodeOd::ReadResult> &results)
+{
+    Q_UNUSED(batchId)
+
+    QList<NodeObjectId> objIds;
+    objIds.reserve(results.count());
+    for (const NodeOd::ReadResult &result : results)
+    {
+        objIds.append(result.objectId);
+    }
+    updateSubIndexRanges(objIds);
+}
+
+/**
+ * @brief One dataChanged per index instead of one per subindex
+ */
+void NodeOdItemModel::updateSubIndexRanges(const QList<NodeObjectId> &objIds)
+{
+    QMap<quint16, QPair<quint8, quint8>> subIndexRanges;
+    for (const NodeObjectId &objId : objIds)
+    {
+        quint16 index = objId.index();
+        quint8 subIndex = objId.subIndex();
+        QMap<quint16, QPair<quint8, quint8>>::iterator itRange = subIndexRanges.find(index);
+        if (itRange == subIndexRanges.end())
+        {
+            subIndexRanges.insert(index, qMakePair(subIndex, subIndex));
+        }
+        else
+        {
+            itRange.value().first = qMin(itRange.value().first, subIndex);
+            itRange.value().second = qMax(itRange.value().second, subIndex);
+        }
+    }
+
+    QMap<quint16, QPair<quint8, quint8>>::const_iterator itRange = subIndexRanges.cbegin();
+    while (itRange != subIndexRanges.cend())
+    {
+        QModelIndex modelIndexStart = subIndexItem(itRange.key(), itRange.value().first, Value);
+        QModelIndex modelIndexEnd = subIndexItem(itRange.key(), itRange.value().second, ColumnCount - 1);
+        if (modelIndexStart.isValid() && modelIndexEnd.isValid() && modelIndexStart.parent() == modelIndexEnd.parent())
+        {
+            emit dataChanged(modelIndexStart, modelIndexEnd);
+        }
+        ++itRange;
+    }
+}
+
 QStringList NodeOdItemModel::mimeTypes() const
 {
     QStringList types;
@@ -82,10 +82,15 @@ public:
     // NodeOdSubscriber interface
 protected:
     void odNotify(const NodeObjectId &objId, NodeOd::FlagsRequest flags) override;
+    void odNotifyChanged(const QList<NodeObjectId> &objIds) override;
+
+protected slots:
+    void updateObjects(quint32 batchId, const QList<NodeOd::ReadResult> &results);
 
 protected:
     QModelIndex indexItem(quint16 index, int col);
     QModelIndex subIndexItem(quint16 index, quint8 subindex, int col);
+    void updateSubIndexRanges(const QList<NodeObjectId> &objIds);
 
 private:
     NodeOdItem *_root;
@@ -181,6 +181,12 @@ void NodeOdTreeView::setFilter(const QString &filterText)
 
 void NodeOdTreeView::readSelected()
 {
+    if (_odModel->node() == nullptr)
+    {
+        return;
+    }
+
+    QList<NodeObjectId> objectIds;
     QModelIndexList selectedRows = selectionModel()->selectedRows();
     for (QModelIndex row : qAsConst(selectedRows))
     {
@@ -193,7 +199,7 @@ void NodeOdTreeView::readSelected()
             {
                 if (subIndexN->isReadable())
                 {
-                    _odModel->node()->readObject(nodeIndex->index(), subIndexN->subIndex());
+                    objectIds.append(NodeObjectId(nodeIndex->index(), subIndexN->subIndex()));
                 }
             }
             continue;
@@ -204,15 +210,22 @@ void NodeOdTreeView::readSelected()
         {
             if (nodeSubIndex->isReadable())
             {
-                _odModel->node()->readObject(nodeSubIndex->index(), nodeSubIndex->subIndex());
+                objectIds.append(NodeObjectId(nodeSubIndex->index(), nodeSubIndex->subIndex()));
             }
             continue;
         }
     }
+    _odModel->node()->readObjects(objectIds);
 }
 
 void NodeOdTreeView::readAll()
 {
+    if (_odModel->node() == nullptr)
+    {
+        return;
+    }
+
+    QList<NodeObjectId> objectIds;
     for (int i = 0; i < _odModelSorter->rowCount(); i++)
     {
         const QModelIndex &firstIndex = _odModelSorter->mapToSource(_odModelSorter->index(i, 0));
@@ -224,11 +237,12 @@ void NodeOdTreeView::readAll()
             {
                 if (subIndexN->isReadable())
                 {
-                    _odModel->node()->readObject(nodeIndex->index(), subIndexN->subIndex());
+                    objectIds.append(NodeObjectId(nodeIndex->index(), subIndexN->subIndex()));
                 }
             }
         }
     }
+    _odModel->node()->readObjects(objectIds);
 }
 
 void NodeOdTreeView::copy()
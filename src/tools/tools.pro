@@ -3,4 +3,5 @@ TEMPLATE = subdirs
 SUBDIRS += \
     cood \
     ubl \
-    uds
+    uds \
+    ufwbench
@@ -18,22 +18,25 @@
 
 #include "mainconsole.h"
 #include "bootloader/bootloader.h"
+#include "bootloader/ufwflasher.h"
 #include "node.h"
 
 #include <QDebug>
 #include <utility>
 
-MainConsole::MainConsole(quint8 busId, quint8 speed, quint8 nodeid, const QString &binary)
-    : _busId(busId)
-    , _speed(speed)
-    , _nodeId(nodeid)
-    , _binary(binary)
+MainConsole::MainConsole(Node *node)
+    : _node(node)
+    , _flasher(nullptr)
 {
 }
 
-MainConsole::MainConsole(Node *node)
-    : _node(node)
+MainConsole::MainConsole(UfwFlasher *flasher)
+    : _node(nullptr)
+    , _flasher(flasher)
 {
+    connect(_flasher, &UfwFlasher::nodeProgress, this, &MainConsole::updateNodeProgress);
+    connect(_flasher, &UfwFlasher::nodeFinished, this, &MainConsole::nodeFinished);
+    connect(_flasher, &UfwFlasher::finished, this, &MainConsole::flashFinished);
 }
 
 void MainConsole::updateStatus()
@@ -50,6 +53,47 @@ void MainConsole::updateStatus()
     }
 }
 
+void MainConsole::updateNodeProgress(Node *node)
+{
+    UfwFlasher::NodeProgress progress = _flasher->progress(node);
+    QString line = QString("node %1: %2").arg(node->nodeId()).arg(node->bootloader()->statusStr(progress.status));
+    if (progress.bytesTotal > 0)
+    {
+        line += QString(" %1% %2 kB/s").arg(progress.bytesWritten * 100 / progress.bytesTotal).arg(progress.throughput / 1000.0, 0, 'f', 1);
+    }
+    qDebug().noquote() << line;
+}
+
+void MainConsole::nodeFinished(Node *node, bool ok)
+{
+    UfwFlasher::NodeProgress progress = _flasher->progress(node);
+    QString line = QString("node %1: %2 in %3 s")
+                       .arg(node->nodeId())
+                       .arg(ok ? "updated" : "FAILED")
+                       .arg(static_cast<double>(progress.elapsedMs) / 1000.0, 0, 'f', 1);
+    switch (node->bootloader()->deltaSource())
+    {
+        case Bootloader::DELTA_DEVICE_TABLE:
+            line += QString(", delta from device checksums, %1 bytes").arg(progress.bytesTotal);
+            break;
+        case Bootloader::DELTA_CACHED_IMAGE:
+            line += QString(", delta from cached image, %1 bytes").arg(progress.bytesTotal);
+            break;
+        case Bootloader::DELTA_NONE:
+            break;
+    }
+    qDebug().noquote() << line;
+}
+
+void MainConsole::flashFinished(bool ok)
+{
+    qDebug().noquote() << QString("%1 node(s) updated, %2 failed in %3 s")
+                              .arg(_flasher->successCount())
+                              .arg(_flasher->failureCount())
+                              .arg(static_cast<double>(_flasher->elapsedMs()) / 1000.0, 0, 'f', 1);
+    emit finished(ok ? 0 : -1);
+}
+
 void MainConsole::nodeConnected(bool connected)
 {
     if (!connected)
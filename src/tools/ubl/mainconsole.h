@@ -21,18 +21,21 @@
 
 #include <QObject>
 
-class UpdateProcess;
 class Node;
+class UfwFlasher;
 
 class MainConsole : public QObject
 {
     Q_OBJECT
 public:
-    MainConsole(quint8 bus, quint8 speed, quint8 nodeid, const QString &binary);
     MainConsole(Node *node);
+    MainConsole(UfwFlasher *flasher);
 
 public slots:
     void updateStatus();
+    void updateNodeProgress(Node *node);
+    void nodeFinished(Node *node, bool ok);
+    void flashFinished(bool ok);
 
 private slots:
     void nodeConnected(bool connected);
@@ -42,13 +45,7 @@ signals:
 
 private:
     Node *_node;
-
-    quint8 _busId;
-    quint8 _speed;
-    quint8 _nodeId;
-    QString _binary;
-
-    UpdateProcess *_updateProcess;
+    UfwFlasher *_flasher;
 };
 
 #endif  // MAINCONSOLE_H
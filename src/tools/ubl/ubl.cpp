@@ -26,8 +26,10 @@
 #include <QFileInfo>
 #include <QObject>
 #include <QProcess>
+#include <QScopedPointer>
 #include <QStandardPaths>
 #include <QTextStream>
+#include <QTimer>
 #include <cstdint>
 
 #include "mainconsole.h"
@@ -36,7 +38,9 @@
 #include "bootloader/model/ufwmodel.h"
 #include "bootloader/parser/hexparser.h"
 #include "bootloader/parser/ufwparser.h"
+#include "bootloader/ufwflasher.h"
 #include "bootloader/utility/hexmerger.h"
+#include "bootloader/utility/ufwdelta.h"
 #include "bootloader/writer/hexwriter.h"
 #include "bootloader/writer/ufwwriter.h"
 
@@ -185,6 +189,44 @@ int diff(const QString &fileA, const QString &fileB)
     return 0;
 }
 
+int ufwDiff(const QString &previousFile, const QString &newFile, int pageSize, QTextStream &out, QTextStream &err)
+{
+    QScopedPointer<UfwModel> previousModel(UfwParser::parse(previousFile));
+    QScopedPointer<UfwModel> newModel(UfwParser::parse(newFile));
+    if (previousModel.isNull() || newModel.isNull())
+    {
+        err << QCoreApplication::translate("ubl", "error (1): invalid binary file") << "\n";
+        return -1;
+    }
+    if (previousModel->deviceType() != newModel->deviceType())
+    {
+        err << QCoreApplication::translate("ubl", "error (1): device types are different, a full update is needed") << "\n";
+        return -1;
+    }
+
+    UfwDelta delta(newModel.data(), pageSize);
+    delta.compare(previousModel.data());
+
+    for (const UfwModel::Segment &segment : delta.changedSegments())
+    {
+        out << QString("changed %1:%2").arg(segment.start, 8, 16, QChar('0')).arg(segment.end, 8, 16, QChar('0')) << "\n";
+    }
+    qint64 fullSize = delta.fullTransferSize();
+    qint64 deltaSize = delta.transferSize();
+    out << QString("%1 / %2 pages of %3 bytes changed").arg(delta.changedPageCount()).arg(delta.pageCount()).arg(delta.pageSize()) << "\n";
+    if (delta.erasedPageCount() > 0)
+    {
+        out << QString("%1 changed pages are erased, a full update is needed").arg(delta.erasedPageCount()) << "\n";
+        return 0;
+    }
+    out << QString("transfer %1 bytes instead of %2 (%3%)")
+               .arg(deltaSize)
+               .arg(fullSize)
+               .arg(fullSize > 0 ? static_cast<double>(deltaSize) * 100.0 / static_cast<double>(fullSize) : 0.0, 0, 'f', 1)
+        << "\n";
+    return 0;
+}
+
 int merge(QStringList aOptionList, QStringList bOptionList, QString outputFile, QTextStream &err)
 {
     if (bOptionList.isEmpty() || aOptionList.isEmpty())
@@ -264,11 +306,13 @@ int main(int argc, char *argv[])
     // MERGE
     cliParser.addPositionalArgument("merge", QCoreApplication::translate("ubl", "-afileA -bfileB -a start:end ... -b start:end ..."), "merge");
     // UPDATE and Flash
-    cliParser.addPositionalArgument("update", QCoreApplication::translate("ubl", "file -n nodeId"), "update");
+    cliParser.addPositionalArgument("update",
+                                    QCoreApplication::translate("ubl", "-f file -n nodeId [-n nodeId ...] | --all [-j jobs] [--load busLoad] [--delta] [--cache dir]"),
+                                    "update");
     // CREATE BIN
     cliParser.addPositionalArgument("ufw", QCoreApplication::translate("ubl", "-h file.hex -t type -s start:end ..."), "create");
     // DIFF
-    cliParser.addPositionalArgument("diff", QCoreApplication::translate("ubl", "fileA fileB"), "diff");
+    cliParser.addPositionalArgument("diff", QCoreApplication::translate("ubl", "fileA.hex fileB.hex | previous.ufw new.ufw [--page-size bytes]"), "diff");
     // HEX DUMP
     cliParser.addPositionalArgument("hexdump", QCoreApplication::translate("ubl", "fileA"), "hexdump");
     // OTP
@@ -312,6 +356,27 @@ int main(int argc, char *argv[])
                                    QCoreApplication::translate("ubl", "CAN Speed."),
                                    "speed");
     cliParser.addOption(speedOption);
+    QCommandLineOption allOption(QStringList() << "all", QCoreApplication::translate("ubl", "Update all nodes of the bus matching the firmware device type."));
+    cliParser.addOption(allOption);
+    QCommandLineOption jobsOption(QStringList() << "j"
+                                                << "jobs",
+                                  QCoreApplication::translate("ubl", "Number of nodes updated at the same time, 8 by default."),
+                                  "jobs");
+    cliParser.addOption(jobsOption);
+    QCommandLineOption loadOption(QStringList() << "load", QCoreApplication::translate("ubl", "Max bus load of the update, 0.6 by default."), "load");
+    cliParser.addOption(loadOption);
+    QCommandLineOption discoverOption(QStringList() << "discover-ms",
+                                      QCoreApplication::translate("ubl", "Max bus exploration duration before an update of all nodes, 30000 ms by default."),
+                                      "ms");
+    cliParser.addOption(discoverOption);
+    QCommandLineOption deltaOption(QStringList() << "delta", QCoreApplication::translate("ubl", "Write only the pages that differ from the firmware of the nodes."));
+    cliParser.addOption(deltaOption);
+    QCommandLineOption cacheOption(QStringList() << "cache",
+                                   QCoreApplication::translate("ubl", "Directory of the images flashed by node serial number, used by delta updates."),
+                                   "dir");
+    cliParser.addOption(cacheOption);
+    QCommandLineOption pageSizeOption(QStringList() << "page-size", QCoreApplication::translate("ubl", "Page size of delta comparisons, 2048 by default."), "bytes");
+    cliParser.addOption(pageSizeOption);
 
     // CREATE BIN
     QCommandLineOption hOption(QStringList() << "f"
@@ -375,6 +440,12 @@ int main(int argc, char *argv[])
             err << QCoreApplication::translate("ubl", "error (1): miss arguments to compare two files") << "\n";
             cliParser.showHelp(-1);
         }
+        const QStringList ufwSuffixes = {"ufw", "uni"};
+        if (ufwSuffixes.contains(QFileInfo(argument.at(1)).suffix()) && ufwSuffixes.contains(QFileInfo(argument.at(2)).suffix()))
+        {
+            int pageSize = cliParser.isSet(pageSizeOption) ? cliParser.value(pageSizeOption).toInt() : UfwDelta::DefaultPageSize;
+            return ufwDiff(argument.at(1), argument.at(2), pageSize, out, err);
+        }
         int ret = diff(argument.at(1), argument.at(2));
         if (ret < 0)
         {
@@ -420,6 +491,11 @@ int main(int argc, char *argv[])
 
         if (!hex->read())
         {
+            if (hex->errorLine() > 0)
+            {
+                err << QCoreApplication::translate("ubl", "error (1): invalid record in hex file at line %1").arg(hex->errorLine()) << "\n";
+                return -1;
+            }
             err << QCoreApplication::translate("ubl", "error (1): Hex file not present") << "\n";
             cliParser.showHelp(-1);
         }
@@ -448,24 +524,29 @@ int main(int argc, char *argv[])
     }
     else if (argument.at(0) == "update")
     {
-        quint8 nodeid = static_cast<uint8_t>(cliParser.value("nodeid").toUInt());
-        if (nodeid == 0 || nodeid >= 126)
+        QList<quint8> nodeIds;
+        for (const QString &nodeIdStr : cliParser.values(nodeIdOption))
         {
-            err << QCoreApplication::translate("ubl", "error (2): invalid node id, nodeId > 0 && nodeId < 126") << "\n";
-            return -2;
+            quint8 nodeid = static_cast<uint8_t>(nodeIdStr.toUInt());
+            if (nodeid == 0 || nodeid >= 126)
+            {
+                err << QCoreApplication::translate("ubl", "error (2): invalid node id, nodeId > 0 && nodeId < 126") << "\n";
+                return -2;
+            }
+            nodeIds.append(nodeid);
         }
-        quint8 bus = static_cast<uint8_t>(cliParser.value("busId").toUInt());
-        if (bus >= 126)
+        bool all = cliParser.isSet(allOption);
+        if (nodeIds.isEmpty() && !all)
         {
-            err << QCoreApplication::translate("ubl", "error (3): invalid bus id, busId > 0 && busId < 126") << "\n";
-            return -3;
+            err << QCoreApplication::translate("ubl", "error (2): node id or --all is needed") << "\n";
+            return -2;
         }
 
-        quint8 speed = static_cast<uint8_t>(cliParser.value("speed").toUInt());
-        if (speed == 0 || speed >= 126)
+        quint8 busId = static_cast<uint8_t>(cliParser.value("busId").toUInt());
+        if (busId >= 126)
         {
-            // err << QCoreApplication::translate("ubl", "error (4): invalid speed") << "\n";
-            // return -4;
+            err << QCoreApplication::translate("ubl", "error (3): invalid bus id, busId > 0 && busId < 126") << "\n";
+            return -3;
         }
 
         QString binFile = cliParser.value(hOption);
@@ -475,9 +556,81 @@ int main(int argc, char *argv[])
             cliParser.showHelp(-1);
         }
 
-        MainConsole *mainConsole = new MainConsole(bus, speed, nodeid, UfwParser::parse(binFile)->prog());
+        // firmware parsed once, shared by all nodes
+        UfwFlasher *flasher = new UfwFlasher();
+        if (!flasher->openUfw(binFile))
+        {
+            err << QCoreApplication::translate("ubl", "error (1): invalid binary file") << "\n";
+            return -1;
+        }
+        if (cliParser.isSet(jobsOption))
+        {
+            flasher->setMaxConcurrent(cliParser.value(jobsOption).toInt());
+        }
+        if (cliParser.isSet(loadOption))
+        {
+            flasher->setBusLoadLimit(cliParser.value(loadOption).toDouble());
+        }
+        flasher->setDeltaMode(cliParser.isSet(deltaOption));
+        if (cliParser.isSet(cacheOption))
+        {
+            flasher->setImageCacheDir(cliParser.value(cacheOption));
+        }
+        else
+        {
+            flasher->setImageCacheDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/images");
+        }
+
+        CanOpenBus *bus = nullptr;
+#ifdef Q_OS_UNIX
+        bus = new CanOpenBus(new CanBusSocketCAN(QString("can%1").arg(busId)));
+#endif
+        if (bus == nullptr)
+        {
+            return 0;
+        }
+        bus->setBusName("Bus 1");
+        CanOpen::addBus(bus);
+
+        for (quint8 nodeId : qAsConst(nodeIds))
+        {
+            bus->addNode(new Node(nodeId));
+            flasher->addNode(bus->node(nodeId));
+        }
+
+        MainConsole *mainConsole = new MainConsole(flasher);
         QObject::connect(mainConsole, &MainConsole::finished, &app, &QCoreApplication::exit);
 
+        if (all)
+        {
+            // nodes are updated once explored, the exploration of a node not answering is bounded by --discover-ms
+            int discoverMs = cliParser.isSet(discoverOption) ? cliParser.value(discoverOption).toInt() : 30000;
+            QTimer *discoverTimer = new QTimer();
+            discoverTimer->setSingleShot(true);
+            auto startAll = [=, &err]()
+            {
+                QObject::disconnect(bus->nodeDiscover(), nullptr, discoverTimer, nullptr);
+                discoverTimer->stop();
+                discoverTimer->deleteLater();
+
+                flasher->addMatchingNodes(bus);
+                if (!flasher->start())
+                {
+                    err << QCoreApplication::translate("ubl", "error (2): no node to update") << "\n";
+                    err.flush();
+                    qApp->exit(-2);
+                }
+            };
+            QObject::connect(discoverTimer, &QTimer::timeout, discoverTimer, startAll);
+            QObject::connect(bus->nodeDiscover(), &NodeDiscover::explorationFinished, discoverTimer, startAll);
+            discoverTimer->start(discoverMs);
+            bus->exploreBus();
+        }
+        else
+        {
+            flasher->start();
+        }
+
         return QCoreApplication::exec();
     }
     else if (argument.at(0) == "otp")
@@ -0,0 +1,286 @@
+/**
+ ** This file is part of the UDTStudio project.
+ ** Copyright 2021 UniSwarm
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QtEndian>
+
+#include "bootloader/model/ufwmodel.h"
+#include "bootloader/utility/ufwpacker.h"
+
+#include <random>
+
+#if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
+#    define cendl endl
+#else
+#    define cendl Qt::endl
+#endif
+
+typedef QByteArray (*PackFunction)(const QByteArray &prog, const UfwModel::Segment &segment, uint32_t &sum);
+
+/**
+ * @brief Byte by byte packing of a segment, reference of the vector paths of UfwPacker
+ */
+QByteArray packScalar(const QByteArray &prog, const UfwModel::Segment &segment, uint32_t &sum)
+{
+    uint32_t progSize = static_cast<uint32_t>(prog.size());
+    uint32_t start = qMin(segment.start, progSize);
+    uint32_t end = qBound(start, segment.end, progSize);
+
+    QByteArray data(4, Qt::Uninitialized);
+    qToLittleEndian(segment.start, data.data());
+    data.reserve(4 + static_cast<int>(end - start));
+
+    int erased = 0;
+    for (uint32_t i = start; i < end; i++)
+    {
+        if (((i - start) & 3) == 3)
+        {
+            continue;
+        }
+        uint8_t byte = static_cast<uint8_t>(prog.at(static_cast<int>(i)));
+        sum += byte;
+        if (byte == 0xFF)
+        {
+            erased = (erased + 1) % 8;
+            continue;
+        }
+        if (erased > 0)
+        {
+            data.append(erased, static_cast<char>(0xFF));
+            erased = 0;
+        }
+        data.append(static_cast<char>(byte));
+    }
+    data.append(erased, static_cast<char>(0xFF));
+    return data;
+}
+
+/**
+ * @brief Packing of a segment as done before UfwPacker, quadratic with the number of erased runs
+ */
+QByteArray packPrevious(const QByteArray &prog, const UfwModel::Segment &segment, uint32_t &sum)
+{
+    QByteArray segmentProg = prog.mid(static_cast<int>(segment.start), static_cast<int>(segment.end) - static_cast<int>(segment.start));
+
+    QByteArray data;
+    for (int index = 0; index < segmentProg.size(); index += 4)
+    {
+        data.append(segmentProg.mid(index, 3));
+    }
+    for (int i = 0; i < data.size(); i++)
+    {
+        sum += static_cast<uint8_t>(data.at(i));
+    }
+
+    const QByteArray erasedRun(8, static_cast<char>(0xFF));
+    int j = 0;
+    while ((j = data.indexOf(erasedRun, j)) != -1)
+    {
+        data.remove(j, 8);
+    }
+
+    char buffer[4];
+    qToLittleEndian(segment.start, buffer);
+    data.prepend(buffer, sizeof(buffer));
+    return data;
+}
+
+/**
+ * @brief Firmware like image: blocks of code bytes and erased blocks
+ */
+QByteArray firmwareImage(int size, std::mt19937 &random)
+{
+    QByteArray prog(size, static_cast<char>(0xFF));
+    const int blockSize = 32 * 1024;
+    for (int block = 0; block < size; block += blockSize)
+    {
+        if (random() % 5 < 2)
+        {
+            continue;
+        }
+        int blockEnd = qMin(block + blockSize, size);
+        for (int i = block; i < blockEnd; i++)
+        {
+            // about 3% of erased bytes in code, phantom bytes are null
+            uint8_t byte = ((i & 3) == 3) ? 0 : static_cast<uint8_t>(random());
+            if (random() % 32 == 0)
+            {
+                byte = 0xFF;
+            }
+            prog[i] = static_cast<char>(byte);
+        }
+    }
+    return prog;
+}
+
+/**
+ * @brief Worst case image: one byte out of four erased, scattered in the whole image
+ */
+QByteArray scatteredImage(int size, std::mt19937 &random)
+{
+    QByteArray prog(size, Qt::Uninitialized);
+    for (int i = 0; i < size; i++)
+    {
+        prog[i] = (random() % 4 == 0) ? static_cast<char>(0xFF) : static_cast<char>(random() % 0xFF);
+    }
+    return prog;
+}
+
+/**
+ * @brief Best time of a packing function in ns, data and sum of the last run
+ */
+qint64 bestTime(PackFunction pack, const QByteArray &prog, const UfwModel::Segment &segment, int repeat, QByteArray &data, uint32_t &sum)
+{
+    QElapsedTimer timer;
+    qint64 best = -1;
+    for (int i = 0; i < repeat; i++)
+    {
+        sum = 0;
+        timer.start();
+        data = pack(prog, segment, sum);
+        qint64 elapsed = timer.nsecsElapsed();
+        if (best < 0 || elapsed < best)
+        {
+            best = elapsed;
+        }
+    }
+    return best;
+}
+
+QString formatMs(qint64 ns)
+{
+    return QString::number(static_cast<double>(ns) / 1000000.0, 'f', 2);
+}
+
+/**
+ * @brief main
+ * @return
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("ufwbench");
+    QCoreApplication::setApplicationVersion("1.0");
+
+    QTextStream out(stdout, QIODevice::WriteOnly);
+    QTextStream err(stderr, QIODevice::WriteOnly);
+
+    QCommandLineParser cliParser;
+    cliParser.setApplicationDescription(QCoreApplication::translate("ufwbench", "Firmware segment packing benchmark."));
+    cliParser.addHelpOption();
+    cliParser.addVersionOption();
+
+    QCommandLineOption sizesOption(QStringList() << "s"
+                                                 << "sizes",
+                                   QCoreApplication::translate("ufwbench", "Image sizes in MiB, comma separated (default 1,4,16)"),
+                                   "sizes");
+    cliParser.addOption(sizesOption);
+
+    QCommandLineOption repeatOption(QStringList() << "r"
+                                                  << "repeat",
+                                    QCoreApplication::translate("ufwbench", "Runs of each packing, the best time is kept (default 5)"),
+                                    "repeat");
+    cliParser.addOption(repeatOption);
+
+    QCommandLineOption previousOption(QStringList() << "p"
+                                                    << "previous-max",
+                                      QCoreApplication::translate("ufwbench", "Largest size in MiB timed with the previous packing, 0 to skip it (default 1)"),
+                                      "previous-max");
+    cliParser.addOption(previousOption);
+
+    cliParser.process(app);
+
+    QList<int> sizes;
+    const QStringList sizeList = cliParser.isSet(sizesOption) ? cliParser.value(sizesOption).split(',') : QStringList({"1", "4", "16"});
+    for (const QString &sizeStr : sizeList)
+    {
+        int size = sizeStr.toInt();
+        if (size <= 0 || size > 1024)
+        {
+            err << QCoreApplication::translate("ufwbench", "error (1): invalid size %1, 0 < size <= 1024").arg(sizeStr) << cendl;
+            return -1;
+        }
+        sizes.append(size);
+    }
+    int repeat = cliParser.isSet(repeatOption) ? qMax(1, cliParser.value(repeatOption).toInt()) : 5;
+    int previousMax = cliParser.isSet(previousOption) ? cliParser.value(previousOption).toInt() : 1;
+
+    out << QString("instruction set: %1, best of %2 runs").arg(UfwPacker::instructionSet()).arg(repeat) << cendl;
+    out << QString("%1 %2 %3 %4 %5 %6")
+               .arg("image", -10)
+               .arg("MiB", 5)
+               .arg("packer ms", 11)
+               .arg("scalar ms", 11)
+               .arg("previous ms", 13)
+               .arg("packer MiB/s", 14)
+        << cendl;
+
+    std::mt19937 random(0x55F0);
+    for (int image = 0; image < 2; image++)
+    {
+        for (int size : qAsConst(sizes))
+        {
+            QByteArray prog = (image == 0) ? firmwareImage(size * 1024 * 1024, random) : scatteredImage(size * 1024 * 1024, random);
+            UfwModel::Segment segment;
+            segment.start = 0;
+            segment.end = static_cast<uint32_t>(prog.size());
+
+            QByteArray packerData;
+            uint32_t packerSum = 0;
+            qint64 packerNs = bestTime(&UfwPacker::packSegment, prog, segment, repeat, packerData, packerSum);
+
+            QByteArray scalarData;
+            uint32_t scalarSum = 0;
+            qint64 scalarNs = bestTime(&packScalar, prog, segment, repeat, scalarData, scalarSum);
+            if (scalarData != packerData || scalarSum != packerSum)
+            {
+                err << QCoreApplication::translate("ufwbench", "error (2): packer and scalar outputs differ") << cendl;
+                return -2;
+            }
+
+            QString previousMs = "-";
+            if (size <= previousMax)
+            {
+                QByteArray previousData;
+                uint32_t previousSum = 0;
+                qint64 previousNs = bestTime(&packPrevious, prog, segment, 1, previousData, previousSum);
+                if (previousData != packerData || previousSum != packerSum)
+                {
+                    err << QCoreApplication::translate("ufwbench", "error (2): packer and previous outputs differ") << cendl;
+                    return -2;
+                }
+                previousMs = formatMs(previousNs);
+            }
+
+            double throughput = (packerNs > 0) ? static_cast<double>(size) * 1000000000.0 / static_cast<double>(packerNs) : 0.0;
+            out << QString("%1 %2 %3 %4 %5 %6")
+                       .arg((image == 0) ? "firmware" : "scattered", -10)
+                       .arg(size, 5)
+                       .arg(formatMs(packerNs), 11)
+                       .arg(formatMs(scalarNs), 11)
+                       .arg(previousMs, 13)
+                       .arg(QString::number(throughput, 'f', 0), 14)
+                << cendl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,28 @@
+
+QT += core
+TARGET = ufwbench
+TEMPLATE = app
+DESTDIR = "$$PWD/../../../bin"
+
+HEADERS += \
+
+SOURCES += \
+    $$PWD/ufwbench.cpp
+
+LIBS += -L"$$PWD/../../../bin"
+android:LIBS += -lod_$${QT_ARCH} -lcanopen_$${QT_ARCH}
+else:LIBS += -lod -lcanopen
+
+INCLUDEPATH += $$PWD/../../lib/canopen/ $$PWD/../../lib/od/
+DEPENDPATH += $$PWD/../../lib/canopen/ $$PWD/../../lib/od/
+unix:{
+    QMAKE_LFLAGS_RPATH=
+    QMAKE_LFLAGS += "-Wl,-rpath,\'\$$ORIGIN\'"
+}
+
+isEmpty(PREFIX)
+{
+    PREFIX=/usr/local
+}
+target.path=$$PREFIX/bin
+!isEmpty(target.path): INSTALLS += target
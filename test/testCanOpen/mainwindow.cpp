@@ -57,9 +57,9 @@ MainWindow::~MainWindow()
 
 void MainWindow::explore()
 {
-    _canDev->writeFrame(QCanBusFrame(0x702, QByteArray()));
-    //_canDev->writeFrame(QCanBusFrame(0x708, QByteArray()));
-    //_canDev->writeFrame(QCanBusFrame(0x703, QByteArray()));
+    _canDev->writeFrame(CanFrame(0x702, QByteArray()));
+    //_canDev->writeFrame(CanFrame(0x708, QByteArray()));
+    //_canDev->writeFrame(CanFrame(0x703, QByteArray()));
 }
 
 void MainWindow::sendState()
@@ -68,7 +68,7 @@ void MainWindow::sendState()
     toggle = !toggle;
     QByteArray data;
     data.append(c);
-    _canDev->writeFrame(QCanBusFrame(0x702, data));
+    _canDev->writeFrame(CanFrame(0x702, data));
 }
 
 void MainWindow::replySdo1000()
@@ -82,5 +82,5 @@ void MainWindow::replySdo1000()
     QDataStream stream(&data, QIODevice::WriteOnly);
     stream.setByteOrder(QDataStream::LittleEndian);
     stream << command << index << subIndex << value;
-    _canDev->writeFrame(QCanBusFrame(0x582, data));
+    _canDev->writeFrame(CanFrame(0x582, data));
 }